@@ -512,6 +512,11 @@ func (Project) Release() error {
 	return coreBuild(PROJECT_NAME, "Release", true)
 }
 
+// Companion tool which displays the telemetry of a running host
+func (Project) Telemetry() error {
+	return coreBuild("telemetry", "Debug", true)
+}
+
 // Module Build Targets
 // --------------------
 
@@ -527,7 +532,50 @@ func (Module) Basic() error {
 type Test mg.Namespace
 
 func (Test) Build() error {
-	return coreBuild("test", "Debug", true)
+	return testBuild("Debug")
+}
+
+// Run the unit tests
+func (Test) Run() error {
+	err := testBuild("Debug")
+
+	if err != nil {
+		return err
+	}
+
+	return testRun()
+}
+
+// Run the unit tests and microbenchmarks on a release build, appending the results to build/bench.jsonl
+func (Test) Bench() error {
+	err := testBuild("Release")
+
+	if err != nil {
+		return err
+	}
+
+	return testRun("--bench", "--json", "./build/bench.jsonl")
+}
+
+// the tests load the fixture module
+func testBuild(config string) error {
+	err := coreBuild("fixture", config, true)
+
+	if err != nil {
+		return err
+	}
+
+	return coreBuild("test", config, false)
+}
+
+func testRun(args ...string) error {
+	ran, err := sh.Exec(nil, os.Stdout, os.Stderr, "./build/test", args...)
+
+	if !ran || err != nil {
+		return printFailTitle("Tests failed. Error: " + err.Error())
+	}
+
+	return nil
 }
 
 // Tool Build Targets
@@ -21,6 +21,12 @@ filter "configurations:Debug"
     "TRACY_ENABLE"
   }
 
+-- the sampling profiler walks frame pointers
+filter { "configurations:Debug", "system:not windows" }
+  buildoptions {
+    "-fno-omit-frame-pointer"
+  }
+
 filter "configurations:Release"
   optimize "On"
   defines { "NDEBUG" }
@@ -72,6 +78,10 @@ project "raylib"
     "-D_GNU_SOURCE",
     "-DGL_SILENCE_DEPRECATION=199309L",
 
+    -- a shared library, the workspace's -fPIE can't reach thread locals
+    -- (stb_image's failure reason) from one
+    "-fPIC",
+
     -- "-mcmodel=large",
     -- "-fPIE",
     -- "-Werror=return-type",
@@ -92,6 +102,12 @@ project "raylib"
     "src/ext/raylib/rtext.c",
     "src/ext/raylib/rtextures.c",
     "src/ext/raylib/utils.c",
+
+    -- the host replaces raylib's allocator, see rlalloc.h
+    "src/lib/memory/rlalloc.c",
+  }
+  forceincludes {
+    "src/lib/memory/rlalloc.h",
   }
   includedirs {
     "src/ext/raylib/",
@@ -166,7 +182,11 @@ project "reload"
     "src/**_test.*",
 
     "src/ext/**",
-    "src/modules/**"
+    "src/modules/**",
+    "src/tools/**",
+
+    -- built into raylib
+    "src/lib/memory/rlalloc.c"
   }
 
   -- enable tracing for debug builds
@@ -188,6 +208,7 @@ project "reload"
       "dl",
       "m",
       "pthread",
+      "rt",
       "dl"
     }
   end
@@ -229,6 +250,46 @@ project "reload"
    --  filter "files:src/main.c"
    --    compileas "Objective-C"
 
+-- attaches to a running host and displays or records its telemetry
+project "telemetry"
+  kind "ConsoleApp"
+  language "C"
+  targetdir( "build" )
+
+  includedirs {
+    "src",
+    "src/lib",
+  }
+
+  files {
+    "src/lib/telemetry/segment.h",
+    "src/tools/telemetry/**.c"
+  }
+
+  if (os.host() == "linux") then
+    links {
+      "rt"
+    }
+  end
+
+-- a module the tests load and reload
+project "fixture"
+  kind "SharedLib"
+  language "C"
+  targetdir( "build" )
+
+  includedirs {
+    "src",
+    "src/lib/",
+  }
+
+  files {
+    "src/test/fixture/**.h",
+    "src/test/fixture/**.c"
+  }
+
+-- unit tests and microbenchmarks for the host libraries, run from the
+-- repository root: build/test [--bench] [--filter <text>] [--json <path>]
 project "test"
   kind "ConsoleApp"
   language "C"
@@ -238,52 +299,57 @@ project "test"
     "RELOAD_UNIT"
   }
 
+  dependson {
+    "fixture"
+  }
+
   links {
-    "munit"
+    "raylib"
   }
 
   libdirs {
     "build"
   }
 
-  sysincludedirs {
-    "ext"
-  }
-
   includedirs {
-    "src"
+    "src",
+    "src/lib",
+    "src/ext/raylib/",
   }
 
   files {
-    "src/**.h",
-    "src/**.c",
-
+    "src/lib/**.h",
+    "src/lib/**.c",
+    "src/test/**.h",
+    "src/test/**.c"
   }
 
-  -- ignore the reload main
   removefiles {
-    "src/main.c"
+    "src/test/fixture/**",
+
+    -- built into raylib
+    "src/lib/memory/rlalloc.c"
   }
 
-  if (system == macosx) then
+  if (os.host() == "linux") then
     links {
-      "c"
+      "c",
+      "dl",
+      "m",
+      "pthread",
+      "rt"
     }
   end
 
-  if (system == linux) then
-    libdirs {
-      os.findlib("m"),
-      os.findlib("c")
-    }
+  if (os.host() == "macosx") then
     links {
+      "CoreServices.framework",
       "c",
-      "m",
-      "pthread",
+      "dl"
     }
   end
 
-  if (system == windows) then
+  if (os.host() == "windows") then
     defines {
       "_CRT_SECURE_NO_WARNINGS"
     }
@@ -292,9 +358,9 @@ project "test"
     }
     -- Turn off edit and continue
     editAndContinue "Off"
-
-  filter "platforms:windows"
-    -- if on windows include the win32 impl of unix utils
+    links {
+      "winstd"
+    }
     sysincludedirs {
       "ext/winstd"
     }
@@ -302,16 +368,6 @@ project "test"
 
 -- External Libraries
 
-project "munit"
-  kind "StaticLib"
-  language "C"
-  targetdir( "build" )
-
-  files {
-    "ext/munit/**.h",
-    "ext/munit/**.c"
-  }
-
 if (system == windows) then
 project "winstd"
   kind "StaticLib"
@@ -404,6 +404,14 @@ typedef struct Model {
     Transform *bindPose;    // Bones base transformation (pose)
 } Model;
 
+// ModelData, model loaded without GPU uploads, see LoadModelData()
+typedef struct ModelData {
+    Model model;            // Model with meshes not uploaded yet
+    int imageCount;         // Material map images count
+    Image *images;          // Material map images, uploaded by UploadModelData()
+    Texture2D **textures;   // Material map textures the images are uploaded into
+} ModelData;
+
 // ModelAnimation
 typedef struct ModelAnimation {
     int boneCount;          // Number of bones
@@ -499,6 +507,13 @@ typedef struct VrStereoConfig {
     float scaleIn[2];               // VR distortion scale in
 } VrStereoConfig;
 
+// AutomationEvent, one change of the input state registered by PollInputEvents()
+typedef struct AutomationEvent {
+    unsigned int frame;             // Event frame
+    unsigned int type;              // Event type (AutomationEventType)
+    int params[4];                  // Event parameters (if required)
+} AutomationEvent;
+
 // File path list
 typedef struct FilePathList {
     unsigned int capacity;          // Filepaths max entries
@@ -1151,6 +1166,16 @@ RLAPI Vector2 GetTouchPosition(int index);                    // Get touch posit
 RLAPI int GetTouchPointId(int index);                         // Get touch point identifier for given index
 RLAPI int GetTouchPointCount(void);                           // Get number of touch points
 
+// Input-related functions: automation events
+RLAPI int GetAutomationEvents(AutomationEvent *events, int capacity); // Get input changes registered by the last PollInputEvents(), returns the events count, which may exceed capacity
+RLAPI void PlayAutomationEvents(const AutomationEvent *events, int count); // Apply input changes over the current input state
+RLAPI bool IsAutomationEventSupported(unsigned int type);     // Check if an event type is one the functions above register and apply
+
+// Input-related functions: input state copies
+RLAPI int GetInputStateSize(void);                            // Get the size of a copy of the input state
+RLAPI void CopyInputState(void *state);                       // Copy the live input state into state (GetInputStateSize() bytes)
+RLAPI void SetThreadInputState(void *state);                  // Read input on the calling thread from a copy, NULL for the live state
+
 //------------------------------------------------------------------------------------
 // Gestures and Touch Handling Functions (Module: rgestures)
 //------------------------------------------------------------------------------------
@@ -1450,6 +1475,9 @@ RLAPI void DrawGrid(int slices, float spacing);
 // Model management functions
 RLAPI Model LoadModel(const char *fileName);                                                // Load model from files (meshes and materials)
 RLAPI Model LoadModelFromMesh(Mesh mesh);                                                   // Load model from generated mesh (default material)
+RLAPI ModelData LoadModelData(const char *fileName);                                        // Load model data from files without GPU uploads (callable from any thread)
+RLAPI Model UploadModelData(ModelData data);                                                // Upload model data meshes and material map images to GPU
+RLAPI void UnloadModelData(ModelData data);                                                 // Unload model data which was never uploaded (callable from any thread)
 RLAPI bool IsModelReady(Model model);                                                       // Check if a model is ready
 RLAPI void UnloadModel(Model model);                                                        // Unload model (including meshes) from memory (RAM and/or VRAM)
 RLAPI BoundingBox GetModelBoundingBox(Model model);                                         // Compute model bounding box limits (considers all meshes)
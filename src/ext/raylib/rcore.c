@@ -428,7 +428,7 @@ typedef struct CoreData {
     struct {
         const char *basePath;               // Base path for data storage
     } Storage;
-    struct {
+    struct CoreInputData {
 #if defined(PLATFORM_RPI) || defined(PLATFORM_DRM)
         InputEventWorker eventWorker[10];   // List of worker threads for every monitored "/dev/input/event<N>"
 #endif
@@ -514,6 +514,11 @@ RLAPI const char *raylib_version = RAYLIB_VERSION;  // raylib version exported s
 
 static CoreData CORE = { 0 };               // Global CORE state context
 
+// Input state the calling thread reads instead of the live one, see SetThreadInputState()
+// NOTE: Only the thread polling the events writes the live state
+static _Thread_local struct CoreInputData *threadInputState = NULL;
+#define CORE_INPUT (*(threadInputState? threadInputState : &CORE.Input))
+
 #if defined(SUPPORT_SCREEN_CAPTURE)
 static int screenshotCounter = 0;           // Screenshots counter
 #endif
@@ -524,9 +529,6 @@ static bool gifRecording = false;           // GIF recording state
 static MsfGifState gifState = { 0 };        // MSGIF context state
 #endif
 
-#if defined(SUPPORT_EVENTS_AUTOMATION)
-#define MAX_CODE_AUTOMATION_EVENTS      16384
-
 typedef enum AutomationEventType {
     EVENT_NONE = 0,
     // Input events
@@ -554,9 +556,14 @@ typedef enum AutomationEventType {
     WINDOW_RESIZE,                  // param[0]: width, param[1]: height
     // Custom events
     ACTION_TAKE_SCREENSHOT,
-    ACTION_SETTARGETFPS
+    ACTION_SETTARGETFPS,
+    // Input queue events
+    INPUT_CHAR_PRESSED              // param[0]: char (unicode)
 } AutomationEventType;
 
+#if defined(SUPPORT_EVENTS_AUTOMATION)
+#define MAX_CODE_AUTOMATION_EVENTS      16384
+
 // Event type
 // Used to enable events flags
 typedef enum {
@@ -593,16 +600,10 @@ static const char *autoEventTypeName[] = {
     "WINDOW_MINIMIZE",
     "WINDOW_RESIZE",
     "ACTION_TAKE_SCREENSHOT",
-    "ACTION_SETTARGETFPS"
+    "ACTION_SETTARGETFPS",
+    "INPUT_CHAR_PRESSED"
 };
 
-// Automation Event (24 bytes)
-typedef struct AutomationEvent {
-    unsigned int frame;                 // Event frame
-    unsigned int type;                  // Event type (AutomationEventType)
-    int params[4];                      // Event parameters (if required)
-} AutomationEvent;
-
 static AutomationEvent *events = NULL;  // Events array
 static unsigned int eventCount = 0;     // Events count
 static bool eventsPlaying = false;      // Play events
@@ -785,11 +786,11 @@ void InitWindow(int width, int height, const char *title)
     if ((title != NULL) && (title[0] != 0)) CORE.Window.title = title;
 
     // Initialize global input state
-    memset(&CORE.Input, 0, sizeof(CORE.Input));
-    CORE.Input.Keyboard.exitKey = KEY_ESCAPE;
-    CORE.Input.Mouse.scale = (Vector2){ 1.0f, 1.0f };
-    CORE.Input.Mouse.cursor = MOUSE_CURSOR_ARROW;
-    CORE.Input.Gamepad.lastButtonPressed = 0;       // GAMEPAD_BUTTON_UNKNOWN
+    memset(&CORE_INPUT, 0, sizeof(CORE_INPUT));
+    CORE_INPUT.Keyboard.exitKey = KEY_ESCAPE;
+    CORE_INPUT.Mouse.scale = (Vector2){ 1.0f, 1.0f };
+    CORE_INPUT.Mouse.cursor = MOUSE_CURSOR_ARROW;
+    CORE_INPUT.Gamepad.lastButtonPressed = 0;       // GAMEPAD_BUTTON_UNKNOWN
 #if defined(SUPPORT_EVENTS_WAITING)
     CORE.Window.eventWaiting = true;
 #endif
@@ -1075,21 +1076,21 @@ void CloseWindow(void)
     CORE.Window.shouldClose = true;   // Added to force threads to exit when the close window is called
 
     // Close the evdev keyboard
-    if (CORE.Input.Keyboard.fd != -1)
+    if (CORE_INPUT.Keyboard.fd != -1)
     {
-        close(CORE.Input.Keyboard.fd);
-        CORE.Input.Keyboard.fd = -1;
+        close(CORE_INPUT.Keyboard.fd);
+        CORE_INPUT.Keyboard.fd = -1;
     }
 
-    for (int i = 0; i < sizeof(CORE.Input.eventWorker)/sizeof(InputEventWorker); ++i)
+    for (int i = 0; i < sizeof(CORE_INPUT.eventWorker)/sizeof(InputEventWorker); ++i)
     {
-        if (CORE.Input.eventWorker[i].threadId)
+        if (CORE_INPUT.eventWorker[i].threadId)
         {
-            pthread_join(CORE.Input.eventWorker[i].threadId, NULL);
+            pthread_join(CORE_INPUT.eventWorker[i].threadId, NULL);
         }
     }
 
-    if (CORE.Input.Gamepad.threadId) pthread_join(CORE.Input.Gamepad.threadId, NULL);
+    if (CORE_INPUT.Gamepad.threadId) pthread_join(CORE_INPUT.Gamepad.threadId, NULL);
 #endif
 
 #if defined(SUPPORT_EVENTS_AUTOMATION)
@@ -2070,7 +2071,7 @@ void ShowCursor(void)
     glfwSetInputMode(CORE.Window.handle, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
 #endif
 
-    CORE.Input.Mouse.cursorHidden = false;
+    CORE_INPUT.Mouse.cursorHidden = false;
 }
 
 // Hides mouse cursor
@@ -2080,13 +2081,13 @@ void HideCursor(void)
     glfwSetInputMode(CORE.Window.handle, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
 #endif
 
-    CORE.Input.Mouse.cursorHidden = true;
+    CORE_INPUT.Mouse.cursorHidden = true;
 }
 
 // Check if cursor is not visible
 bool IsCursorHidden(void)
 {
-    return CORE.Input.Mouse.cursorHidden;
+    return CORE_INPUT.Mouse.cursorHidden;
 }
 
 // Enables cursor (unlock cursor)
@@ -2101,7 +2102,7 @@ void EnableCursor(void)
     // Set cursor position in the middle
     SetMousePosition(CORE.Window.screen.width/2, CORE.Window.screen.height/2);
 
-    CORE.Input.Mouse.cursorHidden = false;
+    CORE_INPUT.Mouse.cursorHidden = false;
 }
 
 // Disables cursor (lock cursor)
@@ -2116,13 +2117,13 @@ void DisableCursor(void)
     // Set cursor position in the middle
     SetMousePosition(CORE.Window.screen.width/2, CORE.Window.screen.height/2);
 
-    CORE.Input.Mouse.cursorHidden = true;
+    CORE_INPUT.Mouse.cursorHidden = true;
 }
 
 // Check if cursor is on the current screen.
 bool IsCursorOnScreen(void)
 {
-    return CORE.Input.Mouse.cursorOnScreen;
+    return CORE_INPUT.Mouse.cursorOnScreen;
 }
 
 // Set background color (framebuffer clear color)
@@ -3621,7 +3622,7 @@ bool IsKeyPressed(int key)
 {
     bool pressed = false;
 
-    if ((CORE.Input.Keyboard.previousKeyState[key] == 0) && (CORE.Input.Keyboard.currentKeyState[key] == 1)) pressed = true;
+    if ((CORE_INPUT.Keyboard.previousKeyState[key] == 0) && (CORE_INPUT.Keyboard.currentKeyState[key] == 1)) pressed = true;
 
     return pressed;
 }
@@ -3629,7 +3630,7 @@ bool IsKeyPressed(int key)
 // Check if a key is being pressed (key held down)
 bool IsKeyDown(int key)
 {
-    if (CORE.Input.Keyboard.currentKeyState[key] == 1) return true;
+    if (CORE_INPUT.Keyboard.currentKeyState[key] == 1) return true;
     else return false;
 }
 
@@ -3638,7 +3639,7 @@ bool IsKeyReleased(int key)
 {
     bool released = false;
 
-    if ((CORE.Input.Keyboard.previousKeyState[key] == 1) && (CORE.Input.Keyboard.currentKeyState[key] == 0)) released = true;
+    if ((CORE_INPUT.Keyboard.previousKeyState[key] == 1) && (CORE_INPUT.Keyboard.currentKeyState[key] == 0)) released = true;
 
     return released;
 }
@@ -3646,7 +3647,7 @@ bool IsKeyReleased(int key)
 // Check if a key is NOT being pressed (key not held down)
 bool IsKeyUp(int key)
 {
-    if (CORE.Input.Keyboard.currentKeyState[key] == 0) return true;
+    if (CORE_INPUT.Keyboard.currentKeyState[key] == 0) return true;
     else return false;
 }
 
@@ -3655,18 +3656,18 @@ int GetKeyPressed(void)
 {
     int value = 0;
 
-    if (CORE.Input.Keyboard.keyPressedQueueCount > 0)
+    if (CORE_INPUT.Keyboard.keyPressedQueueCount > 0)
     {
         // Get character from the queue head
-        value = CORE.Input.Keyboard.keyPressedQueue[0];
+        value = CORE_INPUT.Keyboard.keyPressedQueue[0];
 
         // Shift elements 1 step toward the head.
-        for (int i = 0; i < (CORE.Input.Keyboard.keyPressedQueueCount - 1); i++)
-            CORE.Input.Keyboard.keyPressedQueue[i] = CORE.Input.Keyboard.keyPressedQueue[i + 1];
+        for (int i = 0; i < (CORE_INPUT.Keyboard.keyPressedQueueCount - 1); i++)
+            CORE_INPUT.Keyboard.keyPressedQueue[i] = CORE_INPUT.Keyboard.keyPressedQueue[i + 1];
 
         // Reset last character in the queue
-        CORE.Input.Keyboard.keyPressedQueue[CORE.Input.Keyboard.keyPressedQueueCount - 1] = 0;
-        CORE.Input.Keyboard.keyPressedQueueCount--;
+        CORE_INPUT.Keyboard.keyPressedQueue[CORE_INPUT.Keyboard.keyPressedQueueCount - 1] = 0;
+        CORE_INPUT.Keyboard.keyPressedQueueCount--;
     }
 
     return value;
@@ -3677,18 +3678,18 @@ int GetCharPressed(void)
 {
     int value = 0;
 
-    if (CORE.Input.Keyboard.charPressedQueueCount > 0)
+    if (CORE_INPUT.Keyboard.charPressedQueueCount > 0)
     {
         // Get character from the queue head
-        value = CORE.Input.Keyboard.charPressedQueue[0];
+        value = CORE_INPUT.Keyboard.charPressedQueue[0];
 
         // Shift elements 1 step toward the head.
-        for (int i = 0; i < (CORE.Input.Keyboard.charPressedQueueCount - 1); i++)
-            CORE.Input.Keyboard.charPressedQueue[i] = CORE.Input.Keyboard.charPressedQueue[i + 1];
+        for (int i = 0; i < (CORE_INPUT.Keyboard.charPressedQueueCount - 1); i++)
+            CORE_INPUT.Keyboard.charPressedQueue[i] = CORE_INPUT.Keyboard.charPressedQueue[i + 1];
 
         // Reset last character in the queue
-        CORE.Input.Keyboard.charPressedQueue[CORE.Input.Keyboard.charPressedQueueCount - 1] = 0;
-        CORE.Input.Keyboard.charPressedQueueCount--;
+        CORE_INPUT.Keyboard.charPressedQueue[CORE_INPUT.Keyboard.charPressedQueueCount - 1] = 0;
+        CORE_INPUT.Keyboard.charPressedQueueCount--;
     }
 
     return value;
@@ -3699,7 +3700,7 @@ int GetCharPressed(void)
 void SetExitKey(int key)
 {
 #if !defined(PLATFORM_ANDROID)
-    CORE.Input.Keyboard.exitKey = key;
+    CORE_INPUT.Keyboard.exitKey = key;
 #endif
 }
 
@@ -3710,7 +3711,7 @@ bool IsGamepadAvailable(int gamepad)
 {
     bool result = false;
 
-    if ((gamepad < MAX_GAMEPADS) && CORE.Input.Gamepad.ready[gamepad]) result = true;
+    if ((gamepad < MAX_GAMEPADS) && CORE_INPUT.Gamepad.ready[gamepad]) result = true;
 
     return result;
 }
@@ -3719,15 +3720,15 @@ bool IsGamepadAvailable(int gamepad)
 const char *GetGamepadName(int gamepad)
 {
 #if defined(PLATFORM_DESKTOP)
-    if (CORE.Input.Gamepad.ready[gamepad]) return glfwGetJoystickName(gamepad);
+    if (CORE_INPUT.Gamepad.ready[gamepad]) return glfwGetJoystickName(gamepad);
     else return NULL;
 #endif
 #if defined(PLATFORM_RPI) || defined(PLATFORM_DRM)
-    if (CORE.Input.Gamepad.ready[gamepad]) ioctl(CORE.Input.Gamepad.streamId[gamepad], JSIOCGNAME(64), &CORE.Input.Gamepad.name[gamepad]);
-    return CORE.Input.Gamepad.name[gamepad];
+    if (CORE_INPUT.Gamepad.ready[gamepad]) ioctl(CORE_INPUT.Gamepad.streamId[gamepad], JSIOCGNAME(64), &CORE_INPUT.Gamepad.name[gamepad]);
+    return CORE_INPUT.Gamepad.name[gamepad];
 #endif
 #if defined(PLATFORM_WEB)
-    return CORE.Input.Gamepad.name[gamepad];
+    return CORE_INPUT.Gamepad.name[gamepad];
 #endif
     return NULL;
 }
@@ -3737,11 +3738,11 @@ int GetGamepadAxisCount(int gamepad)
 {
 #if defined(PLATFORM_RPI) || defined(PLATFORM_DRM)
     int axisCount = 0;
-    if (CORE.Input.Gamepad.ready[gamepad]) ioctl(CORE.Input.Gamepad.streamId[gamepad], JSIOCGAXES, &axisCount);
-    CORE.Input.Gamepad.axisCount = axisCount;
+    if (CORE_INPUT.Gamepad.ready[gamepad]) ioctl(CORE_INPUT.Gamepad.streamId[gamepad], JSIOCGAXES, &axisCount);
+    CORE_INPUT.Gamepad.axisCount = axisCount;
 #endif
 
-    return CORE.Input.Gamepad.axisCount;
+    return CORE_INPUT.Gamepad.axisCount;
 }
 
 // Get axis movement vector for a gamepad
@@ -3749,8 +3750,8 @@ float GetGamepadAxisMovement(int gamepad, int axis)
 {
     float value = 0;
 
-    if ((gamepad < MAX_GAMEPADS) && CORE.Input.Gamepad.ready[gamepad] && (axis < MAX_GAMEPAD_AXIS) &&
-        (fabsf(CORE.Input.Gamepad.axisState[gamepad][axis]) > 0.1f)) value = CORE.Input.Gamepad.axisState[gamepad][axis];      // 0.1f = GAMEPAD_AXIS_MINIMUM_DRIFT/DELTA
+    if ((gamepad < MAX_GAMEPADS) && CORE_INPUT.Gamepad.ready[gamepad] && (axis < MAX_GAMEPAD_AXIS) &&
+        (fabsf(CORE_INPUT.Gamepad.axisState[gamepad][axis]) > 0.1f)) value = CORE_INPUT.Gamepad.axisState[gamepad][axis];      // 0.1f = GAMEPAD_AXIS_MINIMUM_DRIFT/DELTA
 
     return value;
 }
@@ -3760,8 +3761,8 @@ bool IsGamepadButtonPressed(int gamepad, int button)
 {
     bool pressed = false;
 
-    if ((gamepad < MAX_GAMEPADS) && CORE.Input.Gamepad.ready[gamepad] && (button < MAX_GAMEPAD_BUTTONS) &&
-        (CORE.Input.Gamepad.previousButtonState[gamepad][button] == 0) && (CORE.Input.Gamepad.currentButtonState[gamepad][button] == 1)) pressed = true;
+    if ((gamepad < MAX_GAMEPADS) && CORE_INPUT.Gamepad.ready[gamepad] && (button < MAX_GAMEPAD_BUTTONS) &&
+        (CORE_INPUT.Gamepad.previousButtonState[gamepad][button] == 0) && (CORE_INPUT.Gamepad.currentButtonState[gamepad][button] == 1)) pressed = true;
 
     return pressed;
 }
@@ -3771,8 +3772,8 @@ bool IsGamepadButtonDown(int gamepad, int button)
 {
     bool result = false;
 
-    if ((gamepad < MAX_GAMEPADS) && CORE.Input.Gamepad.ready[gamepad] && (button < MAX_GAMEPAD_BUTTONS) &&
-        (CORE.Input.Gamepad.currentButtonState[gamepad][button] == 1)) result = true;
+    if ((gamepad < MAX_GAMEPADS) && CORE_INPUT.Gamepad.ready[gamepad] && (button < MAX_GAMEPAD_BUTTONS) &&
+        (CORE_INPUT.Gamepad.currentButtonState[gamepad][button] == 1)) result = true;
 
     return result;
 }
@@ -3782,8 +3783,8 @@ bool IsGamepadButtonReleased(int gamepad, int button)
 {
     bool released = false;
 
-    if ((gamepad < MAX_GAMEPADS) && CORE.Input.Gamepad.ready[gamepad] && (button < MAX_GAMEPAD_BUTTONS) &&
-        (CORE.Input.Gamepad.previousButtonState[gamepad][button] == 1) && (CORE.Input.Gamepad.currentButtonState[gamepad][button] == 0)) released = true;
+    if ((gamepad < MAX_GAMEPADS) && CORE_INPUT.Gamepad.ready[gamepad] && (button < MAX_GAMEPAD_BUTTONS) &&
+        (CORE_INPUT.Gamepad.previousButtonState[gamepad][button] == 1) && (CORE_INPUT.Gamepad.currentButtonState[gamepad][button] == 0)) released = true;
 
     return released;
 }
@@ -3793,8 +3794,8 @@ bool IsGamepadButtonUp(int gamepad, int button)
 {
     bool result = false;
 
-    if ((gamepad < MAX_GAMEPADS) && CORE.Input.Gamepad.ready[gamepad] && (button < MAX_GAMEPAD_BUTTONS) &&
-        (CORE.Input.Gamepad.currentButtonState[gamepad][button] == 0)) result = true;
+    if ((gamepad < MAX_GAMEPADS) && CORE_INPUT.Gamepad.ready[gamepad] && (button < MAX_GAMEPAD_BUTTONS) &&
+        (CORE_INPUT.Gamepad.currentButtonState[gamepad][button] == 0)) result = true;
 
     return result;
 }
@@ -3802,7 +3803,7 @@ bool IsGamepadButtonUp(int gamepad, int button)
 // Get the last gamepad button pressed
 int GetGamepadButtonPressed(void)
 {
-    return CORE.Input.Gamepad.lastButtonPressed;
+    return CORE_INPUT.Gamepad.lastButtonPressed;
 }
 
 // Set internal gamepad mappings
@@ -3822,10 +3823,10 @@ bool IsMouseButtonPressed(int button)
 {
     bool pressed = false;
 
-    if ((CORE.Input.Mouse.currentButtonState[button] == 1) && (CORE.Input.Mouse.previousButtonState[button] == 0)) pressed = true;
+    if ((CORE_INPUT.Mouse.currentButtonState[button] == 1) && (CORE_INPUT.Mouse.previousButtonState[button] == 0)) pressed = true;
 
     // Map touches to mouse buttons checking
-    if ((CORE.Input.Touch.currentTouchState[button] == 1) && (CORE.Input.Touch.previousTouchState[button] == 0)) pressed = true;
+    if ((CORE_INPUT.Touch.currentTouchState[button] == 1) && (CORE_INPUT.Touch.previousTouchState[button] == 0)) pressed = true;
 
     return pressed;
 }
@@ -3835,10 +3836,10 @@ bool IsMouseButtonDown(int button)
 {
     bool down = false;
 
-    if (CORE.Input.Mouse.currentButtonState[button] == 1) down = true;
+    if (CORE_INPUT.Mouse.currentButtonState[button] == 1) down = true;
 
     // Map touches to mouse buttons checking
-    if (CORE.Input.Touch.currentTouchState[button] == 1) down = true;
+    if (CORE_INPUT.Touch.currentTouchState[button] == 1) down = true;
 
     return down;
 }
@@ -3848,10 +3849,10 @@ bool IsMouseButtonReleased(int button)
 {
     bool released = false;
 
-    if ((CORE.Input.Mouse.currentButtonState[button] == 0) && (CORE.Input.Mouse.previousButtonState[button] == 1)) released = true;
+    if ((CORE_INPUT.Mouse.currentButtonState[button] == 0) && (CORE_INPUT.Mouse.previousButtonState[button] == 1)) released = true;
 
     // Map touches to mouse buttons checking
-    if ((CORE.Input.Touch.currentTouchState[button] == 0) && (CORE.Input.Touch.previousTouchState[button] == 1)) released = true;
+    if ((CORE_INPUT.Touch.currentTouchState[button] == 0) && (CORE_INPUT.Touch.previousTouchState[button] == 1)) released = true;
 
     return released;
 }
@@ -3866,9 +3867,9 @@ bool IsMouseButtonUp(int button)
 int GetMouseX(void)
 {
 #if defined(PLATFORM_ANDROID)
-    return (int)CORE.Input.Touch.position[0].x;
+    return (int)CORE_INPUT.Touch.position[0].x;
 #else
-    return (int)((CORE.Input.Mouse.currentPosition.x + CORE.Input.Mouse.offset.x)*CORE.Input.Mouse.scale.x);
+    return (int)((CORE_INPUT.Mouse.currentPosition.x + CORE_INPUT.Mouse.offset.x)*CORE_INPUT.Mouse.scale.x);
 #endif
 }
 
@@ -3876,9 +3877,9 @@ int GetMouseX(void)
 int GetMouseY(void)
 {
 #if defined(PLATFORM_ANDROID)
-    return (int)CORE.Input.Touch.position[0].y;
+    return (int)CORE_INPUT.Touch.position[0].y;
 #else
-    return (int)((CORE.Input.Mouse.currentPosition.y + CORE.Input.Mouse.offset.y)*CORE.Input.Mouse.scale.y);
+    return (int)((CORE_INPUT.Mouse.currentPosition.y + CORE_INPUT.Mouse.offset.y)*CORE_INPUT.Mouse.scale.y);
 #endif
 }
 
@@ -3890,8 +3891,8 @@ Vector2 GetMousePosition(void)
 #if defined(PLATFORM_ANDROID) || defined(PLATFORM_WEB)
     position = GetTouchPosition(0);
 #else
-    position.x = (CORE.Input.Mouse.currentPosition.x + CORE.Input.Mouse.offset.x)*CORE.Input.Mouse.scale.x;
-    position.y = (CORE.Input.Mouse.currentPosition.y + CORE.Input.Mouse.offset.y)*CORE.Input.Mouse.scale.y;
+    position.x = (CORE_INPUT.Mouse.currentPosition.x + CORE_INPUT.Mouse.offset.x)*CORE_INPUT.Mouse.scale.x;
+    position.y = (CORE_INPUT.Mouse.currentPosition.y + CORE_INPUT.Mouse.offset.y)*CORE_INPUT.Mouse.scale.y;
 #endif
 
     return position;
@@ -3902,8 +3903,8 @@ Vector2 GetMouseDelta(void)
 {
     Vector2 delta = { 0 };
 
-    delta.x = CORE.Input.Mouse.currentPosition.x - CORE.Input.Mouse.previousPosition.x;
-    delta.y = CORE.Input.Mouse.currentPosition.y - CORE.Input.Mouse.previousPosition.y;
+    delta.x = CORE_INPUT.Mouse.currentPosition.x - CORE_INPUT.Mouse.previousPosition.x;
+    delta.y = CORE_INPUT.Mouse.currentPosition.y - CORE_INPUT.Mouse.previousPosition.y;
 
     return delta;
 }
@@ -3911,12 +3912,12 @@ Vector2 GetMouseDelta(void)
 // Set mouse position XY
 void SetMousePosition(int x, int y)
 {
-    CORE.Input.Mouse.currentPosition = (Vector2){ (float)x, (float)y };
-    CORE.Input.Mouse.previousPosition = CORE.Input.Mouse.currentPosition;
+    CORE_INPUT.Mouse.currentPosition = (Vector2){ (float)x, (float)y };
+    CORE_INPUT.Mouse.previousPosition = CORE_INPUT.Mouse.currentPosition;
 
 #if defined(PLATFORM_DESKTOP) || defined(PLATFORM_WEB)
     // NOTE: emscripten not implemented
-    glfwSetCursorPos(CORE.Window.handle, CORE.Input.Mouse.currentPosition.x, CORE.Input.Mouse.currentPosition.y);
+    glfwSetCursorPos(CORE.Window.handle, CORE_INPUT.Mouse.currentPosition.x, CORE_INPUT.Mouse.currentPosition.y);
 #endif
 }
 
@@ -3924,14 +3925,14 @@ void SetMousePosition(int x, int y)
 // NOTE: Useful when rendering to different size targets
 void SetMouseOffset(int offsetX, int offsetY)
 {
-    CORE.Input.Mouse.offset = (Vector2){ (float)offsetX, (float)offsetY };
+    CORE_INPUT.Mouse.offset = (Vector2){ (float)offsetX, (float)offsetY };
 }
 
 // Set mouse scaling
 // NOTE: Useful when rendering to different size targets
 void SetMouseScale(float scaleX, float scaleY)
 {
-    CORE.Input.Mouse.scale = (Vector2){ scaleX, scaleY };
+    CORE_INPUT.Mouse.scale = (Vector2){ scaleX, scaleY };
 }
 
 // Get mouse wheel movement Y
@@ -3940,8 +3941,8 @@ float GetMouseWheelMove(void)
     float result = 0.0f;
 
 #if !defined(PLATFORM_ANDROID)
-    if (fabsf(CORE.Input.Mouse.currentWheelMove.x) > fabsf(CORE.Input.Mouse.currentWheelMove.y)) result = (float)CORE.Input.Mouse.currentWheelMove.x;
-    else result = (float)CORE.Input.Mouse.currentWheelMove.y;
+    if (fabsf(CORE_INPUT.Mouse.currentWheelMove.x) > fabsf(CORE_INPUT.Mouse.currentWheelMove.y)) result = (float)CORE_INPUT.Mouse.currentWheelMove.x;
+    else result = (float)CORE_INPUT.Mouse.currentWheelMove.y;
 #endif
 
     return result;
@@ -3952,7 +3953,7 @@ Vector2 GetMouseWheelMoveV(void)
 {
     Vector2 result = { 0 };
 
-    result = CORE.Input.Mouse.currentWheelMove;
+    result = CORE_INPUT.Mouse.currentWheelMove;
 
     return result;
 }
@@ -3962,7 +3963,7 @@ Vector2 GetMouseWheelMoveV(void)
 void SetMouseCursor(int cursor)
 {
 #if defined(PLATFORM_DESKTOP)
-    CORE.Input.Mouse.cursor = cursor;
+    CORE_INPUT.Mouse.cursor = cursor;
     if (cursor == MOUSE_CURSOR_DEFAULT) glfwSetCursor(CORE.Window.handle, NULL);
     else
     {
@@ -3976,7 +3977,7 @@ void SetMouseCursor(int cursor)
 int GetTouchX(void)
 {
 #if defined(PLATFORM_ANDROID) || defined(PLATFORM_WEB)
-    return (int)CORE.Input.Touch.position[0].x;
+    return (int)CORE_INPUT.Touch.position[0].x;
 #else   // PLATFORM_DESKTOP, PLATFORM_RPI, PLATFORM_DRM
     return GetMouseX();
 #endif
@@ -3986,7 +3987,7 @@ int GetTouchX(void)
 int GetTouchY(void)
 {
 #if defined(PLATFORM_ANDROID) || defined(PLATFORM_WEB)
-    return (int)CORE.Input.Touch.position[0].y;
+    return (int)CORE_INPUT.Touch.position[0].y;
 #else   // PLATFORM_DESKTOP, PLATFORM_RPI, PLATFORM_DRM
     return GetMouseY();
 #endif
@@ -4005,7 +4006,7 @@ Vector2 GetTouchPosition(int index)
     if (index == 0) position = GetMousePosition();
 #endif
 #if defined(PLATFORM_ANDROID) || defined(PLATFORM_WEB) || defined(PLATFORM_RPI) || defined(PLATFORM_DRM)
-    if (index < MAX_TOUCH_POINTS) position = CORE.Input.Touch.position[index];
+    if (index < MAX_TOUCH_POINTS) position = CORE_INPUT.Touch.position[index];
     else TRACELOG(LOG_WARNING, "INPUT: Required touch point out of range (Max touch points: %i)", MAX_TOUCH_POINTS);
 #endif
 
@@ -4017,7 +4018,7 @@ int GetTouchPointId(int index)
 {
     int id = -1;
 
-    if (index < MAX_TOUCH_POINTS) id = CORE.Input.Touch.pointId[index];
+    if (index < MAX_TOUCH_POINTS) id = CORE_INPUT.Touch.pointId[index];
 
     return id;
 }
@@ -4025,7 +4026,136 @@ int GetTouchPointId(int index)
 // Get number of touch points
 int GetTouchPointCount(void)
 {
-    return CORE.Input.Touch.pointCount;
+    return CORE_INPUT.Touch.pointCount;
+}
+
+// Get the size of a copy of the input state
+int GetInputStateSize(void)
+{
+    return (int)sizeof(struct CoreInputData);
+}
+
+// Copy the live input state, e.g. to hand a frame's input to another thread
+void CopyInputState(void *state)
+{
+    memcpy(state, &CORE.Input, sizeof(struct CoreInputData));
+}
+
+// Read input on the calling thread from a copy made by CopyInputState(), NULL reads the live state again
+// NOTE: The copy is read and, for the key and char queues, consumed by the calling thread only
+void SetThreadInputState(void *state)
+{
+    threadInputState = (struct CoreInputData *)state;
+}
+
+// Get input changes registered by the last PollInputEvents(), returns the events count
+// NOTE: The count includes the events which didn't fit in capacity, call it again with more room to get them all
+// NOTE: Only changes are registered (keys and buttons going down or up, queued keys and chars,
+// mouse moves and wheel moves), mouse positions and wheel moves are fixed point with 16 fractional
+// bits so they are played back exactly
+int GetAutomationEvents(AutomationEvent *events, int capacity)
+{
+    int count = 0;
+    unsigned int frame = CORE.Time.frameCounter;
+
+    #define ADD_AUTOMATION_EVENT(eventType, param0, param1) \
+        do { if (count < capacity) events[count] = (AutomationEvent){ frame, eventType, { param0, param1, 0, 0 } }; count++; } while (0)
+
+    for (int key = 0; key < MAX_KEYBOARD_KEYS; key++)
+    {
+        if (CORE_INPUT.Keyboard.currentKeyState[key] == CORE_INPUT.Keyboard.previousKeyState[key]) continue;
+
+        if (CORE_INPUT.Keyboard.currentKeyState[key]) ADD_AUTOMATION_EVENT(INPUT_KEY_DOWN, key, 0);
+        else ADD_AUTOMATION_EVENT(INPUT_KEY_UP, key, 0);
+    }
+
+    for (int i = 0; i < CORE_INPUT.Keyboard.keyPressedQueueCount; i++) ADD_AUTOMATION_EVENT(INPUT_KEY_PRESSED, CORE_INPUT.Keyboard.keyPressedQueue[i], 0);
+    for (int i = 0; i < CORE_INPUT.Keyboard.charPressedQueueCount; i++) ADD_AUTOMATION_EVENT(INPUT_CHAR_PRESSED, CORE_INPUT.Keyboard.charPressedQueue[i], 0);
+
+    for (int button = 0; button < MAX_MOUSE_BUTTONS; button++)
+    {
+        if (CORE_INPUT.Mouse.currentButtonState[button] == CORE_INPUT.Mouse.previousButtonState[button]) continue;
+
+        if (CORE_INPUT.Mouse.currentButtonState[button]) ADD_AUTOMATION_EVENT(INPUT_MOUSE_BUTTON_DOWN, button, 0);
+        else ADD_AUTOMATION_EVENT(INPUT_MOUSE_BUTTON_UP, button, 0);
+    }
+
+    if ((CORE_INPUT.Mouse.currentPosition.x != CORE_INPUT.Mouse.previousPosition.x) ||
+        (CORE_INPUT.Mouse.currentPosition.y != CORE_INPUT.Mouse.previousPosition.y))
+    {
+        ADD_AUTOMATION_EVENT(INPUT_MOUSE_POSITION, (int)(CORE_INPUT.Mouse.currentPosition.x*65536.0f), (int)(CORE_INPUT.Mouse.currentPosition.y*65536.0f));
+    }
+
+    // Wheel moves are reset on every poll
+    if ((CORE_INPUT.Mouse.currentWheelMove.x != 0.0f) || (CORE_INPUT.Mouse.currentWheelMove.y != 0.0f))
+    {
+        ADD_AUTOMATION_EVENT(INPUT_MOUSE_WHEEL_MOTION, (int)(CORE_INPUT.Mouse.currentWheelMove.x*65536.0f), (int)(CORE_INPUT.Mouse.currentWheelMove.y*65536.0f));
+    }
+
+    #undef ADD_AUTOMATION_EVENT
+
+    return count;
+}
+
+// Apply input changes over the current input state
+// NOTE: Call it after PollInputEvents() so the previous state is the one of the last frame
+void PlayAutomationEvents(const AutomationEvent *events, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        int param0 = events[i].params[0];
+        int param1 = events[i].params[1];
+
+        switch (events[i].type)
+        {
+            case INPUT_KEY_UP:
+            case INPUT_KEY_DOWN:
+            {
+                if ((param0 >= 0) && (param0 < MAX_KEYBOARD_KEYS)) CORE_INPUT.Keyboard.currentKeyState[param0] = (events[i].type == INPUT_KEY_DOWN);
+            } break;
+            case INPUT_KEY_PRESSED:
+            {
+                if (CORE_INPUT.Keyboard.keyPressedQueueCount < MAX_KEY_PRESSED_QUEUE) CORE_INPUT.Keyboard.keyPressedQueue[CORE_INPUT.Keyboard.keyPressedQueueCount++] = param0;
+            } break;
+            case INPUT_CHAR_PRESSED:
+            {
+                if (CORE_INPUT.Keyboard.charPressedQueueCount < MAX_CHAR_PRESSED_QUEUE) CORE_INPUT.Keyboard.charPressedQueue[CORE_INPUT.Keyboard.charPressedQueueCount++] = param0;
+            } break;
+            case INPUT_MOUSE_BUTTON_UP:
+            case INPUT_MOUSE_BUTTON_DOWN:
+            {
+                if ((param0 >= 0) && (param0 < MAX_MOUSE_BUTTONS)) CORE_INPUT.Mouse.currentButtonState[param0] = (events[i].type == INPUT_MOUSE_BUTTON_DOWN);
+            } break;
+            case INPUT_MOUSE_POSITION:
+            {
+                CORE_INPUT.Mouse.currentPosition.x = (float)param0/65536.0f;
+                CORE_INPUT.Mouse.currentPosition.y = (float)param1/65536.0f;
+            } break;
+            case INPUT_MOUSE_WHEEL_MOTION:
+            {
+                CORE_INPUT.Mouse.currentWheelMove.x = (float)param0/65536.0f;
+                CORE_INPUT.Mouse.currentWheelMove.y = (float)param1/65536.0f;
+            } break;
+            default: break;
+        }
+    }
+}
+
+// Check if an event type is one GetAutomationEvents() registers and PlayAutomationEvents() applies
+bool IsAutomationEventSupported(unsigned int type)
+{
+    switch (type)
+    {
+        case INPUT_KEY_UP:
+        case INPUT_KEY_DOWN:
+        case INPUT_KEY_PRESSED:
+        case INPUT_CHAR_PRESSED:
+        case INPUT_MOUSE_BUTTON_UP:
+        case INPUT_MOUSE_BUTTON_DOWN:
+        case INPUT_MOUSE_POSITION:
+        case INPUT_MOUSE_WHEEL_MOTION: return true;
+        default: return false;
+    }
 }
 
 //----------------------------------------------------------------------------------
@@ -5034,37 +5164,37 @@ void PollInputEvents(void)
 #endif
 
     // Reset keys/chars pressed registered
-    CORE.Input.Keyboard.keyPressedQueueCount = 0;
-    CORE.Input.Keyboard.charPressedQueueCount = 0;
+    CORE_INPUT.Keyboard.keyPressedQueueCount = 0;
+    CORE_INPUT.Keyboard.charPressedQueueCount = 0;
 
 #if !(defined(PLATFORM_RPI) || defined(PLATFORM_DRM))
     // Reset last gamepad button/axis registered state
-    CORE.Input.Gamepad.lastButtonPressed = 0;       // GAMEPAD_BUTTON_UNKNOWN
-    CORE.Input.Gamepad.axisCount = 0;
+    CORE_INPUT.Gamepad.lastButtonPressed = 0;       // GAMEPAD_BUTTON_UNKNOWN
+    CORE_INPUT.Gamepad.axisCount = 0;
 #endif
 
 #if defined(PLATFORM_RPI) || defined(PLATFORM_DRM)
     // Register previous keys states
-    for (int i = 0; i < MAX_KEYBOARD_KEYS; i++) CORE.Input.Keyboard.previousKeyState[i] = CORE.Input.Keyboard.currentKeyState[i];
+    for (int i = 0; i < MAX_KEYBOARD_KEYS; i++) CORE_INPUT.Keyboard.previousKeyState[i] = CORE_INPUT.Keyboard.currentKeyState[i];
 
     PollKeyboardEvents();
 
     // Register previous mouse states
-    CORE.Input.Mouse.previousWheelMove = CORE.Input.Mouse.currentWheelMove;
-    CORE.Input.Mouse.currentWheelMove = (Vector2){ 0.0f, 0.0f };
+    CORE_INPUT.Mouse.previousWheelMove = CORE_INPUT.Mouse.currentWheelMove;
+    CORE_INPUT.Mouse.currentWheelMove = (Vector2){ 0.0f, 0.0f };
     for (int i = 0; i < MAX_MOUSE_BUTTONS; i++)
     {
-        CORE.Input.Mouse.previousButtonState[i] = CORE.Input.Mouse.currentButtonState[i];
-        CORE.Input.Mouse.currentButtonState[i] = CORE.Input.Mouse.currentButtonStateEvdev[i];
+        CORE_INPUT.Mouse.previousButtonState[i] = CORE_INPUT.Mouse.currentButtonState[i];
+        CORE_INPUT.Mouse.currentButtonState[i] = CORE_INPUT.Mouse.currentButtonStateEvdev[i];
     }
 
     // Register gamepads buttons events
     for (int i = 0; i < MAX_GAMEPADS; i++)
     {
-        if (CORE.Input.Gamepad.ready[i])
+        if (CORE_INPUT.Gamepad.ready[i])
         {
             // Register previous gamepad states
-            for (int k = 0; k < MAX_GAMEPAD_BUTTONS; k++) CORE.Input.Gamepad.previousButtonState[i][k] = CORE.Input.Gamepad.currentButtonState[i][k];
+            for (int k = 0; k < MAX_GAMEPAD_BUTTONS; k++) CORE_INPUT.Gamepad.previousButtonState[i][k] = CORE_INPUT.Gamepad.currentButtonState[i][k];
         }
     }
 #endif
@@ -5073,43 +5203,43 @@ void PollInputEvents(void)
     // Keyboard/Mouse input polling (automatically managed by GLFW3 through callback)
 
     // Register previous keys states
-    for (int i = 0; i < MAX_KEYBOARD_KEYS; i++) CORE.Input.Keyboard.previousKeyState[i] = CORE.Input.Keyboard.currentKeyState[i];
+    for (int i = 0; i < MAX_KEYBOARD_KEYS; i++) CORE_INPUT.Keyboard.previousKeyState[i] = CORE_INPUT.Keyboard.currentKeyState[i];
 
     // Register previous mouse states
-    for (int i = 0; i < MAX_MOUSE_BUTTONS; i++) CORE.Input.Mouse.previousButtonState[i] = CORE.Input.Mouse.currentButtonState[i];
+    for (int i = 0; i < MAX_MOUSE_BUTTONS; i++) CORE_INPUT.Mouse.previousButtonState[i] = CORE_INPUT.Mouse.currentButtonState[i];
 
     // Register previous mouse wheel state
-    CORE.Input.Mouse.previousWheelMove = CORE.Input.Mouse.currentWheelMove;
-    CORE.Input.Mouse.currentWheelMove = (Vector2){ 0.0f, 0.0f };
+    CORE_INPUT.Mouse.previousWheelMove = CORE_INPUT.Mouse.currentWheelMove;
+    CORE_INPUT.Mouse.currentWheelMove = (Vector2){ 0.0f, 0.0f };
 
     // Register previous mouse position
-    CORE.Input.Mouse.previousPosition = CORE.Input.Mouse.currentPosition;
+    CORE_INPUT.Mouse.previousPosition = CORE_INPUT.Mouse.currentPosition;
 #endif
 
     // Register previous touch states
-    for (int i = 0; i < MAX_TOUCH_POINTS; i++) CORE.Input.Touch.previousTouchState[i] = CORE.Input.Touch.currentTouchState[i];
+    for (int i = 0; i < MAX_TOUCH_POINTS; i++) CORE_INPUT.Touch.previousTouchState[i] = CORE_INPUT.Touch.currentTouchState[i];
 
     // Reset touch positions
     // TODO: It resets on PLATFORM_WEB the mouse position and not filled again until a move-event,
     // so, if mouse is not moved it returns a (0, 0) position... this behaviour should be reviewed!
-    //for (int i = 0; i < MAX_TOUCH_POINTS; i++) CORE.Input.Touch.position[i] = (Vector2){ 0, 0 };
+    //for (int i = 0; i < MAX_TOUCH_POINTS; i++) CORE_INPUT.Touch.position[i] = (Vector2){ 0, 0 };
 
 #if defined(PLATFORM_DESKTOP)
     // Check if gamepads are ready
     // NOTE: We do it here in case of disconnection
     for (int i = 0; i < MAX_GAMEPADS; i++)
     {
-        if (glfwJoystickPresent(i)) CORE.Input.Gamepad.ready[i] = true;
-        else CORE.Input.Gamepad.ready[i] = false;
+        if (glfwJoystickPresent(i)) CORE_INPUT.Gamepad.ready[i] = true;
+        else CORE_INPUT.Gamepad.ready[i] = false;
     }
 
     // Register gamepads buttons events
     for (int i = 0; i < MAX_GAMEPADS; i++)
     {
-        if (CORE.Input.Gamepad.ready[i])     // Check if gamepad is available
+        if (CORE_INPUT.Gamepad.ready[i])     // Check if gamepad is available
         {
             // Register previous gamepad states
-            for (int k = 0; k < MAX_GAMEPAD_BUTTONS; k++) CORE.Input.Gamepad.previousButtonState[i][k] = CORE.Input.Gamepad.currentButtonState[i][k];
+            for (int k = 0; k < MAX_GAMEPAD_BUTTONS; k++) CORE_INPUT.Gamepad.previousButtonState[i][k] = CORE_INPUT.Gamepad.currentButtonState[i][k];
 
             // Get current gamepad state
             // NOTE: There is no callback available, so we get it manually
@@ -5150,10 +5280,10 @@ void PollInputEvents(void)
                 {
                     if (buttons[k] == GLFW_PRESS)
                     {
-                        CORE.Input.Gamepad.currentButtonState[i][button] = 1;
-                        CORE.Input.Gamepad.lastButtonPressed = button;
+                        CORE_INPUT.Gamepad.currentButtonState[i][button] = 1;
+                        CORE_INPUT.Gamepad.lastButtonPressed = button;
                     }
-                    else CORE.Input.Gamepad.currentButtonState[i][button] = 0;
+                    else CORE_INPUT.Gamepad.currentButtonState[i][button] = 0;
                 }
             }
 
@@ -5162,14 +5292,14 @@ void PollInputEvents(void)
 
             for (int k = 0; (axes != NULL) && (k < GLFW_GAMEPAD_AXIS_LAST + 1) && (k < MAX_GAMEPAD_AXIS); k++)
             {
-                CORE.Input.Gamepad.axisState[i][k] = axes[k];
+                CORE_INPUT.Gamepad.axisState[i][k] = axes[k];
             }
 
             // Register buttons for 2nd triggers (because GLFW doesn't count these as buttons but rather axis)
-            CORE.Input.Gamepad.currentButtonState[i][GAMEPAD_BUTTON_LEFT_TRIGGER_2] = (char)(CORE.Input.Gamepad.axisState[i][GAMEPAD_AXIS_LEFT_TRIGGER] > 0.1f);
-            CORE.Input.Gamepad.currentButtonState[i][GAMEPAD_BUTTON_RIGHT_TRIGGER_2] = (char)(CORE.Input.Gamepad.axisState[i][GAMEPAD_AXIS_RIGHT_TRIGGER] > 0.1f);
+            CORE_INPUT.Gamepad.currentButtonState[i][GAMEPAD_BUTTON_LEFT_TRIGGER_2] = (char)(CORE_INPUT.Gamepad.axisState[i][GAMEPAD_AXIS_LEFT_TRIGGER] > 0.1f);
+            CORE_INPUT.Gamepad.currentButtonState[i][GAMEPAD_BUTTON_RIGHT_TRIGGER_2] = (char)(CORE_INPUT.Gamepad.axisState[i][GAMEPAD_AXIS_RIGHT_TRIGGER] > 0.1f);
 
-            CORE.Input.Gamepad.axisCount = GLFW_GAMEPAD_AXIS_LAST + 1;
+            CORE_INPUT.Gamepad.axisCount = GLFW_GAMEPAD_AXIS_LAST + 1;
         }
     }
 
@@ -5193,7 +5323,7 @@ void PollInputEvents(void)
     for (int i = 0; (i < numGamepads) && (i < MAX_GAMEPADS); i++)
     {
         // Register previous gamepad button states
-        for (int k = 0; k < MAX_GAMEPAD_BUTTONS; k++) CORE.Input.Gamepad.previousButtonState[i][k] = CORE.Input.Gamepad.currentButtonState[i][k];
+        for (int k = 0; k < MAX_GAMEPAD_BUTTONS; k++) CORE_INPUT.Gamepad.previousButtonState[i][k] = CORE_INPUT.Gamepad.currentButtonState[i][k];
 
         EmscriptenGamepadEvent gamepadState;
 
@@ -5232,10 +5362,10 @@ void PollInputEvents(void)
                 {
                     if (gamepadState.digitalButton[j] == 1)
                     {
-                        CORE.Input.Gamepad.currentButtonState[i][button] = 1;
-                        CORE.Input.Gamepad.lastButtonPressed = button;
+                        CORE_INPUT.Gamepad.currentButtonState[i][button] = 1;
+                        CORE_INPUT.Gamepad.lastButtonPressed = button;
                     }
-                    else CORE.Input.Gamepad.currentButtonState[i][button] = 0;
+                    else CORE_INPUT.Gamepad.currentButtonState[i][button] = 0;
                 }
 
                 //TRACELOGD("INPUT: Gamepad %d, button %d: Digital: %d, Analog: %g", gamepadState.index, j, gamepadState.digitalButton[j], gamepadState.analogButton[j]);
@@ -5244,10 +5374,10 @@ void PollInputEvents(void)
             // Register axis data for every connected gamepad
             for (int j = 0; (j < gamepadState.numAxes) && (j < MAX_GAMEPAD_AXIS); j++)
             {
-                CORE.Input.Gamepad.axisState[i][j] = gamepadState.axis[j];
+                CORE_INPUT.Gamepad.axisState[i][j] = gamepadState.axis[j];
             }
 
-            CORE.Input.Gamepad.axisCount = gamepadState.numAxes;
+            CORE_INPUT.Gamepad.axisCount = gamepadState.numAxes;
         }
     }
 #endif
@@ -5255,7 +5385,7 @@ void PollInputEvents(void)
 #if defined(PLATFORM_ANDROID)
     // Register previous keys states
     // NOTE: Android supports up to 260 keys
-    for (int i = 0; i < 260; i++) CORE.Input.Keyboard.previousKeyState[i] = CORE.Input.Keyboard.currentKeyState[i];
+    for (int i = 0; i < 260; i++) CORE_INPUT.Keyboard.previousKeyState[i] = CORE_INPUT.Keyboard.currentKeyState[i];
 
     // Android ALooper_pollAll() variables
     int pollResult = 0;
@@ -5281,7 +5411,7 @@ void PollInputEvents(void)
     // NOTE: Keyboard reading could be done using input_event(s) or just read from stdin, both methods are used here.
     // stdin reading is still used for legacy purposes, it allows keyboard input trough SSH console
 
-    if (!CORE.Input.Keyboard.evtMode) ProcessKeyboard();
+    if (!CORE_INPUT.Keyboard.evtMode) ProcessKeyboard();
 
     // NOTE: Mouse input events polling is done asynchronously in another pthread - EventThread()
     // NOTE: Gamepad (Joystick) input events polling is done asynchonously in another pthread - GamepadThread()
@@ -5450,25 +5580,25 @@ static void KeyCallback(GLFWwindow *window, int key, int scancode, int action, i
 
     // WARNING: GLFW could return GLFW_REPEAT, we need to consider it as 1
     // to work properly with our implementation (IsKeyDown/IsKeyUp checks)
-    if (action == GLFW_RELEASE) CORE.Input.Keyboard.currentKeyState[key] = 0;
-    else CORE.Input.Keyboard.currentKeyState[key] = 1;
+    if (action == GLFW_RELEASE) CORE_INPUT.Keyboard.currentKeyState[key] = 0;
+    else CORE_INPUT.Keyboard.currentKeyState[key] = 1;
 
 #if !defined(PLATFORM_WEB)
     // WARNING: Check if CAPS/NUM key modifiers are enabled and force down state for those keys
     if (((key == KEY_CAPS_LOCK) && ((mods & GLFW_MOD_CAPS_LOCK) > 0)) ||
-        ((key == KEY_NUM_LOCK) && ((mods & GLFW_MOD_NUM_LOCK) > 0))) CORE.Input.Keyboard.currentKeyState[key] = 1;
+        ((key == KEY_NUM_LOCK) && ((mods & GLFW_MOD_NUM_LOCK) > 0))) CORE_INPUT.Keyboard.currentKeyState[key] = 1;
 #endif
 
     // Check if there is space available in the key queue
-    if ((CORE.Input.Keyboard.keyPressedQueueCount < MAX_KEY_PRESSED_QUEUE) && (action == GLFW_PRESS))
+    if ((CORE_INPUT.Keyboard.keyPressedQueueCount < MAX_KEY_PRESSED_QUEUE) && (action == GLFW_PRESS))
     {
         // Add character to the queue
-        CORE.Input.Keyboard.keyPressedQueue[CORE.Input.Keyboard.keyPressedQueueCount] = key;
-        CORE.Input.Keyboard.keyPressedQueueCount++;
+        CORE_INPUT.Keyboard.keyPressedQueue[CORE_INPUT.Keyboard.keyPressedQueueCount] = key;
+        CORE_INPUT.Keyboard.keyPressedQueueCount++;
     }
 
     // Check the exit key to set close window
-    if ((key == CORE.Input.Keyboard.exitKey) && (action == GLFW_PRESS)) glfwSetWindowShouldClose(CORE.Window.handle, GLFW_TRUE);
+    if ((key == CORE_INPUT.Keyboard.exitKey) && (action == GLFW_PRESS)) glfwSetWindowShouldClose(CORE.Window.handle, GLFW_TRUE);
 
 #if defined(SUPPORT_SCREEN_CAPTURE)
     if ((key == GLFW_KEY_F12) && (action == GLFW_PRESS))
@@ -5543,11 +5673,11 @@ static void CharCallback(GLFWwindow *window, unsigned int key)
     // Ref: https://www.glfw.org/docs/latest/input_guide.html#input_char
 
     // Check if there is space available in the queue
-    if (CORE.Input.Keyboard.charPressedQueueCount < MAX_CHAR_PRESSED_QUEUE)
+    if (CORE_INPUT.Keyboard.charPressedQueueCount < MAX_CHAR_PRESSED_QUEUE)
     {
         // Add character to the queue
-        CORE.Input.Keyboard.charPressedQueue[CORE.Input.Keyboard.charPressedQueueCount] = key;
-        CORE.Input.Keyboard.charPressedQueueCount++;
+        CORE_INPUT.Keyboard.charPressedQueue[CORE_INPUT.Keyboard.charPressedQueueCount] = key;
+        CORE_INPUT.Keyboard.charPressedQueueCount++;
     }
 }
 
@@ -5556,15 +5686,15 @@ static void MouseButtonCallback(GLFWwindow *window, int button, int action, int
 {
     // WARNING: GLFW could only return GLFW_PRESS (1) or GLFW_RELEASE (0) for now,
     // but future releases may add more actions (i.e. GLFW_REPEAT)
-    CORE.Input.Mouse.currentButtonState[button] = action;
+    CORE_INPUT.Mouse.currentButtonState[button] = action;
 
 #if defined(SUPPORT_GESTURES_SYSTEM) && defined(SUPPORT_MOUSE_GESTURES)         // PLATFORM_DESKTOP
     // Process mouse events as touches to be able to use mouse-gestures
     GestureEvent gestureEvent = { 0 };
 
     // Register touch actions
-    if ((CORE.Input.Mouse.currentButtonState[button] == 1) && (CORE.Input.Mouse.previousButtonState[button] == 0)) gestureEvent.touchAction = TOUCH_ACTION_DOWN;
-    else if ((CORE.Input.Mouse.currentButtonState[button] == 0) && (CORE.Input.Mouse.previousButtonState[button] == 1)) gestureEvent.touchAction = TOUCH_ACTION_UP;
+    if ((CORE_INPUT.Mouse.currentButtonState[button] == 1) && (CORE_INPUT.Mouse.previousButtonState[button] == 0)) gestureEvent.touchAction = TOUCH_ACTION_DOWN;
+    else if ((CORE_INPUT.Mouse.currentButtonState[button] == 0) && (CORE_INPUT.Mouse.previousButtonState[button] == 1)) gestureEvent.touchAction = TOUCH_ACTION_UP;
 
     // NOTE: TOUCH_ACTION_MOVE event is registered in MouseCursorPosCallback()
 
@@ -5589,9 +5719,9 @@ static void MouseButtonCallback(GLFWwindow *window, int button, int action, int
 // GLFW3 Cursor Position Callback, runs on mouse move
 static void MouseCursorPosCallback(GLFWwindow *window, double x, double y)
 {
-    CORE.Input.Mouse.currentPosition.x = (float)x;
-    CORE.Input.Mouse.currentPosition.y = (float)y;
-    CORE.Input.Touch.position[0] = CORE.Input.Mouse.currentPosition;
+    CORE_INPUT.Mouse.currentPosition.x = (float)x;
+    CORE_INPUT.Mouse.currentPosition.y = (float)y;
+    CORE_INPUT.Touch.position[0] = CORE_INPUT.Mouse.currentPosition;
 
 #if defined(SUPPORT_GESTURES_SYSTEM) && defined(SUPPORT_MOUSE_GESTURES)         // PLATFORM_DESKTOP
     // Process mouse events as touches to be able to use mouse-gestures
@@ -5606,7 +5736,7 @@ static void MouseCursorPosCallback(GLFWwindow *window, double x, double y)
     gestureEvent.pointCount = 1;
 
     // Register touch points position, only one point registered
-    gestureEvent.position[0] = CORE.Input.Touch.position[0];
+    gestureEvent.position[0] = CORE_INPUT.Touch.position[0];
 
     // Normalize gestureEvent.position[0] for CORE.Window.screen.width and CORE.Window.screen.height
     gestureEvent.position[0].x /= (float)GetScreenWidth();
@@ -5620,14 +5750,14 @@ static void MouseCursorPosCallback(GLFWwindow *window, double x, double y)
 // GLFW3 Scrolling Callback, runs on mouse wheel
 static void MouseScrollCallback(GLFWwindow *window, double xoffset, double yoffset)
 {
-    CORE.Input.Mouse.currentWheelMove = (Vector2){ (float)xoffset, (float)yoffset };
+    CORE_INPUT.Mouse.currentWheelMove = (Vector2){ (float)xoffset, (float)yoffset };
 }
 
 // GLFW3 CursorEnter Callback, when cursor enters the window
 static void CursorEnterCallback(GLFWwindow *window, int enter)
 {
-    if (enter == true) CORE.Input.Mouse.cursorOnScreen = true;
-    else CORE.Input.Mouse.cursorOnScreen = false;
+    if (enter == true) CORE_INPUT.Mouse.cursorOnScreen = true;
+    else CORE_INPUT.Mouse.cursorOnScreen = false;
 }
 
 // GLFW3 Window Drop Callback, runs when drop files into window
@@ -5818,19 +5948,19 @@ static int32_t AndroidInputCallback(struct android_app *app, AInputEvent *event)
             ((source & AINPUT_SOURCE_GAMEPAD) == AINPUT_SOURCE_GAMEPAD))
         {
             // For now we'll assume a single gamepad which we "detect" on its input event
-            CORE.Input.Gamepad.ready[0] = true;
+            CORE_INPUT.Gamepad.ready[0] = true;
 
-            CORE.Input.Gamepad.axisState[0][GAMEPAD_AXIS_LEFT_X] = AMotionEvent_getAxisValue(
+            CORE_INPUT.Gamepad.axisState[0][GAMEPAD_AXIS_LEFT_X] = AMotionEvent_getAxisValue(
                     event, AMOTION_EVENT_AXIS_X, 0);
-            CORE.Input.Gamepad.axisState[0][GAMEPAD_AXIS_LEFT_Y] = AMotionEvent_getAxisValue(
+            CORE_INPUT.Gamepad.axisState[0][GAMEPAD_AXIS_LEFT_Y] = AMotionEvent_getAxisValue(
                     event, AMOTION_EVENT_AXIS_Y, 0);
-            CORE.Input.Gamepad.axisState[0][GAMEPAD_AXIS_RIGHT_X] = AMotionEvent_getAxisValue(
+            CORE_INPUT.Gamepad.axisState[0][GAMEPAD_AXIS_RIGHT_X] = AMotionEvent_getAxisValue(
                     event, AMOTION_EVENT_AXIS_Z, 0);
-            CORE.Input.Gamepad.axisState[0][GAMEPAD_AXIS_RIGHT_Y] = AMotionEvent_getAxisValue(
+            CORE_INPUT.Gamepad.axisState[0][GAMEPAD_AXIS_RIGHT_Y] = AMotionEvent_getAxisValue(
                     event, AMOTION_EVENT_AXIS_RZ, 0);
-            CORE.Input.Gamepad.axisState[0][GAMEPAD_AXIS_LEFT_TRIGGER] = AMotionEvent_getAxisValue(
+            CORE_INPUT.Gamepad.axisState[0][GAMEPAD_AXIS_LEFT_TRIGGER] = AMotionEvent_getAxisValue(
                     event, AMOTION_EVENT_AXIS_BRAKE, 0) * 2.0f - 1.0f;
-            CORE.Input.Gamepad.axisState[0][GAMEPAD_AXIS_RIGHT_TRIGGER] = AMotionEvent_getAxisValue(
+            CORE_INPUT.Gamepad.axisState[0][GAMEPAD_AXIS_RIGHT_TRIGGER] = AMotionEvent_getAxisValue(
                     event, AMOTION_EVENT_AXIS_GAS, 0) * 2.0f - 1.0f;
 
             // dpad is reported as an axis on android
@@ -5839,34 +5969,34 @@ static int32_t AndroidInputCallback(struct android_app *app, AInputEvent *event)
 
             if (dpadX == 1.0f)
             {
-                CORE.Input.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_RIGHT] = 1;
-                CORE.Input.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_LEFT] = 0;
+                CORE_INPUT.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_RIGHT] = 1;
+                CORE_INPUT.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_LEFT] = 0;
             }
             else if (dpadX == -1.0f)
             {
-                CORE.Input.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_RIGHT] = 0;
-                CORE.Input.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_LEFT] = 1;
+                CORE_INPUT.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_RIGHT] = 0;
+                CORE_INPUT.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_LEFT] = 1;
             }
             else
             {
-                CORE.Input.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_RIGHT] = 0;
-                CORE.Input.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_LEFT] = 0;
+                CORE_INPUT.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_RIGHT] = 0;
+                CORE_INPUT.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_LEFT] = 0;
             }
 
             if (dpadY == 1.0f)
             {
-                CORE.Input.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_DOWN] = 1;
-                CORE.Input.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_UP] = 0;
+                CORE_INPUT.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_DOWN] = 1;
+                CORE_INPUT.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_UP] = 0;
             }
             else if (dpadY == -1.0f)
             {
-                CORE.Input.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_DOWN] = 0;
-                CORE.Input.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_UP] = 1;
+                CORE_INPUT.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_DOWN] = 0;
+                CORE_INPUT.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_UP] = 1;
             }
             else
             {
-                CORE.Input.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_DOWN] = 0;
-                CORE.Input.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_UP] = 0;
+                CORE_INPUT.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_DOWN] = 0;
+                CORE_INPUT.Gamepad.currentButtonState[0][GAMEPAD_BUTTON_LEFT_FACE_UP] = 0;
             }
 
             return 1; // Handled gamepad axis motion
@@ -5882,7 +6012,7 @@ static int32_t AndroidInputCallback(struct android_app *app, AInputEvent *event)
             ((source & AINPUT_SOURCE_GAMEPAD) == AINPUT_SOURCE_GAMEPAD))
         {
             // For now we'll assume a single gamepad which we "detect" on its input event
-            CORE.Input.Gamepad.ready[0] = true;
+            CORE_INPUT.Gamepad.ready[0] = true;
 
             GamepadButton button = AndroidTranslateGamepadButton(keycode);
 
@@ -5890,9 +6020,9 @@ static int32_t AndroidInputCallback(struct android_app *app, AInputEvent *event)
 
             if (AKeyEvent_getAction(event) == AKEY_EVENT_ACTION_DOWN)
             {
-                CORE.Input.Gamepad.currentButtonState[0][button] = 1;
+                CORE_INPUT.Gamepad.currentButtonState[0][button] = 1;
             }
-            else CORE.Input.Gamepad.currentButtonState[0][button] = 0;  // Key up
+            else CORE_INPUT.Gamepad.currentButtonState[0][button] = 0;  // Key up
 
             return 1; // Handled gamepad button
         }
@@ -5901,12 +6031,12 @@ static int32_t AndroidInputCallback(struct android_app *app, AInputEvent *event)
         // NOTE: Android key action is 0 for down and 1 for up
         if (AKeyEvent_getAction(event) == AKEY_EVENT_ACTION_DOWN)
         {
-            CORE.Input.Keyboard.currentKeyState[keycode] = 1;   // Key down
+            CORE_INPUT.Keyboard.currentKeyState[keycode] = 1;   // Key down
 
-            CORE.Input.Keyboard.keyPressedQueue[CORE.Input.Keyboard.keyPressedQueueCount] = keycode;
-            CORE.Input.Keyboard.keyPressedQueueCount++;
+            CORE_INPUT.Keyboard.keyPressedQueue[CORE_INPUT.Keyboard.keyPressedQueueCount] = keycode;
+            CORE_INPUT.Keyboard.keyPressedQueueCount++;
         }
-        else CORE.Input.Keyboard.currentKeyState[keycode] = 0;  // Key up
+        else CORE_INPUT.Keyboard.currentKeyState[keycode] = 0;  // Key up
 
         if (keycode == AKEYCODE_POWER)
         {
@@ -5932,21 +6062,21 @@ static int32_t AndroidInputCallback(struct android_app *app, AInputEvent *event)
     }
 
     // Register touch points count
-    CORE.Input.Touch.pointCount = AMotionEvent_getPointerCount(event);
+    CORE_INPUT.Touch.pointCount = AMotionEvent_getPointerCount(event);
 
-    for (int i = 0; (i < CORE.Input.Touch.pointCount) && (i < MAX_TOUCH_POINTS); i++)
+    for (int i = 0; (i < CORE_INPUT.Touch.pointCount) && (i < MAX_TOUCH_POINTS); i++)
     {
         // Register touch points id
-        CORE.Input.Touch.pointId[i] = AMotionEvent_getPointerId(event, i);
+        CORE_INPUT.Touch.pointId[i] = AMotionEvent_getPointerId(event, i);
 
         // Register touch points position
-        CORE.Input.Touch.position[i] = (Vector2){ AMotionEvent_getX(event, i), AMotionEvent_getY(event, i) };
+        CORE_INPUT.Touch.position[i] = (Vector2){ AMotionEvent_getX(event, i), AMotionEvent_getY(event, i) };
 
-        // Normalize CORE.Input.Touch.position[i] for CORE.Window.screen.width and CORE.Window.screen.height
+        // Normalize CORE_INPUT.Touch.position[i] for CORE.Window.screen.width and CORE.Window.screen.height
         float widthRatio = (float)(CORE.Window.screen.width + CORE.Window.renderOffset.x) / (float)CORE.Window.display.width;
         float heightRatio = (float)(CORE.Window.screen.height + CORE.Window.renderOffset.y) / (float)CORE.Window.display.height;
-        CORE.Input.Touch.position[i].x = CORE.Input.Touch.position[i].x * widthRatio - (float)CORE.Window.renderOffset.x / 2;
-        CORE.Input.Touch.position[i].y = CORE.Input.Touch.position[i].y * heightRatio - (float)CORE.Window.renderOffset.y / 2;
+        CORE_INPUT.Touch.position[i].x = CORE_INPUT.Touch.position[i].x * widthRatio - (float)CORE.Window.renderOffset.x / 2;
+        CORE_INPUT.Touch.position[i].y = CORE_INPUT.Touch.position[i].y * heightRatio - (float)CORE.Window.renderOffset.y / 2;
     }
 
     int32_t action = AMotionEvent_getAction(event);
@@ -5955,7 +6085,7 @@ static int32_t AndroidInputCallback(struct android_app *app, AInputEvent *event)
 #if defined(SUPPORT_GESTURES_SYSTEM)        // PLATFORM_ANDROID
     GestureEvent gestureEvent = { 0 };
 
-    gestureEvent.pointCount = CORE.Input.Touch.pointCount;
+    gestureEvent.pointCount = CORE_INPUT.Touch.pointCount;
 
     // Register touch actions
     if (flags == AMOTION_EVENT_ACTION_DOWN) gestureEvent.touchAction = TOUCH_ACTION_DOWN;
@@ -5965,8 +6095,8 @@ static int32_t AndroidInputCallback(struct android_app *app, AInputEvent *event)
 
     for (int i = 0; (i < gestureEvent.pointCount) && (i < MAX_TOUCH_POINTS); i++)
     {
-        gestureEvent.pointId[i] = CORE.Input.Touch.pointId[i];
-        gestureEvent.position[i] = CORE.Input.Touch.position[i];
+        gestureEvent.pointId[i] = CORE_INPUT.Touch.pointId[i];
+        gestureEvent.position[i] = CORE_INPUT.Touch.position[i];
     }
 
     // Gesture data is sent to gestures system for processing
@@ -5978,20 +6108,20 @@ static int32_t AndroidInputCallback(struct android_app *app, AInputEvent *event)
     if (flags == AMOTION_EVENT_ACTION_POINTER_UP || flags == AMOTION_EVENT_ACTION_UP)
     {
         // One of the touchpoints is released, remove it from touch point arrays
-        for (int i = pointerIndex; (i < CORE.Input.Touch.pointCount - 1) && (i < MAX_TOUCH_POINTS); i++)
+        for (int i = pointerIndex; (i < CORE_INPUT.Touch.pointCount - 1) && (i < MAX_TOUCH_POINTS); i++)
         {
-            CORE.Input.Touch.pointId[i] = CORE.Input.Touch.pointId[i+1];
-            CORE.Input.Touch.position[i] = CORE.Input.Touch.position[i+1];
+            CORE_INPUT.Touch.pointId[i] = CORE_INPUT.Touch.pointId[i+1];
+            CORE_INPUT.Touch.position[i] = CORE_INPUT.Touch.position[i+1];
         }
 
-        CORE.Input.Touch.pointCount--;
+        CORE_INPUT.Touch.pointCount--;
     }
 
     // When all touchpoints are tapped and released really quickly, this event is generated
-    if (flags == AMOTION_EVENT_ACTION_CANCEL) CORE.Input.Touch.pointCount = 0;
+    if (flags == AMOTION_EVENT_ACTION_CANCEL) CORE_INPUT.Touch.pointCount = 0;
 
-    if (CORE.Input.Touch.pointCount > 0) CORE.Input.Touch.currentTouchState[MOUSE_BUTTON_LEFT] = 1;
-    else CORE.Input.Touch.currentTouchState[MOUSE_BUTTON_LEFT] = 0;
+    if (CORE_INPUT.Touch.pointCount > 0) CORE_INPUT.Touch.currentTouchState[MOUSE_BUTTON_LEFT] = 1;
+    else CORE_INPUT.Touch.currentTouchState[MOUSE_BUTTON_LEFT] = 0;
 
     return 0;
 }
@@ -6068,10 +6198,10 @@ static EM_BOOL EmscriptenGamepadCallback(int eventType, const EmscriptenGamepadE
 
     if ((gamepadEvent->connected) && (gamepadEvent->index < MAX_GAMEPADS))
     {
-        CORE.Input.Gamepad.ready[gamepadEvent->index] = true;
-        sprintf(CORE.Input.Gamepad.name[gamepadEvent->index],"%s",gamepadEvent->id);
+        CORE_INPUT.Gamepad.ready[gamepadEvent->index] = true;
+        sprintf(CORE_INPUT.Gamepad.name[gamepadEvent->index],"%s",gamepadEvent->id);
     }
-    else CORE.Input.Gamepad.ready[gamepadEvent->index] = false;
+    else CORE_INPUT.Gamepad.ready[gamepadEvent->index] = false;
 
     return 1;   // The event was consumed by the callback handler
 }
@@ -6080,7 +6210,7 @@ static EM_BOOL EmscriptenGamepadCallback(int eventType, const EmscriptenGamepadE
 static EM_BOOL EmscriptenTouchCallback(int eventType, const EmscriptenTouchEvent *touchEvent, void *userData)
 {
     // Register touch points count
-    CORE.Input.Touch.pointCount = touchEvent->numTouches;
+    CORE_INPUT.Touch.pointCount = touchEvent->numTouches;
 
     double canvasWidth = 0.0;
     double canvasHeight = 0.0;
@@ -6089,26 +6219,26 @@ static EM_BOOL EmscriptenTouchCallback(int eventType, const EmscriptenTouchEvent
     //EMSCRIPTEN_RESULT res = emscripten_get_canvas_element_size("#canvas", &canvasWidth, &canvasHeight);
     emscripten_get_element_css_size("#canvas", &canvasWidth, &canvasHeight);
 
-    for (int i = 0; (i < CORE.Input.Touch.pointCount) && (i < MAX_TOUCH_POINTS); i++)
+    for (int i = 0; (i < CORE_INPUT.Touch.pointCount) && (i < MAX_TOUCH_POINTS); i++)
     {
         // Register touch points id
-        CORE.Input.Touch.pointId[i] = touchEvent->touches[i].identifier;
+        CORE_INPUT.Touch.pointId[i] = touchEvent->touches[i].identifier;
 
         // Register touch points position
-        CORE.Input.Touch.position[i] = (Vector2){ touchEvent->touches[i].targetX, touchEvent->touches[i].targetY };
+        CORE_INPUT.Touch.position[i] = (Vector2){ touchEvent->touches[i].targetX, touchEvent->touches[i].targetY };
 
         // Normalize gestureEvent.position[x] for CORE.Window.screen.width and CORE.Window.screen.height
-        CORE.Input.Touch.position[i].x *= ((float)GetScreenWidth()/(float)canvasWidth);
-        CORE.Input.Touch.position[i].y *= ((float)GetScreenHeight()/(float)canvasHeight);
+        CORE_INPUT.Touch.position[i].x *= ((float)GetScreenWidth()/(float)canvasWidth);
+        CORE_INPUT.Touch.position[i].y *= ((float)GetScreenHeight()/(float)canvasHeight);
 
-        if (eventType == EMSCRIPTEN_EVENT_TOUCHSTART) CORE.Input.Touch.currentTouchState[i] = 1;
-        else if (eventType == EMSCRIPTEN_EVENT_TOUCHEND) CORE.Input.Touch.currentTouchState[i] = 0;
+        if (eventType == EMSCRIPTEN_EVENT_TOUCHSTART) CORE_INPUT.Touch.currentTouchState[i] = 1;
+        else if (eventType == EMSCRIPTEN_EVENT_TOUCHEND) CORE_INPUT.Touch.currentTouchState[i] = 0;
     }
 
 #if defined(SUPPORT_GESTURES_SYSTEM)        // PLATFORM_WEB
     GestureEvent gestureEvent = { 0 };
 
-    gestureEvent.pointCount = CORE.Input.Touch.pointCount;
+    gestureEvent.pointCount = CORE_INPUT.Touch.pointCount;
 
     // Register touch actions
     if (eventType == EMSCRIPTEN_EVENT_TOUCHSTART) gestureEvent.touchAction = TOUCH_ACTION_DOWN;
@@ -6118,8 +6248,8 @@ static EM_BOOL EmscriptenTouchCallback(int eventType, const EmscriptenTouchEvent
 
     for (int i = 0; (i < gestureEvent.pointCount) && (i < MAX_TOUCH_POINTS); i++)
     {
-        gestureEvent.pointId[i] = CORE.Input.Touch.pointId[i];
-        gestureEvent.position[i] = CORE.Input.Touch.position[i];
+        gestureEvent.pointId[i] = CORE_INPUT.Touch.pointId[i];
+        gestureEvent.position[i] = CORE_INPUT.Touch.position[i];
     }
 
     // Gesture data is sent to gestures system for processing
@@ -6138,11 +6268,11 @@ static void InitKeyboard(void)
     // Reading directly from stdin will give chars already key-mapped by kernel to ASCII or UNICODE
 
     // Save terminal keyboard settings
-    tcgetattr(STDIN_FILENO, &CORE.Input.Keyboard.defaultSettings);
+    tcgetattr(STDIN_FILENO, &CORE_INPUT.Keyboard.defaultSettings);
 
     // Reconfigure terminal with new settings
     struct termios keyboardNewSettings = { 0 };
-    keyboardNewSettings = CORE.Input.Keyboard.defaultSettings;
+    keyboardNewSettings = CORE_INPUT.Keyboard.defaultSettings;
 
     // New terminal settings for keyboard: turn off buffering (non-canonical mode), echo and key processing
     // NOTE: ISIG controls if ^C and ^Z generate break signals or not
@@ -6155,11 +6285,11 @@ static void InitKeyboard(void)
     tcsetattr(STDIN_FILENO, TCSANOW, &keyboardNewSettings);
 
     // Save old keyboard mode to restore it at the end
-    CORE.Input.Keyboard.defaultFileFlags = fcntl(STDIN_FILENO, F_GETFL, 0);          // F_GETFL: Get the file access mode and the file status flags
-    fcntl(STDIN_FILENO, F_SETFL, CORE.Input.Keyboard.defaultFileFlags | O_NONBLOCK); // F_SETFL: Set the file status flags to the value specified
+    CORE_INPUT.Keyboard.defaultFileFlags = fcntl(STDIN_FILENO, F_GETFL, 0);          // F_GETFL: Get the file access mode and the file status flags
+    fcntl(STDIN_FILENO, F_SETFL, CORE_INPUT.Keyboard.defaultFileFlags | O_NONBLOCK); // F_SETFL: Set the file status flags to the value specified
 
     // NOTE: If ioctl() returns -1, it means the call failed for some reason (error code set in errno)
-    int result = ioctl(STDIN_FILENO, KDGKBMODE, &CORE.Input.Keyboard.defaultMode);
+    int result = ioctl(STDIN_FILENO, KDGKBMODE, &CORE_INPUT.Keyboard.defaultMode);
 
     // In case of failure, it could mean a remote keyboard is used (SSH)
     if (result < 0) TRACELOG(LOG_WARNING, "RPI: Failed to change keyboard mode, an SSH keyboard is probably used");
@@ -6181,11 +6311,11 @@ static void InitKeyboard(void)
 static void RestoreKeyboard(void)
 {
     // Reset to default keyboard settings
-    tcsetattr(STDIN_FILENO, TCSANOW, &CORE.Input.Keyboard.defaultSettings);
+    tcsetattr(STDIN_FILENO, TCSANOW, &CORE_INPUT.Keyboard.defaultSettings);
 
     // Reconfigure keyboard to default mode
-    fcntl(STDIN_FILENO, F_SETFL, CORE.Input.Keyboard.defaultFileFlags);
-    ioctl(STDIN_FILENO, KDSKBMODE, CORE.Input.Keyboard.defaultMode);
+    fcntl(STDIN_FILENO, F_SETFL, CORE_INPUT.Keyboard.defaultFileFlags);
+    ioctl(STDIN_FILENO, KDSKBMODE, CORE_INPUT.Keyboard.defaultMode);
 }
 
 #if defined(SUPPORT_SSH_KEYBOARD_RPI)
@@ -6202,7 +6332,7 @@ static void ProcessKeyboard(void)
     bufferByteCount = read(STDIN_FILENO, keysBuffer, MAX_KEYBUFFER_SIZE);     // POSIX system call
 
     // Reset pressed keys array (it will be filled below)
-    for (int i = 0; i < MAX_KEYBOARD_KEYS; i++) CORE.Input.Keyboard.currentKeyState[i] = 0;
+    for (int i = 0; i < MAX_KEYBOARD_KEYS; i++) CORE_INPUT.Keyboard.currentKeyState[i] = 0;
 
     // Fill all read bytes (looking for keys)
     for (int i = 0; i < bufferByteCount; i++)
@@ -6212,7 +6342,7 @@ static void ProcessKeyboard(void)
         if (keysBuffer[i] == 0x1b)
         {
             // Check if ESCAPE key has been pressed to stop program
-            if (bufferByteCount == 1) CORE.Input.Keyboard.currentKeyState[CORE.Input.Keyboard.exitKey] = 1;
+            if (bufferByteCount == 1) CORE_INPUT.Keyboard.currentKeyState[CORE_INPUT.Keyboard.exitKey] = 1;
             else
             {
                 if (keysBuffer[i + 1] == 0x5b)    // Special function key
@@ -6222,18 +6352,18 @@ static void ProcessKeyboard(void)
                         // Process special function keys (F1 - F12)
                         switch (keysBuffer[i + 3])
                         {
-                            case 0x41: CORE.Input.Keyboard.currentKeyState[290] = 1; break;    // raylib KEY_F1
-                            case 0x42: CORE.Input.Keyboard.currentKeyState[291] = 1; break;    // raylib KEY_F2
-                            case 0x43: CORE.Input.Keyboard.currentKeyState[292] = 1; break;    // raylib KEY_F3
-                            case 0x44: CORE.Input.Keyboard.currentKeyState[293] = 1; break;    // raylib KEY_F4
-                            case 0x45: CORE.Input.Keyboard.currentKeyState[294] = 1; break;    // raylib KEY_F5
-                            case 0x37: CORE.Input.Keyboard.currentKeyState[295] = 1; break;    // raylib KEY_F6
-                            case 0x38: CORE.Input.Keyboard.currentKeyState[296] = 1; break;    // raylib KEY_F7
-                            case 0x39: CORE.Input.Keyboard.currentKeyState[297] = 1; break;    // raylib KEY_F8
-                            case 0x30: CORE.Input.Keyboard.currentKeyState[298] = 1; break;    // raylib KEY_F9
-                            case 0x31: CORE.Input.Keyboard.currentKeyState[299] = 1; break;    // raylib KEY_F10
-                            case 0x33: CORE.Input.Keyboard.currentKeyState[300] = 1; break;    // raylib KEY_F11
-                            case 0x34: CORE.Input.Keyboard.currentKeyState[301] = 1; break;    // raylib KEY_F12
+                            case 0x41: CORE_INPUT.Keyboard.currentKeyState[290] = 1; break;    // raylib KEY_F1
+                            case 0x42: CORE_INPUT.Keyboard.currentKeyState[291] = 1; break;    // raylib KEY_F2
+                            case 0x43: CORE_INPUT.Keyboard.currentKeyState[292] = 1; break;    // raylib KEY_F3
+                            case 0x44: CORE_INPUT.Keyboard.currentKeyState[293] = 1; break;    // raylib KEY_F4
+                            case 0x45: CORE_INPUT.Keyboard.currentKeyState[294] = 1; break;    // raylib KEY_F5
+                            case 0x37: CORE_INPUT.Keyboard.currentKeyState[295] = 1; break;    // raylib KEY_F6
+                            case 0x38: CORE_INPUT.Keyboard.currentKeyState[296] = 1; break;    // raylib KEY_F7
+                            case 0x39: CORE_INPUT.Keyboard.currentKeyState[297] = 1; break;    // raylib KEY_F8
+                            case 0x30: CORE_INPUT.Keyboard.currentKeyState[298] = 1; break;    // raylib KEY_F9
+                            case 0x31: CORE_INPUT.Keyboard.currentKeyState[299] = 1; break;    // raylib KEY_F10
+                            case 0x33: CORE_INPUT.Keyboard.currentKeyState[300] = 1; break;    // raylib KEY_F11
+                            case 0x34: CORE_INPUT.Keyboard.currentKeyState[301] = 1; break;    // raylib KEY_F12
                             default: break;
                         }
 
@@ -6244,10 +6374,10 @@ static void ProcessKeyboard(void)
                     {
                         switch (keysBuffer[i + 2])
                         {
-                            case 0x41: CORE.Input.Keyboard.currentKeyState[265] = 1; break;    // raylib KEY_UP
-                            case 0x42: CORE.Input.Keyboard.currentKeyState[264] = 1; break;    // raylib KEY_DOWN
-                            case 0x43: CORE.Input.Keyboard.currentKeyState[262] = 1; break;    // raylib KEY_RIGHT
-                            case 0x44: CORE.Input.Keyboard.currentKeyState[263] = 1; break;    // raylib KEY_LEFT
+                            case 0x41: CORE_INPUT.Keyboard.currentKeyState[265] = 1; break;    // raylib KEY_UP
+                            case 0x42: CORE_INPUT.Keyboard.currentKeyState[264] = 1; break;    // raylib KEY_DOWN
+                            case 0x43: CORE_INPUT.Keyboard.currentKeyState[262] = 1; break;    // raylib KEY_RIGHT
+                            case 0x44: CORE_INPUT.Keyboard.currentKeyState[263] = 1; break;    // raylib KEY_LEFT
                             default: break;
                         }
 
@@ -6260,38 +6390,38 @@ static void ProcessKeyboard(void)
         }
         else if (keysBuffer[i] == 0x0a)     // raylib KEY_ENTER (don't mix with <linux/input.h> KEY_*)
         {
-            CORE.Input.Keyboard.currentKeyState[257] = 1;
+            CORE_INPUT.Keyboard.currentKeyState[257] = 1;
 
-            CORE.Input.Keyboard.keyPressedQueue[CORE.Input.Keyboard.keyPressedQueueCount] = 257;     // Add keys pressed into queue
-            CORE.Input.Keyboard.keyPressedQueueCount++;
+            CORE_INPUT.Keyboard.keyPressedQueue[CORE_INPUT.Keyboard.keyPressedQueueCount] = 257;     // Add keys pressed into queue
+            CORE_INPUT.Keyboard.keyPressedQueueCount++;
         }
         else if (keysBuffer[i] == 0x7f)     // raylib KEY_BACKSPACE
         {
-            CORE.Input.Keyboard.currentKeyState[259] = 1;
+            CORE_INPUT.Keyboard.currentKeyState[259] = 1;
 
-            CORE.Input.Keyboard.keyPressedQueue[CORE.Input.Keyboard.keyPressedQueueCount] = 257;     // Add keys pressed into queue
-            CORE.Input.Keyboard.keyPressedQueueCount++;
+            CORE_INPUT.Keyboard.keyPressedQueue[CORE_INPUT.Keyboard.keyPressedQueueCount] = 257;     // Add keys pressed into queue
+            CORE_INPUT.Keyboard.keyPressedQueueCount++;
         }
         else
         {
             // Translate lowercase a-z letters to A-Z
             if ((keysBuffer[i] >= 97) && (keysBuffer[i] <= 122))
             {
-                CORE.Input.Keyboard.currentKeyState[(int)keysBuffer[i] - 32] = 1;
+                CORE_INPUT.Keyboard.currentKeyState[(int)keysBuffer[i] - 32] = 1;
             }
-            else CORE.Input.Keyboard.currentKeyState[(int)keysBuffer[i]] = 1;
+            else CORE_INPUT.Keyboard.currentKeyState[(int)keysBuffer[i]] = 1;
 
-            CORE.Input.Keyboard.keyPressedQueue[CORE.Input.Keyboard.keyPressedQueueCount] = keysBuffer[i];     // Add keys pressed into queue
-            CORE.Input.Keyboard.keyPressedQueueCount++;
+            CORE_INPUT.Keyboard.keyPressedQueue[CORE_INPUT.Keyboard.keyPressedQueueCount] = keysBuffer[i];     // Add keys pressed into queue
+            CORE_INPUT.Keyboard.keyPressedQueueCount++;
         }
     }
 
     // Check exit key (same functionality as GLFW3 KeyCallback())
-    if (CORE.Input.Keyboard.currentKeyState[CORE.Input.Keyboard.exitKey] == 1) CORE.Window.shouldClose = true;
+    if (CORE_INPUT.Keyboard.currentKeyState[CORE_INPUT.Keyboard.exitKey] == 1) CORE.Window.shouldClose = true;
 
 #if defined(SUPPORT_SCREEN_CAPTURE)
     // Check screen capture key (raylib key: KEY_F12)
-    if (CORE.Input.Keyboard.currentKeyState[301] == 1)
+    if (CORE_INPUT.Keyboard.currentKeyState[301] == 1)
     {
         TakeScreenshot(TextFormat("screenshot%03i.png", screenshotCounter));
         screenshotCounter++;
@@ -6308,17 +6438,17 @@ static void InitEvdevInput(void)
     struct dirent *entity = NULL;
 
     // Initialise keyboard file descriptor
-    CORE.Input.Keyboard.fd = -1;
+    CORE_INPUT.Keyboard.fd = -1;
 
     // Reset variables
     for (int i = 0; i < MAX_TOUCH_POINTS; ++i)
     {
-        CORE.Input.Touch.position[i].x = -1;
-        CORE.Input.Touch.position[i].y = -1;
+        CORE_INPUT.Touch.position[i].x = -1;
+        CORE_INPUT.Touch.position[i].y = -1;
     }
 
     // Reset keyboard key state
-    for (int i = 0; i < MAX_KEYBOARD_KEYS; i++) CORE.Input.Keyboard.currentKeyState[i] = 0;
+    for (int i = 0; i < MAX_KEYBOARD_KEYS; i++) CORE_INPUT.Keyboard.currentKeyState[i] = 0;
 
     // Open the linux directory of "/dev/input"
     directory = opendir(DEFAULT_EVDEV_PATH);
@@ -6366,9 +6496,9 @@ static void ConfigureEvdevDevice(char *device)
     // Open the device and allocate worker
     //-------------------------------------------------------------------------------------------------------
     // Find a free spot in the workers array
-    for (int i = 0; i < sizeof(CORE.Input.eventWorker)/sizeof(InputEventWorker); ++i)
+    for (int i = 0; i < sizeof(CORE_INPUT.eventWorker)/sizeof(InputEventWorker); ++i)
     {
-        if (CORE.Input.eventWorker[i].threadId == 0)
+        if (CORE_INPUT.eventWorker[i].threadId == 0)
         {
             freeWorkerId = i;
             break;
@@ -6378,7 +6508,7 @@ static void ConfigureEvdevDevice(char *device)
     // Select the free worker from array
     if (freeWorkerId >= 0)
     {
-        worker = &(CORE.Input.eventWorker[freeWorkerId]);       // Grab a pointer to the worker
+        worker = &(CORE_INPUT.eventWorker[freeWorkerId]);       // Grab a pointer to the worker
         memset(worker, 0, sizeof(InputEventWorker));  // Clear the worker
     }
     else
@@ -6489,13 +6619,13 @@ static void ConfigureEvdevDevice(char *device)
 
     // Decide what to do with the device
     //-------------------------------------------------------------------------------------------------------
-    if (worker->isKeyboard && (CORE.Input.Keyboard.fd == -1))
+    if (worker->isKeyboard && (CORE_INPUT.Keyboard.fd == -1))
     {
         // Use the first keyboard encountered. This assumes that a device that says it's a keyboard is just a
         // keyboard. The keyboard is polled synchronously, whereas other input devices are polled in separate
         // threads so that they don't drop events when the frame rate is slow.
         TRACELOG(LOG_INFO, "RPI: Opening keyboard device: %s", device);
-        CORE.Input.Keyboard.fd = worker->fd;
+        CORE_INPUT.Keyboard.fd = worker->fd;
     }
     else if (worker->isTouch || worker->isMouse)
     {
@@ -6519,21 +6649,21 @@ static void ConfigureEvdevDevice(char *device)
         // Find touchscreen with the highest index
         int maxTouchNumber = -1;
 
-        for (int i = 0; i < sizeof(CORE.Input.eventWorker)/sizeof(InputEventWorker); ++i)
+        for (int i = 0; i < sizeof(CORE_INPUT.eventWorker)/sizeof(InputEventWorker); ++i)
         {
-            if (CORE.Input.eventWorker[i].isTouch && (CORE.Input.eventWorker[i].eventNum > maxTouchNumber)) maxTouchNumber = CORE.Input.eventWorker[i].eventNum;
+            if (CORE_INPUT.eventWorker[i].isTouch && (CORE_INPUT.eventWorker[i].eventNum > maxTouchNumber)) maxTouchNumber = CORE_INPUT.eventWorker[i].eventNum;
         }
 
         // Find touchscreens with lower indexes
-        for (int i = 0; i < sizeof(CORE.Input.eventWorker)/sizeof(InputEventWorker); ++i)
+        for (int i = 0; i < sizeof(CORE_INPUT.eventWorker)/sizeof(InputEventWorker); ++i)
         {
-            if (CORE.Input.eventWorker[i].isTouch && (CORE.Input.eventWorker[i].eventNum < maxTouchNumber))
+            if (CORE_INPUT.eventWorker[i].isTouch && (CORE_INPUT.eventWorker[i].eventNum < maxTouchNumber))
             {
-                if (CORE.Input.eventWorker[i].threadId != 0)
+                if (CORE_INPUT.eventWorker[i].threadId != 0)
                 {
                     TRACELOG(LOG_WARNING, "RPI: Found duplicate touchscreen, killing touchscreen on event: %d", i);
-                    pthread_cancel(CORE.Input.eventWorker[i].threadId);
-                    close(CORE.Input.eventWorker[i].fd);
+                    pthread_cancel(CORE_INPUT.eventWorker[i].threadId);
+                    close(CORE_INPUT.eventWorker[i].fd);
                 }
             }
         }
@@ -6566,7 +6696,7 @@ static void PollKeyboardEvents(void)
         243, 244, 245, 246, 247, 248, 0, 0, 0, 0, 0, 0, 0
     };
 
-    int fd = CORE.Input.Keyboard.fd;
+    int fd = CORE_INPUT.Keyboard.fd;
     if (fd == -1) return;
 
     struct input_event event = { 0 };
@@ -6580,7 +6710,7 @@ static void PollKeyboardEvents(void)
         {
 #if defined(SUPPORT_SSH_KEYBOARD_RPI)
             // Change keyboard mode to events
-            CORE.Input.Keyboard.evtMode = true;
+            CORE_INPUT.Keyboard.evtMode = true;
 #endif
             // Keyboard button parsing
             if ((event.code >= 1) && (event.code <= 255))     //Keyboard keys appear for codes 1 to 255
@@ -6588,28 +6718,28 @@ static void PollKeyboardEvents(void)
                 keycode = keymapUS[event.code & 0xFF];     // The code we get is a scancode so we look up the apropriate keycode
 
                 // Make sure we got a valid keycode
-                if ((keycode > 0) && (keycode < sizeof(CORE.Input.Keyboard.currentKeyState)))
+                if ((keycode > 0) && (keycode < sizeof(CORE_INPUT.Keyboard.currentKeyState)))
                 {
                     // WARNING: https://www.kernel.org/doc/Documentation/input/input.txt
                     // Event interface: 'value' is the value the event carries. Either a relative change for EV_REL,
                     // absolute new value for EV_ABS (joysticks ...), or 0 for EV_KEY for release, 1 for keypress and 2 for autorepeat
-                    CORE.Input.Keyboard.currentKeyState[keycode] = (event.value >= 1)? 1 : 0;
+                    CORE_INPUT.Keyboard.currentKeyState[keycode] = (event.value >= 1)? 1 : 0;
                     if (event.value >= 1)
                     {
-                        CORE.Input.Keyboard.keyPressedQueue[CORE.Input.Keyboard.keyPressedQueueCount] = keycode;     // Register last key pressed
-                        CORE.Input.Keyboard.keyPressedQueueCount++;
+                        CORE_INPUT.Keyboard.keyPressedQueue[CORE_INPUT.Keyboard.keyPressedQueueCount] = keycode;     // Register last key pressed
+                        CORE_INPUT.Keyboard.keyPressedQueueCount++;
                     }
 
                 #if defined(SUPPORT_SCREEN_CAPTURE)
                     // Check screen capture key (raylib key: KEY_F12)
-                    if (CORE.Input.Keyboard.currentKeyState[301] == 1)
+                    if (CORE_INPUT.Keyboard.currentKeyState[301] == 1)
                     {
                         TakeScreenshot(TextFormat("screenshot%03i.png", screenshotCounter));
                         screenshotCounter++;
                     }
                 #endif
 
-                    if (CORE.Input.Keyboard.currentKeyState[CORE.Input.Keyboard.exitKey] == 1) CORE.Window.shouldClose = true;
+                    if (CORE_INPUT.Keyboard.currentKeyState[CORE_INPUT.Keyboard.exitKey] == 1) CORE.Window.shouldClose = true;
 
                     TRACELOGD("RPI: KEY_%s ScanCode: %4i KeyCode: %4i", event.value == 0 ? "UP":"DOWN", event.code, keycode);
                 }
@@ -6637,8 +6767,8 @@ static void *EventThread(void *arg)
             {
                 if (event.code == REL_X)
                 {
-                    CORE.Input.Mouse.currentPosition.x += event.value;
-                    CORE.Input.Touch.position[0].x = CORE.Input.Mouse.currentPosition.x;
+                    CORE_INPUT.Mouse.currentPosition.x += event.value;
+                    CORE_INPUT.Touch.position[0].x = CORE_INPUT.Mouse.currentPosition.x;
 
                     touchAction = 2;    // TOUCH_ACTION_MOVE
                     gestureUpdate = true;
@@ -6646,14 +6776,14 @@ static void *EventThread(void *arg)
 
                 if (event.code == REL_Y)
                 {
-                    CORE.Input.Mouse.currentPosition.y += event.value;
-                    CORE.Input.Touch.position[0].y = CORE.Input.Mouse.currentPosition.y;
+                    CORE_INPUT.Mouse.currentPosition.y += event.value;
+                    CORE_INPUT.Touch.position[0].y = CORE_INPUT.Mouse.currentPosition.y;
 
                     touchAction = 2;    // TOUCH_ACTION_MOVE
                     gestureUpdate = true;
                 }
 
-                if (event.code == REL_WHEEL) CORE.Input.Mouse.currentWheelMove.y += event.value;
+                if (event.code == REL_WHEEL) CORE_INPUT.Mouse.currentWheelMove.y += event.value;
             }
 
             // Absolute movement parsing
@@ -6662,8 +6792,8 @@ static void *EventThread(void *arg)
                 // Basic movement
                 if (event.code == ABS_X)
                 {
-                    CORE.Input.Mouse.currentPosition.x = (event.value - worker->absRange.x)*CORE.Window.screen.width/worker->absRange.width;    // Scale acording to absRange
-                    CORE.Input.Touch.position[0].x = (event.value - worker->absRange.x)*CORE.Window.screen.width/worker->absRange.width;        // Scale acording to absRange
+                    CORE_INPUT.Mouse.currentPosition.x = (event.value - worker->absRange.x)*CORE.Window.screen.width/worker->absRange.width;    // Scale acording to absRange
+                    CORE_INPUT.Touch.position[0].x = (event.value - worker->absRange.x)*CORE.Window.screen.width/worker->absRange.width;        // Scale acording to absRange
 
                     touchAction = 2;    // TOUCH_ACTION_MOVE
                     gestureUpdate = true;
@@ -6671,8 +6801,8 @@ static void *EventThread(void *arg)
 
                 if (event.code == ABS_Y)
                 {
-                    CORE.Input.Mouse.currentPosition.y = (event.value - worker->absRange.y)*CORE.Window.screen.height/worker->absRange.height;  // Scale acording to absRange
-                    CORE.Input.Touch.position[0].y = (event.value - worker->absRange.y)*CORE.Window.screen.height/worker->absRange.height;      // Scale acording to absRange
+                    CORE_INPUT.Mouse.currentPosition.y = (event.value - worker->absRange.y)*CORE.Window.screen.height/worker->absRange.height;  // Scale acording to absRange
+                    CORE_INPUT.Touch.position[0].y = (event.value - worker->absRange.y)*CORE.Window.screen.height/worker->absRange.height;      // Scale acording to absRange
 
                     touchAction = 2;    // TOUCH_ACTION_MOVE
                     gestureUpdate = true;
@@ -6683,12 +6813,12 @@ static void *EventThread(void *arg)
 
                 if (event.code == ABS_MT_POSITION_X)
                 {
-                    if (worker->touchSlot < MAX_TOUCH_POINTS) CORE.Input.Touch.position[worker->touchSlot].x = (event.value - worker->absRange.x)*CORE.Window.screen.width/worker->absRange.width;    // Scale acording to absRange
+                    if (worker->touchSlot < MAX_TOUCH_POINTS) CORE_INPUT.Touch.position[worker->touchSlot].x = (event.value - worker->absRange.x)*CORE.Window.screen.width/worker->absRange.width;    // Scale acording to absRange
                 }
 
                 if (event.code == ABS_MT_POSITION_Y)
                 {
-                    if (worker->touchSlot < MAX_TOUCH_POINTS) CORE.Input.Touch.position[worker->touchSlot].y = (event.value - worker->absRange.y)*CORE.Window.screen.height/worker->absRange.height;  // Scale acording to absRange
+                    if (worker->touchSlot < MAX_TOUCH_POINTS) CORE_INPUT.Touch.position[worker->touchSlot].y = (event.value - worker->absRange.y)*CORE.Window.screen.height/worker->absRange.height;  // Scale acording to absRange
                 }
 
                 if (event.code == ABS_MT_TRACKING_ID)
@@ -6696,19 +6826,19 @@ static void *EventThread(void *arg)
                     if ((event.value < 0) && (worker->touchSlot < MAX_TOUCH_POINTS))
                     {
                         // Touch has ended for this point
-                        CORE.Input.Touch.position[worker->touchSlot].x = -1;
-                        CORE.Input.Touch.position[worker->touchSlot].y = -1;
+                        CORE_INPUT.Touch.position[worker->touchSlot].x = -1;
+                        CORE_INPUT.Touch.position[worker->touchSlot].y = -1;
                     }
                 }
 
                 // Touchscreen tap
                 if (event.code == ABS_PRESSURE)
                 {
-                    int previousMouseLeftButtonState = CORE.Input.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_LEFT];
+                    int previousMouseLeftButtonState = CORE_INPUT.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_LEFT];
 
                     if (!event.value && previousMouseLeftButtonState)
                     {
-                        CORE.Input.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_LEFT] = 0;
+                        CORE_INPUT.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_LEFT] = 0;
 
                         touchAction = 0;    // TOUCH_ACTION_UP
                         gestureUpdate = true;
@@ -6716,7 +6846,7 @@ static void *EventThread(void *arg)
 
                     if (event.value && !previousMouseLeftButtonState)
                     {
-                        CORE.Input.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_LEFT] = 1;
+                        CORE_INPUT.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_LEFT] = 1;
 
                         touchAction = 1;    // TOUCH_ACTION_DOWN
                         gestureUpdate = true;
@@ -6731,37 +6861,37 @@ static void *EventThread(void *arg)
                 // Mouse button parsing
                 if ((event.code == BTN_TOUCH) || (event.code == BTN_LEFT))
                 {
-                    CORE.Input.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_LEFT] = event.value;
+                    CORE_INPUT.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_LEFT] = event.value;
 
                     if (event.value > 0) touchAction = 1;   // TOUCH_ACTION_DOWN
                     else touchAction = 0;       // TOUCH_ACTION_UP
                     gestureUpdate = true;
                 }
 
-                if (event.code == BTN_RIGHT) CORE.Input.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_RIGHT] = event.value;
-                if (event.code == BTN_MIDDLE) CORE.Input.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_MIDDLE] = event.value;
-                if (event.code == BTN_SIDE) CORE.Input.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_SIDE] = event.value;
-                if (event.code == BTN_EXTRA) CORE.Input.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_EXTRA] = event.value;
-                if (event.code == BTN_FORWARD) CORE.Input.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_FORWARD] = event.value;
-                if (event.code == BTN_BACK) CORE.Input.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_BACK] = event.value;
+                if (event.code == BTN_RIGHT) CORE_INPUT.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_RIGHT] = event.value;
+                if (event.code == BTN_MIDDLE) CORE_INPUT.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_MIDDLE] = event.value;
+                if (event.code == BTN_SIDE) CORE_INPUT.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_SIDE] = event.value;
+                if (event.code == BTN_EXTRA) CORE_INPUT.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_EXTRA] = event.value;
+                if (event.code == BTN_FORWARD) CORE_INPUT.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_FORWARD] = event.value;
+                if (event.code == BTN_BACK) CORE_INPUT.Mouse.currentButtonStateEvdev[MOUSE_BUTTON_BACK] = event.value;
             }
 
             // Screen confinement
-            if (!CORE.Input.Mouse.cursorHidden)
+            if (!CORE_INPUT.Mouse.cursorHidden)
             {
-                if (CORE.Input.Mouse.currentPosition.x < 0) CORE.Input.Mouse.currentPosition.x = 0;
-                if (CORE.Input.Mouse.currentPosition.x > CORE.Window.screen.width/CORE.Input.Mouse.scale.x) CORE.Input.Mouse.currentPosition.x = CORE.Window.screen.width/CORE.Input.Mouse.scale.x;
+                if (CORE_INPUT.Mouse.currentPosition.x < 0) CORE_INPUT.Mouse.currentPosition.x = 0;
+                if (CORE_INPUT.Mouse.currentPosition.x > CORE.Window.screen.width/CORE_INPUT.Mouse.scale.x) CORE_INPUT.Mouse.currentPosition.x = CORE.Window.screen.width/CORE_INPUT.Mouse.scale.x;
 
-                if (CORE.Input.Mouse.currentPosition.y < 0) CORE.Input.Mouse.currentPosition.y = 0;
-                if (CORE.Input.Mouse.currentPosition.y > CORE.Window.screen.height/CORE.Input.Mouse.scale.y) CORE.Input.Mouse.currentPosition.y = CORE.Window.screen.height/CORE.Input.Mouse.scale.y;
+                if (CORE_INPUT.Mouse.currentPosition.y < 0) CORE_INPUT.Mouse.currentPosition.y = 0;
+                if (CORE_INPUT.Mouse.currentPosition.y > CORE.Window.screen.height/CORE_INPUT.Mouse.scale.y) CORE_INPUT.Mouse.currentPosition.y = CORE.Window.screen.height/CORE_INPUT.Mouse.scale.y;
             }
 
             // Update touch point count
-            CORE.Input.Touch.pointCount = 0;
-            if (CORE.Input.Touch.position[0].x >= 0) CORE.Input.Touch.pointCount++;
-            if (CORE.Input.Touch.position[1].x >= 0) CORE.Input.Touch.pointCount++;
-            if (CORE.Input.Touch.position[2].x >= 0) CORE.Input.Touch.pointCount++;
-            if (CORE.Input.Touch.position[3].x >= 0) CORE.Input.Touch.pointCount++;
+            CORE_INPUT.Touch.pointCount = 0;
+            if (CORE_INPUT.Touch.position[0].x >= 0) CORE_INPUT.Touch.pointCount++;
+            if (CORE_INPUT.Touch.position[1].x >= 0) CORE_INPUT.Touch.pointCount++;
+            if (CORE_INPUT.Touch.position[2].x >= 0) CORE_INPUT.Touch.pointCount++;
+            if (CORE_INPUT.Touch.position[3].x >= 0) CORE_INPUT.Touch.pointCount++;
 
 #if defined(SUPPORT_GESTURES_SYSTEM)        // PLATFORM_RPI, PLATFORM_DRM
             if (gestureUpdate)
@@ -6769,17 +6899,17 @@ static void *EventThread(void *arg)
                 GestureEvent gestureEvent = { 0 };
 
                 gestureEvent.touchAction = touchAction;
-                gestureEvent.pointCount = CORE.Input.Touch.pointCount;
+                gestureEvent.pointCount = CORE_INPUT.Touch.pointCount;
 
                 gestureEvent.pointId[0] = 0;
                 gestureEvent.pointId[1] = 1;
                 gestureEvent.pointId[2] = 2;
                 gestureEvent.pointId[3] = 3;
 
-                gestureEvent.position[0] = CORE.Input.Touch.position[0];
-                gestureEvent.position[1] = CORE.Input.Touch.position[1];
-                gestureEvent.position[2] = CORE.Input.Touch.position[2];
-                gestureEvent.position[3] = CORE.Input.Touch.position[3];
+                gestureEvent.position[0] = CORE_INPUT.Touch.position[0];
+                gestureEvent.position[1] = CORE_INPUT.Touch.position[1];
+                gestureEvent.position[2] = CORE_INPUT.Touch.position[2];
+                gestureEvent.position[3] = CORE_INPUT.Touch.position[3];
 
                 ProcessGestureEvent(gestureEvent);
             }
@@ -6803,19 +6933,19 @@ static void InitGamepad(void)
     {
         sprintf(gamepadDev, "%s%i", DEFAULT_GAMEPAD_DEV, i);
 
-        if ((CORE.Input.Gamepad.streamId[i] = open(gamepadDev, O_RDONLY | O_NONBLOCK)) < 0)
+        if ((CORE_INPUT.Gamepad.streamId[i] = open(gamepadDev, O_RDONLY | O_NONBLOCK)) < 0)
         {
             // NOTE: Only show message for first gamepad
             if (i == 0) TRACELOG(LOG_WARNING, "RPI: Failed to open Gamepad device, no gamepad available");
         }
         else
         {
-            CORE.Input.Gamepad.ready[i] = true;
+            CORE_INPUT.Gamepad.ready[i] = true;
 
             // NOTE: Only create one thread
             if (i == 0)
             {
-                int error = pthread_create(&CORE.Input.Gamepad.threadId, NULL, &GamepadThread, NULL);
+                int error = pthread_create(&CORE_INPUT.Gamepad.threadId, NULL, &GamepadThread, NULL);
 
                 if (error != 0) TRACELOG(LOG_WARNING, "RPI: Failed to create gamepad input event thread");
                 else  TRACELOG(LOG_INFO, "RPI: Gamepad device initialized successfully");
@@ -6845,7 +6975,7 @@ static void *GamepadThread(void *arg)
     {
         for (int i = 0; i < MAX_GAMEPADS; i++)
         {
-            if (read(CORE.Input.Gamepad.streamId[i], &gamepadEvent, sizeof(struct js_event)) == (int)sizeof(struct js_event))
+            if (read(CORE_INPUT.Gamepad.streamId[i], &gamepadEvent, sizeof(struct js_event)) == (int)sizeof(struct js_event))
             {
                 gamepadEvent.type &= ~JS_EVENT_INIT;     // Ignore synthetic events
 
@@ -6857,10 +6987,10 @@ static void *GamepadThread(void *arg)
                     if (gamepadEvent.number < MAX_GAMEPAD_BUTTONS)
                     {
                         // 1 - button pressed, 0 - button released
-                        CORE.Input.Gamepad.currentButtonState[i][gamepadEvent.number] = (int)gamepadEvent.value;
+                        CORE_INPUT.Gamepad.currentButtonState[i][gamepadEvent.number] = (int)gamepadEvent.value;
 
-                        if ((int)gamepadEvent.value == 1) CORE.Input.Gamepad.lastButtonPressed = gamepadEvent.number;
-                        else CORE.Input.Gamepad.lastButtonPressed = 0;       // GAMEPAD_BUTTON_UNKNOWN
+                        if ((int)gamepadEvent.value == 1) CORE_INPUT.Gamepad.lastButtonPressed = gamepadEvent.number;
+                        else CORE_INPUT.Gamepad.lastButtonPressed = 0;       // GAMEPAD_BUTTON_UNKNOWN
                     }
                 }
                 else if (gamepadEvent.type == JS_EVENT_AXIS)
@@ -6870,7 +7000,7 @@ static void *GamepadThread(void *arg)
                     if (gamepadEvent.number < MAX_GAMEPAD_AXIS)
                     {
                         // NOTE: Scaling of gamepadEvent.value to get values between -1..1
-                        CORE.Input.Gamepad.axisState[i][gamepadEvent.number] = (float)gamepadEvent.value/32768;
+                        CORE_INPUT.Gamepad.axisState[i][gamepadEvent.number] = (float)gamepadEvent.value/32768;
                     }
                 }
             }
@@ -7072,7 +7202,7 @@ static void RecordAutomationEvent(unsigned int frame)
     for (int key = 0; key < MAX_KEYBOARD_KEYS; key++)
     {
         // INPUT_KEY_UP (only saved once)
-        if (CORE.Input.Keyboard.previousKeyState[key] && !CORE.Input.Keyboard.currentKeyState[key])
+        if (CORE_INPUT.Keyboard.previousKeyState[key] && !CORE_INPUT.Keyboard.currentKeyState[key])
         {
             events[eventCount].frame = frame;
             events[eventCount].type = INPUT_KEY_UP;
@@ -7085,7 +7215,7 @@ static void RecordAutomationEvent(unsigned int frame)
         }
 
         // INPUT_KEY_DOWN
-        if (CORE.Input.Keyboard.currentKeyState[key])
+        if (CORE_INPUT.Keyboard.currentKeyState[key])
         {
             events[eventCount].frame = frame;
             events[eventCount].type = INPUT_KEY_DOWN;
@@ -7101,7 +7231,7 @@ static void RecordAutomationEvent(unsigned int frame)
     for (int button = 0; button < MAX_MOUSE_BUTTONS; button++)
     {
         // INPUT_MOUSE_BUTTON_UP
-        if (CORE.Input.Mouse.previousButtonState[button] && !CORE.Input.Mouse.currentButtonState[button])
+        if (CORE_INPUT.Mouse.previousButtonState[button] && !CORE_INPUT.Mouse.currentButtonState[button])
         {
             events[eventCount].frame = frame;
             events[eventCount].type = INPUT_MOUSE_BUTTON_UP;
@@ -7114,7 +7244,7 @@ static void RecordAutomationEvent(unsigned int frame)
         }
 
         // INPUT_MOUSE_BUTTON_DOWN
-        if (CORE.Input.Mouse.currentButtonState[button])
+        if (CORE_INPUT.Mouse.currentButtonState[button])
         {
             events[eventCount].frame = frame;
             events[eventCount].type = INPUT_MOUSE_BUTTON_DOWN;
@@ -7128,13 +7258,13 @@ static void RecordAutomationEvent(unsigned int frame)
     }
 
     // INPUT_MOUSE_POSITION (only saved if changed)
-    if (((int)CORE.Input.Mouse.currentPosition.x != (int)CORE.Input.Mouse.previousPosition.x) ||
-        ((int)CORE.Input.Mouse.currentPosition.y != (int)CORE.Input.Mouse.previousPosition.y))
+    if (((int)CORE_INPUT.Mouse.currentPosition.x != (int)CORE_INPUT.Mouse.previousPosition.x) ||
+        ((int)CORE_INPUT.Mouse.currentPosition.y != (int)CORE_INPUT.Mouse.previousPosition.y))
     {
         events[eventCount].frame = frame;
         events[eventCount].type = INPUT_MOUSE_POSITION;
-        events[eventCount].params[0] = (int)CORE.Input.Mouse.currentPosition.x;
-        events[eventCount].params[1] = (int)CORE.Input.Mouse.currentPosition.y;
+        events[eventCount].params[0] = (int)CORE_INPUT.Mouse.currentPosition.x;
+        events[eventCount].params[1] = (int)CORE_INPUT.Mouse.currentPosition.y;
         events[eventCount].params[2] = 0;
 
         TRACELOG(LOG_INFO, "[%i] INPUT_MOUSE_POSITION: %i, %i, %i", events[eventCount].frame, events[eventCount].params[0], events[eventCount].params[1], events[eventCount].params[2]);
@@ -7142,13 +7272,13 @@ static void RecordAutomationEvent(unsigned int frame)
     }
 
     // INPUT_MOUSE_WHEEL_MOTION
-    if (((int)CORE.Input.Mouse.currentWheelMove.x != (int)CORE.Input.Mouse.previousWheelMove.x) ||
-        ((int)CORE.Input.Mouse.currentWheelMove.y != (int)CORE.Input.Mouse.previousWheelMove.y))
+    if (((int)CORE_INPUT.Mouse.currentWheelMove.x != (int)CORE_INPUT.Mouse.previousWheelMove.x) ||
+        ((int)CORE_INPUT.Mouse.currentWheelMove.y != (int)CORE_INPUT.Mouse.previousWheelMove.y))
     {
         events[eventCount].frame = frame;
         events[eventCount].type = INPUT_MOUSE_WHEEL_MOTION;
-        events[eventCount].params[0] = (int)CORE.Input.Mouse.currentWheelMove.x;
-        events[eventCount].params[1] = (int)CORE.Input.Mouse.currentWheelMove.y;;
+        events[eventCount].params[0] = (int)CORE_INPUT.Mouse.currentWheelMove.x;
+        events[eventCount].params[1] = (int)CORE_INPUT.Mouse.currentWheelMove.y;;
         events[eventCount].params[2] = 0;
 
         TRACELOG(LOG_INFO, "[%i] INPUT_MOUSE_WHEEL_MOTION: %i, %i, %i", events[eventCount].frame, events[eventCount].params[0], events[eventCount].params[1], events[eventCount].params[2]);
@@ -7158,7 +7288,7 @@ static void RecordAutomationEvent(unsigned int frame)
     for (int id = 0; id < MAX_TOUCH_POINTS; id++)
     {
         // INPUT_TOUCH_UP
-        if (CORE.Input.Touch.previousTouchState[id] && !CORE.Input.Touch.currentTouchState[id])
+        if (CORE_INPUT.Touch.previousTouchState[id] && !CORE_INPUT.Touch.currentTouchState[id])
         {
             events[eventCount].frame = frame;
             events[eventCount].type = INPUT_TOUCH_UP;
@@ -7171,7 +7301,7 @@ static void RecordAutomationEvent(unsigned int frame)
         }
 
         // INPUT_TOUCH_DOWN
-        if (CORE.Input.Touch.currentTouchState[id])
+        if (CORE_INPUT.Touch.currentTouchState[id])
         {
             events[eventCount].frame = frame;
             events[eventCount].type = INPUT_TOUCH_DOWN;
@@ -7186,14 +7316,14 @@ static void RecordAutomationEvent(unsigned int frame)
         // INPUT_TOUCH_POSITION
         // TODO: It requires the id!
         /*
-        if (((int)CORE.Input.Touch.currentPosition[id].x != (int)CORE.Input.Touch.previousPosition[id].x) ||
-            ((int)CORE.Input.Touch.currentPosition[id].y != (int)CORE.Input.Touch.previousPosition[id].y))
+        if (((int)CORE_INPUT.Touch.currentPosition[id].x != (int)CORE_INPUT.Touch.previousPosition[id].x) ||
+            ((int)CORE_INPUT.Touch.currentPosition[id].y != (int)CORE_INPUT.Touch.previousPosition[id].y))
         {
             events[eventCount].frame = frame;
             events[eventCount].type = INPUT_TOUCH_POSITION;
             events[eventCount].params[0] = id;
-            events[eventCount].params[1] = (int)CORE.Input.Touch.currentPosition[id].x;
-            events[eventCount].params[2] = (int)CORE.Input.Touch.currentPosition[id].y;
+            events[eventCount].params[1] = (int)CORE_INPUT.Touch.currentPosition[id].x;
+            events[eventCount].params[2] = (int)CORE_INPUT.Touch.currentPosition[id].y;
 
             TRACELOG(LOG_INFO, "[%i] INPUT_TOUCH_POSITION: %i, %i, %i", events[eventCount].frame, events[eventCount].params[0], events[eventCount].params[1], events[eventCount].params[2]);
             eventCount++;
@@ -7205,8 +7335,8 @@ static void RecordAutomationEvent(unsigned int frame)
     {
         // INPUT_GAMEPAD_CONNECT
         /*
-        if ((CORE.Input.Gamepad.currentState[gamepad] != CORE.Input.Gamepad.previousState[gamepad]) &&
-            (CORE.Input.Gamepad.currentState[gamepad] == true)) // Check if changed to ready
+        if ((CORE_INPUT.Gamepad.currentState[gamepad] != CORE_INPUT.Gamepad.previousState[gamepad]) &&
+            (CORE_INPUT.Gamepad.currentState[gamepad] == true)) // Check if changed to ready
         {
             // TODO: Save gamepad connect event
         }
@@ -7214,8 +7344,8 @@ static void RecordAutomationEvent(unsigned int frame)
 
         // INPUT_GAMEPAD_DISCONNECT
         /*
-        if ((CORE.Input.Gamepad.currentState[gamepad] != CORE.Input.Gamepad.previousState[gamepad]) &&
-            (CORE.Input.Gamepad.currentState[gamepad] == false)) // Check if changed to not-ready
+        if ((CORE_INPUT.Gamepad.currentState[gamepad] != CORE_INPUT.Gamepad.previousState[gamepad]) &&
+            (CORE_INPUT.Gamepad.currentState[gamepad] == false)) // Check if changed to not-ready
         {
             // TODO: Save gamepad disconnect event
         }
@@ -7224,7 +7354,7 @@ static void RecordAutomationEvent(unsigned int frame)
         for (int button = 0; button < MAX_GAMEPAD_BUTTONS; button++)
         {
             // INPUT_GAMEPAD_BUTTON_UP
-            if (CORE.Input.Gamepad.previousButtonState[gamepad][button] && !CORE.Input.Gamepad.currentButtonState[gamepad][button])
+            if (CORE_INPUT.Gamepad.previousButtonState[gamepad][button] && !CORE_INPUT.Gamepad.currentButtonState[gamepad][button])
             {
                 events[eventCount].frame = frame;
                 events[eventCount].type = INPUT_GAMEPAD_BUTTON_UP;
@@ -7237,7 +7367,7 @@ static void RecordAutomationEvent(unsigned int frame)
             }
 
             // INPUT_GAMEPAD_BUTTON_DOWN
-            if (CORE.Input.Gamepad.currentButtonState[gamepad][button])
+            if (CORE_INPUT.Gamepad.currentButtonState[gamepad][button])
             {
                 events[eventCount].frame = frame;
                 events[eventCount].type = INPUT_GAMEPAD_BUTTON_DOWN;
@@ -7253,13 +7383,13 @@ static void RecordAutomationEvent(unsigned int frame)
         for (int axis = 0; axis < MAX_GAMEPAD_AXIS; axis++)
         {
             // INPUT_GAMEPAD_AXIS_MOTION
-            if (CORE.Input.Gamepad.axisState[gamepad][axis] > 0.1f)
+            if (CORE_INPUT.Gamepad.axisState[gamepad][axis] > 0.1f)
             {
                 events[eventCount].frame = frame;
                 events[eventCount].type = INPUT_GAMEPAD_AXIS_MOTION;
                 events[eventCount].params[0] = gamepad;
                 events[eventCount].params[1] = axis;
-                events[eventCount].params[2] = (int)(CORE.Input.Gamepad.axisState[gamepad][axis]*32768.0f);
+                events[eventCount].params[2] = (int)(CORE_INPUT.Gamepad.axisState[gamepad][axis]*32768.0f);
 
                 TRACELOG(LOG_INFO, "[%i] INPUT_GAMEPAD_AXIS_MOTION: %i, %i, %i", events[eventCount].frame, events[eventCount].params[0], events[eventCount].params[1], events[eventCount].params[2]);
                 eventCount++;
@@ -7291,34 +7421,34 @@ static void PlayAutomationEvent(unsigned int frame)
             switch (events[i].type)
             {
                 // Input events
-                case INPUT_KEY_UP: CORE.Input.Keyboard.currentKeyState[events[i].params[0]] = false; break;             // param[0]: key
-                case INPUT_KEY_DOWN: CORE.Input.Keyboard.currentKeyState[events[i].params[0]] = true; break;            // param[0]: key
-                case INPUT_MOUSE_BUTTON_UP: CORE.Input.Mouse.currentButtonState[events[i].params[0]] = false; break;    // param[0]: key
-                case INPUT_MOUSE_BUTTON_DOWN: CORE.Input.Mouse.currentButtonState[events[i].params[0]] = true; break;   // param[0]: key
+                case INPUT_KEY_UP: CORE_INPUT.Keyboard.currentKeyState[events[i].params[0]] = false; break;             // param[0]: key
+                case INPUT_KEY_DOWN: CORE_INPUT.Keyboard.currentKeyState[events[i].params[0]] = true; break;            // param[0]: key
+                case INPUT_MOUSE_BUTTON_UP: CORE_INPUT.Mouse.currentButtonState[events[i].params[0]] = false; break;    // param[0]: key
+                case INPUT_MOUSE_BUTTON_DOWN: CORE_INPUT.Mouse.currentButtonState[events[i].params[0]] = true; break;   // param[0]: key
                 case INPUT_MOUSE_POSITION:      // param[0]: x, param[1]: y
                 {
-                    CORE.Input.Mouse.currentPosition.x = (float)events[i].params[0];
-                    CORE.Input.Mouse.currentPosition.y = (float)events[i].params[1];
+                    CORE_INPUT.Mouse.currentPosition.x = (float)events[i].params[0];
+                    CORE_INPUT.Mouse.currentPosition.y = (float)events[i].params[1];
                 } break;
                 case INPUT_MOUSE_WHEEL_MOTION:  // param[0]: x delta, param[1]: y delta
                 {
-                    CORE.Input.Mouse.currentWheelMove.x = (float)events[i].params[0]; break;
-                    CORE.Input.Mouse.currentWheelMove.y = (float)events[i].params[1]; break;
+                    CORE_INPUT.Mouse.currentWheelMove.x = (float)events[i].params[0]; break;
+                    CORE_INPUT.Mouse.currentWheelMove.y = (float)events[i].params[1]; break;
                 } break;
-                case INPUT_TOUCH_UP: CORE.Input.Touch.currentTouchState[events[i].params[0]] = false; break;            // param[0]: id
-                case INPUT_TOUCH_DOWN: CORE.Input.Touch.currentTouchState[events[i].params[0]] = true; break;           // param[0]: id
+                case INPUT_TOUCH_UP: CORE_INPUT.Touch.currentTouchState[events[i].params[0]] = false; break;            // param[0]: id
+                case INPUT_TOUCH_DOWN: CORE_INPUT.Touch.currentTouchState[events[i].params[0]] = true; break;           // param[0]: id
                 case INPUT_TOUCH_POSITION:      // param[0]: id, param[1]: x, param[2]: y
                 {
-                    CORE.Input.Touch.position[events[i].params[0]].x = (float)events[i].params[1];
-                    CORE.Input.Touch.position[events[i].params[0]].y = (float)events[i].params[2];
+                    CORE_INPUT.Touch.position[events[i].params[0]].x = (float)events[i].params[1];
+                    CORE_INPUT.Touch.position[events[i].params[0]].y = (float)events[i].params[2];
                 } break;
-                case INPUT_GAMEPAD_CONNECT: CORE.Input.Gamepad.ready[events[i].params[0]] = true; break;                // param[0]: gamepad
-                case INPUT_GAMEPAD_DISCONNECT: CORE.Input.Gamepad.ready[events[i].params[0]] = false; break;            // param[0]: gamepad
-                case INPUT_GAMEPAD_BUTTON_UP: CORE.Input.Gamepad.currentButtonState[events[i].params[0]][events[i].params[1]] = false; break;    // param[0]: gamepad, param[1]: button
-                case INPUT_GAMEPAD_BUTTON_DOWN: CORE.Input.Gamepad.currentButtonState[events[i].params[0]][events[i].params[1]] = true; break;   // param[0]: gamepad, param[1]: button
+                case INPUT_GAMEPAD_CONNECT: CORE_INPUT.Gamepad.ready[events[i].params[0]] = true; break;                // param[0]: gamepad
+                case INPUT_GAMEPAD_DISCONNECT: CORE_INPUT.Gamepad.ready[events[i].params[0]] = false; break;            // param[0]: gamepad
+                case INPUT_GAMEPAD_BUTTON_UP: CORE_INPUT.Gamepad.currentButtonState[events[i].params[0]][events[i].params[1]] = false; break;    // param[0]: gamepad, param[1]: button
+                case INPUT_GAMEPAD_BUTTON_DOWN: CORE_INPUT.Gamepad.currentButtonState[events[i].params[0]][events[i].params[1]] = true; break;   // param[0]: gamepad, param[1]: button
                 case INPUT_GAMEPAD_AXIS_MOTION: // param[0]: gamepad, param[1]: axis, param[2]: delta
                 {
-                    CORE.Input.Gamepad.axisState[events[i].params[0]][events[i].params[1]] = ((float)events[i].params[2]/32768.0f);
+                    CORE_INPUT.Gamepad.axisState[events[i].params[0]][events[i].params[1]] = ((float)events[i].params[2]/32768.0f);
                 } break;
                 case INPUT_GESTURE: GESTURES.current = events[i].params[0]; break;     // param[0]: gesture (enum Gesture) -> rgestures.h: GESTURES.current
 
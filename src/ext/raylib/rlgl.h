@@ -652,6 +652,8 @@ RLAPI void rlglInit(int width, int height);             // Initialize rlgl (buff
 RLAPI void rlglClose(void);                             // De-initialize rlgl (buffers, shaders, textures)
 RLAPI void rlLoadExtensions(void *loader);              // Load OpenGL extensions (loader function required)
 RLAPI int rlGetVersion(void);                           // Get current OpenGL version
+RLAPI unsigned int rlGetDrawCallCount(void);            // Get draw calls issued since initialization
+RLAPI unsigned int rlGetDrawVertexCount(void);          // Get vertices drawn since initialization
 RLAPI void rlSetFramebufferWidth(int width);            // Set current framebuffer width
 RLAPI int rlGetFramebufferWidth(void);                  // Get default framebuffer width
 RLAPI void rlSetFramebufferHeight(int height);          // Set current framebuffer height
@@ -955,6 +957,8 @@ typedef struct rlglData {
 
     struct {
         int vertexCounter;                  // Current active render batch vertex counter (generic, used for all batches)
+        unsigned int drawCalls;             // Draw calls issued since initialization, batched or not
+        unsigned int drawVertices;          // Vertices drawn since initialization
         float texcoordx, texcoordy;         // Current active texture coordinate (added on glVertex*())
         float normalx, normaly, normalz;    // Current active normal (added on glVertex*())
         unsigned char colorr, colorg, colorb, colora;   // Current active color (added on glVertex*())
@@ -2388,6 +2392,26 @@ void rlLoadExtensions(void *loader)
 #endif  // GRAPHICS_API_OPENGL_33 || GRAPHICS_API_OPENGL_ES2
 }
 
+// Get draw calls issued since initialization
+unsigned int rlGetDrawCallCount(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    return RLGL.State.drawCalls;
+#else
+    return 0;
+#endif
+}
+
+// Get vertices drawn since initialization
+unsigned int rlGetDrawVertexCount(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    return RLGL.State.drawVertices;
+#else
+    return 0;
+#endif
+}
+
 // Get current OpenGL version
 int rlGetVersion(void)
 {
@@ -2794,6 +2818,9 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
                 }
 
                 vertexOffset += (batch->draws[i].vertexCount + batch->draws[i].vertexAlignment);
+
+                RLGL.State.drawCalls++;
+                RLGL.State.drawVertices += batch->draws[i].vertexCount;
             }
 
             if (!RLGL.ExtSupported.vao)
@@ -3619,12 +3646,20 @@ void rlDisableVertexAttribute(unsigned int index)
 void rlDrawVertexArray(int offset, int count)
 {
     glDrawArrays(GL_TRIANGLES, offset, count);
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    RLGL.State.drawCalls++;
+    RLGL.State.drawVertices += count;
+#endif
 }
 
 // Draw vertex array elements
 void rlDrawVertexArrayElements(int offset, int count, const void *buffer)
 {
     glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_SHORT, (const unsigned short *)buffer + offset);
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    RLGL.State.drawCalls++;
+    RLGL.State.drawVertices += count;
+#endif
 }
 
 // Draw vertex array instanced
@@ -3632,6 +3667,8 @@ void rlDrawVertexArrayInstanced(int offset, int count, int instances)
 {
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     glDrawArraysInstanced(GL_TRIANGLES, 0, count, instances);
+    RLGL.State.drawCalls++;
+    RLGL.State.drawVertices += count*instances;
 #endif
 }
 
@@ -3640,6 +3677,8 @@ void rlDrawVertexArrayElementsInstanced(int offset, int count, const void *buffe
 {
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     glDrawElementsInstanced(GL_TRIANGLES, count, GL_UNSIGNED_SHORT, (const unsigned short *)buffer + offset, instances);
+    RLGL.State.drawCalls++;
+    RLGL.State.drawVertices += count*instances;
 #endif
 }
 
@@ -4336,6 +4375,8 @@ void rlLoadDrawQuad(void)
     glBindVertexArray(quadVAO);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     glBindVertexArray(0);
+    RLGL.State.drawCalls++;
+    RLGL.State.drawVertices += 4;
 
     // Delete buffers (VBO and VAO)
     glDeleteBuffers(1, &quadVBO);
@@ -4414,6 +4455,8 @@ void rlLoadDrawCube(void)
     glBindVertexArray(cubeVAO);
     glDrawArrays(GL_TRIANGLES, 0, 36);
     glBindVertexArray(0);
+    RLGL.State.drawCalls++;
+    RLGL.State.drawVertices += 36;
 
     // Delete VBO and VAO
     glDeleteBuffers(1, &cubeVBO);
@@ -148,26 +148,29 @@
 // Module specific Functions Declaration
 //----------------------------------------------------------------------------------
 #if defined(SUPPORT_FILEFORMAT_OBJ)
-static Model LoadOBJ(const char *fileName);     // Load OBJ mesh data
+static Model LoadOBJ(const char *fileName, ModelData *deferred);     // Load OBJ mesh data
 #endif
 #if defined(SUPPORT_FILEFORMAT_IQM)
 static Model LoadIQM(const char *fileName);     // Load IQM mesh data
 static ModelAnimation *LoadModelAnimationsIQM(const char *fileName, unsigned int *animCount);   // Load IQM animation data
 #endif
 #if defined(SUPPORT_FILEFORMAT_GLTF)
-static Model LoadGLTF(const char *fileName);    // Load GLTF mesh data
+static Model LoadGLTF(const char *fileName, ModelData *deferred);    // Load GLTF mesh data
 static ModelAnimation *LoadModelAnimationsGLTF(const char *fileName, unsigned int *animCount);  // Load GLTF animation data
 #endif
 #if defined(SUPPORT_FILEFORMAT_VOX)
 static Model LoadVOX(const char *filename);     // Load VOX mesh data
 #endif
 #if defined(SUPPORT_FILEFORMAT_M3D)
-static Model LoadM3D(const char *filename);     // Load M3D mesh data
+static Model LoadM3D(const char *filename, ModelData *deferred);     // Load M3D mesh data
 static ModelAnimation *LoadModelAnimationsM3D(const char *fileName, unsigned int *animCount);   // Load M3D animation data
 #endif
 #if defined(SUPPORT_FILEFORMAT_OBJ) || defined(SUPPORT_FILEFORMAT_MTL)
-static void ProcessMaterialsOBJ(Material *rayMaterials, tinyobj_material_t *materials, int materialCount);  // Process obj materials
+static void ProcessMaterialsOBJ(Material *rayMaterials, tinyobj_material_t *materials, int materialCount, ModelData *deferred);  // Process obj materials
 #endif
+static Model LoadModelFile(const char *fileName, ModelData *deferred);          // Load model data from a file without uploading the meshes
+static void LoadMaterialMapTexture(ModelData *deferred, Texture2D *texture, Image image);            // Load a material map texture, deferred into model data when given
+static void LoadMaterialMapTextureFile(ModelData *deferred, Texture2D *texture, const char *fileName); // Load a material map texture from a file, deferred into model data when given
 
 //----------------------------------------------------------------------------------
 // Module Functions Definition
@@ -1032,26 +1035,7 @@ void DrawGrid(int slices, float spacing)
 // Load model from files (mesh and material)
 Model LoadModel(const char *fileName)
 {
-    Model model = { 0 };
-
-#if defined(SUPPORT_FILEFORMAT_OBJ)
-    if (IsFileExtension(fileName, ".obj")) model = LoadOBJ(fileName);
-#endif
-#if defined(SUPPORT_FILEFORMAT_IQM)
-    if (IsFileExtension(fileName, ".iqm")) model = LoadIQM(fileName);
-#endif
-#if defined(SUPPORT_FILEFORMAT_GLTF)
-    if (IsFileExtension(fileName, ".gltf") || IsFileExtension(fileName, ".glb")) model = LoadGLTF(fileName);
-#endif
-#if defined(SUPPORT_FILEFORMAT_VOX)
-    if (IsFileExtension(fileName, ".vox")) model = LoadVOX(fileName);
-#endif
-#if defined(SUPPORT_FILEFORMAT_M3D)
-    if (IsFileExtension(fileName, ".m3d")) model = LoadM3D(fileName);
-#endif
-
-    // Make sure model transform is set to identity matrix!
-    model.transform = MatrixIdentity();
+    Model model = LoadModelFile(fileName, NULL);
 
     if (model.meshCount == 0)
     {
@@ -1084,6 +1068,152 @@ Model LoadModel(const char *fileName)
     return model;
 }
 
+// Load model data from files without any GPU upload, it can be called from any thread
+// NOTE: Material map images are kept in the model data until UploadModelData() turns them into textures
+ModelData LoadModelData(const char *fileName)
+{
+    ModelData data = { 0 };
+
+    data.model = LoadModelFile(fileName, &data);
+
+    return data;
+}
+
+// Upload model data meshes and material map images to GPU, the images are unloaded
+// NOTE: Falls back to a cube mesh and a default material like LoadModel() when data is missing
+Model UploadModelData(ModelData data)
+{
+    Model model = data.model;
+
+    if (model.meshCount == 0)
+    {
+        model.meshCount = 1;
+        model.meshes = (Mesh *)RL_CALLOC(model.meshCount, sizeof(Mesh));
+#if defined(SUPPORT_MESH_GENERATION)
+        TRACELOG(LOG_WARNING, "MESH: Failed to load mesh data, default to cube mesh");
+        model.meshes[0] = GenMeshCube(1.0f, 1.0f, 1.0f);
+#endif
+    }
+    else
+    {
+        for (int i = 0; i < model.meshCount; i++) UploadMesh(&model.meshes[i], false);
+    }
+
+    if (model.materialCount == 0)
+    {
+        model.materialCount = 1;
+        model.materials = (Material *)RL_CALLOC(model.materialCount, sizeof(Material));
+        model.materials[0] = LoadMaterialDefault();
+
+        if (model.meshMaterial == NULL) model.meshMaterial = (int *)RL_CALLOC(model.meshCount, sizeof(int));
+    }
+
+    // Material map textures point into model.materials, which is never reallocated
+    for (int i = 0; i < data.imageCount; i++)
+    {
+        *data.textures[i] = LoadTextureFromImage(data.images[i]);
+        UnloadImage(data.images[i]);
+    }
+
+    RL_FREE(data.images);
+    RL_FREE(data.textures);
+
+    return model;
+}
+
+// Unload model data which was never uploaded, it can be called from any thread
+void UnloadModelData(ModelData data)
+{
+    for (int i = 0; i < data.model.meshCount; i++)
+    {
+        Mesh *mesh = &data.model.meshes[i];
+
+        // Nothing was uploaded, so there are no buffers to release
+        RL_FREE(mesh->vertices);
+        RL_FREE(mesh->texcoords);
+        RL_FREE(mesh->normals);
+        RL_FREE(mesh->colors);
+        RL_FREE(mesh->tangents);
+        RL_FREE(mesh->texcoords2);
+        RL_FREE(mesh->indices);
+        RL_FREE(mesh->animVertices);
+        RL_FREE(mesh->animNormals);
+        RL_FREE(mesh->boneWeights);
+        RL_FREE(mesh->boneIds);
+    }
+
+    for (int i = 0; i < data.imageCount; i++) UnloadImage(data.images[i]);
+
+    // Materials only hold default textures and shaders until the upload
+    for (int i = 0; i < data.model.materialCount; i++) RL_FREE(data.model.materials[i].maps);
+    RL_FREE(data.model.materials);
+    RL_FREE(data.model.meshes);
+    RL_FREE(data.model.meshMaterial);
+    RL_FREE(data.model.bones);
+    RL_FREE(data.model.bindPose);
+    RL_FREE(data.images);
+    RL_FREE(data.textures);
+}
+
+// Load model data from a file, meshes are not uploaded
+static Model LoadModelFile(const char *fileName, ModelData *deferred)
+{
+    Model model = { 0 };
+
+#if defined(SUPPORT_FILEFORMAT_OBJ)
+    if (IsFileExtension(fileName, ".obj")) model = LoadOBJ(fileName, deferred);
+#endif
+#if defined(SUPPORT_FILEFORMAT_IQM)
+    if (IsFileExtension(fileName, ".iqm")) model = LoadIQM(fileName);
+#endif
+#if defined(SUPPORT_FILEFORMAT_GLTF)
+    if (IsFileExtension(fileName, ".gltf") || IsFileExtension(fileName, ".glb")) model = LoadGLTF(fileName, deferred);
+#endif
+#if defined(SUPPORT_FILEFORMAT_VOX)
+    if (IsFileExtension(fileName, ".vox")) model = LoadVOX(fileName);
+#endif
+#if defined(SUPPORT_FILEFORMAT_M3D)
+    if (IsFileExtension(fileName, ".m3d")) model = LoadM3D(fileName, deferred);
+#endif
+
+    // Make sure model transform is set to identity matrix!
+    model.transform = MatrixIdentity();
+
+    return model;
+}
+
+// Load a material map texture, while loading model data the image is kept for UploadModelData()
+static void LoadMaterialMapTexture(ModelData *deferred, Texture2D *texture, Image image)
+{
+    if (deferred == NULL)
+    {
+        *texture = LoadTextureFromImage(image);
+        return;
+    }
+
+    ModelData *data = deferred;
+
+    data->images = (Image *)RL_REALLOC(data->images, (data->imageCount + 1)*sizeof(Image));
+    data->textures = (Texture2D **)RL_REALLOC(data->textures, (data->imageCount + 1)*sizeof(Texture2D *));
+    data->images[data->imageCount] = ImageCopy(image);
+    data->textures[data->imageCount] = texture;
+    data->imageCount++;
+}
+
+// Load a material map texture from a file, while loading model data the image is kept for UploadModelData()
+static void LoadMaterialMapTextureFile(ModelData *deferred, Texture2D *texture, const char *fileName)
+{
+    if (deferred == NULL)
+    {
+        *texture = LoadTexture(fileName);
+        return;
+    }
+
+    Image image = LoadImage(fileName);
+    if (image.data != NULL) LoadMaterialMapTexture(deferred, texture, image);
+    UnloadImage(image);
+}
+
 // Load model from generated mesh
 // WARNING: A shallow copy of mesh is generated, passed by value,
 // as long as struct contains pointers to data and some values, we get a copy
@@ -1857,7 +1987,7 @@ bool ExportMesh(Mesh mesh, const char *fileName)
 
 #if defined(SUPPORT_FILEFORMAT_OBJ) || defined(SUPPORT_FILEFORMAT_MTL)
 // Process obj materials
-static void ProcessMaterialsOBJ(Material *rayMaterials, tinyobj_material_t *materials, int materialCount)
+static void ProcessMaterialsOBJ(Material *rayMaterials, tinyobj_material_t *materials, int materialCount, ModelData *deferred)
 {
     // Init model materials
     for (int m = 0; m < materialCount; m++)
@@ -1870,22 +2000,22 @@ static void ProcessMaterialsOBJ(Material *rayMaterials, tinyobj_material_t *mate
         // NOTE: rlgl default texture is a 1x1 pixel UNCOMPRESSED_R8G8B8A8
         rayMaterials[m].maps[MATERIAL_MAP_DIFFUSE].texture = (Texture2D){ rlGetTextureIdDefault(), 1, 1, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
 
-        if (materials[m].diffuse_texname != NULL) rayMaterials[m].maps[MATERIAL_MAP_DIFFUSE].texture = LoadTexture(materials[m].diffuse_texname);  //char *diffuse_texname; // map_Kd
+        if (materials[m].diffuse_texname != NULL) LoadMaterialMapTextureFile(deferred, &rayMaterials[m].maps[MATERIAL_MAP_DIFFUSE].texture, materials[m].diffuse_texname);  //char *diffuse_texname; // map_Kd
 
         rayMaterials[m].maps[MATERIAL_MAP_DIFFUSE].color = (Color){ (unsigned char)(materials[m].diffuse[0]*255.0f), (unsigned char)(materials[m].diffuse[1]*255.0f), (unsigned char)(materials[m].diffuse[2] * 255.0f), 255 }; //float diffuse[3];
         rayMaterials[m].maps[MATERIAL_MAP_DIFFUSE].value = 0.0f;
 
-        if (materials[m].specular_texname != NULL) rayMaterials[m].maps[MATERIAL_MAP_SPECULAR].texture = LoadTexture(materials[m].specular_texname);  //char *specular_texname; // map_Ks
+        if (materials[m].specular_texname != NULL) LoadMaterialMapTextureFile(deferred, &rayMaterials[m].maps[MATERIAL_MAP_SPECULAR].texture, materials[m].specular_texname);  //char *specular_texname; // map_Ks
         rayMaterials[m].maps[MATERIAL_MAP_SPECULAR].color = (Color){ (unsigned char)(materials[m].specular[0]*255.0f), (unsigned char)(materials[m].specular[1]*255.0f), (unsigned char)(materials[m].specular[2] * 255.0f), 255 }; //float specular[3];
         rayMaterials[m].maps[MATERIAL_MAP_SPECULAR].value = 0.0f;
 
-        if (materials[m].bump_texname != NULL) rayMaterials[m].maps[MATERIAL_MAP_NORMAL].texture = LoadTexture(materials[m].bump_texname);  //char *bump_texname; // map_bump, bump
+        if (materials[m].bump_texname != NULL) LoadMaterialMapTextureFile(deferred, &rayMaterials[m].maps[MATERIAL_MAP_NORMAL].texture, materials[m].bump_texname);  //char *bump_texname; // map_bump, bump
         rayMaterials[m].maps[MATERIAL_MAP_NORMAL].color = WHITE;
         rayMaterials[m].maps[MATERIAL_MAP_NORMAL].value = materials[m].shininess;
 
         rayMaterials[m].maps[MATERIAL_MAP_EMISSION].color = (Color){ (unsigned char)(materials[m].emission[0]*255.0f), (unsigned char)(materials[m].emission[1]*255.0f), (unsigned char)(materials[m].emission[2] * 255.0f), 255 }; //float emission[3];
 
-        if (materials[m].displacement_texname != NULL) rayMaterials[m].maps[MATERIAL_MAP_HEIGHT].texture = LoadTexture(materials[m].displacement_texname);  //char *displacement_texname; // disp
+        if (materials[m].displacement_texname != NULL) LoadMaterialMapTextureFile(deferred, &rayMaterials[m].maps[MATERIAL_MAP_HEIGHT].texture, materials[m].displacement_texname);  //char *displacement_texname; // disp
     }
 }
 #endif
@@ -1907,7 +2037,7 @@ Material *LoadMaterials(const char *fileName, int *materialCount)
         if (result != TINYOBJ_SUCCESS) TRACELOG(LOG_WARNING, "MATERIAL: [%s] Failed to parse materials file", fileName);
 
         materials = MemAlloc(count*sizeof(Material));
-        ProcessMaterialsOBJ(materials, mats, count);
+        ProcessMaterialsOBJ(materials, mats, count, NULL);
 
         tinyobj_materials_free(mats, count);
     }
@@ -3902,7 +4032,7 @@ static void BuildPoseFromParentJoints(BoneInfo *bones, int boneCount, Transform
 //  - A mesh is created for every material present in the obj file
 //  - the model.meshCount is therefore the materialCount returned from tinyobj
 //  - the mesh is automatically triangulated by tinyobj
-static Model LoadOBJ(const char *fileName)
+static Model LoadOBJ(const char *fileName, ModelData *deferred)
 {
     Model model = { 0 };
 
@@ -4029,7 +4159,7 @@ static Model LoadOBJ(const char *fileName)
         }
 
         // Init model materials
-        ProcessMaterialsOBJ(model.materials, materials, materialCount);
+        ProcessMaterialsOBJ(model.materials, materials, materialCount, deferred);
 
         tinyobj_attrib_free(&attrib);
         tinyobj_shapes_free(meshes, meshCount);
@@ -4654,6 +4784,26 @@ static ModelAnimation *LoadModelAnimationsIQM(const char *fileName, unsigned int
 #endif
 
 #if defined(SUPPORT_FILEFORMAT_GLTF)
+// Load file data callback for cgltf, external buffers go through LoadFileData() like every other file
+static cgltf_result LoadFileGLTFCallback(const struct cgltf_memory_options *memoryOptions, const struct cgltf_file_options *fileOptions, const char *path, cgltf_size *size, void **data)
+{
+    unsigned int filesize = 0;
+    void *filedata = LoadFileData(path, &filesize);
+
+    if (filedata == NULL) return cgltf_result_io_error;
+
+    *size = filesize;
+    *data = filedata;
+
+    return cgltf_result_success;
+}
+
+// Release file data callback for cgltf
+static void ReleaseFileGLTFCallback(const struct cgltf_memory_options *memoryOptions, const struct cgltf_file_options *fileOptions, void *data)
+{
+    UnloadFileData(data);
+}
+
 // Load image from different glTF provided methods (uri, path, buffer_view)
 static Image LoadImageFromCgltfImage(cgltf_image *cgltfImage, const char *texPath)
 {
@@ -4753,7 +4903,7 @@ static BoneInfo *LoadBoneInfoGLTF(cgltf_skin skin, int *boneCount)
 }
 
 // Load glTF file into model struct, .gltf and .glb supported
-static Model LoadGLTF(const char *fileName)
+static Model LoadGLTF(const char *fileName, ModelData *deferred)
 {
     /*********************************************************************************************
 
@@ -4805,6 +4955,8 @@ static Model LoadGLTF(const char *fileName)
 
     // glTF data loading
     cgltf_options options = { 0 };
+    options.file.read = LoadFileGLTFCallback;
+    options.file.release = ReleaseFileGLTFCallback;
     cgltf_data *data = NULL;
     cgltf_result result = cgltf_parse(&options, fileData, dataSize, &data);
 
@@ -4858,7 +5010,7 @@ static Model LoadGLTF(const char *fileName)
                     Image imAlbedo = LoadImageFromCgltfImage(data->materials[i].pbr_metallic_roughness.base_color_texture.texture->image, texPath);
                     if (imAlbedo.data != NULL)
                     {
-                        model.materials[j].maps[MATERIAL_MAP_ALBEDO].texture = LoadTextureFromImage(imAlbedo);
+                        LoadMaterialMapTexture(deferred, &model.materials[j].maps[MATERIAL_MAP_ALBEDO].texture, imAlbedo);
                         UnloadImage(imAlbedo);
                     }
                 }
@@ -4874,7 +5026,7 @@ static Model LoadGLTF(const char *fileName)
                     Image imMetallicRoughness = LoadImageFromCgltfImage(data->materials[i].pbr_metallic_roughness.metallic_roughness_texture.texture->image, texPath);
                     if (imMetallicRoughness.data != NULL)
                     {
-                        model.materials[j].maps[MATERIAL_MAP_ROUGHNESS].texture = LoadTextureFromImage(imMetallicRoughness);
+                        LoadMaterialMapTexture(deferred, &model.materials[j].maps[MATERIAL_MAP_ROUGHNESS].texture, imMetallicRoughness);
                         UnloadImage(imMetallicRoughness);
                     }
 
@@ -4892,7 +5044,7 @@ static Model LoadGLTF(const char *fileName)
                     Image imNormal = LoadImageFromCgltfImage(data->materials[i].normal_texture.texture->image, texPath);
                     if (imNormal.data != NULL)
                     {
-                        model.materials[j].maps[MATERIAL_MAP_NORMAL].texture = LoadTextureFromImage(imNormal);
+                        LoadMaterialMapTexture(deferred, &model.materials[j].maps[MATERIAL_MAP_NORMAL].texture, imNormal);
                         UnloadImage(imNormal);
                     }
                 }
@@ -4903,7 +5055,7 @@ static Model LoadGLTF(const char *fileName)
                     Image imOcclusion = LoadImageFromCgltfImage(data->materials[i].occlusion_texture.texture->image, texPath);
                     if (imOcclusion.data != NULL)
                     {
-                        model.materials[j].maps[MATERIAL_MAP_OCCLUSION].texture = LoadTextureFromImage(imOcclusion);
+                        LoadMaterialMapTexture(deferred, &model.materials[j].maps[MATERIAL_MAP_OCCLUSION].texture, imOcclusion);
                         UnloadImage(imOcclusion);
                     }
                 }
@@ -4914,7 +5066,7 @@ static Model LoadGLTF(const char *fileName)
                     Image imEmissive = LoadImageFromCgltfImage(data->materials[i].emissive_texture.texture->image, texPath);
                     if (imEmissive.data != NULL)
                     {
-                        model.materials[j].maps[MATERIAL_MAP_EMISSION].texture = LoadTextureFromImage(imEmissive);
+                        LoadMaterialMapTexture(deferred, &model.materials[j].maps[MATERIAL_MAP_EMISSION].texture, imEmissive);
                         UnloadImage(imEmissive);
                     }
 
@@ -5286,6 +5438,8 @@ static ModelAnimation *LoadModelAnimationsGLTF(const char *fileName, unsigned in
 
     // glTF data loading
     cgltf_options options = { 0 };
+    options.file.read = LoadFileGLTFCallback;
+    options.file.release = ReleaseFileGLTFCallback;
     cgltf_data *data = NULL;
     cgltf_result result = cgltf_parse(&options, fileData, dataSize, &data);
 
@@ -5549,7 +5703,7 @@ unsigned char *m3d_loaderhook(char *fn, unsigned int *len) { return LoadFileData
 void m3d_freehook(void *data) { UnloadFileData((unsigned char *)data); }
 
 // Load M3D mesh data
-static Model LoadM3D(const char *fileName)
+static Model LoadM3D(const char *fileName, ModelData *deferred)
 {
     Model model = { 0 };
 
@@ -5768,12 +5922,12 @@ static Model LoadM3D(const char *fileName)
 
                             switch (prop->type)
                             {
-                                case m3dp_map_Kd: model.materials[i + 1].maps[MATERIAL_MAP_DIFFUSE].texture = LoadTextureFromImage(image); break;
-                                case m3dp_map_Ks: model.materials[i + 1].maps[MATERIAL_MAP_SPECULAR].texture = LoadTextureFromImage(image); break;
-                                case m3dp_map_Ke: model.materials[i + 1].maps[MATERIAL_MAP_EMISSION].texture = LoadTextureFromImage(image); break;
-                                case m3dp_map_Km: model.materials[i + 1].maps[MATERIAL_MAP_NORMAL].texture = LoadTextureFromImage(image); break;
-                                case m3dp_map_Ka: model.materials[i + 1].maps[MATERIAL_MAP_OCCLUSION].texture = LoadTextureFromImage(image); break;
-                                case m3dp_map_Pm: model.materials[i + 1].maps[MATERIAL_MAP_ROUGHNESS].texture = LoadTextureFromImage(image); break;
+                                case m3dp_map_Kd: LoadMaterialMapTexture(deferred, &model.materials[i + 1].maps[MATERIAL_MAP_DIFFUSE].texture, image); break;
+                                case m3dp_map_Ks: LoadMaterialMapTexture(deferred, &model.materials[i + 1].maps[MATERIAL_MAP_SPECULAR].texture, image); break;
+                                case m3dp_map_Ke: LoadMaterialMapTexture(deferred, &model.materials[i + 1].maps[MATERIAL_MAP_EMISSION].texture, image); break;
+                                case m3dp_map_Km: LoadMaterialMapTexture(deferred, &model.materials[i + 1].maps[MATERIAL_MAP_NORMAL].texture, image); break;
+                                case m3dp_map_Ka: LoadMaterialMapTexture(deferred, &model.materials[i + 1].maps[MATERIAL_MAP_OCCLUSION].texture, image); break;
+                                case m3dp_map_Pm: LoadMaterialMapTexture(deferred, &model.materials[i + 1].maps[MATERIAL_MAP_ROUGHNESS].texture, image); break;
                                 default: break;
                             }
                         }
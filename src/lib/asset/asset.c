@@ -0,0 +1,761 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE   // asprintf
+#endif
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset/asset.h"
+#include "asset/cache.h"
+#include "job/job.h"
+#include "log/log.h"
+#include "memory/allocator.h"
+#include "time/time.h"
+
+#include "raylib.h"
+#include "rlgl.h"
+
+// an asset is watched through its path and, for shaders, its vertex path
+#define ASSET_FILES             2
+
+typedef union r_asset_resource {
+    Texture2D texture;
+    Model     model;
+    Font      font;
+    Shader    shader;
+    Sound     sound;
+} r_asset_resource;
+
+struct r_asset {
+    char *           path;
+    char *           vertex_path;
+    r_asset_type     type;
+    int              font_size;
+    bool             main_thread;   // the format is loaded whole by the upload
+    uint32_t         refs;
+
+    // set by the update after current, gets read them on any thread
+    r_asset_resource current;
+    _Atomic bool     loaded;
+    _Atomic uint32_t version;
+
+    // raised by the filetracker
+    bool             changed[ASSET_FILES];
+
+    // a decode job owns the asset until it's been uploaded, stale starts another one then
+    bool             decoding;
+    bool             stale;
+
+    r_asset_data     data;
+    bool             decoded;
+    r_asset *        next;
+
+    // residency, the update the asset was last got in and what its version takes
+    _Atomic uint64_t last_used;
+    _Atomic bool     wanted;        // got while it wasn't loaded
+    bool             evicted;
+    uint64_t         bytes;
+};
+
+// versions which draw lists may still refer to
+typedef struct r_asset_retired {
+    r_asset_type     type;
+    r_asset_resource resource;
+    uint64_t         update;
+} r_asset_retired;
+
+static r_filetracker *     filetracker = NULL;
+static r_asset *           assets[MAX_ASSETS];
+static uint32_t            asset_count = 0;
+static pthread_mutex_t     asset_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// decode jobs run on behalf of the host, the assets outlive the modules
+static r_module_properties owner = { .name = "assets" };
+
+// pushed by the decode jobs, taken in order by the update
+static _Atomic(r_asset *)  decoded = NULL;
+static r_asset *           upload_head = NULL;
+static r_asset *           upload_tail = NULL;
+
+static r_asset_retired     retired[MAX_ASSETS * 2];
+static uint32_t            retired_count = 0;
+static _Atomic uint64_t    updates = 0;
+
+// bytes the loaded versions of every type take, and what they may take
+static uint64_t            resident[R_ASSET_TYPE_COUNT];
+static uint64_t            budgets[R_ASSET_TYPE_COUNT] = {
+    [R_ASSET_TEXTURE] = ASSET_TEXTURE_BUDGET,
+    [R_ASSET_MODEL] = ASSET_MODEL_BUDGET,
+    [R_ASSET_SOUND] = ASSET_SOUND_BUDGET,
+};
+static bool                over_budget[R_ASSET_TYPE_COUNT];
+
+static const char *        type_names[R_ASSET_TYPE_COUNT] = { "textures", "models", "fonts", "shaders", "sounds" };
+
+// Decoding
+// --------
+
+// raylib's OBJ loader changes the working directory of the process while it
+// runs, image and BMFont fonts go straight to a texture
+static bool _main_thread_only(const char *path, r_asset_type type) {
+    if (type == R_ASSET_MODEL) {
+        return IsFileExtension(path, ".obj");
+    }
+    return type == R_ASSET_FONT && !IsFileExtension(path, ".ttf") && !IsFileExtension(path, ".otf");
+}
+
+static void _decode_font(r_asset *asset) {
+    unsigned int   size = 0;
+    unsigned char *file = LoadFileData(asset->path, &size);
+    if (file == NULL) {
+        return;
+    }
+
+    asset->data.font.glyphs = LoadFontData(file, (int)size, asset->font_size, NULL, ASSET_FONT_GLYPHS, FONT_DEFAULT);
+    UnloadFileData(file);
+
+    if (asset->data.font.glyphs == NULL) {
+        return;
+    }
+
+    asset->data.font.atlas = GenImageFontAtlas(asset->data.font.glyphs, &asset->data.font.recs,
+        ASSET_FONT_GLYPHS, asset->font_size, ASSET_FONT_PADDING, 0);
+    asset->decoded = asset->data.font.atlas.data != NULL;
+}
+
+static void _decode_file(r_asset *asset) {
+    switch (asset->type) {
+        case R_ASSET_TEXTURE:
+            asset->data.image = LoadImage(asset->path);
+            asset->decoded = asset->data.image.data != NULL;
+            break;
+        case R_ASSET_MODEL:
+            asset->data.model = LoadModelData(asset->path);
+            asset->decoded = asset->data.model.model.meshCount > 0;
+            break;
+        case R_ASSET_FONT:
+            _decode_font(asset);
+            break;
+        case R_ASSET_SHADER:
+            asset->data.shader.fragment = LoadFileText(asset->path);
+            asset->data.shader.vertex = asset->vertex_path ? LoadFileText(asset->vertex_path) : NULL;
+            asset->decoded = asset->data.shader.fragment != NULL && (!asset->vertex_path || asset->data.shader.vertex != NULL);
+            break;
+        case R_ASSET_SOUND:
+            asset->data.wave = LoadWave(asset->path);
+            asset->decoded = asset->data.wave.data != NULL;
+            break;
+        default:
+            break;
+    }
+}
+
+static void _decode(void *data) {
+    r_asset *asset = (r_asset *)data;
+    uint64_t key = 0;
+
+    memset(&asset->data, 0, sizeof(asset->data));
+    asset->decoded = asset->main_thread;
+
+    if (!asset->main_thread && r_asset_cache_enabled(asset->type)) {
+        key = r_asset_cache_key(asset->path, asset->type, asset->font_size);
+        asset->decoded = r_asset_cache_read(key, asset->type, &asset->data);
+    }
+
+    // a miss bakes what the decode produced, along with the other files it read
+    if (!asset->decoded) {
+        r_asset_cache_dependencies dependencies;
+
+        r_asset_cache_capture_begin(&dependencies, asset->path);
+        _decode_file(asset);
+        r_asset_cache_capture_end(&dependencies);
+
+        if (asset->decoded && key) {
+            r_asset_cache_write(key, asset->type, &asset->data, &dependencies);
+        }
+        r_asset_cache_dependencies_free(&dependencies);
+    }
+
+    // hand it to the main thread, a failed decode goes through as well to end the job's ownership
+    r_asset *head = atomic_load(&decoded);
+    do {
+        asset->next = head;
+    } while (!atomic_compare_exchange_weak(&decoded, &head, asset));
+}
+
+static void _decode_start(r_asset *asset) {
+    asset->decoding = true;
+    asset->stale = false;
+    r_job *job = r_job_create(&owner, _decode, asset, NULL);
+
+    // the job system is saturated, decode it here
+    if (job == NULL) {
+        _decode(asset);
+        return;
+    }
+    r_job_run(job);
+}
+
+// free what was decoded but never uploaded
+static void _decode_discard(r_asset *asset) {
+    switch (asset->type) {
+        case R_ASSET_TEXTURE:
+            UnloadImage(asset->data.image);
+            break;
+        case R_ASSET_MODEL:
+            UnloadModelData(asset->data.model);
+            break;
+        case R_ASSET_FONT:
+            UnloadImage(asset->data.font.atlas);
+            if (asset->data.font.glyphs != NULL) {
+                UnloadFontData(asset->data.font.glyphs, ASSET_FONT_GLYPHS);
+            }
+            MemFree(asset->data.font.recs);
+            break;
+        case R_ASSET_SHADER:
+            UnloadFileText(asset->data.shader.fragment);
+            UnloadFileText(asset->data.shader.vertex);
+            break;
+        case R_ASSET_SOUND:
+            UnloadWave(asset->data.wave);
+            break;
+        default:
+            break;
+    }
+
+    memset(&asset->data, 0, sizeof(asset->data));
+}
+
+// Uploading
+// ---------
+
+// upload the decoded data on the main thread, it's consumed either way
+static bool _upload(r_asset *asset, r_asset_resource *resource) {
+    switch (asset->type) {
+        case R_ASSET_TEXTURE:
+            resource->texture = LoadTextureFromImage(asset->data.image);
+            UnloadImage(asset->data.image);
+            return resource->texture.id != 0;
+        case R_ASSET_MODEL:
+            if (asset->main_thread) {
+                asset->data.model = LoadModelData(asset->path);
+
+                if (asset->data.model.model.meshCount == 0) {
+                    UnloadModelData(asset->data.model);
+                    return false;
+                }
+            }
+
+            resource->model = UploadModelData(asset->data.model);
+            return true;
+        case R_ASSET_FONT:
+            if (asset->main_thread) {
+                resource->font = LoadFont(asset->path);
+                return resource->font.texture.id != GetFontDefault().texture.id;
+            }
+
+            resource->font = (Font){
+                .baseSize = asset->font_size,
+                .glyphCount = ASSET_FONT_GLYPHS,
+                .glyphPadding = ASSET_FONT_PADDING,
+                .texture = LoadTextureFromImage(asset->data.font.atlas),
+                .recs = asset->data.font.recs,
+                .glyphs = asset->data.font.glyphs,
+            };
+            UnloadImage(asset->data.font.atlas);
+
+            if (resource->font.texture.id == 0) {
+                UnloadFont(resource->font);
+                return false;
+            }
+            return true;
+        case R_ASSET_SHADER:
+            resource->shader = LoadShaderFromMemory(asset->data.shader.vertex, asset->data.shader.fragment);
+            UnloadFileText(asset->data.shader.fragment);
+            UnloadFileText(asset->data.shader.vertex);
+
+            // raylib falls back on its default shader when compiling fails
+            if (resource->shader.id == rlGetShaderIdDefault()) {
+                UnloadShader(resource->shader);
+                return false;
+            }
+            return true;
+        case R_ASSET_SOUND:
+            resource->sound = LoadSoundFromWave(asset->data.wave);
+            UnloadWave(asset->data.wave);
+            return resource->sound.frameCount > 0;
+        default:
+            return false;
+    }
+}
+
+// UnloadModel() leaves the map textures, the ones UploadModelData() created go here
+static void _unload_model(Model model) {
+    for (int i = 0; i < model.materialCount; i++) {
+        for (int map = 0; map < ASSET_MATERIAL_MAPS; map++) {
+            Texture2D texture = model.materials[i].maps[map].texture;
+
+            if (texture.id != 0 && texture.id != rlGetTextureIdDefault()) {
+                UnloadTexture(texture);
+            }
+        }
+    }
+    UnloadModel(model);
+}
+
+static void _unload(r_asset_type type, r_asset_resource *resource) {
+    switch (type) {
+        case R_ASSET_TEXTURE:
+            UnloadTexture(resource->texture);
+            break;
+        case R_ASSET_MODEL:
+            _unload_model(resource->model);
+            break;
+        case R_ASSET_FONT:
+            UnloadFont(resource->font);
+            break;
+        case R_ASSET_SHADER:
+            UnloadShader(resource->shader);
+            break;
+        case R_ASSET_SOUND:
+            UnloadSound(resource->sound);
+            break;
+        default:
+            break;
+    }
+}
+
+// unload the version once the draw lists of the frame have been replayed
+static void _retire(r_asset *asset) {
+    if (!atomic_load_explicit(&asset->loaded, memory_order_relaxed)) {
+        return;
+    }
+
+    retired[retired_count++] = (r_asset_retired){
+        .type = asset->type,
+        .resource = asset->current,
+        .update = atomic_load(&updates),
+    };
+    resident[asset->type] -= asset->bytes;
+    asset->bytes = 0;
+    atomic_store_explicit(&asset->loaded, false, memory_order_relaxed);
+}
+
+// Residency
+// ---------
+
+static uint64_t _texture_size(Texture2D texture) {
+    uint64_t size = 0;
+    int      width = texture.width, height = texture.height;
+
+    for (int level = 0; level < texture.mipmaps; level++) {
+        size += (uint64_t)GetPixelDataSize(width, height, texture.format);
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    return size;
+}
+
+static uint64_t _mesh_size(const Mesh *mesh) {
+    uint64_t vertices = (uint64_t)mesh->vertexCount;
+    uint64_t size = vertices * 3 * sizeof(float);
+
+    size += mesh->texcoords ? vertices * 2 * sizeof(float) : 0;
+    size += mesh->texcoords2 ? vertices * 2 * sizeof(float) : 0;
+    size += mesh->normals ? vertices * 3 * sizeof(float) : 0;
+    size += mesh->tangents ? vertices * 4 * sizeof(float) : 0;
+    size += mesh->colors ? vertices * 4 : 0;
+    size += mesh->indices ? (uint64_t)mesh->triangleCount * 3 * sizeof(unsigned short) : 0;
+    size += mesh->animVertices ? vertices * 3 * sizeof(float) : 0;
+    size += mesh->animNormals ? vertices * 3 * sizeof(float) : 0;
+    size += mesh->boneIds ? vertices * 4 : 0;
+    size += mesh->boneWeights ? vertices * 4 * sizeof(float) : 0;
+    return size;
+}
+
+// the bytes a version takes, what it holds in VRAM, or in RAM for sounds
+static uint64_t _size(r_asset_type type, const r_asset_resource *resource) {
+    uint64_t size = 0;
+
+    switch (type) {
+        case R_ASSET_TEXTURE:
+            return _texture_size(resource->texture);
+        case R_ASSET_MODEL:
+            for (int i = 0; i < resource->model.meshCount; i++) {
+                size += _mesh_size(&resource->model.meshes[i]);
+            }
+            // the map textures the model brought, not rlgl's default one
+            for (int i = 0; i < resource->model.materialCount; i++) {
+                for (int map = 0; map < ASSET_MATERIAL_MAPS; map++) {
+                    Texture2D texture = resource->model.materials[i].maps[map].texture;
+
+                    if (texture.id != 0 && texture.id != rlGetTextureIdDefault()) {
+                        size += _texture_size(texture);
+                    }
+                }
+            }
+            return size;
+        case R_ASSET_SOUND:
+            return (uint64_t)resource->sound.frameCount * resource->sound.stream.channels * (resource->sound.stream.sampleSize / 8);
+        default:
+            return 0;
+    }
+}
+
+static int _least_recently_used(const void *a, const void *b) {
+    uint64_t left = atomic_load_explicit(&(*(r_asset *const *)a)->last_used, memory_order_relaxed);
+    uint64_t right = atomic_load_explicit(&(*(r_asset *const *)b)->last_used, memory_order_relaxed);
+    return (left > right) - (left < right);
+}
+
+// unload the least recently used versions of the types over their budget
+static void _evict() {
+    uint64_t now = atomic_load(&updates);
+    r_asset *candidates[MAX_ASSETS];
+
+    for (int type = 0; type < R_ASSET_TYPE_COUNT; type++) {
+        if (budgets[type] == 0 || resident[type] <= budgets[type]) {
+            over_budget[type] = false;
+            continue;
+        }
+
+        // what's been used lately stays, evicting it would only bring it back
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < asset_count; i++) {
+            r_asset *asset = assets[i];
+
+            if (asset->type == (r_asset_type)type && atomic_load_explicit(&asset->loaded, memory_order_relaxed) && !asset->decoding &&
+                now - atomic_load_explicit(&asset->last_used, memory_order_relaxed) >= ASSET_EVICT_AFTER) {
+                candidates[count++] = asset;
+            }
+        }
+        qsort(candidates, count, sizeof(r_asset *), _least_recently_used);
+
+        for (uint32_t i = 0; i < count && resident[type] > budgets[type]; i++) {
+            r_log(R_LOG_DEBUG, "asset: evicting %s, unused for %llu updates\n", candidates[i]->path,
+                (unsigned long long)(now - atomic_load_explicit(&candidates[i]->last_used, memory_order_relaxed)));
+
+            _retire(candidates[i]);
+            candidates[i]->evicted = true;
+            atomic_store_explicit(&candidates[i]->wanted, false, memory_order_relaxed);
+        }
+
+        if (resident[type] > budgets[type] && !over_budget[type]) {
+            r_log(R_LOG_WARNING, "asset: the %s in use take %llu MiB, over their budget of %llu MiB\n", type_names[type],
+                (unsigned long long)(resident[type] >> 20), (unsigned long long)(budgets[type] >> 20));
+        }
+        over_budget[type] = resident[type] > budgets[type];
+    }
+}
+
+static void _unload_retired(bool all) {
+    uint32_t kept = 0;
+
+    for (uint32_t i = 0; i < retired_count; i++) {
+        if (all || retired[i].update < atomic_load(&updates)) {
+            _unload(retired[i].type, &retired[i].resource);
+        } else {
+            retired[kept++] = retired[i];
+        }
+    }
+    retired_count = kept;
+}
+
+// Assets
+// ------
+
+static void _asset_free(r_asset *asset) {
+    if (filetracker != NULL) {
+        r_filetracker_remove_file(filetracker, &asset->changed[0]);
+        r_filetracker_remove_file(filetracker, &asset->changed[1]);
+    }
+
+    free(asset->path);
+    free(asset->vertex_path);
+    FREE(r_asset, asset);
+}
+
+// take the asset out of the table, the lock is held
+static void _asset_remove(r_asset *asset) {
+    for (uint32_t i = 0; i < asset_count; i++) {
+        if (assets[i] == asset) {
+            assets[i] = assets[--asset_count];
+            break;
+        }
+    }
+
+    _retire(asset);
+    _asset_free(asset);
+}
+
+static bool _asset_matches(r_asset *asset, const char *path, r_asset_type type, int font_size, const char *vertex_path) {
+    if (asset->type != type || asset->font_size != font_size || strcmp(asset->path, path) != 0) {
+        return false;
+    }
+
+    if (asset->vertex_path == NULL || vertex_path == NULL) {
+        return asset->vertex_path == vertex_path;
+    }
+    return strcmp(asset->vertex_path, vertex_path) == 0;
+}
+
+bool r_asset_create(r_filetracker *tracker) {
+    filetracker = tracker;
+    asset_count = 0;
+    retired_count = 0;
+    atomic_store(&updates, 0);
+    memset(resident, 0, sizeof(resident));
+    memset(over_budget, 0, sizeof(over_budget));
+    upload_head = upload_tail = NULL;
+    atomic_store(&decoded, NULL);
+
+    // without a cache every load decodes
+    r_asset_cache_create(ASSET_CACHE_DIRECTORY);
+    return true;
+}
+
+void r_asset_destroy() {
+    // the jobs still decoding hold on to their assets
+    r_job_drain(&owner);
+    r_asset_cache_destroy();
+
+    pthread_mutex_lock(&asset_lock);
+
+    r_asset *list = atomic_exchange(&decoded, NULL);
+    for (; list != NULL; list = list->next) {
+        _decode_discard(list);
+    }
+    for (r_asset *asset = upload_head; asset != NULL; asset = asset->next) {
+        _decode_discard(asset);
+    }
+    upload_head = upload_tail = NULL;
+
+    for (uint32_t i = 0; i < asset_count; i++) {
+        _retire(assets[i]);
+        _asset_free(assets[i]);
+    }
+    asset_count = 0;
+    _unload_retired(true);
+
+    // assets released later on have nothing to release
+    filetracker = NULL;
+
+    pthread_mutex_unlock(&asset_lock);
+}
+
+r_asset * r_asset_load(r_module_properties *props, const char *path, r_asset_type type, const r_asset_options *options) {
+    int         font_size = 0;
+    const char *vertex_path = NULL;
+
+    if (type == R_ASSET_FONT) {
+        font_size = options && options->font_size > 0 ? options->font_size : ASSET_FONT_DEFAULT_SIZE;
+    } else if (type == R_ASSET_SHADER && options) {
+        vertex_path = options->vertex_path;
+    }
+
+    pthread_mutex_lock(&asset_lock);
+
+    for (uint32_t i = 0; i < asset_count; i++) {
+        if (_asset_matches(assets[i], path, type, font_size, vertex_path)) {
+            assets[i]->refs++;
+            pthread_mutex_unlock(&asset_lock);
+            return assets[i];
+        }
+    }
+
+    if (asset_count == MAX_ASSETS || filetracker == NULL) {
+        pthread_mutex_unlock(&asset_lock);
+        r_log(R_LOG_ERROR, "asset: unable to load %s for %s\n", path, props ? props->name : "host");
+        return NULL;
+    }
+
+    r_asset *asset = MALLOC(r_asset, 1);
+    memset(asset, 0, sizeof(r_asset));
+    asprintf(&asset->path, "%s", path);
+    if (vertex_path) {
+        asprintf(&asset->vertex_path, "%s", vertex_path);
+    }
+    asset->type = type;
+    asset->font_size = font_size;
+    asset->main_thread = _main_thread_only(path, type);
+    asset->refs = 1;
+
+    r_filetracker_add_file(filetracker, asset->path, &asset->changed[0]);
+    if (asset->vertex_path) {
+        r_filetracker_add_file(filetracker, asset->vertex_path, &asset->changed[1]);
+    }
+
+    assets[asset_count++] = asset;
+    _decode_start(asset);
+
+    pthread_mutex_unlock(&asset_lock);
+    return asset;
+}
+
+void r_asset_release(r_asset *asset) {
+    if (asset == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&asset_lock);
+
+    // the host has already let go of everything
+    if (filetracker == NULL) {
+        pthread_mutex_unlock(&asset_lock);
+        return;
+    }
+
+    // a decoding asset is removed by the update once the job hands it back
+    if (--asset->refs == 0 && !asset->decoding) {
+        _asset_remove(asset);
+    }
+
+    pthread_mutex_unlock(&asset_lock);
+}
+
+const void * r_asset_get(r_asset *asset, uint32_t *version) {
+    if (version) {
+        *version = asset ? atomic_load_explicit(&asset->version, memory_order_relaxed) : 0;
+    }
+    if (asset == NULL) {
+        return NULL;
+    }
+
+    atomic_store_explicit(&asset->last_used, atomic_load_explicit(&updates, memory_order_relaxed), memory_order_relaxed);
+
+    // an evicted asset is reloaded by the next update
+    if (!atomic_load_explicit(&asset->loaded, memory_order_acquire)) {
+        atomic_store_explicit(&asset->wanted, true, memory_order_relaxed);
+        return NULL;
+    }
+    return &asset->current;
+}
+
+void r_asset_set_budget(r_asset_type type, uint64_t bytes) {
+    pthread_mutex_lock(&asset_lock);
+    budgets[type] = bytes;
+    pthread_mutex_unlock(&asset_lock);
+}
+
+uint64_t r_asset_resident(r_asset_type type) {
+    pthread_mutex_lock(&asset_lock);
+    uint64_t bytes = resident[type];
+    pthread_mutex_unlock(&asset_lock);
+    return bytes;
+}
+
+uint32_t r_asset_retiring() {
+    pthread_mutex_lock(&asset_lock);
+    uint32_t count = retired_count;
+    pthread_mutex_unlock(&asset_lock);
+    return count;
+}
+
+void r_asset_update(uint64_t budget_ns) {
+    pthread_mutex_lock(&asset_lock);
+
+    _unload_retired(false);
+
+    // start decoding what changed on disk, it's picked up again after the running decode
+    for (uint32_t i = 0; i < asset_count; i++) {
+        r_asset *asset = assets[i];
+        bool     changed = asset->changed[0] || asset->changed[1];
+
+        asset->changed[0] = asset->changed[1] = false;
+
+        // an evicted asset is read again once it's wanted, with whatever changed meanwhile
+        if (asset->evicted) {
+            if (atomic_exchange(&asset->wanted, false) && !asset->decoding) {
+                _decode_start(asset);
+            }
+            continue;
+        }
+
+        if (!changed) {
+            continue;
+        }
+
+        if (asset->decoding) {
+            asset->stale = true;
+        } else {
+            _decode_start(asset);
+        }
+    }
+
+    // the jobs push on the front, the uploads go in the order the decodes finished
+    r_asset *list = atomic_exchange(&decoded, NULL);
+    r_asset *reversed = NULL;
+    while (list != NULL) {
+        r_asset *next = list->next;
+        list->next = reversed;
+        reversed = list;
+        list = next;
+    }
+    if (reversed != NULL) {
+        if (upload_tail != NULL) {
+            upload_tail->next = reversed;
+        } else {
+            upload_head = reversed;
+        }
+        for (upload_tail = reversed; upload_tail->next != NULL; upload_tail = upload_tail->next);
+    }
+
+    uint64_t start = r_time_now_ns();
+    uint32_t uploaded = 0;
+
+    // upload at least one asset so a small budget still makes progress
+    while (upload_head != NULL && (uploaded == 0 || r_time_now_ns() - start < budget_ns)) {
+        r_asset *asset = upload_head;
+        upload_head = asset->next;
+        upload_tail = upload_head ? upload_tail : NULL;
+        asset->next = NULL;
+        asset->decoding = false;
+        uploaded++;
+
+        if (asset->refs == 0) {
+            _decode_discard(asset);
+            _asset_remove(asset);
+            continue;
+        }
+
+        r_asset_resource resource;
+        if (!asset->decoded) {
+            _decode_discard(asset);
+            r_log(R_LOG_WARNING, "asset: unable to decode %s, keeping version %u\n", asset->path, atomic_load_explicit(&asset->version, memory_order_relaxed));
+        } else if (!_upload(asset, &resource)) {
+            r_log(R_LOG_WARNING, "asset: unable to upload %s, keeping version %u\n", asset->path, atomic_load_explicit(&asset->version, memory_order_relaxed));
+        } else {
+            bool evicted = asset->evicted;
+
+            _retire(asset);
+            asset->current = resource;
+            uint32_t version = atomic_fetch_add_explicit(&asset->version, 1, memory_order_relaxed) + 1;
+            atomic_store_explicit(&asset->loaded, true, memory_order_release);
+
+            // a version counts as used when it arrives, or it could be evicted before anyone got it
+            asset->bytes = _size(asset->type, &resource);
+            resident[asset->type] += asset->bytes;
+            atomic_store_explicit(&asset->last_used, atomic_load(&updates), memory_order_relaxed);
+
+            if (version > 1 && !evicted) {
+                r_log(R_LOG_INFO, "asset: reloaded %s, version %u\n", asset->path, version);
+            }
+        }
+        memset(&asset->data, 0, sizeof(asset->data));
+
+        // an evicted asset which can't be read again waits for its file to change, like a failed load
+        asset->evicted = false;
+
+        if (asset->stale) {
+            _decode_start(asset);
+        }
+    }
+
+    _evict();
+
+    updates++;
+    pthread_mutex_unlock(&asset_lock);
+}
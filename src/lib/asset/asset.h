@@ -0,0 +1,59 @@
+#ifndef _ASSET_H_
+#define _ASSET_H_
+
+// r_asset keeps raylib resources behind handles which follow their files.
+//
+// Loading an asset, and reloading it when the filetracker reports one of its
+// files changed, decodes it on a job worker: images, model data, wave data,
+// rasterised font glyphs and shader sources. What needs the GL context, the
+// texture, mesh, shader and sound uploads, happens on the main thread in
+// r_asset_update, which takes decoded assets in order until the frame's upload
+// budget is spent. A new version replaces the current one in the handle, the
+// old one is unloaded a frame later, once the draw lists which refer to it
+// have been replayed. A version which fails to decode or upload is dropped and
+// the handle keeps the current one.
+//
+// Decodes go through the baked cache (asset/cache.h) first: a file decoded
+// before is copied out of its entry instead of being parsed. OBJ models and
+// image or BMFont fonts are loaded whole by the upload, raylib's loaders for
+// them change the working directory or create the texture as they go.
+//
+// Textures, models and sounds are kept within a byte budget per type. Every
+// get() marks the asset used in the current update. When a type is over its
+// budget, the update evicts the versions which have gone unused longest,
+// sparing those used in the last ASSET_EVICT_AFTER updates. An evicted
+// asset's get() returns NULL and asks for it again: the next update decodes
+// it, from the cache when it's there, and uploads it like a first load.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "filetracker/filetracker.h"
+#include "module/interface.h"
+
+#define MAX_ASSETS               1024
+#define ASSET_UPLOAD_BUDGET_NS   (2 * 1000000ull)
+
+// residency budgets, the bytes the loaded versions of a type take in VRAM, or RAM for sounds
+#define ASSET_TEXTURE_BUDGET     (512ull << 20)
+#define ASSET_MODEL_BUDGET       (256ull << 20)
+#define ASSET_SOUND_BUDGET       (128ull << 20)
+#define ASSET_EVICT_AFTER        120
+
+bool r_asset_create(r_filetracker *filetracker);
+void r_asset_destroy();
+
+r_asset *    r_asset_load(r_module_properties *props, const char *path, r_asset_type type, const r_asset_options *options);
+void         r_asset_release(r_asset *asset);
+const void * r_asset_get(r_asset *asset, uint32_t *version);
+
+// start reloading what changed, upload what's been decoded within budget_ns and unload retired versions
+void r_asset_update(uint64_t budget_ns);
+
+// 0 lets the type take what it needs, fonts and shaders have no budget by default
+void     r_asset_set_budget(r_asset_type type, uint64_t bytes);
+uint64_t r_asset_resident(r_asset_type type);
+// replaced or evicted versions waiting for the next update to be unloaded
+uint32_t r_asset_retiring();
+
+#endif
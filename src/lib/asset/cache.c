@@ -0,0 +1,1088 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE   // asprintf
+#endif
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "asset/cache.h"
+#include "io/io.h"
+#include "log/log.h"
+#include "memory/allocator.h"
+
+#include "rlgl.h"
+
+#define ASSET_CACHE_MESH_ARRAYS   11
+
+// the blobs every entry starts with
+#define ASSET_CACHE_BLOB_FILES    0
+#define ASSET_CACHE_BLOB_INFO     1
+
+#define ALIGN(size) (((size) + ASSET_CACHE_ALIGNMENT - 1) & ~(uint64_t)(ASSET_CACHE_ALIGNMENT - 1))
+
+typedef struct r_asset_cache_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t type;
+    uint32_t blob_count;
+    uint64_t key;
+    uint64_t size;
+} r_asset_cache_header;
+
+typedef struct r_asset_cache_blob {
+    uint64_t offset;
+    uint64_t size;
+} r_asset_cache_blob;
+
+// a dependency, the path follows it and is padded to 8 bytes
+typedef struct r_asset_cache_file {
+    uint64_t hash;
+    uint32_t length;
+    uint32_t reserved;
+} r_asset_cache_file;
+
+typedef struct r_asset_cache_image {
+    int32_t width;
+    int32_t height;
+    int32_t mipmaps;
+    int32_t format;
+} r_asset_cache_image;
+
+typedef struct r_asset_cache_wave {
+    uint32_t frame_count;
+    uint32_t sample_rate;
+    uint32_t sample_size;
+    uint32_t channels;
+} r_asset_cache_wave;
+
+typedef struct r_asset_cache_glyph {
+    int32_t             value;
+    int32_t             offset_x;
+    int32_t             offset_y;
+    int32_t             advance_x;
+    r_asset_cache_image image;
+} r_asset_cache_glyph;
+
+// followed by the glyphs, the recs, the atlas pixels, then the pixels of every glyph
+typedef struct r_asset_cache_font {
+    int32_t             glyph_count;
+    int32_t             reserved;
+    r_asset_cache_image atlas;
+} r_asset_cache_font;
+
+typedef enum r_asset_cache_map_texture {
+    R_ASSET_CACHE_MAP_NONE,
+    R_ASSET_CACHE_MAP_DEFAULT,     // rlgl's default texture
+    R_ASSET_CACHE_MAP_IMAGE,       // one of the model's images
+} r_asset_cache_map_texture;
+
+typedef struct r_asset_cache_map {
+    uint8_t color[4];
+    float   value;
+    int32_t texture;
+} r_asset_cache_map;
+
+typedef struct r_asset_cache_material {
+    float             params[4];
+    r_asset_cache_map maps[ASSET_MATERIAL_MAPS];
+} r_asset_cache_material;
+
+typedef struct r_asset_cache_mesh {
+    int32_t vertex_count;
+    int32_t triangle_count;
+} r_asset_cache_mesh;
+
+typedef struct r_asset_cache_model_image {
+    int32_t             material;
+    int32_t             map;
+    r_asset_cache_image image;
+} r_asset_cache_model_image;
+
+// followed by the meshes, materials, mesh materials, bones, bind pose and image
+// descriptions, then the vertex arrays of every mesh and the pixels of every image
+typedef struct r_asset_cache_model {
+    int32_t mesh_count;
+    int32_t material_count;
+    int32_t bone_count;
+    int32_t image_count;
+} r_asset_cache_model;
+
+// the blobs an entry is written from
+typedef struct r_asset_cache_source {
+    const void * data;
+    uint64_t     size;
+} r_asset_cache_source;
+
+typedef struct r_asset_cache_writer {
+    r_asset_cache_source * blobs;
+    uint32_t               count;
+    uint32_t               capacity;
+} r_asset_cache_writer;
+
+// an entry file found by the prune
+typedef struct r_asset_cache_stored {
+    char            name[32];
+    uint64_t        size;
+    struct timespec used;
+} r_asset_cache_stored;
+
+// a mapped entry
+typedef struct r_asset_cache_entry {
+    const uint8_t *            base;
+    uint64_t                   size;
+    const r_asset_cache_blob * blobs;
+    uint32_t                   count;
+} r_asset_cache_entry;
+
+static char *           directory = NULL;
+static _Atomic uint64_t written = 0;
+static _Atomic uint64_t hits = 0;
+static _Atomic uint64_t misses = 0;
+
+static const uint8_t padding[ASSET_CACHE_ALIGNMENT] = { 0 };
+
+// Hashing
+// -------
+
+// xxh64, the keys hash every byte of the asset files so it has to keep up with the disk
+#define PRIME64_1 0x9e3779b185ebca87ull
+#define PRIME64_2 0xc2b2ae3d27d4eb4full
+#define PRIME64_3 0x165667b19e3779f9ull
+#define PRIME64_4 0x85ebca77c2b2ae63ull
+#define PRIME64_5 0x27d4eb2f165667c5ull
+
+static inline uint64_t _rotl(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline uint64_t _read64(const uint8_t *bytes) {
+    uint64_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+static inline uint32_t _read32(const uint8_t *bytes) {
+    uint32_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+static inline uint64_t _round(uint64_t acc, uint64_t input) {
+    acc += input * PRIME64_2;
+    return _rotl(acc, 31) * PRIME64_1;
+}
+
+static inline uint64_t _merge(uint64_t acc, uint64_t value) {
+    acc ^= _round(0, value);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+uint64_t r_asset_cache_hash(const void *data, size_t size, uint64_t seed) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    const uint8_t *end = bytes + size;
+    uint64_t       hash;
+
+    if (size >= 32) {
+        uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+        uint64_t v2 = seed + PRIME64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME64_1;
+
+        for (; bytes + 32 <= end; bytes += 32) {
+            v1 = _round(v1, _read64(bytes));
+            v2 = _round(v2, _read64(bytes + 8));
+            v3 = _round(v3, _read64(bytes + 16));
+            v4 = _round(v4, _read64(bytes + 24));
+        }
+
+        hash = _rotl(v1, 1) + _rotl(v2, 7) + _rotl(v3, 12) + _rotl(v4, 18);
+        hash = _merge(hash, v1);
+        hash = _merge(hash, v2);
+        hash = _merge(hash, v3);
+        hash = _merge(hash, v4);
+    } else {
+        hash = seed + PRIME64_5;
+    }
+
+    hash += size;
+
+    for (; bytes + 8 <= end; bytes += 8) {
+        hash ^= _round(0, _read64(bytes));
+        hash = _rotl(hash, 27) * PRIME64_1 + PRIME64_4;
+    }
+    if (bytes + 4 <= end) {
+        hash ^= _read32(bytes) * PRIME64_1;
+        hash = _rotl(hash, 23) * PRIME64_2 + PRIME64_3;
+        bytes += 4;
+    }
+    for (; bytes < end; bytes++) {
+        hash ^= *bytes * PRIME64_5;
+        hash = _rotl(hash, 11) * PRIME64_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+// hash a file's content, false when it can't be read
+static bool _hash_file(const char *path, uint64_t seed, uint64_t *hash) {
+    unsigned int   size = 0;
+    unsigned char *data = LoadFileData(path, &size);
+
+    if (data == NULL) {
+        return false;
+    }
+
+    *hash = r_asset_cache_hash(data, size, seed);
+    UnloadFileData(data);
+    return true;
+}
+
+// Sizes
+// -----
+
+static uint64_t _image_size(int width, int height, int mipmaps, int format) {
+    uint64_t size = 0;
+
+    for (int level = 0; level < mipmaps; level++) {
+        size += (uint64_t)GetPixelDataSize(width, height, format);
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    return size;
+}
+
+static r_asset_cache_image _image_describe(Image image) {
+    return (r_asset_cache_image){
+        .width = image.width,
+        .height = image.height,
+        .mipmaps = image.mipmaps,
+        .format = image.format,
+    };
+}
+
+// the vertex arrays of a mesh and the bytes they hold
+static void _mesh_arrays(Mesh *mesh, void **arrays[ASSET_CACHE_MESH_ARRAYS], uint64_t sizes[ASSET_CACHE_MESH_ARRAYS]) {
+    uint64_t vertices = (uint64_t)(mesh->vertexCount > 0 ? mesh->vertexCount : 0);
+    uint64_t triangles = (uint64_t)(mesh->triangleCount > 0 ? mesh->triangleCount : 0);
+
+    void **mesh_arrays[ASSET_CACHE_MESH_ARRAYS] = {
+        (void **)&mesh->vertices, (void **)&mesh->texcoords, (void **)&mesh->texcoords2,
+        (void **)&mesh->normals, (void **)&mesh->tangents, (void **)&mesh->colors,
+        (void **)&mesh->indices, (void **)&mesh->animVertices, (void **)&mesh->animNormals,
+        (void **)&mesh->boneIds, (void **)&mesh->boneWeights,
+    };
+    uint64_t mesh_sizes[ASSET_CACHE_MESH_ARRAYS] = {
+        vertices * 3 * sizeof(float), vertices * 2 * sizeof(float), vertices * 2 * sizeof(float),
+        vertices * 3 * sizeof(float), vertices * 4 * sizeof(float), vertices * 4,
+        triangles * 3 * sizeof(unsigned short), vertices * 3 * sizeof(float), vertices * 3 * sizeof(float),
+        vertices * 4, vertices * 4 * sizeof(float),
+    };
+
+    memcpy(arrays, mesh_arrays, sizeof(mesh_arrays));
+    memcpy(sizes, mesh_sizes, sizeof(mesh_sizes));
+}
+
+// Writing
+// -------
+
+static void _add(r_asset_cache_writer *writer, const void *data, uint64_t size) {
+    if (writer->count == writer->capacity) {
+        uint32_t              capacity = writer->capacity ? writer->capacity * 2 : 16;
+        r_asset_cache_source *grown = MALLOC(r_asset_cache_source, capacity);
+
+        if (writer->blobs != NULL) {
+            memcpy(grown, writer->blobs, writer->count * sizeof(r_asset_cache_source));
+            FREE(r_asset_cache_source, writer->blobs);
+        }
+        writer->blobs = grown;
+        writer->capacity = capacity;
+    }
+
+    writer->blobs[writer->count++] = (r_asset_cache_source){ .data = data, .size = data ? size : 0 };
+}
+
+static uint8_t * _files_blob(const r_asset_cache_dependencies *dependencies, uint64_t *size) {
+    *size = 0;
+    for (uint32_t i = 0; i < dependencies->count; i++) {
+        *size += sizeof(r_asset_cache_file) + ((strlen(dependencies->files[i].path) + 7) & ~(size_t)7);
+    }
+
+    uint8_t *blob = MALLOC(uint8_t, (*size + 1));
+    memset(blob, 0, *size + 1);
+
+    uint8_t *cursor = blob;
+    for (uint32_t i = 0; i < dependencies->count; i++) {
+        r_asset_cache_file file = {
+            .hash = dependencies->files[i].hash,
+            .length = (uint32_t)strlen(dependencies->files[i].path),
+            .reserved = 0,
+        };
+
+        memcpy(cursor, &file, sizeof(file));
+        memcpy(cursor + sizeof(file), dependencies->files[i].path, file.length);
+        cursor += sizeof(file) + ((file.length + 7) & ~(uint32_t)7);
+    }
+    return blob;
+}
+
+static bool _write_entry(uint64_t key, r_asset_type type, r_asset_cache_writer *writer) {
+    r_asset_cache_blob *blobs = MALLOC(r_asset_cache_blob, writer->count);
+    uint64_t            offset = ALIGN(sizeof(r_asset_cache_header) + writer->count * sizeof(r_asset_cache_blob));
+
+    for (uint32_t i = 0; i < writer->count; i++) {
+        blobs[i] = (r_asset_cache_blob){ .offset = offset, .size = writer->blobs[i].size };
+        offset = ALIGN(offset + writer->blobs[i].size);
+    }
+
+    r_asset_cache_header header = {
+        .magic = ASSET_CACHE_MAGIC,
+        .version = ASSET_CACHE_VERSION,
+        .type = (uint32_t)type,
+        .blob_count = writer->count,
+        .key = key,
+        .size = offset,
+    };
+
+    // written next to the entry and renamed over it, readers never see half an entry
+    char path[PATH_MAX], temporary[PATH_MAX];
+    int  length = snprintf(path, sizeof(path), "%s/%016llx.asset", directory, (unsigned long long)key);
+    int  temporary_length = snprintf(temporary, sizeof(temporary), "%s.%d.%lx", path, (int)getpid(), (unsigned long)pthread_self());
+
+    FILE *file = NULL;
+    if (length >= (int)sizeof(path) || temporary_length >= (int)sizeof(temporary)) {
+        errno = ENAMETOOLONG;
+    } else {
+        file = fopen(temporary, "wb");
+    }
+    if (file == NULL) {
+        r_log(R_LOG_WARNING, "asset: unable to write to the cache: %s\n", strerror(errno));
+        FREE(r_asset_cache_blob, blobs);
+        return false;
+    }
+
+    bool     ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  fwrite(blobs, sizeof(r_asset_cache_blob), writer->count, file) == writer->count;
+    uint64_t position = sizeof(header) + writer->count * sizeof(r_asset_cache_blob);
+
+    for (uint32_t i = 0; ok && i < writer->count; i++) {
+        ok = fwrite(padding, 1, blobs[i].offset - position, file) == blobs[i].offset - position &&
+             (blobs[i].size == 0 || fwrite(writer->blobs[i].data, 1, blobs[i].size, file) == blobs[i].size);
+        position = blobs[i].offset + blobs[i].size;
+    }
+    ok = ok && fwrite(padding, 1, header.size - position, file) == header.size - position;
+    ok = fclose(file) == 0 && ok;
+
+    if (ok && rename(temporary, path) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        unlink(temporary);
+        r_log(R_LOG_WARNING, "asset: unable to write to the cache: %s\n", path);
+    }
+
+    FREE(r_asset_cache_blob, blobs);
+    return ok;
+}
+
+static void _add_image(r_asset_cache_writer *writer, Image image) {
+    _add(writer, image.data, _image_size(image.width, image.height, image.mipmaps, image.format));
+}
+
+static bool _write_model(r_asset_cache_writer *writer, const ModelData *data, void **scratch) {
+    const Model *model = &data->model;
+
+    r_asset_cache_model *         info = MALLOC(r_asset_cache_model, 1);
+    r_asset_cache_mesh *          meshes = MALLOC(r_asset_cache_mesh, (model->meshCount + 1));
+    r_asset_cache_material *      materials = MALLOC(r_asset_cache_material, (model->materialCount + 1));
+    r_asset_cache_model_image *   images = MALLOC(r_asset_cache_model_image, (data->imageCount + 1));
+
+    scratch[0] = info;
+    scratch[1] = meshes;
+    scratch[2] = materials;
+    scratch[3] = images;
+
+    *info = (r_asset_cache_model){
+        .mesh_count = model->meshCount,
+        .material_count = model->materialCount,
+        .bone_count = model->boneCount,
+        .image_count = data->imageCount,
+    };
+
+    for (int i = 0; i < model->meshCount; i++) {
+        meshes[i] = (r_asset_cache_mesh){ .vertex_count = model->meshes[i].vertexCount, .triangle_count = model->meshes[i].triangleCount };
+    }
+
+    // the textures of the maps are either rlgl's default one or deferred images
+    memset(materials, 0, sizeof(r_asset_cache_material) * (model->materialCount + 1));
+    for (int i = 0; i < model->materialCount; i++) {
+        memcpy(materials[i].params, model->materials[i].params, sizeof(materials[i].params));
+
+        for (int map = 0; map < ASSET_MATERIAL_MAPS; map++) {
+            MaterialMap *source = &model->materials[i].maps[map];
+
+            materials[i].maps[map] = (r_asset_cache_map){
+                .color = { source->color.r, source->color.g, source->color.b, source->color.a },
+                .value = source->value,
+                .texture = source->texture.id == rlGetTextureIdDefault() ? R_ASSET_CACHE_MAP_DEFAULT : R_ASSET_CACHE_MAP_NONE,
+            };
+        }
+    }
+
+    for (int i = 0; i < data->imageCount; i++) {
+        images[i] = (r_asset_cache_model_image){ .material = -1, .map = -1, .image = _image_describe(data->images[i]) };
+
+        for (int material = 0; material < model->materialCount && images[i].material < 0; material++) {
+            for (int map = 0; map < ASSET_MATERIAL_MAPS; map++) {
+                if (data->textures[i] == &model->materials[material].maps[map].texture) {
+                    images[i].material = material;
+                    images[i].map = map;
+                    materials[material].maps[map].texture = R_ASSET_CACHE_MAP_IMAGE;
+                    break;
+                }
+            }
+        }
+
+        // an image which doesn't belong to a map can't be put back
+        if (images[i].material < 0) {
+            return false;
+        }
+    }
+
+    _add(writer, info, sizeof(r_asset_cache_model));
+    _add(writer, meshes, sizeof(r_asset_cache_mesh) * model->meshCount);
+    _add(writer, materials, sizeof(r_asset_cache_material) * model->materialCount);
+    _add(writer, model->meshMaterial, sizeof(int) * model->meshCount);
+    _add(writer, model->bones, sizeof(BoneInfo) * model->boneCount);
+    _add(writer, model->bindPose, sizeof(Transform) * model->boneCount);
+    _add(writer, images, sizeof(r_asset_cache_model_image) * data->imageCount);
+
+    for (int i = 0; i < model->meshCount; i++) {
+        void **  arrays[ASSET_CACHE_MESH_ARRAYS];
+        uint64_t sizes[ASSET_CACHE_MESH_ARRAYS];
+
+        _mesh_arrays(&model->meshes[i], arrays, sizes);
+        for (int array = 0; array < ASSET_CACHE_MESH_ARRAYS; array++) {
+            _add(writer, *arrays[array], sizes[array]);
+        }
+    }
+
+    for (int i = 0; i < data->imageCount; i++) {
+        _add_image(writer, data->images[i]);
+    }
+    return true;
+}
+
+static bool _write_font(r_asset_cache_writer *writer, const r_asset_data *data, void **scratch) {
+    r_asset_cache_font * info = MALLOC(r_asset_cache_font, 1);
+    r_asset_cache_glyph *glyphs = MALLOC(r_asset_cache_glyph, ASSET_FONT_GLYPHS);
+
+    scratch[0] = info;
+    scratch[1] = glyphs;
+
+    *info = (r_asset_cache_font){
+        .glyph_count = ASSET_FONT_GLYPHS,
+        .reserved = 0,
+        .atlas = _image_describe(data->font.atlas),
+    };
+
+    for (int i = 0; i < ASSET_FONT_GLYPHS; i++) {
+        GlyphInfo *glyph = &data->font.glyphs[i];
+
+        glyphs[i] = (r_asset_cache_glyph){
+            .value = glyph->value,
+            .offset_x = glyph->offsetX,
+            .offset_y = glyph->offsetY,
+            .advance_x = glyph->advanceX,
+            .image = _image_describe(glyph->image),
+        };
+    }
+
+    _add(writer, info, sizeof(r_asset_cache_font));
+    _add(writer, glyphs, sizeof(r_asset_cache_glyph) * ASSET_FONT_GLYPHS);
+    _add(writer, data->font.recs, sizeof(Rectangle) * ASSET_FONT_GLYPHS);
+    _add_image(writer, data->font.atlas);
+
+    for (int i = 0; i < ASSET_FONT_GLYPHS; i++) {
+        _add_image(writer, data->font.glyphs[i].image);
+    }
+    return true;
+}
+
+// Reading
+// -------
+
+static bool _map(uint64_t key, r_asset_type type, r_asset_cache_entry *entry) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%016llx.asset", directory, (unsigned long long)key);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat statbuf;
+    if (fstat(fd, &statbuf) != 0 || (uint64_t)statbuf.st_size < sizeof(r_asset_cache_header)) {
+        close(fd);
+        return false;
+    }
+
+    // the prune keeps the entries used most recently
+    futimens(fd, NULL);
+
+    void *base = mmap(NULL, statbuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    *entry = (r_asset_cache_entry){
+        .base = (const uint8_t *)base,
+        .size = (uint64_t)statbuf.st_size,
+        .blobs = (const r_asset_cache_blob *)((const uint8_t *)base + sizeof(r_asset_cache_header)),
+        .count = 0,
+    };
+
+    // an entry from another version, or which was cut short, is written again
+    const r_asset_cache_header *header = (const r_asset_cache_header *)base;
+    bool valid = header->magic == ASSET_CACHE_MAGIC && header->version == ASSET_CACHE_VERSION &&
+                 header->type == (uint32_t)type && header->key == key && header->size == entry->size &&
+                 header->blob_count > ASSET_CACHE_BLOB_INFO &&
+                 header->blob_count <= (entry->size - sizeof(r_asset_cache_header)) / sizeof(r_asset_cache_blob);
+
+    for (uint32_t i = 0; valid && i < header->blob_count; i++) {
+        valid = entry->blobs[i].offset <= entry->size && entry->blobs[i].size <= entry->size - entry->blobs[i].offset;
+    }
+
+    if (!valid) {
+        munmap(base, statbuf.st_size);
+        return false;
+    }
+
+    entry->count = header->blob_count;
+    return true;
+}
+
+static void _unmap(r_asset_cache_entry *entry) {
+    munmap((void *)entry->base, entry->size);
+}
+
+// the blob at index when it holds size bytes, size 0 takes any
+static const void * _blob(const r_asset_cache_entry *entry, uint32_t index, uint64_t size) {
+    if (index >= entry->count || (size && entry->blobs[index].size != size)) {
+        return NULL;
+    }
+    return entry->base + entry->blobs[index].offset;
+}
+
+// a copy raylib owns, NULL for an empty blob
+static void * _copy(const r_asset_cache_entry *entry, uint32_t index, uint64_t size, bool *ok) {
+    if (index >= entry->count || (entry->blobs[index].size != size && entry->blobs[index].size != 0)) {
+        *ok = false;
+        return NULL;
+    }
+    if (entry->blobs[index].size == 0) {
+        return NULL;
+    }
+
+    void *copy = MemAlloc((unsigned int)size);
+    memcpy(copy, entry->base + entry->blobs[index].offset, size);
+    return copy;
+}
+
+static bool _read_image(const r_asset_cache_entry *entry, uint32_t index, const r_asset_cache_image *info, Image *image) {
+    if (info->width <= 0 || info->height <= 0 || info->mipmaps <= 0) {
+        return false;
+    }
+
+    uint64_t size = _image_size(info->width, info->height, info->mipmaps, info->format);
+    bool     ok = size > 0;
+
+    *image = (Image){
+        .data = ok ? _copy(entry, index, size, &ok) : NULL,
+        .width = info->width,
+        .height = info->height,
+        .mipmaps = info->mipmaps,
+        .format = info->format,
+    };
+    return ok && image->data != NULL;
+}
+
+// every file the decode read still has the content it had
+static bool _files_unchanged(const r_asset_cache_entry *entry) {
+    const uint8_t *cursor = _blob(entry, ASSET_CACHE_BLOB_FILES, 0);
+    const uint8_t *end = cursor + entry->blobs[ASSET_CACHE_BLOB_FILES].size;
+
+    while (cursor + sizeof(r_asset_cache_file) <= end) {
+        r_asset_cache_file file;
+        memcpy(&file, cursor, sizeof(file));
+        cursor += sizeof(file);
+
+        if (file.length >= PATH_MAX || cursor + file.length > end) {
+            return false;
+        }
+
+        char     path[PATH_MAX];
+        uint64_t hash;
+        memcpy(path, cursor, file.length);
+        path[file.length] = '\0';
+        cursor += (file.length + 7) & ~(uint32_t)7;
+
+        if (!_hash_file(path, 0, &hash) || hash != file.hash) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool _read_model(const r_asset_cache_entry *entry, ModelData *data) {
+    const r_asset_cache_model *info = _blob(entry, ASSET_CACHE_BLOB_INFO, sizeof(r_asset_cache_model));
+    if (info == NULL || info->mesh_count <= 0 || info->material_count < 0 || info->bone_count < 0 || info->image_count < 0) {
+        return false;
+    }
+
+    uint32_t                         index = ASSET_CACHE_BLOB_INFO + 1;
+    const r_asset_cache_mesh *       meshes = _blob(entry, index++, sizeof(r_asset_cache_mesh) * info->mesh_count);
+    const r_asset_cache_material *   materials = _blob(entry, index++, sizeof(r_asset_cache_material) * info->material_count);
+    uint32_t                         tables = index;
+    const r_asset_cache_model_image *images = _blob(entry, tables + 3, sizeof(r_asset_cache_model_image) * info->image_count);
+
+    if (meshes == NULL || (info->material_count && materials == NULL) || (info->image_count && images == NULL) ||
+        entry->count != tables + 4 + (uint32_t)info->mesh_count * ASSET_CACHE_MESH_ARRAYS + (uint32_t)info->image_count) {
+        return false;
+    }
+
+    bool   ok = true;
+    Model *model = &data->model;
+
+    *data = (ModelData){ 0 };
+    model->transform = (Matrix){ .m0 = 1.f, .m5 = 1.f, .m10 = 1.f, .m15 = 1.f };
+    model->meshCount = info->mesh_count;
+    model->materialCount = info->material_count;
+    model->boneCount = info->bone_count;
+    model->meshes = MemAlloc(sizeof(Mesh) * info->mesh_count);
+    model->materials = info->material_count ? MemAlloc(sizeof(Material) * info->material_count) : NULL;
+    model->meshMaterial = _copy(entry, tables, sizeof(int) * info->mesh_count, &ok);
+    model->bones = _copy(entry, tables + 1, sizeof(BoneInfo) * info->bone_count, &ok);
+    model->bindPose = _copy(entry, tables + 2, sizeof(Transform) * info->bone_count, &ok);
+
+    index = tables + 4;
+    for (int i = 0; i < info->mesh_count; i++) {
+        void **  arrays[ASSET_CACHE_MESH_ARRAYS];
+        uint64_t sizes[ASSET_CACHE_MESH_ARRAYS];
+
+        ok = ok && meshes[i].vertex_count >= 0 && meshes[i].triangle_count >= 0;
+        model->meshes[i].vertexCount = meshes[i].vertex_count;
+        model->meshes[i].triangleCount = meshes[i].triangle_count;
+
+        _mesh_arrays(&model->meshes[i], arrays, sizes);
+        for (int array = 0; array < ASSET_CACHE_MESH_ARRAYS; array++) {
+            *arrays[array] = _copy(entry, index++, sizes[array], &ok);
+        }
+    }
+
+    Texture2D fallback = { rlGetTextureIdDefault(), 1, 1, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    for (int i = 0; i < info->material_count; i++) {
+        model->materials[i] = LoadMaterialDefault();
+        memcpy(model->materials[i].params, materials[i].params, sizeof(materials[i].params));
+
+        for (int map = 0; map < ASSET_MATERIAL_MAPS; map++) {
+            const r_asset_cache_map *source = &materials[i].maps[map];
+
+            model->materials[i].maps[map] = (MaterialMap){
+                .texture = source->texture == R_ASSET_CACHE_MAP_DEFAULT ? fallback : (Texture2D){ 0 },
+                .color = { source->color[0], source->color[1], source->color[2], source->color[3] },
+                .value = source->value,
+            };
+        }
+    }
+
+    if (info->image_count > 0) {
+        data->images = MemAlloc(sizeof(Image) * info->image_count);
+        data->textures = MemAlloc(sizeof(Texture2D *) * info->image_count);
+    }
+
+    for (int i = 0; ok && i < info->image_count; i++) {
+        if (images[i].material < 0 || images[i].material >= info->material_count ||
+            images[i].map < 0 || images[i].map >= ASSET_MATERIAL_MAPS) {
+            ok = false;
+            break;
+        }
+
+        data->textures[i] = &model->materials[images[i].material].maps[images[i].map].texture;
+        ok = _read_image(entry, index++, &images[i].image, &data->images[i]);
+        data->imageCount = i + 1;
+    }
+
+    if (!ok) {
+        UnloadModelData(*data);
+        *data = (ModelData){ 0 };
+    }
+    return ok;
+}
+
+static bool _read_font(const r_asset_cache_entry *entry, r_asset_data *data) {
+    const r_asset_cache_font * info = _blob(entry, ASSET_CACHE_BLOB_INFO, sizeof(r_asset_cache_font));
+    const r_asset_cache_glyph *glyphs = _blob(entry, ASSET_CACHE_BLOB_INFO + 1, sizeof(r_asset_cache_glyph) * ASSET_FONT_GLYPHS);
+    uint32_t                   index = ASSET_CACHE_BLOB_INFO + 2;
+
+    if (info == NULL || glyphs == NULL || info->glyph_count != ASSET_FONT_GLYPHS || entry->count != index + 2 + ASSET_FONT_GLYPHS) {
+        return false;
+    }
+
+    bool ok = true;
+
+    data->font.recs = _copy(entry, index++, sizeof(Rectangle) * ASSET_FONT_GLYPHS, &ok);
+    data->font.glyphs = MemAlloc(sizeof(GlyphInfo) * ASSET_FONT_GLYPHS);
+    ok = ok && data->font.recs != NULL && _read_image(entry, index++, &info->atlas, &data->font.atlas);
+
+    // a glyph without pixels, the space, is kept as raylib rasterised it
+    for (int i = 0; i < ASSET_FONT_GLYPHS; i++) {
+        GlyphInfo *glyph = &data->font.glyphs[i];
+
+        *glyph = (GlyphInfo){
+            .value = glyphs[i].value,
+            .offsetX = glyphs[i].offset_x,
+            .offsetY = glyphs[i].offset_y,
+            .advanceX = glyphs[i].advance_x,
+        };
+
+        if (ok && entry->blobs[index].size > 0) {
+            ok = _read_image(entry, index, &glyphs[i].image, &glyph->image);
+        } else {
+            glyph->image = (Image){ .width = glyphs[i].image.width, .height = glyphs[i].image.height, .mipmaps = 1, .format = glyphs[i].image.format };
+        }
+        index++;
+    }
+
+    if (!ok) {
+        UnloadImage(data->font.atlas);
+        UnloadFontData(data->font.glyphs, ASSET_FONT_GLYPHS);
+        MemFree(data->font.recs);
+        memset(data, 0, sizeof(r_asset_data));
+    }
+    return ok;
+}
+
+static bool _read_texture(const r_asset_cache_entry *entry, Image *image) {
+    const r_asset_cache_image *info = _blob(entry, ASSET_CACHE_BLOB_INFO, sizeof(r_asset_cache_image));
+    if (info == NULL || entry->count != ASSET_CACHE_BLOB_INFO + 2) {
+        return false;
+    }
+
+    if (!_read_image(entry, ASSET_CACHE_BLOB_INFO + 1, info, image)) {
+        UnloadImage(*image);
+        return false;
+    }
+    return true;
+}
+
+static bool _read_wave(const r_asset_cache_entry *entry, Wave *wave) {
+    const r_asset_cache_wave *info = _blob(entry, ASSET_CACHE_BLOB_INFO, sizeof(r_asset_cache_wave));
+    if (info == NULL || entry->count != ASSET_CACHE_BLOB_INFO + 2) {
+        return false;
+    }
+
+    uint64_t size = (uint64_t)info->frame_count * info->channels * (info->sample_size / 8);
+    bool     ok = size > 0;
+
+    *wave = (Wave){
+        .frameCount = info->frame_count,
+        .sampleRate = info->sample_rate,
+        .sampleSize = info->sample_size,
+        .channels = info->channels,
+        .data = ok ? _copy(entry, ASSET_CACHE_BLOB_INFO + 1, size, &ok) : NULL,
+    };
+    if (!ok || wave->data == NULL) {
+        UnloadWave(*wave);
+        return false;
+    }
+    return true;
+}
+
+// Capture
+// -------
+
+static void _observe(const char *path, const void *buffer, size_t size, void *data) {
+    r_asset_cache_dependencies *dependencies = (r_asset_cache_dependencies *)data;
+
+    if (strcmp(path, dependencies->path) == 0) {
+        return;
+    }
+    for (uint32_t i = 0; i < dependencies->count; i++) {
+        if (strcmp(path, dependencies->files[i].path) == 0) {
+            return;
+        }
+    }
+
+    // an entry which can't list all its files can't tell when it's out of date
+    if (dependencies->count == MAX_ASSET_CACHE_DEPENDENCIES) {
+        dependencies->overflow = true;
+        return;
+    }
+
+    r_asset_cache_dependency *file = &dependencies->files[dependencies->count++];
+    asprintf(&file->path, "%s", path);
+    file->hash = r_asset_cache_hash(buffer, size, 0);
+}
+
+void r_asset_cache_capture_begin(r_asset_cache_dependencies *dependencies, const char *path) {
+    memset(dependencies, 0, sizeof(r_asset_cache_dependencies));
+    dependencies->path = path;
+    r_io_observe(_observe, dependencies);
+}
+
+void r_asset_cache_capture_end(r_asset_cache_dependencies *dependencies) {
+    (void)dependencies;
+    r_io_observe(NULL, NULL);
+}
+
+void r_asset_cache_dependencies_free(r_asset_cache_dependencies *dependencies) {
+    for (uint32_t i = 0; i < dependencies->count; i++) {
+        free(dependencies->files[i].path);
+    }
+    dependencies->count = 0;
+}
+
+// Cache
+// -----
+
+// create the directory and its parents
+static bool _make_directory(const char *path) {
+    char partial[PATH_MAX];
+    snprintf(partial, sizeof(partial), "%s", path);
+
+    for (char *slash = strchr(partial + 1, '/'); slash != NULL; slash = strchr(slash + 1, '/')) {
+        *slash = '\0';
+        if (mkdir(partial, 0755) != 0 && errno != EEXIST) {
+            return false;
+        }
+        *slash = '/';
+    }
+    return mkdir(partial, 0755) == 0 || errno == EEXIST;
+}
+
+bool r_asset_cache_create(const char *path) {
+    if (!_make_directory(path)) {
+        r_log(R_LOG_WARNING, "asset: unable to create the cache in %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    if (directory) {
+        free(directory);
+    }
+    asprintf(&directory, "%s", path);
+    atomic_store(&hits, 0);
+    atomic_store(&misses, 0);
+    atomic_store(&written, 0);
+
+    uint32_t pruned = r_asset_cache_prune(ASSET_CACHE_MAX_BYTES);
+    if (pruned > 0) {
+        r_log(R_LOG_INFO, "asset: pruned %u entries from the cache\n", pruned);
+    }
+    return true;
+}
+
+void r_asset_cache_destroy() {
+    if (directory == NULL) {
+        return;
+    }
+
+    r_log(R_LOG_INFO, "asset: cache had %llu hits, %llu misses, %llu entries baked\n",
+        (unsigned long long)atomic_load(&hits), (unsigned long long)atomic_load(&misses),
+        (unsigned long long)atomic_load(&written));
+
+    free(directory);
+    directory = NULL;
+}
+
+// least recently used first
+static int _stored_compare(const void *a, const void *b) {
+    const r_asset_cache_stored *x = a;
+    const r_asset_cache_stored *y = b;
+
+    if (x->used.tv_sec != y->used.tv_sec) {
+        return x->used.tv_sec < y->used.tv_sec ? -1 : 1;
+    }
+    if (x->used.tv_nsec != y->used.tv_nsec) {
+        return x->used.tv_nsec < y->used.tv_nsec ? -1 : 1;
+    }
+    return strcmp(x->name, y->name);
+}
+
+uint32_t r_asset_cache_prune(uint64_t max_bytes) {
+    DIR *dir = directory ? opendir(directory) : NULL;
+    if (dir == NULL) {
+        return 0;
+    }
+
+    r_asset_cache_stored *files = NULL;
+    uint32_t            count = 0;
+    uint32_t            capacity = 0;
+    uint64_t            total = 0;
+
+    // only whole entries, a temporary may still be being written by another process
+    for (struct dirent *dirent = readdir(dir); dirent != NULL; dirent = readdir(dir)) {
+        size_t      length = strlen(dirent->d_name);
+        struct stat statbuf;
+
+        if (length != 22 || strcmp(dirent->d_name + 16, ".asset") != 0 || fstatat(dirfd(dir), dirent->d_name, &statbuf, 0) != 0) {
+            continue;
+        }
+
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            r_asset_cache_stored *grown = MALLOC(r_asset_cache_stored, capacity);
+            if (files) {
+                memcpy(grown, files, count * sizeof(r_asset_cache_stored));
+                FREE(r_asset_cache_stored, files);
+            }
+            files = grown;
+        }
+
+        r_asset_cache_stored *file = &files[count++];
+        memcpy(file->name, dirent->d_name, length + 1);
+        file->size = (uint64_t)statbuf.st_size;
+        file->used = statbuf.st_mtim;
+        total += file->size;
+    }
+
+    uint32_t removed = 0;
+    if (total > max_bytes) {
+        qsort(files, count, sizeof(r_asset_cache_stored), _stored_compare);
+
+        for (uint32_t i = 0; i < count && total > max_bytes; i++) {
+            if (unlinkat(dirfd(dir), files[i].name, 0) == 0) {
+                total -= files[i].size;
+                removed++;
+            }
+        }
+    }
+
+    closedir(dir);
+    if (files) {
+        FREE(r_asset_cache_stored, files);
+    }
+    return removed;
+}
+
+bool r_asset_cache_enabled(r_asset_type type) {
+    return directory != NULL && (type == R_ASSET_TEXTURE || type == R_ASSET_MODEL || type == R_ASSET_FONT || type == R_ASSET_SOUND);
+}
+
+uint64_t r_asset_cache_key(const char *path, r_asset_type type, int font_size) {
+    uint64_t seed = ((uint64_t)ASSET_CACHE_VERSION << 48) ^ ((uint64_t)type << 32) ^ (uint32_t)font_size;
+    uint64_t key;
+
+    // 0 is left for files which can't be read
+    return _hash_file(path, seed, &key) ? (key ? key : 1) : 0;
+}
+
+bool r_asset_cache_read(uint64_t key, r_asset_type type, r_asset_data *data) {
+    r_asset_cache_entry entry;
+
+    if (!r_asset_cache_enabled(type) || key == 0 || !_map(key, type, &entry)) {
+        atomic_fetch_add_explicit(&misses, 1, memory_order_relaxed);
+        return false;
+    }
+
+    bool ok = _files_unchanged(&entry);
+    memset(data, 0, sizeof(r_asset_data));
+
+    if (ok) {
+        switch (type) {
+            case R_ASSET_TEXTURE:
+                ok = _read_texture(&entry, &data->image);
+                break;
+            case R_ASSET_MODEL:
+                ok = _read_model(&entry, &data->model);
+                break;
+            case R_ASSET_FONT:
+                ok = _read_font(&entry, data);
+                break;
+            case R_ASSET_SOUND:
+                ok = _read_wave(&entry, &data->wave);
+                break;
+            default:
+                ok = false;
+                break;
+        }
+    }
+
+    _unmap(&entry);
+    atomic_fetch_add_explicit(ok ? &hits : &misses, 1, memory_order_relaxed);
+    return ok;
+}
+
+bool r_asset_cache_write(uint64_t key, r_asset_type type, const r_asset_data *data, const r_asset_cache_dependencies *dependencies) {
+    if (!r_asset_cache_enabled(type) || key == 0 || dependencies->overflow) {
+        return false;
+    }
+
+    r_asset_cache_writer writer = { 0 };
+    r_asset_cache_image  image;
+    r_asset_cache_wave   wave;
+    void *               scratch[4] = { NULL };
+    uint64_t             files_size;
+    uint8_t *            files = _files_blob(dependencies, &files_size);
+    bool                 ok = true;
+
+    _add(&writer, files, files_size);
+
+    switch (type) {
+        case R_ASSET_TEXTURE:
+            image = _image_describe(data->image);
+            _add(&writer, &image, sizeof(image));
+            _add_image(&writer, data->image);
+            break;
+        case R_ASSET_MODEL:
+            ok = _write_model(&writer, &data->model, scratch);
+            break;
+        case R_ASSET_FONT:
+            ok = data->font.glyphs != NULL && _write_font(&writer, data, scratch);
+            break;
+        case R_ASSET_SOUND:
+            wave = (r_asset_cache_wave){
+                .frame_count = data->wave.frameCount,
+                .sample_rate = data->wave.sampleRate,
+                .sample_size = data->wave.sampleSize,
+                .channels = data->wave.channels,
+            };
+            _add(&writer, &wave, sizeof(wave));
+            _add(&writer, data->wave.data, (uint64_t)wave.frame_count * wave.channels * (wave.sample_size / 8));
+            break;
+        default:
+            ok = false;
+            break;
+    }
+
+    ok = ok && _write_entry(key, type, &writer);
+    if (ok) {
+        atomic_fetch_add_explicit(&written, 1, memory_order_relaxed);
+    }
+
+    for (int i = 0; i < 4; i++) {
+        if (scratch[i] != NULL) {
+            FREE(void, scratch[i]);
+        }
+    }
+    FREE(uint8_t, files);
+    if (writer.blobs != NULL) {
+        FREE(r_asset_cache_source, writer.blobs);
+    }
+    return ok;
+}
@@ -0,0 +1,97 @@
+#ifndef _ASSET_CACHE_H_
+#define _ASSET_CACHE_H_
+
+// r_asset_cache keeps what the asset decodes produced, so a file which was
+// decoded once is loaded again without parsing it. An entry is one file in the
+// cache directory, named after its key: the hash of the asset file's content,
+// its type and the options it was loaded with.
+//
+// Entries are laid out to be mapped and copied from as they are:
+//   header  magic, version, type, key, the entry's size and its blob count
+//   blobs   offset and size of every blob, each one starts on ASSET_CACHE_ALIGNMENT
+// Blob 0 lists the other files the decode read (material libraries, glTF
+// buffers, textures) with the hash of their content, an entry is only used
+// while they are unchanged. Blob 1 describes the asset, the rest are its
+// pixels, glyphs, vertex arrays or samples.
+//
+// Textures, models, TTF/OTF fonts and sounds are cached. Shaders are only read.
+//
+// Every edit bakes a new entry and leaves the old one behind. Creating the
+// cache prunes it back to ASSET_CACHE_MAX_BYTES, dropping the entries read or
+// written least recently.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "module/interface.h"
+
+#include "raylib.h"
+
+#define ASSET_CACHE_MAGIC            0x48434152   // "RACH"
+#define ASSET_CACHE_VERSION          1
+#define ASSET_CACHE_ALIGNMENT        64
+#define ASSET_CACHE_DIRECTORY        "build/cache/assets"
+#define ASSET_CACHE_MAX_BYTES        (1024ull << 20)
+#define MAX_ASSET_CACHE_DEPENDENCIES 32
+
+// the same glyphs and padding raylib's LoadFont() gives a TTF font
+#define ASSET_FONT_DEFAULT_SIZE      32
+#define ASSET_FONT_GLYPHS            95
+#define ASSET_FONT_PADDING           4
+
+// raylib's MAX_MATERIAL_MAPS, what LoadMaterialDefault() allocates
+#define ASSET_MATERIAL_MAPS          12
+
+// what a decode produced, ready to be uploaded
+typedef union r_asset_data {
+    Image     image;
+    ModelData model;
+    struct {
+        Image       atlas;
+        GlyphInfo * glyphs;
+        Rectangle * recs;
+    } font;
+    struct {
+        char * vertex;
+        char * fragment;
+    } shader;
+    Wave      wave;
+} r_asset_data;
+
+typedef struct r_asset_cache_dependency {
+    char *   path;
+    uint64_t hash;
+} r_asset_cache_dependency;
+
+// the files a decode read besides the asset's own
+typedef struct r_asset_cache_dependencies {
+    const char *             path;
+    r_asset_cache_dependency files[MAX_ASSET_CACHE_DEPENDENCIES];
+    uint32_t                 count;
+    bool                     overflow;
+} r_asset_cache_dependencies;
+
+// entries go to directory, which is created when missing
+bool r_asset_cache_create(const char *directory);
+void r_asset_cache_destroy();
+bool r_asset_cache_enabled(r_asset_type type);
+// remove the least recently used entries until the rest take at most max_bytes, returns how many went
+uint32_t r_asset_cache_prune(uint64_t max_bytes);
+
+uint64_t r_asset_cache_hash(const void *data, size_t size, uint64_t seed);
+// the key of the file at path loaded as type with the options, 0 when it can't be read
+uint64_t r_asset_cache_key(const char *path, r_asset_type type, int font_size);
+
+// record the files raylib reads on this thread until the capture ends
+void r_asset_cache_capture_begin(r_asset_cache_dependencies *dependencies, const char *path);
+void r_asset_cache_capture_end(r_asset_cache_dependencies *dependencies);
+void r_asset_cache_dependencies_free(r_asset_cache_dependencies *dependencies);
+
+// fill data from the entry baked for key, false when there's none or it's out of date. the
+// key covers the options the asset was loaded with
+bool r_asset_cache_read(uint64_t key, r_asset_type type, r_asset_data *data);
+// bake the decoded data under key, data is left as it was
+bool r_asset_cache_write(uint64_t key, r_asset_type type, const r_asset_data *data, const r_asset_cache_dependencies *dependencies);
+
+#endif
@@ -0,0 +1,167 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#include "bus/bus.h"
+#include "log/log.h"
+#include "memory/allocator.h"
+
+// bounded multiple producer queue, each slot carries a sequence number
+// which tells producers and the consumer whose turn it is
+typedef struct r_bus_slot {
+    _Atomic uint64_t sequence;
+} r_bus_slot;
+
+struct r_bus_channel {
+    char             name[MAX_MODULE_FN_NAME];
+    char             type[MAX_MODULE_FN_NAME];
+    uint32_t         size;
+    r_module_phase   delivery;
+
+    // ring
+    r_bus_slot *     slots;
+    uint8_t *        payloads;
+    _Atomic uint64_t head;
+    uint64_t         tail;
+    _Atomic uint32_t dropped;
+
+    // last delivered batch
+    uint8_t *        batch;
+    uint32_t         batch_count;
+};
+
+static r_bus_channel    channels[MAX_BUS_CHANNELS];
+// published once a channel is fully set up, delivery reads it without the lock
+static _Atomic uint32_t channel_count = 0;
+
+// channels are created while modules initialise, which may be concurrent
+static pthread_mutex_t channel_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static r_bus_channel * _channel_get(r_module_properties *props, const char *name, const char *type, uint32_t size, r_module_phase delivery) {
+    uint32_t count = atomic_load_explicit(&channel_count, memory_order_relaxed);
+
+    for (uint32_t i = 0; i < count; i++) {
+        r_bus_channel *channel = &channels[i];
+
+        if (strcmp(channel->name, name) == 0) {
+            if (strcmp(channel->type, type) != 0 || channel->size != size) {
+                r_log(R_LOG_ERROR, "module %s: channel %s carries %s, not %s\n", props->name, name, channel->type, type);
+                return NULL;
+            }
+            return channel;
+        }
+    }
+
+    if (count == MAX_BUS_CHANNELS || strlen(name) >= MAX_MODULE_FN_NAME || strlen(type) >= MAX_MODULE_FN_NAME) {
+        r_log(R_LOG_ERROR, "module %s: unable to create channel: %s\n", props->name, name);
+        return NULL;
+    }
+
+    r_bus_channel *channel = &channels[count];
+    strcpy(channel->name, name);
+    strcpy(channel->type, type);
+    channel->size = size;
+    channel->delivery = delivery;
+
+    channel->slots = MALLOC(r_bus_slot, BUS_CHANNEL_CAPACITY);
+    channel->payloads = MALLOC(uint8_t, (size_t)size * BUS_CHANNEL_CAPACITY);
+    channel->batch = MALLOC(uint8_t, (size_t)size * BUS_CHANNEL_CAPACITY);
+    channel->batch_count = 0;
+    channel->tail = 0;
+    atomic_init(&channel->head, 0);
+    atomic_init(&channel->dropped, 0);
+
+    for (uint64_t i = 0; i < BUS_CHANNEL_CAPACITY; i++) {
+        atomic_init(&channel->slots[i].sequence, i);
+    }
+
+    atomic_store_explicit(&channel_count, count + 1, memory_order_release);
+    return channel;
+}
+
+r_bus_channel * r_bus_channel_get(r_module_properties *props, const char *name, const char *type, uint32_t size, r_module_phase delivery) {
+    pthread_mutex_lock(&channel_lock);
+    r_bus_channel *channel = _channel_get(props, name, type, size, delivery);
+    pthread_mutex_unlock(&channel_lock);
+    return channel;
+}
+
+bool r_bus_post(r_bus_channel *channel, const void *message) {
+    uint64_t position = atomic_load_explicit(&channel->head, memory_order_relaxed);
+
+    for (;;) {
+        r_bus_slot *slot = &channel->slots[position % BUS_CHANNEL_CAPACITY];
+        uint64_t    sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        int64_t     difference = (int64_t)(sequence - position);
+
+        if (difference == 0) {
+            // the slot is free, claim it
+            if (atomic_compare_exchange_weak_explicit(&channel->head, &position, position + 1, memory_order_relaxed, memory_order_relaxed)) {
+                memcpy(channel->payloads + (position % BUS_CHANNEL_CAPACITY) * channel->size, message, channel->size);
+                atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            // full until the next delivery
+            atomic_fetch_add_explicit(&channel->dropped, 1, memory_order_relaxed);
+            return false;
+        } else {
+            position = atomic_load_explicit(&channel->head, memory_order_relaxed);
+        }
+    }
+}
+
+const void * r_bus_messages(r_bus_channel *channel, uint32_t *count) {
+    *count = channel->batch_count;
+    return channel->batch;
+}
+
+void r_bus_deliver(r_module_phase phase) {
+    uint32_t count = atomic_load_explicit(&channel_count, memory_order_acquire);
+
+    for (uint32_t i = 0; i < count; i++) {
+        r_bus_channel *channel = &channels[i];
+
+        if (channel->delivery != phase) {
+            continue;
+        }
+
+        // drain everything which has been completely written
+        uint32_t delivered = 0;
+        for (;;) {
+            r_bus_slot *slot = &channel->slots[channel->tail % BUS_CHANNEL_CAPACITY];
+            uint64_t    sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+
+            if (sequence != channel->tail + 1) {
+                break;
+            }
+
+            memcpy(channel->batch + (size_t)delivered * channel->size,
+                   channel->payloads + (channel->tail % BUS_CHANNEL_CAPACITY) * channel->size,
+                   channel->size);
+            delivered++;
+
+            atomic_store_explicit(&slot->sequence, channel->tail + BUS_CHANNEL_CAPACITY, memory_order_release);
+            channel->tail++;
+        }
+        channel->batch_count = delivered;
+
+        uint32_t dropped = atomic_exchange_explicit(&channel->dropped, 0, memory_order_relaxed);
+        if (dropped > 0) {
+            r_log(R_LOG_WARNING, "channel %s: dropped %u messages\n", channel->name, dropped);
+        }
+    }
+}
+
+void r_bus_destroy() {
+    pthread_mutex_lock(&channel_lock);
+    uint32_t count = atomic_load_explicit(&channel_count, memory_order_relaxed);
+
+    for (uint32_t i = 0; i < count; i++) {
+        FREE(r_bus_slot, channels[i].slots);
+        FREE(uint8_t, channels[i].payloads);
+        FREE(uint8_t, channels[i].batch);
+    }
+    atomic_store_explicit(&channel_count, 0, memory_order_relaxed);
+    pthread_mutex_unlock(&channel_lock);
+}
@@ -0,0 +1,25 @@
+#ifndef _BUS_H_
+#define _BUS_H_
+
+// r_bus is a message bus for communication between modules. Each channel is
+// backed by a lock free multiple producer ring buffer which the host drains
+// into the channel's batch at the start of its delivery phase.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "module/interface.h"
+
+#define MAX_BUS_CHANNELS     64
+#define BUS_CHANNEL_CAPACITY 1024
+
+r_bus_channel * r_bus_channel_get(r_module_properties *props, const char *name, const char *type, uint32_t size, r_module_phase delivery);
+bool            r_bus_post(r_bus_channel *channel, const void *message);
+const void *    r_bus_messages(r_bus_channel *channel, uint32_t *count);
+
+// deliver the messages posted to every channel for this phase
+void r_bus_deliver(r_module_phase phase);
+
+void r_bus_destroy();
+
+#endif
@@ -0,0 +1,312 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "cluster/cluster.h"
+#include "log/log.h"
+#include "module/interface.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#define CLUSTER_COMMIT "commit\n"
+
+typedef struct r_cluster_ready {
+    char     module[MAX_MODULE_FN_NAME];
+    uint32_t version;
+    char     path[PATH_MAX];
+} r_cluster_ready;
+
+static r_cluster_role role = R_CLUSTER_NONE;
+static char           socket_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+static char           lock_path[PATH_MAX];
+static int            lock_fd = -1;
+
+// leader
+static int            listen_fd = -1;
+static int            followers[MAX_CLUSTER_FOLLOWERS];
+static uint32_t       follower_count = 0;
+static char           outbox[CLUSTER_MESSAGE_SIZE * MAX_MODULES];
+static size_t         outbox_size = 0;
+static bool           outbox_overflow = false;
+
+// follower
+static int            leader_fd = -1;
+static char           inbox[CLUSTER_MESSAGE_SIZE * 4];
+static size_t         inbox_size = 0;
+static r_cluster_ready pending[MAX_MODULES];
+static uint32_t       pending_count = 0;
+
+static void _nonblocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+static bool _address(struct sockaddr_un *address) {
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    return snprintf(address->sun_path, sizeof(address->sun_path), "%s", socket_path) < (int)sizeof(address->sun_path);
+}
+
+static bool _lead() {
+    struct sockaddr_un address;
+    _address(&address);
+
+    // whoever held the lock before is gone, so is their socket
+    unlink(socket_path);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0 || bind(listen_fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listen_fd, MAX_CLUSTER_FOLLOWERS) != 0) {
+        r_log(R_LOG_ERROR, "cluster: unable to listen at %s: %s\n", socket_path, strerror(errno));
+        if (listen_fd >= 0) {
+            close(listen_fd);
+            listen_fd = -1;
+        }
+        return false;
+    }
+    _nonblocking(listen_fd);
+
+    role = R_CLUSTER_LEADER;
+    r_log(R_LOG_INFO, "cluster: leading at %s\n", socket_path);
+    return true;
+}
+
+static bool _follow() {
+    struct sockaddr_un address;
+    _address(&address);
+
+    role = R_CLUSTER_FOLLOWER;
+    inbox_size = 0;
+    pending_count = 0;
+
+    leader_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (leader_fd < 0 || connect(leader_fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        // the leader may not be listening yet, try again at the next poll
+        if (leader_fd >= 0) {
+            close(leader_fd);
+            leader_fd = -1;
+        }
+        return false;
+    }
+    _nonblocking(leader_fd);
+
+    r_log(R_LOG_INFO, "cluster: following the leader at %s\n", socket_path);
+    return true;
+}
+
+// lead if nobody holds the lock, otherwise follow
+static bool _elect() {
+    if (lock_fd < 0) {
+        lock_fd = open(lock_path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    }
+
+    if (lock_fd >= 0 && flock(lock_fd, LOCK_EX | LOCK_NB) == 0) {
+        return _lead();
+    }
+    return _follow();
+}
+
+bool r_cluster_join(const char *path) {
+    if (role != R_CLUSTER_NONE) {
+        return true;
+    }
+
+    if (path) {
+        snprintf(socket_path, sizeof(socket_path), "%s", path);
+    } else {
+        // instances started from the same directory share a cluster
+        char cwd[PATH_MAX];
+        uint32_t hash = 2166136261u;
+        if (getcwd(cwd, sizeof(cwd))) {
+            for (const char *c = cwd; *c; c++) {
+                hash = (hash ^ (uint8_t)*c) * 16777619u;
+            }
+        }
+        snprintf(socket_path, sizeof(socket_path), "/tmp/reload-%u-%08x.sock", (unsigned)getuid(), hash);
+    }
+    snprintf(lock_path, sizeof(lock_path), "%s.lock", socket_path);
+
+    _elect();
+    return role != R_CLUSTER_NONE;
+}
+
+void r_cluster_leave() {
+    for (uint32_t i = 0; i < follower_count; i++) {
+        close(followers[i]);
+    }
+    follower_count = 0;
+
+    if (listen_fd >= 0) {
+        close(listen_fd);
+        listen_fd = -1;
+        unlink(socket_path);
+    }
+    if (leader_fd >= 0) {
+        close(leader_fd);
+        leader_fd = -1;
+    }
+    // the lock file stays, removing it would let two instances lock different files
+    if (lock_fd >= 0) {
+        close(lock_fd);
+        lock_fd = -1;
+    }
+
+    role = R_CLUSTER_NONE;
+}
+
+r_cluster_role r_cluster_get_role() {
+    return role;
+}
+
+// Leader
+// ------
+
+void r_cluster_publish(const char *module, uint32_t version, const char *path) {
+    if (role != R_CLUSTER_LEADER) {
+        return;
+    }
+
+    // keep room for the commit line
+    size_t room = sizeof(outbox) - outbox_size - sizeof(CLUSTER_COMMIT);
+    int    length = snprintf(outbox + outbox_size, room, "ready %s %u %s\n", module, version, path);
+    if (length > 0 && (size_t)length < room) {
+        outbox_size += (size_t)length;
+    } else {
+        outbox_overflow = true;
+    }
+}
+
+void r_cluster_commit() {
+    if (role != R_CLUSTER_LEADER || (outbox_size == 0 && !outbox_overflow)) {
+        return;
+    }
+
+    // a set which doesn't fit isn't announced half way
+    if (outbox_overflow) {
+        r_log(R_LOG_ERROR, "cluster: reload set too large to announce\n");
+        outbox_size = 0;
+        outbox_overflow = false;
+        return;
+    }
+
+    // publish left room for it
+    memcpy(outbox + outbox_size, CLUSTER_COMMIT, sizeof(CLUSTER_COMMIT) - 1);
+    outbox_size += sizeof(CLUSTER_COMMIT) - 1;
+
+    // a follower which can't take the whole set at once has fallen behind, it reconnects
+    for (uint32_t i = 0; i < follower_count; ) {
+        if (send(followers[i], outbox, outbox_size, MSG_NOSIGNAL) != (ssize_t)outbox_size) {
+            close(followers[i]);
+            followers[i] = followers[--follower_count];
+        } else {
+            i++;
+        }
+    }
+
+    r_log(R_LOG_INFO, "cluster: announced a reload to %u followers\n", follower_count);
+    outbox_size = 0;
+}
+
+static void _accept() {
+    int fd;
+    while ((fd = accept(listen_fd, NULL, NULL)) >= 0) {
+        if (follower_count == MAX_CLUSTER_FOLLOWERS) {
+            close(fd);
+            continue;
+        }
+        _nonblocking(fd);
+#ifdef SO_NOSIGPIPE
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+        followers[follower_count++] = fd;
+        r_log(R_LOG_INFO, "cluster: follower joined, %u following\n", follower_count);
+    }
+}
+
+// Follower
+// --------
+
+static void _receive(char *line, r_cluster_ready_fn ready, void *data) {
+    if (strcmp(line, "commit") == 0) {
+        for (uint32_t i = 0; i < pending_count; i++) {
+            ready(pending[i].module, pending[i].version, pending[i].path, data);
+        }
+        pending_count = 0;
+        return;
+    }
+
+    r_cluster_ready *entry = &pending[pending_count];
+    int              offset = 0;
+
+    if (pending_count == MAX_MODULES || sscanf(line, "ready %63s %u %n", entry->module, &entry->version, &offset) != 2 || offset == 0) {
+        r_log(R_LOG_WARNING, "cluster: ignoring message: %s\n", line);
+        return;
+    }
+
+    // the path is the rest of the line and may contain spaces
+    snprintf(entry->path, sizeof(entry->path), "%s", line + offset);
+    pending_count++;
+}
+
+static void _read(r_cluster_ready_fn ready, void *data) {
+    for (;;) {
+        ssize_t n = read(leader_fd, inbox + inbox_size, sizeof(inbox) - inbox_size - 1);
+
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            return;
+        }
+
+        if (n <= 0) {
+            // a half announced set is dropped with the leader, the next one covers it
+            r_log(R_LOG_INFO, "cluster: the leader has gone away\n");
+            close(leader_fd);
+            leader_fd = -1;
+            _elect();
+            return;
+        }
+
+        inbox_size += (size_t)n;
+        inbox[inbox_size] = '\0';
+
+        char *line = inbox;
+        char *end;
+        while ((end = strchr(line, '\n')) != NULL) {
+            *end = '\0';
+            _receive(line, ready, data);
+            line = end + 1;
+        }
+
+        inbox_size -= (size_t)(line - inbox);
+        memmove(inbox, line, inbox_size);
+
+        if (inbox_size == sizeof(inbox) - 1) {
+            r_log(R_LOG_WARNING, "cluster: message too long, dropped\n");
+            inbox_size = 0;
+        }
+    }
+}
+
+void r_cluster_poll(r_cluster_ready_fn ready, void *data) {
+    switch (role) {
+        case R_CLUSTER_LEADER:
+            _accept();
+            break;
+        case R_CLUSTER_FOLLOWER:
+            if (leader_fd < 0 && !_elect()) {
+                break;
+            }
+            if (role == R_CLUSTER_FOLLOWER) {
+                _read(ready, data);
+            }
+            break;
+        default:
+            break;
+    }
+}
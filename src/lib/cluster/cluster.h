@@ -0,0 +1,46 @@
+#ifndef _CLUSTER_H_
+#define _CLUSTER_H_
+
+// r_cluster lets host instances running side by side share one build.
+//
+// The first instance to take the lock next to the socket becomes the leader.
+// It watches and builds as usual and announces every reload set over a unix
+// domain socket. The others follow: they connect to the socket, skip builds,
+// and reload the libraries the leader announces. They keep watching files, so
+// tweaks and assets still reload locally. When the leader goes away, the next
+// instance to take the lock leads.
+//
+// The protocol is line based text:
+//   ready <module> <version> <library path>
+//   commit
+// and a follower applies the modules announced since the last commit together.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MAX_CLUSTER_FOLLOWERS 64
+#define CLUSTER_MESSAGE_SIZE  1024
+
+typedef enum r_cluster_role {
+    R_CLUSTER_NONE,
+    R_CLUSTER_LEADER,
+    R_CLUSTER_FOLLOWER,
+} r_cluster_role;
+
+typedef void (*r_cluster_ready_fn)(const char *module, uint32_t version, const char *path, void *data);
+
+// join the cluster at the socket path, NULL picks one for the working directory
+bool r_cluster_join(const char *path);
+void r_cluster_leave();
+
+r_cluster_role r_cluster_get_role();
+
+// leader: announce a module of the next reload set, then commit the set
+void r_cluster_publish(const char *module, uint32_t version, const char *path);
+void r_cluster_commit();
+
+// accept followers, or read announcements and hand every committed module to ready,
+// taking over when the leader has gone away
+void r_cluster_poll(r_cluster_ready_fn ready, void *data);
+
+#endif
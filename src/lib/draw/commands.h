@@ -0,0 +1,230 @@
+#ifndef _DRAW_COMMANDS_H_
+#define _DRAW_COMMANDS_H_
+
+// Recording side of the deferred draw lists. The functions mirror the raylib
+// calls they replay as, e.g. r_draw_cube(list, ...) replays as DrawCubeV.
+// Recording only touches the list, so a list can be filled on any thread as
+// long as only one thread records into it at a time.
+//
+//     r_draw_list *list = props->draw.begin(props, 0);
+//     r_draw_begin_mode_3d(list, camera);
+//     r_draw_grid(list, 10, 1.0f);
+//     r_draw_end_mode_3d(list);
+//     props->draw.submit(list);
+//
+// Resources (textures, fonts, meshes, models) are copied by value and must
+// stay loaded until the list has been replayed. Text is copied.
+
+#include <stdint.h>
+#include <string.h>
+
+#include "raylib.h"
+
+#include "module/interface.h"
+
+typedef enum r_draw_type {
+    R_DRAW_CLEAR,
+    R_DRAW_LINE,
+    R_DRAW_CIRCLE,
+    R_DRAW_CIRCLE_LINES,
+    R_DRAW_RECTANGLE,
+    R_DRAW_RECTANGLE_LINES,
+    R_DRAW_TRIANGLE,
+    R_DRAW_TEXT,
+    R_DRAW_TEXTURE,
+    R_DRAW_BEGIN_MODE_2D,
+    R_DRAW_END_MODE_2D,
+    R_DRAW_BEGIN_MODE_3D,
+    R_DRAW_END_MODE_3D,
+    R_DRAW_LINE_3D,
+    R_DRAW_CUBE,
+    R_DRAW_CUBE_WIRES,
+    R_DRAW_SPHERE,
+    R_DRAW_SPHERE_WIRES,
+    R_DRAW_PLANE,
+    R_DRAW_GRID,
+    R_DRAW_MESH,
+    R_DRAW_MODEL,
+    R_DRAW_TYPE_COUNT
+} r_draw_type;
+
+// every command starts with a header, size includes the header and padding
+typedef struct r_draw_command {
+    uint32_t type;
+    uint32_t size;
+} r_draw_command;
+
+struct r_draw_list {
+    uint8_t *   data;
+    uint32_t    size;
+    uint32_t    capacity;
+    uint32_t    key;
+    // copied, the module may be unregistered before the list is replayed
+    char        owner[MAX_MODULE_FN_NAME];
+
+    // make room for at least `size` more bytes
+    void     (*reserve)(r_draw_list *list, uint32_t size);
+    r_draw_list *next;
+};
+
+// Command payloads
+// ----------------
+
+typedef struct r_draw_color_cmd     { Color color; } r_draw_color_cmd;
+typedef struct r_draw_line_cmd      { Vector2 start; Vector2 end; float thick; Color color; } r_draw_line_cmd;
+typedef struct r_draw_circle_cmd    { Vector2 center; float radius; Color color; } r_draw_circle_cmd;
+typedef struct r_draw_rectangle_cmd { Rectangle rec; Vector2 origin; float rotation; Color color; } r_draw_rectangle_cmd;
+typedef struct r_draw_rectangle_lines_cmd { Rectangle rec; float thick; Color color; } r_draw_rectangle_lines_cmd;
+typedef struct r_draw_triangle_cmd  { Vector2 v1; Vector2 v2; Vector2 v3; Color color; } r_draw_triangle_cmd;
+typedef struct r_draw_text_cmd      { Font font; Vector2 position; float size; float spacing; Color color; bool default_font; } r_draw_text_cmd;
+typedef struct r_draw_texture_cmd   { Texture2D texture; Rectangle source; Rectangle dest; Vector2 origin; float rotation; Color tint; } r_draw_texture_cmd;
+typedef struct r_draw_camera_2d_cmd { Camera2D camera; } r_draw_camera_2d_cmd;
+typedef struct r_draw_camera_3d_cmd { Camera3D camera; } r_draw_camera_3d_cmd;
+typedef struct r_draw_line_3d_cmd   { Vector3 start; Vector3 end; Color color; } r_draw_line_3d_cmd;
+typedef struct r_draw_cube_cmd      { Vector3 position; Vector3 size; Color color; } r_draw_cube_cmd;
+typedef struct r_draw_sphere_cmd    { Vector3 center; float radius; int rings; int slices; Color color; } r_draw_sphere_cmd;
+typedef struct r_draw_plane_cmd     { Vector3 center; Vector2 size; Color color; } r_draw_plane_cmd;
+typedef struct r_draw_grid_cmd      { int slices; float spacing; } r_draw_grid_cmd;
+typedef struct r_draw_mesh_cmd      { Mesh mesh; Material material; Matrix transform; } r_draw_mesh_cmd;
+typedef struct r_draw_model_cmd     { Model model; Vector3 position; float scale; Color tint; } r_draw_model_cmd;
+
+// append a command with `size` bytes of payload, returns the payload
+static inline void * r_draw_push(r_draw_list *list, r_draw_type type, uint32_t size) {
+    uint32_t total = (uint32_t)(sizeof(r_draw_command) + size + 7) & ~7u;
+
+    if (list->size + total > list->capacity) {
+        list->reserve(list, total);
+    }
+
+    // cleared so lists with the same commands compare equal, see r_draw_replay
+    r_draw_command *command = (r_draw_command *)(list->data + list->size);
+    memset(command, 0, total);
+    command->type = type;
+    command->size = total;
+    list->size += total;
+
+    return command + 1;
+}
+
+// built in a cleared local and copied in as bytes, storing the struct straight
+// into the list may leave garbage in its padding, see r_draw_push
+#define R_DRAW_PUSH(list, type, cmd_type, ...) do {                            \
+        cmd_type _cmd;                                                          \
+        memset(&_cmd, 0, sizeof(_cmd));                                         \
+        _cmd = (cmd_type){ __VA_ARGS__ };                                       \
+        memcpy(r_draw_push(list, type, sizeof(cmd_type)), &_cmd, sizeof(_cmd)); \
+    } while (0)
+
+// 2D
+// --
+
+static inline void r_draw_clear(r_draw_list *list, Color color) {
+    R_DRAW_PUSH(list, R_DRAW_CLEAR, r_draw_color_cmd, color);
+}
+
+static inline void r_draw_line(r_draw_list *list, Vector2 start, Vector2 end, float thick, Color color) {
+    R_DRAW_PUSH(list, R_DRAW_LINE, r_draw_line_cmd, start, end, thick, color);
+}
+
+static inline void r_draw_circle(r_draw_list *list, Vector2 center, float radius, Color color) {
+    R_DRAW_PUSH(list, R_DRAW_CIRCLE, r_draw_circle_cmd, center, radius, color);
+}
+
+static inline void r_draw_circle_lines(r_draw_list *list, Vector2 center, float radius, Color color) {
+    R_DRAW_PUSH(list, R_DRAW_CIRCLE_LINES, r_draw_circle_cmd, center, radius, color);
+}
+
+static inline void r_draw_rectangle(r_draw_list *list, Rectangle rec, Vector2 origin, float rotation, Color color) {
+    R_DRAW_PUSH(list, R_DRAW_RECTANGLE, r_draw_rectangle_cmd, rec, origin, rotation, color);
+}
+
+static inline void r_draw_rectangle_lines(r_draw_list *list, Rectangle rec, float thick, Color color) {
+    R_DRAW_PUSH(list, R_DRAW_RECTANGLE_LINES, r_draw_rectangle_lines_cmd, rec, thick, color);
+}
+
+static inline void r_draw_triangle(r_draw_list *list, Vector2 v1, Vector2 v2, Vector2 v3, Color color) {
+    R_DRAW_PUSH(list, R_DRAW_TRIANGLE, r_draw_triangle_cmd, v1, v2, v3, color);
+}
+
+// the fields are set one by one, default_font leaves padding behind it
+static inline void _r_draw_text(r_draw_list *list, Font font, Vector2 position, float size, float spacing, Color color, bool default_font, const char *text) {
+    uint32_t length = (uint32_t)strlen(text) + 1;
+    r_draw_text_cmd *cmd = r_draw_push(list, R_DRAW_TEXT, sizeof(r_draw_text_cmd) + length);
+    cmd->font = font;
+    cmd->position = position;
+    cmd->size = size;
+    cmd->spacing = spacing;
+    cmd->color = color;
+    cmd->default_font = default_font;
+    memcpy(cmd + 1, text, length);
+}
+
+static inline void r_draw_text_ex(r_draw_list *list, Font font, const char *text, Vector2 position, float size, float spacing, Color color) {
+    _r_draw_text(list, font, position, size, spacing, color, false, text);
+}
+
+// DrawText with the default font
+static inline void r_draw_text(r_draw_list *list, const char *text, int x, int y, int size, Color color) {
+    _r_draw_text(list, (Font){ 0 }, (Vector2){ (float)x, (float)y }, (float)size, 0.f, color, true, text);
+}
+
+static inline void r_draw_texture(r_draw_list *list, Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint) {
+    R_DRAW_PUSH(list, R_DRAW_TEXTURE, r_draw_texture_cmd, texture, source, dest, origin, rotation, tint);
+}
+
+static inline void r_draw_begin_mode_2d(r_draw_list *list, Camera2D camera) {
+    R_DRAW_PUSH(list, R_DRAW_BEGIN_MODE_2D, r_draw_camera_2d_cmd, camera);
+}
+
+static inline void r_draw_end_mode_2d(r_draw_list *list) {
+    r_draw_push(list, R_DRAW_END_MODE_2D, 0);
+}
+
+// 3D
+// --
+
+static inline void r_draw_begin_mode_3d(r_draw_list *list, Camera3D camera) {
+    R_DRAW_PUSH(list, R_DRAW_BEGIN_MODE_3D, r_draw_camera_3d_cmd, camera);
+}
+
+static inline void r_draw_end_mode_3d(r_draw_list *list) {
+    r_draw_push(list, R_DRAW_END_MODE_3D, 0);
+}
+
+static inline void r_draw_line_3d(r_draw_list *list, Vector3 start, Vector3 end, Color color) {
+    R_DRAW_PUSH(list, R_DRAW_LINE_3D, r_draw_line_3d_cmd, start, end, color);
+}
+
+static inline void r_draw_cube(r_draw_list *list, Vector3 position, Vector3 size, Color color) {
+    R_DRAW_PUSH(list, R_DRAW_CUBE, r_draw_cube_cmd, position, size, color);
+}
+
+static inline void r_draw_cube_wires(r_draw_list *list, Vector3 position, Vector3 size, Color color) {
+    R_DRAW_PUSH(list, R_DRAW_CUBE_WIRES, r_draw_cube_cmd, position, size, color);
+}
+
+static inline void r_draw_sphere(r_draw_list *list, Vector3 center, float radius, int rings, int slices, Color color) {
+    R_DRAW_PUSH(list, R_DRAW_SPHERE, r_draw_sphere_cmd, center, radius, rings, slices, color);
+}
+
+static inline void r_draw_sphere_wires(r_draw_list *list, Vector3 center, float radius, int rings, int slices, Color color) {
+    R_DRAW_PUSH(list, R_DRAW_SPHERE_WIRES, r_draw_sphere_cmd, center, radius, rings, slices, color);
+}
+
+static inline void r_draw_plane(r_draw_list *list, Vector3 center, Vector2 size, Color color) {
+    R_DRAW_PUSH(list, R_DRAW_PLANE, r_draw_plane_cmd, center, size, color);
+}
+
+static inline void r_draw_grid(r_draw_list *list, int slices, float spacing) {
+    R_DRAW_PUSH(list, R_DRAW_GRID, r_draw_grid_cmd, slices, spacing);
+}
+
+static inline void r_draw_mesh(r_draw_list *list, Mesh mesh, Material material, Matrix transform) {
+    R_DRAW_PUSH(list, R_DRAW_MESH, r_draw_mesh_cmd, mesh, material, transform);
+}
+
+static inline void r_draw_model(r_draw_list *list, Model model, Vector3 position, float scale, Color tint) {
+    R_DRAW_PUSH(list, R_DRAW_MODEL, r_draw_model_cmd, model, position, scale, tint);
+}
+
+#endif
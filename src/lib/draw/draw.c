@@ -0,0 +1,294 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "draw/draw.h"
+#include "log/log.h"
+#include "memory/allocator.h"
+
+// lists are only ever taken from and handed back to these, the lock is held
+// for a push or a pop while recording itself is lock free
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static r_draw_list *   pool = NULL;
+static r_draw_list *   submitted = NULL;
+static uint32_t        submitted_count = 0;
+static r_draw_list *   sealed = NULL;
+static uint32_t        sealed_count = 0;
+
+static void _reserve(r_draw_list *list, uint32_t size) {
+    uint32_t capacity = list->capacity ? list->capacity : DRAW_LIST_CAPACITY;
+    while (capacity < list->size + size) {
+        capacity *= 2;
+    }
+
+    uint8_t *data = MALLOC(uint8_t, capacity);
+    if (list->data) {
+        memcpy(data, list->data, list->size);
+        FREE(uint8_t, list->data);
+    }
+    list->data = data;
+    list->capacity = capacity;
+}
+
+// replay order: key, then owner, then the commands themselves. The order of
+// submission depends on thread timing, so it can't be used
+static int _list_compare(const void *a, const void *b) {
+    const r_draw_list *x = *(const r_draw_list * const *)a;
+    const r_draw_list *y = *(const r_draw_list * const *)b;
+
+    if (x->key != y->key) {
+        return x->key < y->key ? -1 : 1;
+    }
+    int owner = strcmp(x->owner, y->owner);
+    if (owner != 0) {
+        return owner;
+    }
+    int contents = memcmp(x->data, y->data, x->size < y->size ? x->size : y->size);
+    if (contents != 0) {
+        return contents;
+    }
+    return x->size < y->size ? -1 : x->size > y->size;
+}
+
+static void _replay_list(r_draw_list *list) {
+    bool mode_2d = false;
+    bool mode_3d = false;
+
+    for (uint32_t offset = 0; offset < list->size; ) {
+        r_draw_command *command = (r_draw_command *)(list->data + offset);
+        void *          payload = command + 1;
+        offset += command->size;
+
+        switch (command->type) {
+            case R_DRAW_CLEAR: {
+                r_draw_color_cmd *cmd = payload;
+                ClearBackground(cmd->color);
+                break;
+            }
+            case R_DRAW_LINE: {
+                r_draw_line_cmd *cmd = payload;
+                DrawLineEx(cmd->start, cmd->end, cmd->thick, cmd->color);
+                break;
+            }
+            case R_DRAW_CIRCLE: {
+                r_draw_circle_cmd *cmd = payload;
+                DrawCircleV(cmd->center, cmd->radius, cmd->color);
+                break;
+            }
+            case R_DRAW_CIRCLE_LINES: {
+                r_draw_circle_cmd *cmd = payload;
+                DrawCircleLines((int)cmd->center.x, (int)cmd->center.y, cmd->radius, cmd->color);
+                break;
+            }
+            case R_DRAW_RECTANGLE: {
+                r_draw_rectangle_cmd *cmd = payload;
+                DrawRectanglePro(cmd->rec, cmd->origin, cmd->rotation, cmd->color);
+                break;
+            }
+            case R_DRAW_RECTANGLE_LINES: {
+                r_draw_rectangle_lines_cmd *cmd = payload;
+                DrawRectangleLinesEx(cmd->rec, cmd->thick, cmd->color);
+                break;
+            }
+            case R_DRAW_TRIANGLE: {
+                r_draw_triangle_cmd *cmd = payload;
+                DrawTriangle(cmd->v1, cmd->v2, cmd->v3, cmd->color);
+                break;
+            }
+            case R_DRAW_TEXT: {
+                r_draw_text_cmd *cmd = payload;
+                const char *     text = (const char *)(cmd + 1);
+                if (cmd->default_font) {
+                    DrawText(text, (int)cmd->position.x, (int)cmd->position.y, (int)cmd->size, cmd->color);
+                } else {
+                    DrawTextEx(cmd->font, text, cmd->position, cmd->size, cmd->spacing, cmd->color);
+                }
+                break;
+            }
+            case R_DRAW_TEXTURE: {
+                r_draw_texture_cmd *cmd = payload;
+                DrawTexturePro(cmd->texture, cmd->source, cmd->dest, cmd->origin, cmd->rotation, cmd->tint);
+                break;
+            }
+            case R_DRAW_BEGIN_MODE_2D: {
+                r_draw_camera_2d_cmd *cmd = payload;
+                BeginMode2D(cmd->camera);
+                mode_2d = true;
+                break;
+            }
+            case R_DRAW_END_MODE_2D:
+                EndMode2D();
+                mode_2d = false;
+                break;
+            case R_DRAW_BEGIN_MODE_3D: {
+                r_draw_camera_3d_cmd *cmd = payload;
+                BeginMode3D(cmd->camera);
+                mode_3d = true;
+                break;
+            }
+            case R_DRAW_END_MODE_3D:
+                EndMode3D();
+                mode_3d = false;
+                break;
+            case R_DRAW_LINE_3D: {
+                r_draw_line_3d_cmd *cmd = payload;
+                DrawLine3D(cmd->start, cmd->end, cmd->color);
+                break;
+            }
+            case R_DRAW_CUBE: {
+                r_draw_cube_cmd *cmd = payload;
+                DrawCubeV(cmd->position, cmd->size, cmd->color);
+                break;
+            }
+            case R_DRAW_CUBE_WIRES: {
+                r_draw_cube_cmd *cmd = payload;
+                DrawCubeWiresV(cmd->position, cmd->size, cmd->color);
+                break;
+            }
+            case R_DRAW_SPHERE: {
+                r_draw_sphere_cmd *cmd = payload;
+                DrawSphereEx(cmd->center, cmd->radius, cmd->rings, cmd->slices, cmd->color);
+                break;
+            }
+            case R_DRAW_SPHERE_WIRES: {
+                r_draw_sphere_cmd *cmd = payload;
+                DrawSphereWires(cmd->center, cmd->radius, cmd->rings, cmd->slices, cmd->color);
+                break;
+            }
+            case R_DRAW_PLANE: {
+                r_draw_plane_cmd *cmd = payload;
+                DrawPlane(cmd->center, cmd->size, cmd->color);
+                break;
+            }
+            case R_DRAW_GRID: {
+                r_draw_grid_cmd *cmd = payload;
+                DrawGrid(cmd->slices, cmd->spacing);
+                break;
+            }
+            case R_DRAW_MESH: {
+                r_draw_mesh_cmd *cmd = payload;
+                DrawMesh(cmd->mesh, cmd->material, cmd->transform);
+                break;
+            }
+            case R_DRAW_MODEL: {
+                r_draw_model_cmd *cmd = payload;
+                DrawModel(cmd->model, cmd->position, cmd->scale, cmd->tint);
+                break;
+            }
+            default:
+                r_log(R_LOG_ERROR, "draw: unknown command %u in a list of %s\n", command->type, list->owner);
+                return;
+        }
+    }
+
+    // a list can't leave its camera behind for the next one
+    if (mode_2d) {
+        EndMode2D();
+    }
+    if (mode_3d) {
+        EndMode3D();
+    }
+}
+
+r_draw_list * r_draw_list_begin(r_module_properties *props, uint32_t key) {
+    pthread_mutex_lock(&lock);
+    r_draw_list *list = pool;
+    if (list != NULL) {
+        pool = list->next;
+    }
+    pthread_mutex_unlock(&lock);
+
+    if (list == NULL) {
+        list = MALLOC(r_draw_list, 1);
+        list->data = NULL;
+        list->capacity = 0;
+        list->reserve = _reserve;
+    }
+
+    list->size = 0;
+    list->key = key;
+    snprintf(list->owner, sizeof(list->owner), "%s", props ? props->name : "host");
+    list->next = NULL;
+
+    return list;
+}
+
+void r_draw_list_submit(r_draw_list *list) {
+    pthread_mutex_lock(&lock);
+    list->next = submitted;
+    submitted = list;
+    submitted_count++;
+    pthread_mutex_unlock(&lock);
+}
+
+void r_draw_frame_end() {
+    pthread_mutex_lock(&lock);
+    // a frame which was never replayed is drawn along with this one
+    while (submitted) {
+        r_draw_list *next = submitted->next;
+        submitted->next = sealed;
+        sealed = submitted;
+        submitted = next;
+    }
+    sealed_count += submitted_count;
+    submitted_count = 0;
+    pthread_mutex_unlock(&lock);
+}
+
+void r_draw_replay() {
+    pthread_mutex_lock(&lock);
+    r_draw_list *lists = sealed;
+    uint32_t     count = sealed_count;
+    sealed = NULL;
+    sealed_count = 0;
+    pthread_mutex_unlock(&lock);
+
+    if (count == 0) {
+        return;
+    }
+
+    r_draw_list **sorted = MALLOC(r_draw_list *, count);
+    uint32_t      index = count;
+
+    for (r_draw_list *list = lists; list; list = list->next) {
+        sorted[--index] = list;
+    }
+    qsort(sorted, count, sizeof(r_draw_list *), _list_compare);
+
+    for (uint32_t i = 0; i < count; i++) {
+        _replay_list(sorted[i]);
+    }
+
+    // hand the buffers back with their capacity
+    pthread_mutex_lock(&lock);
+    for (uint32_t i = 0; i < count; i++) {
+        sorted[i]->next = pool;
+        pool = sorted[i];
+    }
+    pthread_mutex_unlock(&lock);
+
+    FREE(r_draw_list *, sorted);
+}
+
+void r_draw_destroy() {
+    pthread_mutex_lock(&lock);
+    r_draw_list *lists[3] = { pool, submitted, sealed };
+    pool = NULL;
+    submitted = NULL;
+    submitted_count = 0;
+    sealed = NULL;
+    sealed_count = 0;
+    pthread_mutex_unlock(&lock);
+
+    for (uint32_t i = 0; i < 3; i++) {
+        while (lists[i]) {
+            r_draw_list *next = lists[i]->next;
+            if (lists[i]->data) {
+                FREE(uint8_t, lists[i]->data);
+            }
+            FREE(r_draw_list, lists[i]);
+            lists[i] = next;
+        }
+    }
+}
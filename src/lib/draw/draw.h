@@ -0,0 +1,28 @@
+#ifndef _DRAW_H_
+#define _DRAW_H_
+
+// r_draw owns the pool of deferred draw lists (see draw/commands.h) and
+// replays the submitted ones on the main thread.
+//
+// Lists replay in order of their key, then their module's name. Lists of one
+// module sharing a key are ordered by their contents, which doesn't depend on
+// the threads that recorded them, give them distinct keys when the order
+// between them matters.
+
+#include "draw/commands.h"
+
+#define DRAW_LIST_CAPACITY 4096
+
+r_draw_list * r_draw_list_begin(r_module_properties *props, uint32_t key);
+void          r_draw_list_submit(r_draw_list *list);
+
+// seal the lists submitted so far into the frame the next replay draws, lists
+// submitted afterwards wait for the following frame
+void r_draw_frame_end();
+
+// replay the sealed frame, call between BeginDrawing and EndDrawing
+void r_draw_replay();
+
+void r_draw_destroy();
+
+#endif
@@ -0,0 +1,588 @@
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "fiber/fiber.h"
+#include "job/job.h"
+#include "log/log.h"
+#include "memory/allocator.h"
+#include "module/context.h"
+
+#if defined(__x86_64__) || defined(__aarch64__)
+#define FIBER_ASM
+#else
+#include <ucontext.h>
+#endif
+
+// distinct cache line offsets for the tops of the stacks
+#define FIBER_STACK_COLOURS 64
+
+typedef enum r_fiber_wait {
+    R_FIBER_READY,
+    R_FIBER_NEXT_FRAME,
+    R_FIBER_JOB,
+    R_FIBER_FD,
+    R_FIBER_DONE,
+} r_fiber_wait;
+
+typedef struct r_fiber {
+#ifdef FIBER_ASM
+    // saved stack pointer while suspended, the registers are pushed below it
+    void *               sp;
+#else
+    ucontext_t           context;
+#endif
+    uint8_t *            mapping;
+
+    r_module_properties *owner;
+    r_fiber_fn           fn;
+    // set for fibers which migrate across a reload
+    r_module_fn *        entry;
+    void *               data;
+    r_module_phase       phase;
+
+    r_fiber_wait         wait;
+    r_job *              job;
+    uint32_t             job_generation;
+    int                  fd;
+    short                events;
+    short                revents;
+
+    struct r_fiber *     next;
+} r_fiber;
+
+// fibers which have been spawned but not yet picked up by their phase
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static r_fiber *       incoming[R_MODULE_PHASE_COUNT];
+
+// only touched by the thread running the phase, or while no phase runs
+static r_fiber *       runnable[R_MODULE_PHASE_COUNT];
+static struct pollfd * polled[R_MODULE_PHASE_COUNT];
+static uint32_t        polled_capacity[R_MODULE_PHASE_COUNT];
+
+// stacks of finished fibers, kept mapped for the next spawn
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static r_fiber *       pool = NULL;
+
+static _Thread_local r_fiber *current = NULL;
+
+// Context switch
+// --------------
+
+#ifdef FIBER_ASM
+
+// saves the callee saved registers on the current stack, stores the stack
+// pointer in *from and resumes the stack at to
+void r_fiber_switch_context(void **from, void *to) __asm__("r_fiber_switch_context");
+// first return address of a fiber, calls the function in the second register with the fiber in the first
+void r_fiber_trampoline(void) __asm__("r_fiber_trampoline");
+
+#if defined(__x86_64__)
+
+__asm__(
+    ".text\n"
+    ".globl r_fiber_switch_context\n"
+#ifdef __linux__
+    ".hidden r_fiber_switch_context\n"
+#endif
+    ".p2align 4\n"
+    "r_fiber_switch_context:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".globl r_fiber_trampoline\n"
+#ifdef __linux__
+    ".hidden r_fiber_trampoline\n"
+#endif
+    ".p2align 4\n"
+    "r_fiber_trampoline:\n"
+    "    movq %r12, %rdi\n"
+    "    andq $-16, %rsp\n"
+    "    callq *%r13\n"
+    "    ud2\n"
+);
+
+// mxcsr and the x87 control word, then r15 to rbp and the return address
+#define FIBER_FRAME_WORDS 8
+
+static void * _frame(uintptr_t *top, r_fiber *fiber, void (*main)(r_fiber *)) {
+    uintptr_t *frame = top - FIBER_FRAME_WORDS;
+
+    memset(frame, 0, sizeof(uintptr_t) * FIBER_FRAME_WORDS);
+    frame[0] = 0x1F80 | ((uintptr_t)0x037F << 32);
+    frame[3] = (uintptr_t)main;          // r13
+    frame[4] = (uintptr_t)fiber;         // r12
+    frame[7] = (uintptr_t)r_fiber_trampoline;
+    return frame;
+}
+
+#else
+
+__asm__(
+    ".text\n"
+    ".globl r_fiber_switch_context\n"
+#ifdef __linux__
+    ".hidden r_fiber_switch_context\n"
+#endif
+    ".p2align 4\n"
+    "r_fiber_switch_context:\n"
+    "    sub sp, sp, #160\n"
+    "    stp x19, x20, [sp, #0]\n"
+    "    stp x21, x22, [sp, #16]\n"
+    "    stp x23, x24, [sp, #32]\n"
+    "    stp x25, x26, [sp, #48]\n"
+    "    stp x27, x28, [sp, #64]\n"
+    "    stp x29, x30, [sp, #80]\n"
+    "    stp d8, d9, [sp, #96]\n"
+    "    stp d10, d11, [sp, #112]\n"
+    "    stp d12, d13, [sp, #128]\n"
+    "    stp d14, d15, [sp, #144]\n"
+    "    mov x9, sp\n"
+    "    str x9, [x0]\n"
+    "    mov sp, x1\n"
+    "    ldp x19, x20, [sp, #0]\n"
+    "    ldp x21, x22, [sp, #16]\n"
+    "    ldp x23, x24, [sp, #32]\n"
+    "    ldp x25, x26, [sp, #48]\n"
+    "    ldp x27, x28, [sp, #64]\n"
+    "    ldp x29, x30, [sp, #80]\n"
+    "    ldp d8, d9, [sp, #96]\n"
+    "    ldp d10, d11, [sp, #112]\n"
+    "    ldp d12, d13, [sp, #128]\n"
+    "    ldp d14, d15, [sp, #144]\n"
+    "    add sp, sp, #160\n"
+    "    ret\n"
+    ".globl r_fiber_trampoline\n"
+#ifdef __linux__
+    ".hidden r_fiber_trampoline\n"
+#endif
+    ".p2align 4\n"
+    "r_fiber_trampoline:\n"
+    "    mov x0, x19\n"
+    "    blr x20\n"
+    "    brk #0\n"
+);
+
+// x19 to x30 followed by d8 to d15
+#define FIBER_FRAME_WORDS 20
+
+static void * _frame(uintptr_t *top, r_fiber *fiber, void (*main)(r_fiber *)) {
+    uintptr_t *frame = top - FIBER_FRAME_WORDS;
+
+    memset(frame, 0, sizeof(uintptr_t) * FIBER_FRAME_WORDS);
+    frame[0] = (uintptr_t)fiber;         // x19
+    frame[1] = (uintptr_t)main;          // x20
+    frame[11] = (uintptr_t)r_fiber_trampoline;
+    return frame;
+}
+
+#endif
+
+static _Thread_local void *scheduler = NULL;
+
+static void _switch_to(r_fiber *fiber) {
+    r_fiber_switch_context(&scheduler, fiber->sp);
+}
+
+static void _switch_back(r_fiber *fiber) {
+    r_fiber_switch_context(&fiber->sp, scheduler);
+}
+
+#else
+
+static _Thread_local ucontext_t scheduler;
+
+static void _switch_to(r_fiber *fiber) {
+    swapcontext(&scheduler, &fiber->context);
+}
+
+static void _switch_back(r_fiber *fiber) {
+    swapcontext(&fiber->context, &scheduler);
+}
+
+#endif
+
+// Fibers
+// ------
+
+static void _fiber_main(r_fiber *fiber) {
+    r_fiber_fn fn = fiber->entry ? (r_fiber_fn)fiber->entry->ptr : fiber->fn;
+
+    if (fn) {
+        fn(fiber->data);
+    } else {
+        r_log(R_LOG_ERROR, "fiber: %s has no entry point\n", fiber->owner->name);
+    }
+
+    fiber->wait = R_FIBER_DONE;
+    _switch_back(fiber);
+}
+
+#ifndef FIBER_ASM
+static void _fiber_start(uint32_t high, uint32_t low) {
+    _fiber_main((r_fiber *)(((uintptr_t)high << 32) | low));
+}
+#endif
+
+// point the fiber at the top of a fresh stack
+static void _prepare(r_fiber *fiber) {
+    uint8_t *top = (uint8_t *)((uintptr_t)fiber & ~(uintptr_t)15);
+
+#ifdef FIBER_ASM
+    fiber->sp = _frame((uintptr_t *)top, fiber, _fiber_main);
+#else
+    uint8_t *bottom = fiber->mapping + sysconf(_SC_PAGESIZE);
+    uintptr_t address = (uintptr_t)fiber;
+
+    getcontext(&fiber->context);
+    fiber->context.uc_stack.ss_sp = bottom;
+    fiber->context.uc_stack.ss_size = (size_t)(top - bottom);
+    fiber->context.uc_link = NULL;
+    makecontext(&fiber->context, (void (*)(void))_fiber_start, 2, (uint32_t)(address >> 32), (uint32_t)address);
+#endif
+
+    fiber->wait = R_FIBER_READY;
+}
+
+static size_t _mapping_size() {
+    return FIBER_STACK_SIZE + (size_t)sysconf(_SC_PAGESIZE);
+}
+
+static r_fiber * _acquire() {
+    pthread_mutex_lock(&pool_lock);
+    r_fiber *fiber = pool;
+    if (fiber) {
+        pool = fiber->next;
+    }
+    pthread_mutex_unlock(&pool_lock);
+
+    if (fiber) {
+        return fiber;
+    }
+
+    // the stack grows down towards a guard page, the fiber sits at its top
+    size_t   page = (size_t)sysconf(_SC_PAGESIZE);
+    uint8_t *mapping = mmap(NULL, _mapping_size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (mapping == MAP_FAILED) {
+        return NULL;
+    }
+    mprotect(mapping, page, PROT_NONE);
+
+    // stagger the tops so thousands of stacks don't all land in the same cache sets
+    static _Atomic uint32_t colour = 0;
+    uintptr_t top = (uintptr_t)(mapping + _mapping_size()) - (atomic_fetch_add(&colour, 1) % FIBER_STACK_COLOURS) * 64;
+    fiber = (r_fiber *)((top - sizeof(r_fiber)) & ~(uintptr_t)63);
+    fiber->mapping = mapping;
+
+    return fiber;
+}
+
+static void _release(r_fiber *fiber) {
+    pthread_mutex_lock(&pool_lock);
+    fiber->next = pool;
+    pool = fiber;
+    pthread_mutex_unlock(&pool_lock);
+}
+
+static bool _spawn(r_module_properties *owner, r_fiber_fn fn, r_module_fn *entry, void *data, r_module_phase phase) {
+    if (phase >= R_MODULE_PHASE_COUNT) {
+        return false;
+    }
+
+    r_fiber *fiber = _acquire();
+
+    if (fiber == NULL) {
+        r_log(R_LOG_ERROR, "fiber: unable to map a stack for %s\n", owner ? owner->name : "host");
+        return false;
+    }
+
+    fiber->owner = owner;
+    fiber->fn = fn;
+    fiber->entry = entry;
+    fiber->data = data;
+    fiber->phase = phase;
+    fiber->job = NULL;
+    _prepare(fiber);
+
+    pthread_mutex_lock(&lock);
+    fiber->next = incoming[phase];
+    incoming[phase] = fiber;
+    pthread_mutex_unlock(&lock);
+
+    return true;
+}
+
+bool r_fiber_spawn(r_module_properties *owner, r_fiber_fn fn, void *data, r_module_phase phase) {
+    return _spawn(owner, fn, NULL, data, phase);
+}
+
+bool r_fiber_spawn_bound(r_module_properties *owner, r_module_fn *entry, void *data, r_module_phase phase) {
+    return _spawn(owner, NULL, entry, data, phase);
+}
+
+static void _suspend(r_fiber_wait wait) {
+    r_fiber *fiber = current;
+
+    if (fiber == NULL) {
+        r_log(R_LOG_ERROR, "fiber: unable to wait outside of a fiber\n");
+        return;
+    }
+
+    fiber->wait = wait;
+    _switch_back(fiber);
+    fiber->wait = R_FIBER_READY;
+}
+
+void r_fiber_yield() {
+    _suspend(R_FIBER_NEXT_FRAME);
+}
+
+void r_fiber_wait_job(r_job *job) {
+    if (current) {
+        current->job = job;
+        current->job_generation = r_job_generation(job);
+    }
+    _suspend(R_FIBER_JOB);
+}
+
+void r_fiber_wait_fd(int fd, short events) {
+    if (current) {
+        current->fd = fd;
+        current->events = events;
+    }
+    _suspend(R_FIBER_FD);
+}
+
+bool r_fiber_active() {
+    return current != NULL;
+}
+
+bool r_fiber_stack(uintptr_t *low, uintptr_t *high) {
+    r_fiber *fiber = current;
+
+    if (fiber == NULL) {
+        return false;
+    }
+
+    // the guard page at the bottom is left out by callers checking the stack pointer
+    *low = (uintptr_t)fiber->mapping;
+    *high = (uintptr_t)fiber;
+    return true;
+}
+
+// one poll for every fiber of the phase waiting on an fd, the results are left in revents
+static void _poll(r_module_phase phase) {
+    uint32_t count = 0;
+    for (r_fiber *fiber = runnable[phase]; fiber; fiber = fiber->next) {
+        count += fiber->wait == R_FIBER_FD;
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    if (count > polled_capacity[phase]) {
+        if (polled[phase]) {
+            FREE(struct pollfd, polled[phase]);
+        }
+        polled[phase] = MALLOC(struct pollfd, count);
+        polled_capacity[phase] = count;
+    }
+
+    struct pollfd *fds = polled[phase];
+    uint32_t       i = 0;
+    for (r_fiber *fiber = runnable[phase]; fiber; fiber = fiber->next) {
+        if (fiber->wait == R_FIBER_FD) {
+            fds[i++] = (struct pollfd){ .fd = fiber->fd, .events = fiber->events };
+        }
+    }
+
+    // an interrupted poll leaves them all waiting until the next pass
+    int ready = poll(fds, count, 0);
+
+    i = 0;
+    for (r_fiber *fiber = runnable[phase]; fiber; fiber = fiber->next) {
+        if (fiber->wait == R_FIBER_FD) {
+            fiber->revents = ready > 0 ? fds[i].revents : 0;
+            i++;
+        }
+    }
+}
+
+static bool _ready(r_fiber *fiber) {
+    switch (fiber->wait) {
+        case R_FIBER_JOB:
+            // once the slot has been reused the job we waited on is long done
+            return r_job_finished(fiber->job) || r_job_generation(fiber->job) != fiber->job_generation;
+        case R_FIBER_FD:
+            // errors and hang ups wake the fiber as well
+            return fiber->revents != 0;
+        default:
+            return true;
+    }
+}
+
+void r_fiber_resume(r_module_phase phase) {
+    pthread_mutex_lock(&lock);
+    r_fiber *spawned = incoming[phase];
+    incoming[phase] = NULL;
+    pthread_mutex_unlock(&lock);
+
+    // append the new fibers in the order they were spawned
+    r_fiber **link = &runnable[phase];
+    while (*link) {
+        link = &(*link)->next;
+    }
+
+    r_fiber *reversed = NULL;
+    while (spawned) {
+        r_fiber *next = spawned->next;
+        spawned->next = reversed;
+        reversed = spawned;
+        spawned = next;
+    }
+    *link = reversed;
+
+    if (runnable[phase] == NULL) {
+        return;
+    }
+
+    _poll(phase);
+
+    r_module_properties *previous = r_module_context_get();
+
+    link = &runnable[phase];
+    while (*link) {
+        r_fiber *fiber = *link;
+
+        if (_ready(fiber)) {
+            r_module_context_set(fiber->owner);
+            current = fiber;
+            _switch_to(fiber);
+            current = NULL;
+        }
+
+        if (fiber->wait == R_FIBER_DONE) {
+            *link = fiber->next;
+            _release(fiber);
+        } else {
+            link = &fiber->next;
+        }
+    }
+
+    r_module_context_set(previous);
+}
+
+// Reloads
+// -------
+
+uint32_t r_fiber_pinned(r_module_properties *owner) {
+    uint32_t count = 0;
+
+    pthread_mutex_lock(&lock);
+    for (uint32_t phase = 0; phase < R_MODULE_PHASE_COUNT; phase++) {
+        r_fiber *lists[2] = { runnable[phase], incoming[phase] };
+
+        for (uint32_t i = 0; i < 2; i++) {
+            for (r_fiber *fiber = lists[i]; fiber; fiber = fiber->next) {
+                if (fiber->owner == owner && fiber->entry == NULL) {
+                    count++;
+                }
+            }
+        }
+    }
+    pthread_mutex_unlock(&lock);
+
+    return count;
+}
+
+// restart the module's bound fibers and drop the rest, or drop all of them
+static void _release_owner(r_module_properties *owner, bool restart) {
+    pthread_mutex_lock(&lock);
+    for (uint32_t phase = 0; phase < R_MODULE_PHASE_COUNT; phase++) {
+        r_fiber **lists[2] = { &runnable[phase], &incoming[phase] };
+
+        for (uint32_t i = 0; i < 2; i++) {
+            r_fiber **link = lists[i];
+
+            while (*link) {
+                r_fiber *fiber = *link;
+
+                if (fiber->owner != owner) {
+                    link = &fiber->next;
+                } else if (restart && fiber->entry) {
+                    _prepare(fiber);
+                    link = &fiber->next;
+                } else {
+                    *link = fiber->next;
+                    _release(fiber);
+                }
+            }
+        }
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void r_fiber_migrate(r_module_properties *owner) {
+    _release_owner(owner, true);
+}
+
+void r_fiber_cancel(r_module_properties *owner) {
+    _release_owner(owner, false);
+}
+
+void r_fiber_destroy() {
+    pthread_mutex_lock(&lock);
+    for (uint32_t phase = 0; phase < R_MODULE_PHASE_COUNT; phase++) {
+        r_fiber *lists[2] = { runnable[phase], incoming[phase] };
+        runnable[phase] = NULL;
+        incoming[phase] = NULL;
+
+        for (uint32_t i = 0; i < 2; i++) {
+            while (lists[i]) {
+                r_fiber *next = lists[i]->next;
+                _release(lists[i]);
+                lists[i] = next;
+            }
+        }
+    }
+    pthread_mutex_unlock(&lock);
+
+    for (uint32_t phase = 0; phase < R_MODULE_PHASE_COUNT; phase++) {
+        if (polled[phase]) {
+            FREE(struct pollfd, polled[phase]);
+        }
+        polled_capacity[phase] = 0;
+    }
+
+    pthread_mutex_lock(&pool_lock);
+    while (pool) {
+        r_fiber *next = pool->next;
+        munmap(pool->mapping, _mapping_size());
+        pool = next;
+    }
+    pthread_mutex_unlock(&pool_lock);
+}
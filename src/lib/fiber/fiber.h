@@ -0,0 +1,50 @@
+#ifndef _FIBER_H_
+#define _FIBER_H_
+
+// r_fiber is a cooperative fiber scheduler for module logic which waits
+// across frames, see r_module_fibers.
+//
+// Each fiber owns a pooled stack mapped by the host with a guard page below
+// it, the fiber itself lives at the top of its stack. Switching saves only
+// the callee saved registers, on x86_64 and aarch64 it is a handful of
+// instructions, other targets fall back to ucontext.
+//
+// Fibers of a phase are resumed by r_fiber_resume on whichever thread runs
+// that phase, and only ever on that thread.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "module/interface.h"
+
+#define FIBER_STACK_SIZE (64 * 1024)
+
+bool r_fiber_spawn(r_module_properties *owner, r_fiber_fn fn, void *data, r_module_phase phase);
+bool r_fiber_spawn_bound(r_module_properties *owner, r_module_fn *entry, void *data, r_module_phase phase);
+
+void r_fiber_yield();
+void r_fiber_wait_job(r_job *job);
+void r_fiber_wait_fd(int fd, short events);
+
+// true while running inside a fiber
+bool r_fiber_active();
+
+// bounds of the running fiber's stack, false outside a fiber. Safe to call
+// from a signal handler
+bool r_fiber_stack(uintptr_t *low, uintptr_t *high);
+
+// resume every fiber of the phase which is ready to run
+void r_fiber_resume(r_module_phase phase);
+
+// fibers of the module which keep its image from being unloaded
+uint32_t r_fiber_pinned(r_module_properties *owner);
+
+// restart the module's bound fibers from their entry once it has been reloaded
+void r_fiber_migrate(r_module_properties *owner);
+
+// drop every fiber of the module without running it any further
+void r_fiber_cancel(r_module_properties *owner);
+
+void r_fiber_destroy();
+
+#endif
@@ -1,13 +1,21 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE   // asprintf
+#endif
+
 #include <stdbool.h>
 #include <stdint.h>
+#include <limits.h>
 #include <stdio.h>
 #include <time.h>
 #include <string.h>
 #include <sys/stat.h>
 
 
+#include "cluster/cluster.h"
+#include "log/log.h"
 #include "memory/allocator.h"
 #include "module/interface.h"
+#include "module/tweak.h"
 
 #define USING_NOTIFY 1
 
@@ -17,9 +25,29 @@
 #include "filetracker/notify/notify.h"
 #endif
 
+// directories keep their slot, the notifier holds on to the changed flag
+typedef struct r_tracked_directory {
+    char *   path;
+    bool     changed;
+    bool     notified;   // without a notifier its files are looked at on every check
+    uint32_t files;
+} r_tracked_directory;
+
+typedef struct r_tracked_file {
+    char *   path;
+    bool *   changed;
+    int64_t  modified_ns;
+    int64_t  size;
+    uint32_t directory;
+} r_tracked_file;
+
 typedef struct r_filetracker {
     r_module_interface *modules[MAX_MODULES];
     uint32_t            count;
+
+    r_tracked_file      files[MAX_TRACKED_FILES];
+    uint32_t            file_count;
+    r_tracked_directory directories[MAX_TRACKED_DIRECTORIES];
 } r_filetracker;
 
 // Create a new filetracker instance
@@ -27,7 +55,7 @@ r_filetracker * r_filetracker_create() {
 
     // Allocate memory for the filetracker
     r_filetracker *filetracker = MALLOC(r_filetracker, 1);
-    filetracker->count = 0;
+    memset(filetracker, 0, sizeof(r_filetracker));
 
 #ifdef USING_NOTIFY
     // Initialize the notify system
@@ -48,6 +76,16 @@ void r_filetracker_destroy(r_filetracker *filetracker) {
     // reset the count
     filetracker->count = 0;   
 
+    // the notifiers went with the notify system
+    for (uint32_t i = 0; i < filetracker->file_count; i++) {
+        free(filetracker->files[i].path);
+    }
+    for (uint32_t i = 0; i < MAX_TRACKED_DIRECTORIES; i++) {
+        if (filetracker->directories[i].path) {
+            free(filetracker->directories[i].path);
+        }
+    }
+
     // Free the filetracker
     FREE(r_filetracker, filetracker);
 }
@@ -90,6 +128,134 @@ void r_filetracker_remove_module(r_filetracker *filetracker, const char *lib_pat
     }
 }
 
+static void _stat_file(r_tracked_file *file, int64_t *modified_ns, int64_t *size) {
+    struct stat statbuf;
+
+    // a missing file counts as changed once it appears
+    if (stat(file->path, &statbuf) != 0) {
+        *modified_ns = 0;
+        *size = -1;
+        return;
+    }
+
+#if defined(__APPLE__)
+    *modified_ns = (int64_t)statbuf.st_mtimespec.tv_sec * 1000000000ll + statbuf.st_mtimespec.tv_nsec;
+#else
+    *modified_ns = (int64_t)statbuf.st_mtim.tv_sec * 1000000000ll + statbuf.st_mtim.tv_nsec;
+#endif
+    *size = (int64_t)statbuf.st_size;
+}
+
+static void _check_files(r_filetracker *filetracker) {
+    for (uint32_t i = 0; i < filetracker->file_count; i++) {
+        r_tracked_file *     file = &filetracker->files[i];
+        r_tracked_directory *directory = &filetracker->directories[file->directory];
+
+        if (directory->notified && !directory->changed) {
+            continue;
+        }
+
+        int64_t modified_ns, size;
+        _stat_file(file, &modified_ns, &size);
+
+        if (modified_ns != file->modified_ns || size != file->size) {
+            file->modified_ns = modified_ns;
+            file->size = size;
+            *file->changed = true;
+        }
+    }
+
+    for (uint32_t i = 0; i < MAX_TRACKED_DIRECTORIES; i++) {
+        filetracker->directories[i].changed = false;
+    }
+}
+
+// find or start tracking the directory the file is in
+static int32_t _track_directory(r_filetracker *filetracker, const char *path) {
+    char        directory[PATH_MAX];
+    const char *slash = strrchr(path, '/');
+
+    if (slash == NULL) {
+        snprintf(directory, sizeof(directory), ".");
+    } else {
+        snprintf(directory, sizeof(directory), "%.*s", (int)(slash - path + (slash == path)), path);
+    }
+
+    int32_t free_slot = -1;
+    for (int32_t i = 0; i < MAX_TRACKED_DIRECTORIES; i++) {
+        r_tracked_directory *tracked = &filetracker->directories[i];
+
+        if (tracked->path && strcmp(tracked->path, directory) == 0) {
+            return i;
+        }
+        if (!tracked->path && free_slot < 0) {
+            free_slot = i;
+        }
+    }
+
+    if (free_slot < 0) {
+        r_log(R_LOG_WARNING, "filetracker: too many directories, unable to track %s\n", path);
+        return -1;
+    }
+
+    r_tracked_directory *tracked = &filetracker->directories[free_slot];
+    asprintf(&tracked->path, "%s", directory);
+    tracked->changed = false;
+    tracked->files = 0;
+#ifdef USING_NOTIFY
+    tracked->notified = r_file_notifier_create(tracked->path, &tracked->changed);
+#else
+    tracked->notified = false;
+#endif
+    return free_slot;
+}
+
+bool r_filetracker_add_file(r_filetracker *filetracker, const char *path, bool *changed) {
+    if (filetracker->file_count == MAX_TRACKED_FILES) {
+        r_log(R_LOG_WARNING, "filetracker: too many files, unable to track %s\n", path);
+        return false;
+    }
+
+    int32_t directory = _track_directory(filetracker, path);
+    if (directory < 0) {
+        return false;
+    }
+    filetracker->directories[directory].files++;
+
+    r_tracked_file *file = &filetracker->files[filetracker->file_count++];
+    asprintf(&file->path, "%s", path);
+    file->changed = changed;
+    file->directory = (uint32_t)directory;
+    _stat_file(file, &file->modified_ns, &file->size);
+
+    return true;
+}
+
+void r_filetracker_remove_file(r_filetracker *filetracker, bool *changed) {
+    for (uint32_t i = 0; i < filetracker->file_count; ) {
+        r_tracked_file *file = &filetracker->files[i];
+
+        if (file->changed != changed) {
+            i++;
+            continue;
+        }
+
+        r_tracked_directory *directory = &filetracker->directories[file->directory];
+        if (--directory->files == 0) {
+#ifdef USING_NOTIFY
+            if (directory->notified) {
+                r_file_notifier_destroy(&directory->changed);
+            }
+#endif
+            free(directory->path);
+            directory->path = NULL;
+        }
+
+        free(file->path);
+        *file = filetracker->files[--filetracker->file_count];
+    }
+}
+
 // check if any modules have been modified
 void r_filetracker_check(r_filetracker *filetracker, float delta_time) {
 
@@ -102,26 +268,30 @@ void r_filetracker_check(r_filetracker *filetracker, float delta_time) {
     }
     time_since_last_check = 0.0f;
 
-    // Check if any modules have been modified and need reloading
-    for (uint32_t i = 0; i < filetracker->count; i++) {
+    // Check if any modules have been modified and need reloading, a follower
+    // waits for the leader to announce a library it has finished writing
+    bool following = r_cluster_get_role() == R_CLUSTER_FOLLOWER;
+    for (uint32_t i = 0; i < filetracker->count && !following; i++) {
         r_module_properties *props = &filetracker->modules[i]->properties;
         struct stat statbuf;
 
         if (stat(props->library_path, &statbuf) == 0) {
 
-            if (props->last_modified != statbuf.st_mtime) {
+            uint64_t modified = (uint64_t)statbuf.st_mtime;
+
+            if (props->last_modified != modified) {
                 if ( props->last_modified == 0 ) {
-                    props->last_modified = statbuf.st_mtime;
+                    props->last_modified = modified;
                     continue;                    
                 }
-                props->last_modified = statbuf.st_mtime;
+                props->last_modified = modified;
                 props->needs_reload = true;
             }
         } else {
             perror("failed to stat library");
             char filename[256];
             sprintf(filename, "%s", props->library_path);
-            printf("attempting to stat %s\n", filename);
+            r_log(R_LOG_DEBUG, "attempting to stat %s\n", filename);
         }
     }
 
@@ -130,4 +300,15 @@ void r_filetracker_check(r_filetracker *filetracker, float delta_time) {
     r_file_notify_update(0.1);
 #endif
 
+    _check_files(filetracker);
+
+    // Edits which only change tweak values are patched into the running module without a rebuild
+    for (uint32_t i = 0; i < filetracker->count; i++) {
+        r_module_properties *props = &filetracker->modules[i]->properties;
+
+        if (props->files_changed && r_tweak_apply(props)) {
+            props->files_changed = false;
+        }
+    }
+
 }
@@ -7,12 +7,20 @@ typedef struct r_filetracker r_filetracker;
 
 #define CHECK_FREQUENCY_S 1.0f
 
+#define MAX_TRACKED_FILES       2048
+#define MAX_TRACKED_DIRECTORIES 32
+
 r_filetracker * r_filetracker_create();
 void r_filetracker_destroy(r_filetracker *filetracker);
 void r_filetracker_add_module(r_filetracker *filetracker, r_module_interface *module);
 void r_filetracker_remove_module(r_filetracker *filetracker, const char *lib_path);
 void r_filetracker_check(r_filetracker *filetracker, float delta_time);
 
+// track a single file, changed is raised when its modification time or size moves.
+// only the files of directories which reported events are looked at when checking
+bool r_filetracker_add_file(r_filetracker *filetracker, const char *path, bool *changed);
+void r_filetracker_remove_file(r_filetracker *filetracker, bool *changed);
+
 
 
 #endif
\ No newline at end of file
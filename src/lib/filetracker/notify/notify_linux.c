@@ -1,51 +1,210 @@
 #if defined(__linux__)
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE   // asprintf, nftw and FTW_PHYS
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <limits.h>
 #include <stdio.h>
-#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/inotify.h>
 
-#define EVENT_SIZE (sizeof(struct inotify_event))
-#define BUF_LEN (1024 * (EVENT_SIZE + 16))
+#include "log/log.h"
+#include "memory/allocator.h"
 
-int main() {
-    const char *path = "/path/to/directory";
-    int fd = inotify_init();
-    if (fd < 0) {
-        perror("inotify_init");
-        exit(1);
+#include "filetracker/notify/notify.h"
+
+#define MAX_WATCHERS 64
+#define MAX_WATCHES  1024
+#define EVENT_MASK   (IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM | IN_CLOSE_WRITE)
+
+// inotify doesn't watch subdirectories, every directory below the root gets its own watch
+typedef struct r_file_notify {
+    bool *files_changed;
+} r_file_notify;
+
+typedef struct r_file_watch {
+    int            wd;
+    char *         path;
+    r_file_notify *notify;
+} r_file_watch;
+
+static int           fd = -1;
+static r_file_notify watchers[MAX_WATCHERS];
+static uint32_t      watcher_count = 0;
+static r_file_watch  watches[MAX_WATCHES];
+static uint32_t      watch_count = 0;
+
+// nftw has no user data
+static r_file_notify *adding = NULL;
+
+static void _watch(const char *directory, r_file_notify *notify) {
+    if (watch_count == MAX_WATCHES) {
+        r_log(R_LOG_WARNING, "notify: too many directories, not watching %s\n", directory);
+        return;
     }
-    int wd = inotify_add_watch(fd, path, IN_MODIFY | IN_CREATE | IN_DELETE);
+
+    int wd = inotify_add_watch(fd, directory, EVENT_MASK);
     if (wd < 0) {
-        perror("inotify_add_watch");
-        exit(1);
+        r_log(R_LOG_WARNING, "notify: unable to watch %s: %s\n", directory, strerror(errno));
+        return;
+    }
+
+    // the same directory watched twice shares a descriptor
+    for (uint32_t i = 0; i < watch_count; i++) {
+        if (watches[i].wd == wd && watches[i].notify == notify) {
+            return;
+        }
+    }
+    r_file_watch *watch = &watches[watch_count++];
+    watch->wd = wd;
+    watch->notify = notify;
+    asprintf(&watch->path, "%s", directory);
+}
+
+static int _watch_entry(const char *path, const struct stat *statbuf, int type, struct FTW *ftw) {
+    (void)statbuf;
+    (void)ftw;
+
+    if (type == FTW_D) {
+        _watch(path, adding);
+    }
+    return 0;
+}
+
+// Create a new file notify instance watching the directory and everything below it
+bool r_file_notifier_create(const char *directory, bool *files_changed) {
+
+    if (fd < 0 || watcher_count == MAX_WATCHERS) {
+        return false;
     }
 
-    printf("Tracking directory %s\n", path);
+    r_file_notify *notify = &watchers[watcher_count++];
+    notify->files_changed = files_changed;
+
+    adding = notify;
+    nftw(directory, _watch_entry, 16, FTW_PHYS);
+    adding = NULL;
+
+    return true;
+}
+
+// Destroy a file notify instance
+void r_file_notifier_destroy(bool *files_changed) {
 
-    char buf[BUF_LEN];
-    while (1) {
-        ssize_t len = read(fd, buf, BUF_LEN);
-        if (len < 0) {
-            perror("read");
-            exit(1);
+    // Find the notifier using the bool pointer
+    uint32_t inst = watcher_count;
+    for (uint32_t i = 0; i < watcher_count; i++) {
+        if (watchers[i].files_changed == files_changed) {
+            inst = i;
+            break;
         }
-        char *ptr = buf;
-        while (ptr < buf + len) {
+    }
+    if (inst == watcher_count) {
+        return;
+    }
+
+    // drop its watches, the kernel keeps a descriptor which another notifier still uses
+    for (uint32_t i = 0; i < watch_count; ) {
+        if (watches[i].notify == &watchers[inst]) {
+            int  wd = watches[i].wd;
+            FREE(char, watches[i].path);
+            watches[i] = watches[--watch_count];
+
+            bool shared = false;
+            for (uint32_t j = 0; j < watch_count; j++) {
+                shared = shared || watches[j].wd == wd;
+            }
+            if (!shared) {
+                inotify_rm_watch(fd, wd);
+            }
+        } else {
+            i++;
+        }
+    }
+
+    // shuffle the watchers down to fill the gap, their watches follow
+    for (uint32_t i = inst; i < watcher_count - 1; i++) {
+        watchers[i] = watchers[i + 1];
+    }
+    watcher_count--;
+
+    for (uint32_t i = 0; i < watch_count; i++) {
+        if (watches[i].notify > &watchers[inst]) {
+            watches[i].notify--;
+        }
+    }
+}
+
+// r_notify lifecycle functions
+
+void r_file_notify_init() {
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        r_log(R_LOG_ERROR, "notify: inotify unavailable: %s\n", strerror(errno));
+    }
+}
+
+// the kernel queues events until they're read, so this never waits for run_time
+void r_file_notify_update(float run_time) {
+    (void)run_time;
+
+    if (fd < 0) {
+        return;
+    }
+
+    char buffer[16 * (sizeof(struct inotify_event) + NAME_MAX + 1)] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    for (;;) {
+        ssize_t length = read(fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+
+        for (char *ptr = buffer; ptr < buffer + length; ) {
             struct inotify_event *event = (struct inotify_event *)ptr;
-            if (event->mask & IN_CREATE) {
-                printf("File %s created\n", event->name);
-            } else if (event->mask & IN_DELETE) {
-                printf("File %s deleted\n", event->name);
-            } else if (event->mask & IN_MODIFY) {
-                printf("File %s modified\n", event->name);
+            uint32_t              count = watch_count;
+
+            // one directory may be watched by several notifiers
+            for (uint32_t i = 0; i < count; i++) {
+                r_file_watch *watch = &watches[i];
+                if (watch->wd != event->wd) {
+                    continue;
+                }
+
+                r_log(R_LOG_DEBUG, "notify: %s/%s changed, mask %x\n", watch->path, event->len ? event->name : "", event->mask);
+                *watch->notify->files_changed = true;
+
+                // keep up with directories created below the root
+                if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO)) && event->len) {
+                    char path[PATH_MAX];
+                    snprintf(path, sizeof(path), "%s/%s", watch->path, event->name);
+
+                    adding = watch->notify;
+                    nftw(path, _watch_entry, 16, FTW_PHYS);
+                    adding = NULL;
+                }
             }
-            ptr += EVENT_SIZE + event->len;
+
+            ptr += sizeof(struct inotify_event) + event->len;
         }
     }
+}
 
-    inotify_rm_watch(fd, wd);
-    close(fd);
-    return 0;
+void r_file_notify_destroy() {
+    // Destroy all the watchers
+    while (watcher_count > 0) {
+        r_file_notifier_destroy(watchers[watcher_count - 1].files_changed);
+    }
 
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
 }
-#endif
\ No newline at end of file
+
+#endif
@@ -1,8 +1,10 @@
 #if defined(__APPLE__)
 
 #include <stdio.h>
+#include <string.h>
 #include <CoreServices/CoreServices.h>
 
+#include "log/log.h"
 #include "memory/allocator.h"
 
 #include "filetracker/notify/notify.h"
@@ -16,6 +18,37 @@ typedef struct r_file_notify {
     bool            *files_changed;
 } r_file_notify;
 
+static const struct {
+    FSEventStreamEventFlags flag;
+    const char *            name;
+} event_flags[] = {
+    { kFSEventStreamEventFlagNone, "FlagNone" },
+    { kFSEventStreamEventFlagMustScanSubDirs, "FlagMustScanSubDirs" },
+    { kFSEventStreamEventFlagUserDropped, "FlagUserDropped" },
+    { kFSEventStreamEventFlagKernelDropped, "FlagKernelDropped" },
+    { kFSEventStreamEventFlagEventIdsWrapped, "FlagEventIdsWrapped" },
+    { kFSEventStreamEventFlagHistoryDone, "FlagHistoryDone" },
+    { kFSEventStreamEventFlagRootChanged, "FlagRootChanged" },
+    { kFSEventStreamEventFlagMount, "FlagMount" },
+    { kFSEventStreamEventFlagUnmount, "FlagUnmount" },
+    { kFSEventStreamEventFlagItemCreated, "FlagItemCreated" },
+    { kFSEventStreamEventFlagItemRemoved, "FlagItemRemoved" },
+    { kFSEventStreamEventFlagItemInodeMetaMod, "FlagItemInodeMetaMod" },
+    { kFSEventStreamEventFlagItemRenamed, "FlagItemRenamed" },
+    { kFSEventStreamEventFlagItemModified, "FlagItemModified" },
+    { kFSEventStreamEventFlagItemFinderInfoMod, "FlagItemFinderInfoMod" },
+    { kFSEventStreamEventFlagItemChangeOwner, "FlagItemChangeOwner" },
+    { kFSEventStreamEventFlagItemXattrMod, "FlagItemXattrMod" },
+    { kFSEventStreamEventFlagItemIsFile, "FlagItemIsFile" },
+    { kFSEventStreamEventFlagItemIsDir, "FlagItemIsDir" },
+    { kFSEventStreamEventFlagItemIsSymlink, "FlagItemIsSymlink" },
+    { kFSEventStreamEventFlagOwnEvent, "FlagOwnEvent" },
+    { kFSEventStreamEventFlagItemIsHardlink, "FlagItemIsHardlink" },
+    { kFSEventStreamEventFlagItemIsLastHardlink, "FlagItemIsLastHardlink" },
+    { kFSEventStreamEventFlagItemCloned, "FlagItemCloned" },
+};
+#define FLAG_COUNT (sizeof(event_flags) / sizeof(event_flags[0]))
+
 void file_change_callback(ConstFSEventStreamRef streamRef,
               void *clientCallBackInfo,
               size_t numEvents,
@@ -28,83 +61,18 @@ void file_change_callback(ConstFSEventStreamRef streamRef,
         // Determine the flag for the event
         FSEventStreamEventFlags flag = eventFlags[i];
 
-        // print the event flags to the console
-        printf("Event flags: ");
-        
-        if (flag & kFSEventStreamEventFlagNone) {
-            printf("FlagNone");
-        }   
-        if (flag & kFSEventStreamEventFlagMustScanSubDirs) {
-            printf("FlagMustScanSubDirs");
-        } 
-        if (flag & kFSEventStreamEventFlagUserDropped) {
-            printf("FlagUserDropped");
-        } 
-        if (flag & kFSEventStreamEventFlagKernelDropped) {
-            printf("FlagKernelDropped");
-        } 
-        if (flag & kFSEventStreamEventFlagEventIdsWrapped) {
-            printf("FlagEventIdsWrapped");
-        } 
-        if (flag & kFSEventStreamEventFlagHistoryDone) {
-            printf("FlagHistoryDone");
-        } 
-        if (flag & kFSEventStreamEventFlagRootChanged) {
-            printf("FlagRootChanged");
-        } 
-        if (flag & kFSEventStreamEventFlagMount) {
-            printf("FlagMount");
-        }  
-        if (flag & kFSEventStreamEventFlagUnmount) {
-            printf("FlagUnmount");
-        } 
-        if (flag & kFSEventStreamEventFlagItemCreated) {
-            printf("FlagItemCreated");
-        }
-        if (flag & kFSEventStreamEventFlagItemRemoved) {
-            printf("FlagItemRemoved");
-        }
-        if (flag & kFSEventStreamEventFlagItemInodeMetaMod) {
-            printf("FlagItemInodeMetaMod");
-        }
-        if (flag & kFSEventStreamEventFlagItemRenamed) {
-            printf("FlagItemRenamed");
-        }
-        if (flag & kFSEventStreamEventFlagItemModified) {
-            printf("FlagItemModified");
-        }
-        if (flag & kFSEventStreamEventFlagItemFinderInfoMod) {
-            printf("FlagItemFinderInfoMod");
-        }
-        if (flag & kFSEventStreamEventFlagItemChangeOwner) {
-            printf("FlagItemChangeOwner");
-        }
-        if (flag & kFSEventStreamEventFlagItemXattrMod) {
-            printf("FlagItemXattrMod");
+        // collect the event flags, this runs for every event so it's only formatted when logged
+        if (r_log_get_level() <= R_LOG_DEBUG) {
+            char   flags[512] = "";
+            size_t length = 0;
+            for (size_t f = 0; f < FLAG_COUNT && length < sizeof(flags); f++) {
+                if (flag & event_flags[f].flag) {
+                    int written = snprintf(flags + length, sizeof(flags) - length, "%s ", event_flags[f].name);
+                    length += written > 0 ? (size_t)written : 0;
+                }
+            }
+            r_log(R_LOG_DEBUG, "Path %s changed, event flags: %s\n", paths[i], flags);
         }
-        if (flag & kFSEventStreamEventFlagItemIsFile) {
-            printf("FlagItemIsFile");
-        }
-        if (flag & kFSEventStreamEventFlagItemIsDir) {
-            printf("FlagItemIsDir");
-        }
-        if (flag & kFSEventStreamEventFlagItemIsSymlink) {
-            printf("FlagItemIsSymlink");
-        }
-        if (flag & kFSEventStreamEventFlagOwnEvent) {
-            printf("FlagOwnEvent");
-        }
-        if (flag & kFSEventStreamEventFlagItemIsHardlink) {
-            printf("FlagItemIsHardlink");
-        }
-        if (flag & kFSEventStreamEventFlagItemIsLastHardlink) {
-            printf("FlagItemIsLastHardlink");
-        }
-        if (flag & kFSEventStreamEventFlagItemCloned) {
-            printf("FlagItemCloned");
-        }
-
-        printf("Path %s changed\n", paths[i]);
     }
 
     // don't confirm the direct matching, just assume that apple has it sorted
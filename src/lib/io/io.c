@@ -0,0 +1,1058 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE   // statx and AT_EMPTY_PATH
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#ifdef RELOAD_LINUX
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#define IO_URING
+#endif
+
+#include "raylib.h"
+
+#include "fiber/fiber.h"
+#include "io/io.h"
+#include "log/log.h"
+#include "memory/allocator.h"
+#include "memory/tagged.h"
+#include "module/context.h"
+
+// largest single read or write handed to the kernel
+#define IO_MAX_TRANSFER (1u << 30)
+
+typedef enum r_io_op {
+    R_IO_READ_FILE,
+    R_IO_WRITE_FILE,
+    R_IO_READ,
+    R_IO_WRITE,
+} r_io_op;
+
+// whole file requests open, size up, transfer and close, the others only transfer
+typedef enum r_io_step {
+    R_IO_STEP_OPEN,
+    R_IO_STEP_STAT,
+    R_IO_STEP_TRANSFER,
+    R_IO_STEP_CLOSE,
+    R_IO_STEP_DONE,
+} r_io_step;
+
+struct r_io_request {
+    r_io_op              op;
+    r_io_step            step;
+    r_module_properties *owner;
+    r_io_callback        callback;
+    void *               data;
+
+    char *               path;
+    int                  fd;
+    uint8_t *            buffer;
+    bool                 owns_buffer;
+    size_t               size;
+    size_t               transferred;
+    uint64_t             offset;
+    int                  error;
+    int64_t              result;
+#ifdef IO_URING
+    struct statx         stat;
+    // the step in flight transfers through a registered buffer
+    bool                 fixed;
+#endif
+
+    _Atomic bool         finished;
+    r_io_request *       next;
+};
+
+typedef struct r_io_registered {
+    uint8_t *address;
+    size_t   size;
+} r_io_registered;
+
+static bool            running = false;
+static bool            uring = false;
+
+// completions, and the queue of the thread pool
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  completion = PTHREAD_COND_INITIALIZER;
+static r_io_request *  completed = NULL;
+static _Atomic int32_t outstanding = 0;
+
+static pthread_cond_t  work = PTHREAD_COND_INITIALIZER;
+static r_io_request *  queued = NULL;
+static r_io_request *  ready = NULL;
+static r_io_request *  ready_tail = NULL;
+static bool            stopping = false;
+static pthread_t       threads[IO_THREADS];
+static uint32_t        thread_count = 0;
+
+// guards the submission queue and the registered buffers
+static pthread_mutex_t submit_lock = PTHREAD_MUTEX_INITIALIZER;
+static r_io_registered buffers[MAX_IO_BUFFERS];
+static uint32_t        buffer_count = 0;
+// the registered set only changes once no transfer uses it
+static pthread_cond_t  fixed_idle = PTHREAD_COND_INITIALIZER;
+static uint32_t        fixed_in_flight = 0;
+static bool            registering = false;
+
+// raylib reads of this thread are reported to the observer
+static _Thread_local r_io_observer observer = NULL;
+static _Thread_local void *        observer_data = NULL;
+
+static bool _reading(r_io_request *request) {
+    return request->op == R_IO_READ_FILE || request->op == R_IO_READ;
+}
+
+static bool _opens(r_io_request *request) {
+    return request->op == R_IO_READ_FILE || request->op == R_IO_WRITE_FILE;
+}
+
+// raylib releases loaded file data with RL_FREE, which is r_tagged_free
+static bool _allocate(r_io_request *request, size_t size) {
+    request->buffer = r_tagged_alloc(request->owner, size + 1);
+    if (request->buffer == NULL) {
+        return false;
+    }
+    request->owns_buffer = true;
+    request->size = size;
+    return true;
+}
+
+static int _buffer_index(const uint8_t *address, size_t size) {
+    if (registering) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < buffer_count; i++) {
+        if (address >= buffers[i].address && address + size <= buffers[i].address + buffers[i].size) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static void _finish(r_io_request *request) {
+    request->result = request->error ? -request->error : (int64_t)request->transferred;
+
+    if (request->owns_buffer) {
+        request->buffer[request->transferred] = '\0';
+    }
+
+    pthread_mutex_lock(&lock);
+    if (request->callback) {
+        request->next = completed;
+        completed = request;
+    } else if (request->owner) {
+        // nothing left to run in the module for this one
+        atomic_fetch_sub(&request->owner->io.in_flight, 1);
+    }
+    atomic_fetch_sub(&outstanding, 1);
+    // last, a waiter may release the request as soon as it sees it finished
+    atomic_store_explicit(&request->finished, true, memory_order_release);
+    pthread_cond_broadcast(&completion);
+    pthread_mutex_unlock(&lock);
+}
+
+// account for a transfer of n bytes and work out what comes next
+static void _transferred(r_io_request *request, int64_t n) {
+    if (n < 0) {
+        request->error = (int)-n;
+    } else if (n == 0) {
+        // the file ended early, a write which makes no progress has failed
+        if (_reading(request)) {
+            request->size = request->transferred;
+        } else {
+            request->error = EIO;
+        }
+    } else {
+        request->transferred += (size_t)n;
+    }
+
+    if (request->error == 0 && request->transferred < request->size) {
+        return;
+    }
+    request->step = _opens(request) ? R_IO_STEP_CLOSE : R_IO_STEP_DONE;
+}
+
+// Thread pool
+// -----------
+
+static void _perform(r_io_request *request) {
+    if (_opens(request)) {
+        int flags = _reading(request) ? O_RDONLY : O_WRONLY | O_CREAT | O_TRUNC;
+        request->fd = open(request->path, flags | O_CLOEXEC, 0644);
+
+        if (request->fd < 0) {
+            request->error = errno;
+            return;
+        }
+    }
+
+    if (request->op == R_IO_READ_FILE) {
+        struct stat statbuf;
+        if (fstat(request->fd, &statbuf) != 0) {
+            request->error = errno;
+        } else if (!_allocate(request, (size_t)statbuf.st_size)) {
+            request->error = ENOMEM;
+        }
+    }
+
+    request->step = R_IO_STEP_TRANSFER;
+    while (request->error == 0 && request->step == R_IO_STEP_TRANSFER && request->transferred < request->size) {
+        size_t  remaining = request->size - request->transferred;
+        size_t  chunk = remaining < IO_MAX_TRANSFER ? remaining : IO_MAX_TRANSFER;
+        off_t   offset = (off_t)(request->offset + request->transferred);
+        ssize_t n = _reading(request)
+            ? pread(request->fd, request->buffer + request->transferred, chunk, offset)
+            : pwrite(request->fd, request->buffer + request->transferred, chunk, offset);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        _transferred(request, n < 0 ? -errno : n);
+    }
+
+    if (_opens(request)) {
+        close(request->fd);
+    }
+}
+
+static void * _worker(void *arg) {
+    (void)arg;
+
+    pthread_mutex_lock(&lock);
+    for (;;) {
+        while (ready == NULL && !stopping) {
+            pthread_cond_wait(&work, &lock);
+        }
+        if (ready == NULL) {
+            break;
+        }
+
+        r_io_request *request = ready;
+        ready = request->next;
+        if (ready == NULL) {
+            ready_tail = NULL;
+        }
+        pthread_mutex_unlock(&lock);
+
+        _perform(request);
+        _finish(request);
+
+        pthread_mutex_lock(&lock);
+    }
+    pthread_mutex_unlock(&lock);
+
+    return NULL;
+}
+
+// io_uring
+// --------
+
+#ifdef IO_URING
+
+typedef struct r_io_ring {
+    int                  fd;
+    unsigned             entries;
+
+    _Atomic unsigned *   sq_head;
+    _Atomic unsigned *   sq_tail;
+    unsigned *           sq_mask;
+    unsigned *           sq_array;
+    struct io_uring_sqe *sqes;
+
+    _Atomic unsigned *   cq_head;
+    _Atomic unsigned *   cq_tail;
+    unsigned *           cq_mask;
+    struct io_uring_cqe *cqes;
+
+    void *               sq_map;
+    size_t               sq_map_size;
+    void *               cq_map;
+    size_t               cq_map_size;
+    size_t               sqes_size;
+
+    // prepared but not yet handed to the kernel
+    unsigned             unsubmitted;
+    // waiting for a free submission entry, in order
+    r_io_request *       deferred;
+    r_io_request *       deferred_tail;
+    pthread_t            reaper;
+} r_io_ring;
+
+static r_io_ring ring;
+
+static int _ring_enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+    int result;
+    do {
+        result = (int)syscall(__NR_io_uring_enter, ring.fd, to_submit, min_complete, flags, NULL, 0);
+    } while (result < 0 && errno == EINTR);
+    return result;
+}
+
+// every operation the requests use has to be there
+static bool _ring_probe(int fd) {
+    static const uint8_t needed[] = {
+        IORING_OP_NOP, IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_CLOSE,
+        IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READ_FIXED, IORING_OP_WRITE_FIXED,
+    };
+
+    size_t size = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe *probe = calloc(1, size);
+    bool supported = syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, 256) == 0;
+
+    for (uint32_t i = 0; supported && i < sizeof(needed); i++) {
+        supported = needed[i] <= probe->last_op && (probe->ops[needed[i]].flags & IO_URING_OP_SUPPORTED);
+    }
+
+    free(probe);
+    return supported;
+}
+
+static bool _ring_create() {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    int fd = (int)syscall(__NR_io_uring_setup, IO_QUEUE_DEPTH, &params);
+    if (fd < 0) {
+        r_log(R_LOG_INFO, "io: io_uring unavailable (%s)\n", strerror(errno));
+        return false;
+    }
+
+    if (!(params.features & IORING_FEAT_NODROP) || !_ring_probe(fd)) {
+        r_log(R_LOG_INFO, "io: io_uring lacks the operations needed\n");
+        close(fd);
+        return false;
+    }
+
+    ring.fd = fd;
+    ring.entries = params.sq_entries;
+    ring.sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring.cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring.sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single && ring.cq_map_size > ring.sq_map_size) {
+        ring.sq_map_size = ring.cq_map_size;
+    }
+
+    ring.sq_map = mmap(NULL, ring.sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    ring.cq_map = single ? ring.sq_map : mmap(NULL, ring.cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    ring.sqes = mmap(NULL, ring.sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+
+    if (ring.sq_map == MAP_FAILED || ring.cq_map == MAP_FAILED || ring.sqes == MAP_FAILED) {
+        r_log(R_LOG_ERROR, "io: unable to map the io_uring queues\n");
+        close(fd);
+        return false;
+    }
+
+    uint8_t *sq = ring.sq_map;
+    ring.sq_head = (_Atomic unsigned *)(sq + params.sq_off.head);
+    ring.sq_tail = (_Atomic unsigned *)(sq + params.sq_off.tail);
+    ring.sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+    ring.sq_array = (unsigned *)(sq + params.sq_off.array);
+
+    uint8_t *cq = ring.cq_map;
+    ring.cq_head = (_Atomic unsigned *)(cq + params.cq_off.head);
+    ring.cq_tail = (_Atomic unsigned *)(cq + params.cq_off.tail);
+    ring.cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+    ring.cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+    // entries are always used in ring order
+    for (unsigned i = 0; i < ring.entries; i++) {
+        ring.sq_array[i] = i;
+    }
+    ring.unsubmitted = 0;
+    ring.deferred = NULL;
+    ring.deferred_tail = NULL;
+
+    return true;
+}
+
+static void _ring_destroy() {
+    if (ring.cq_map != ring.sq_map) {
+        munmap(ring.cq_map, ring.cq_map_size);
+    }
+    munmap(ring.sq_map, ring.sq_map_size);
+    munmap(ring.sqes, ring.sqes_size);
+    close(ring.fd);
+}
+
+// the next free submission entry or NULL when the queue is full, with submit_lock held
+static struct io_uring_sqe * _ring_sqe() {
+    unsigned tail = atomic_load_explicit(ring.sq_tail, memory_order_relaxed);
+
+    if (tail - atomic_load_explicit(ring.sq_head, memory_order_acquire) == ring.entries) {
+        return NULL;
+    }
+
+    struct io_uring_sqe *sqe = &ring.sqes[tail & *ring.sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+static void _ring_push() {
+    unsigned tail = atomic_load_explicit(ring.sq_tail, memory_order_relaxed);
+    atomic_store_explicit(ring.sq_tail, tail + 1, memory_order_release);
+    ring.unsubmitted++;
+}
+
+static void _ring_fill(struct io_uring_sqe *sqe, r_io_request *request) {
+    sqe->user_data = (uint64_t)(uintptr_t)request;
+
+    switch (request->step) {
+        case R_IO_STEP_OPEN:
+            sqe->opcode = IORING_OP_OPENAT;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = (uint64_t)(uintptr_t)request->path;
+            sqe->len = 0644;
+            sqe->open_flags = (_reading(request) ? O_RDONLY : O_WRONLY | O_CREAT | O_TRUNC) | O_CLOEXEC;
+            break;
+        case R_IO_STEP_STAT:
+            sqe->opcode = IORING_OP_STATX;
+            sqe->fd = request->fd;
+            sqe->addr = (uint64_t)(uintptr_t)"";
+            sqe->len = STATX_SIZE;
+            sqe->statx_flags = AT_EMPTY_PATH;
+            sqe->off = (uint64_t)(uintptr_t)&request->stat;
+            break;
+        case R_IO_STEP_TRANSFER: {
+            size_t   remaining = request->size - request->transferred;
+            size_t   chunk = remaining < IO_MAX_TRANSFER ? remaining : IO_MAX_TRANSFER;
+            uint8_t *address = request->buffer + request->transferred;
+            int      index = _buffer_index(address, chunk);
+
+            request->fixed = index >= 0;
+            if (request->fixed) {
+                sqe->opcode = _reading(request) ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+                sqe->buf_index = (uint16_t)index;
+                fixed_in_flight++;
+            } else {
+                sqe->opcode = _reading(request) ? IORING_OP_READ : IORING_OP_WRITE;
+            }
+            sqe->fd = request->fd;
+            sqe->addr = (uint64_t)(uintptr_t)address;
+            sqe->len = (uint32_t)chunk;
+            sqe->off = request->offset + request->transferred;
+            break;
+        }
+        case R_IO_STEP_CLOSE:
+            sqe->opcode = IORING_OP_CLOSE;
+            sqe->fd = request->fd;
+            break;
+        default:
+            break;
+    }
+
+    _ring_push();
+}
+
+static void _ring_defer(r_io_request *request) {
+    request->next = NULL;
+    if (ring.deferred_tail) {
+        ring.deferred_tail->next = request;
+    } else {
+        ring.deferred = request;
+    }
+    ring.deferred_tail = request;
+}
+
+// hand every prepared entry to the kernel and the entries which free up to the
+// deferred requests, with submit_lock held
+static void _ring_flush() {
+    for (;;) {
+        while (ring.unsubmitted > 0) {
+            int submitted = _ring_enter(ring.unsubmitted, 0, 0);
+            if (submitted <= 0) {
+                // the completion queue is backed up, the reaper will make room and flush again
+                return;
+            }
+            ring.unsubmitted -= (unsigned)submitted;
+        }
+
+        struct io_uring_sqe *sqe;
+        if (ring.deferred == NULL || (sqe = _ring_sqe()) == NULL) {
+            return;
+        }
+        while (ring.deferred && sqe) {
+            r_io_request *request = ring.deferred;
+            ring.deferred = request->next;
+            if (ring.deferred == NULL) {
+                ring.deferred_tail = NULL;
+            }
+            _ring_fill(sqe, request);
+            sqe = ring.deferred ? _ring_sqe() : NULL;
+        }
+    }
+}
+
+// queue the request's next step, with submit_lock held. Nothing waits for a
+// free entry here, the reaper takes submit_lock to make progress
+static void _ring_prepare(r_io_request *request) {
+    struct io_uring_sqe *sqe = ring.deferred ? NULL : _ring_sqe();
+    if (sqe == NULL && ring.deferred == NULL) {
+        _ring_flush();
+        sqe = _ring_sqe();
+    }
+
+    if (sqe) {
+        _ring_fill(sqe, request);
+    } else {
+        _ring_defer(request);
+    }
+}
+
+// move the request on with the result of its last step
+static void _ring_advance(r_io_request *request, int32_t result) {
+    switch (request->step) {
+        case R_IO_STEP_OPEN:
+            if (result < 0) {
+                request->error = -result;
+                request->step = R_IO_STEP_DONE;
+            } else {
+                request->fd = result;
+                request->step = request->op == R_IO_READ_FILE ? R_IO_STEP_STAT : R_IO_STEP_TRANSFER;
+                if (request->step == R_IO_STEP_TRANSFER && request->size == 0) {
+                    request->step = R_IO_STEP_CLOSE;
+                }
+            }
+            break;
+        case R_IO_STEP_STAT:
+            if (result < 0) {
+                request->error = -result;
+                request->step = R_IO_STEP_CLOSE;
+            } else if (!_allocate(request, (size_t)request->stat.stx_size)) {
+                request->error = ENOMEM;
+                request->step = R_IO_STEP_CLOSE;
+            } else {
+                request->step = request->size ? R_IO_STEP_TRANSFER : R_IO_STEP_CLOSE;
+            }
+            break;
+        case R_IO_STEP_TRANSFER:
+            if (request->fixed) {
+                pthread_mutex_lock(&submit_lock);
+                if (--fixed_in_flight == 0) {
+                    pthread_cond_broadcast(&fixed_idle);
+                }
+                pthread_mutex_unlock(&submit_lock);
+                request->fixed = false;
+            }
+            if (result == -EAGAIN || result == -EINTR) {
+                break;
+            }
+            _transferred(request, result);
+            break;
+        default:
+            request->step = R_IO_STEP_DONE;
+            break;
+    }
+
+    if (request->step == R_IO_STEP_DONE) {
+        _finish(request);
+        return;
+    }
+
+    // follow up steps don't wait for the next batch
+    pthread_mutex_lock(&submit_lock);
+    _ring_prepare(request);
+    _ring_flush();
+    pthread_mutex_unlock(&submit_lock);
+}
+
+static void * _ring_reaper(void *arg) {
+    (void)arg;
+    bool stop = false;
+
+    while (!stop) {
+        _ring_enter(0, 1, IORING_ENTER_GETEVENTS);
+
+        unsigned head = atomic_load_explicit(ring.cq_head, memory_order_relaxed);
+        unsigned tail = atomic_load_explicit(ring.cq_tail, memory_order_acquire);
+
+        while (head != tail) {
+            struct io_uring_cqe *cqe = &ring.cqes[head & *ring.cq_mask];
+            r_io_request *       request = (r_io_request *)(uintptr_t)cqe->user_data;
+            int32_t              result = cqe->res;
+
+            // free the slot first, advancing may queue more work
+            atomic_store_explicit(ring.cq_head, ++head, memory_order_release);
+
+            if (request == NULL) {
+                stop = true;
+            } else {
+                _ring_advance(request, result);
+            }
+        }
+
+        // submissions turned away while the completion queue was backed up
+        pthread_mutex_lock(&submit_lock);
+        _ring_flush();
+        pthread_mutex_unlock(&submit_lock);
+    }
+
+    return NULL;
+}
+
+static bool _ring_register_buffers() {
+    syscall(__NR_io_uring_register, ring.fd, IORING_UNREGISTER_BUFFERS, NULL, 0);
+
+    if (buffer_count == 0) {
+        return true;
+    }
+
+    struct iovec iovecs[MAX_IO_BUFFERS];
+    for (uint32_t i = 0; i < buffer_count; i++) {
+        iovecs[i] = (struct iovec){ .iov_base = buffers[i].address, .iov_len = buffers[i].size };
+    }
+    return syscall(__NR_io_uring_register, ring.fd, IORING_REGISTER_BUFFERS, iovecs, buffer_count) == 0;
+}
+
+#endif
+
+// Service
+// -------
+
+bool r_io_create() {
+    if (running) {
+        return true;
+    }
+
+    stopping = false;
+
+#ifdef IO_URING
+    if (_ring_create()) {
+        if (pthread_create(&ring.reaper, NULL, _ring_reaper, NULL) == 0) {
+            uring = true;
+            running = true;
+            r_log(R_LOG_INFO, "io: using io_uring with %u entries\n", ring.entries);
+            return true;
+        }
+        _ring_destroy();
+    }
+#endif
+
+    for (thread_count = 0; thread_count < IO_THREADS; thread_count++) {
+        if (pthread_create(&threads[thread_count], NULL, _worker, NULL) != 0) {
+            break;
+        }
+    }
+
+    running = thread_count > 0;
+    if (running) {
+        r_log(R_LOG_INFO, "io: using %u I/O threads\n", thread_count);
+    } else {
+        r_log(R_LOG_WARNING, "io: no I/O threads, requests will run on submission\n");
+    }
+    return running;
+}
+
+static r_io_request * _request(r_module_properties *owner, r_io_op op, r_io_callback callback, void *data) {
+    r_io_request *request = MALLOC(r_io_request, 1);
+
+    *request = (r_io_request){
+        .op = op,
+        .step = R_IO_STEP_OPEN,
+        .owner = owner,
+        .callback = callback,
+        .data = data,
+        .fd = -1,
+    };
+    atomic_init(&request->finished, false);
+
+    return request;
+}
+
+static r_io_request * _queue(r_io_request *request) {
+    atomic_fetch_add(&outstanding, 1);
+    if (request->owner) {
+        atomic_fetch_add(&request->owner->io.in_flight, 1);
+    }
+
+    if (!running) {
+        _perform(request);
+        _finish(request);
+        return request;
+    }
+
+#ifdef IO_URING
+    if (uring) {
+        if (!_opens(request)) {
+            request->step = request->size ? R_IO_STEP_TRANSFER : R_IO_STEP_DONE;
+            if (request->step == R_IO_STEP_DONE) {
+                _finish(request);
+                return request;
+            }
+        }
+
+        pthread_mutex_lock(&submit_lock);
+        _ring_prepare(request);
+        pthread_mutex_unlock(&submit_lock);
+        return request;
+    }
+#endif
+
+    pthread_mutex_lock(&lock);
+    request->next = queued;
+    queued = request;
+    pthread_mutex_unlock(&lock);
+
+    return request;
+}
+
+r_io_request * r_io_read_file(r_module_properties *owner, const char *path, r_io_callback callback, void *data) {
+    r_io_request *request = _request(owner, R_IO_READ_FILE, callback, data);
+    request->path = strdup(path);
+    return _queue(request);
+}
+
+r_io_request * r_io_write_file(r_module_properties *owner, const char *path, const void *buffer, size_t size, r_io_callback callback, void *data) {
+    r_io_request *request = _request(owner, R_IO_WRITE_FILE, callback, data);
+    request->path = strdup(path);
+    request->buffer = (uint8_t *)buffer;
+    request->size = size;
+    return _queue(request);
+}
+
+r_io_request * r_io_read(r_module_properties *owner, int fd, void *buffer, size_t size, uint64_t offset, r_io_callback callback, void *data) {
+    r_io_request *request = _request(owner, R_IO_READ, callback, data);
+    request->fd = fd;
+    request->buffer = buffer;
+    request->size = size;
+    request->offset = offset;
+    return _queue(request);
+}
+
+r_io_request * r_io_write(r_module_properties *owner, int fd, const void *buffer, size_t size, uint64_t offset, r_io_callback callback, void *data) {
+    r_io_request *request = _request(owner, R_IO_WRITE, callback, data);
+    request->fd = fd;
+    request->buffer = (uint8_t *)buffer;
+    request->size = size;
+    request->offset = offset;
+    return _queue(request);
+}
+
+// with submit_lock held, new transfers stay off the registered buffers until _registered
+static void _registering() {
+    registering = true;
+    while (fixed_in_flight > 0) {
+        pthread_cond_wait(&fixed_idle, &submit_lock);
+    }
+}
+
+static void _registered() {
+    registering = false;
+}
+
+bool r_io_register_buffer(void *buffer, size_t size) {
+    bool registered = true;
+
+    pthread_mutex_lock(&submit_lock);
+    _registering();
+    if (buffer_count == MAX_IO_BUFFERS) {
+        registered = false;
+    } else {
+        buffers[buffer_count++] = (r_io_registered){ .address = buffer, .size = size };
+#ifdef IO_URING
+        if (uring && !_ring_register_buffers()) {
+            // the kernel dropped the old set as well, put it back
+            buffer_count--;
+            _ring_register_buffers();
+            registered = false;
+        }
+#endif
+    }
+    _registered();
+    pthread_mutex_unlock(&submit_lock);
+
+    if (!registered) {
+        r_log(R_LOG_WARNING, "io: unable to register a buffer of %zu bytes\n", size);
+    }
+    return registered;
+}
+
+void r_io_unregister_buffer(void *buffer) {
+    pthread_mutex_lock(&submit_lock);
+    _registering();
+    for (uint32_t i = 0; i < buffer_count; i++) {
+        if (buffers[i].address == buffer) {
+            buffers[i] = buffers[--buffer_count];
+#ifdef IO_URING
+            if (uring) {
+                _ring_register_buffers();
+            }
+#endif
+            break;
+        }
+    }
+    _registered();
+    pthread_mutex_unlock(&submit_lock);
+}
+
+void r_io_submit() {
+#ifdef IO_URING
+    if (uring) {
+        pthread_mutex_lock(&submit_lock);
+        _ring_flush();
+        pthread_mutex_unlock(&submit_lock);
+        return;
+    }
+#endif
+
+    pthread_mutex_lock(&lock);
+    // the queue is in reverse, hand it to the workers in the order it was made
+    r_io_request *batch = NULL;
+    r_io_request *last = queued;
+    while (queued) {
+        r_io_request *request = queued;
+        queued = request->next;
+        request->next = batch;
+        batch = request;
+    }
+
+    if (batch) {
+        if (ready_tail) {
+            ready_tail->next = batch;
+        } else {
+            ready = batch;
+        }
+        ready_tail = last;
+        pthread_cond_broadcast(&work);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+static void _free(r_io_request *request) {
+    if (request->owns_buffer) {
+        r_tagged_free(request->buffer);
+    }
+    free(request->path);
+    FREE(r_io_request, request);
+}
+
+// take the completed requests of the owner, or of everyone
+static r_io_request * _take_completed(r_module_properties *owner) {
+    r_io_request *taken = NULL;
+    r_io_request **link = &completed;
+
+    while (*link) {
+        r_io_request *request = *link;
+        if (owner == NULL || request->owner == owner) {
+            *link = request->next;
+            request->next = taken;
+            taken = request;
+        } else {
+            link = &request->next;
+        }
+    }
+    return taken;
+}
+
+static bool _has_completed(r_module_properties *owner) {
+    for (r_io_request *request = completed; request; request = request->next) {
+        if (request->owner == owner) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void _dispatch(r_module_properties *owner) {
+    pthread_mutex_lock(&lock);
+    r_io_request *requests = _take_completed(owner);
+    pthread_mutex_unlock(&lock);
+
+    if (requests == NULL) {
+        return;
+    }
+
+    r_module_properties *previous = r_module_context_get();
+
+    while (requests) {
+        r_io_request *request = requests;
+        requests = request->next;
+
+        r_module_context_set(request->owner);
+        request->callback(request->data, request->result, request->buffer, request->transferred);
+
+        if (request->owner) {
+            atomic_fetch_sub(&request->owner->io.in_flight, 1);
+        }
+        _free(request);
+    }
+
+    r_module_context_set(previous);
+}
+
+void r_io_dispatch() {
+    _dispatch(NULL);
+}
+
+void r_io_drain(r_module_properties *owner) {
+    r_io_submit();
+
+    while (atomic_load(&owner->io.in_flight) > 0) {
+        _dispatch(owner);
+
+        pthread_mutex_lock(&lock);
+        while (atomic_load(&owner->io.in_flight) > 0 && !_has_completed(owner)) {
+            pthread_cond_wait(&completion, &lock);
+        }
+        pthread_mutex_unlock(&lock);
+    }
+}
+
+void r_io_wait(r_io_request *request) {
+    r_io_submit();
+
+    // a fiber checks back every frame rather than blocking its phase
+    if (r_fiber_active()) {
+        while (!atomic_load_explicit(&request->finished, memory_order_acquire)) {
+            r_fiber_yield();
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&lock);
+    while (!atomic_load_explicit(&request->finished, memory_order_acquire)) {
+        pthread_cond_wait(&completion, &lock);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+int64_t r_io_result(r_io_request *request) {
+    return request->result;
+}
+
+void * r_io_buffer(r_io_request *request, size_t *size) {
+    if (size) {
+        *size = request->transferred;
+    }
+    return request->buffer;
+}
+
+void * r_io_take_buffer(r_io_request *request, size_t *size) {
+    void *buffer = r_io_buffer(request, size);
+    request->owns_buffer = false;
+    return buffer;
+}
+
+void r_io_release(r_io_request *request) {
+    _free(request);
+}
+
+void r_io_destroy() {
+    if (!running) {
+        return;
+    }
+
+    // let everything in flight land, nobody is left to run the callbacks
+    r_io_submit();
+    pthread_mutex_lock(&lock);
+    while (atomic_load(&outstanding) > 0) {
+        pthread_cond_wait(&completion, &lock);
+    }
+    r_io_request *requests = _take_completed(NULL);
+    stopping = true;
+    pthread_cond_broadcast(&work);
+    pthread_mutex_unlock(&lock);
+
+    while (requests) {
+        r_io_request *next = requests->next;
+        _free(requests);
+        requests = next;
+    }
+
+#ifdef IO_URING
+    if (uring) {
+        // a nop without a request wakes and stops the reaper, nothing is in flight so there is room for it
+        pthread_mutex_lock(&submit_lock);
+        struct io_uring_sqe *sqe = _ring_sqe();
+        sqe->opcode = IORING_OP_NOP;
+        _ring_push();
+        _ring_flush();
+        pthread_mutex_unlock(&submit_lock);
+
+        pthread_join(ring.reaper, NULL);
+        _ring_destroy();
+        uring = false;
+    }
+#endif
+
+    for (uint32_t i = 0; i < thread_count; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    thread_count = 0;
+    buffer_count = 0;
+    running = false;
+}
+
+// raylib
+// ------
+
+static unsigned char * _load_file_data(const char *path, unsigned int *bytes_read) {
+    r_io_request *request = r_io_read_file(NULL, path, NULL, NULL);
+    r_io_wait(request);
+
+    size_t         size = 0;
+    unsigned char *data = NULL;
+
+    if (r_io_result(request) < 0) {
+        r_log(R_LOG_WARNING, "io: unable to read %s: %s\n", path, strerror((int)-r_io_result(request)));
+    } else {
+        data = r_io_take_buffer(request, &size);
+        r_tagged_adopt(data, r_module_context_get());
+
+        if (observer != NULL) {
+            observer(path, data, size, observer_data);
+        }
+    }
+    r_io_release(request);
+
+    *bytes_read = (unsigned int)size;
+    return data;
+}
+
+static bool _save_file_data(const char *path, void *data, unsigned int bytes) {
+    r_io_request *request = r_io_write_file(NULL, path, data, bytes, NULL, NULL);
+    r_io_wait(request);
+
+    bool saved = r_io_result(request) == (int64_t)bytes;
+    if (!saved) {
+        r_log(R_LOG_WARNING, "io: unable to write %s\n", path);
+    }
+    r_io_release(request);
+
+    return saved;
+}
+
+static char * _load_file_text(const char *path) {
+    unsigned int size = 0;
+    // reads are zero terminated
+    return (char *)_load_file_data(path, &size);
+}
+
+static bool _save_file_text(const char *path, char *text) {
+    return _save_file_data(path, text, (unsigned int)strlen(text));
+}
+
+void r_io_hook_raylib() {
+    SetLoadFileDataCallback(_load_file_data);
+    SetSaveFileDataCallback(_save_file_data);
+    SetLoadFileTextCallback(_load_file_text);
+    SetSaveFileTextCallback(_save_file_text);
+}
+
+void r_io_observe(r_io_observer callback, void *data) {
+    observer = callback;
+    observer_data = data;
+}
@@ -0,0 +1,65 @@
+#ifndef _IO_H_
+#define _IO_H_
+
+// r_io is the asynchronous file I/O service. Requests can be created on any
+// thread, they are queued and handed over in one batch by r_io_submit, which
+// the host also calls at every frame boundary. On linux they run on io_uring,
+// elsewhere, or when the kernel doesn't support it, on a pool of I/O threads.
+//
+// Callbacks run on the main thread at the next frame boundary (r_io_dispatch)
+// with the module that created the request as the context. The buffer handed
+// to a read callback is freed once the callback returns. A request without a
+// callback is waited on with r_io_wait and released by its creator.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "module/interface.h"
+
+#define IO_QUEUE_DEPTH 256
+#define IO_THREADS     2
+#define MAX_IO_BUFFERS 16
+
+bool r_io_create();
+void r_io_destroy();
+
+// read a whole file into a buffer owned by the request, it is zero terminated
+r_io_request * r_io_read_file(r_module_properties *owner, const char *path, r_io_callback callback, void *data);
+// replace a file with size bytes of buffer, which must stay valid until the request completes
+r_io_request * r_io_write_file(r_module_properties *owner, const char *path, const void *buffer, size_t size, r_io_callback callback, void *data);
+
+// positioned transfers on a descriptor owned by the caller
+r_io_request * r_io_read(r_module_properties *owner, int fd, void *buffer, size_t size, uint64_t offset, r_io_callback callback, void *data);
+r_io_request * r_io_write(r_module_properties *owner, int fd, const void *buffer, size_t size, uint64_t offset, r_io_callback callback, void *data);
+
+// transfers which fall inside a registered buffer skip mapping the pages for every request
+// changing the registered buffers waits for the transfers using them to land
+bool r_io_register_buffer(void *buffer, size_t size);
+void r_io_unregister_buffer(void *buffer);
+
+// hand the queued requests over
+void r_io_submit();
+// run the callbacks of the requests which have completed
+void r_io_dispatch();
+// wait for every request created by the module and run its callbacks
+void r_io_drain(r_module_properties *owner);
+
+// for requests created without a callback, waiting yields when called from a fiber
+void   r_io_wait(r_io_request *request);
+// bytes transferred, or a negative errno
+int64_t r_io_result(r_io_request *request);
+void * r_io_buffer(r_io_request *request, size_t *size);
+// keep the buffer of a read beyond the request, free it with r_tagged_free() or raylib's MemFree()
+void * r_io_take_buffer(r_io_request *request, size_t *size);
+void   r_io_release(r_io_request *request);
+
+// route raylib's LoadFileData, SaveFileData, LoadFileText and SaveFileText through the service
+void r_io_hook_raylib();
+
+// sees every file raylib reads on the calling thread through the hooks
+typedef void (*r_io_observer)(const char *path, const void *buffer, size_t size, void *data);
+// observe this thread's raylib reads, NULL stops observing
+void r_io_observe(r_io_observer observer, void *data);
+
+#endif
@@ -0,0 +1,640 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "job/job.h"
+#include "log/log.h"
+#include "memory/allocator.h"
+#include "module/context.h"
+#include "profile/profile.h"
+#include "time/time.h"
+
+#define JOB_DEQUE_MASK (MAX_JOBS_PER_THREAD - 1)
+
+// number of failed attempts to find work before a worker goes to sleep
+#define JOB_IDLE_SPINS 64
+
+// how long r_job_create helps out with other jobs waiting for a free slot before giving up
+#define JOB_CREATE_TIMEOUT_NS 1000000000ull
+
+// what a job is doing, only a job which was run but hasn't started can be cancelled
+enum {
+    JOB_CREATED,
+    JOB_WAITING,
+    JOB_STARTED,
+    JOB_CANCELLED,
+};
+
+struct r_job {
+    r_job_fn             fn;
+    void *               data;
+
+    // set for the ranges of a parallel_for
+    r_job_range_fn       range_fn;
+    uint32_t             begin;
+    uint32_t             end;
+
+    r_job *              parent;
+    r_module_properties *owner;
+
+    // the job and its children which haven't finished
+    _Atomic int32_t      unfinished;
+    // dependencies which haven't finished, plus one until the job is run
+    _Atomic int32_t      dependencies;
+
+    // jobs waiting on this one, guarded by lock
+    atomic_flag          lock;
+    bool                 done;
+    r_job *              continuations[MAX_JOB_CONTINUATIONS];
+    uint32_t             continuation_count;
+
+    // one of JOB_CREATED, ...
+    _Atomic uint8_t      state;
+
+    // set from creation until the job has finished with its slot
+    _Atomic bool         busy;
+    // bumped each time the slot is handed out
+    _Atomic uint32_t     generation;
+};
+
+// Chase-Lev deque, the owner pushes and pops at the bottom, thieves take from the top
+typedef struct r_job_deque {
+    _Atomic int64_t  top;
+    _Atomic int64_t  bottom;
+    r_job * _Atomic  jobs[MAX_JOBS_PER_THREAD];
+} r_job_deque;
+
+typedef struct r_job_worker {
+    pthread_t   thread;
+    r_job_deque deque;
+    r_job *     ring;
+    uint32_t    ring_next;
+    uint32_t    seed;
+} r_job_worker;
+
+typedef struct r_job_system {
+    r_job_worker    workers[MAX_JOB_WORKERS];
+    uint32_t        count;
+    _Atomic bool    running;
+
+    // jobs pushed by threads which aren't workers
+    pthread_mutex_t inject_lock;
+    r_job *         inject[MAX_JOBS_PER_THREAD];
+    uint32_t        inject_head;
+    uint32_t        inject_tail;
+    r_job *         inject_ring;
+    uint32_t        inject_ring_next;
+
+    // sleeping workers wait for queued to become non zero
+    _Atomic int32_t queued;
+    _Atomic int32_t sleeping;
+    pthread_mutex_t sleep_lock;
+    pthread_cond_t  wake;
+} r_job_system;
+
+static r_job_system *jobs = NULL;
+static _Thread_local int32_t worker_index = -1;
+
+// Deque
+// -----
+
+static bool _deque_push(r_job_deque *deque, r_job *job) {
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+
+    if (bottom - top >= MAX_JOBS_PER_THREAD) {
+        return false;
+    }
+
+    atomic_store_explicit(&deque->jobs[bottom & JOB_DEQUE_MASK], job, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    return true;
+}
+
+static r_job * _deque_pop(r_job_deque *deque) {
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (top > bottom) {
+        // empty
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    r_job *job = atomic_load_explicit(&deque->jobs[bottom & JOB_DEQUE_MASK], memory_order_relaxed);
+
+    if (top == bottom) {
+        // last job, race any thieves for it
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+            job = NULL;
+        }
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return job;
+}
+
+static r_job * _deque_steal(r_job_deque *deque) {
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+
+    if (top >= bottom) {
+        return NULL;
+    }
+
+    r_job *job = atomic_load_explicit(&deque->jobs[top & JOB_DEQUE_MASK], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+        return NULL;
+    }
+    return job;
+}
+
+// Scheduling
+// ----------
+
+static void _job_execute(r_job *job);
+
+static void _job_wake() {
+    atomic_fetch_add(&jobs->queued, 1);
+
+    if (atomic_load(&jobs->sleeping) > 0) {
+        pthread_mutex_lock(&jobs->sleep_lock);
+        pthread_cond_signal(&jobs->wake);
+        pthread_mutex_unlock(&jobs->sleep_lock);
+    }
+}
+
+static void _job_push(r_job *job) {
+    if (worker_index >= 0) {
+        if (_deque_push(&jobs->workers[worker_index].deque, job)) {
+            _job_wake();
+            return;
+        }
+    } else {
+        pthread_mutex_lock(&jobs->inject_lock);
+        bool pushed = jobs->inject_head - jobs->inject_tail < MAX_JOBS_PER_THREAD;
+        if (pushed) {
+            jobs->inject[jobs->inject_head++ & JOB_DEQUE_MASK] = job;
+        }
+        pthread_mutex_unlock(&jobs->inject_lock);
+
+        if (pushed) {
+            _job_wake();
+            return;
+        }
+    }
+
+    // the queue is full, run it here instead
+    _job_execute(job);
+}
+
+static r_job * _job_take() {
+    r_job *job = NULL;
+
+    if (worker_index >= 0) {
+        job = _deque_pop(&jobs->workers[worker_index].deque);
+    }
+
+    // steal from another worker, starting at a random victim
+    if (job == NULL && jobs->count > 1) {
+        uint32_t *seed = worker_index >= 0 ? &jobs->workers[worker_index].seed : &(uint32_t){ 1 };
+        *seed = *seed * 1664525u + 1013904223u;
+        uint32_t start = *seed % jobs->count;
+
+        for (uint32_t i = 0; i < jobs->count && job == NULL; i++) {
+            uint32_t victim = (start + i) % jobs->count;
+            if ((int32_t)victim != worker_index) {
+                job = _deque_steal(&jobs->workers[victim].deque);
+            }
+        }
+    }
+
+    if (job == NULL && jobs->inject_head != jobs->inject_tail) {
+        pthread_mutex_lock(&jobs->inject_lock);
+        if (jobs->inject_head != jobs->inject_tail) {
+            job = jobs->inject[jobs->inject_tail++ & JOB_DEQUE_MASK];
+        }
+        pthread_mutex_unlock(&jobs->inject_lock);
+    }
+
+    if (job != NULL) {
+        atomic_fetch_sub(&jobs->queued, 1);
+    }
+    return job;
+}
+
+// release a hold on the job, once there are none left it is queued
+static void _job_release(r_job *job) {
+    if (atomic_fetch_sub(&job->dependencies, 1) == 1) {
+        _job_push(job);
+    }
+}
+
+static void _job_finish(r_job *job) {
+    if (atomic_fetch_sub(&job->unfinished, 1) != 1) {
+        return;
+    }
+
+    // take the continuations, anything added from now on sees the job as done
+    r_job   *continuations[MAX_JOB_CONTINUATIONS];
+    uint32_t count;
+
+    while (atomic_flag_test_and_set_explicit(&job->lock, memory_order_acquire)) {}
+    job->done = true;
+    count = job->continuation_count;
+    memcpy(continuations, job->continuations, sizeof(r_job *) * count);
+    atomic_flag_clear_explicit(&job->lock, memory_order_release);
+
+    // a cancelled job was taken off its owner's count when it was cancelled, the owner may be gone
+    r_job               *parent = job->parent;
+    r_module_properties *owner = atomic_load(&job->state) == JOB_CANCELLED ? NULL : job->owner;
+
+    for (uint32_t i = 0; i < count; i++) {
+        _job_release(continuations[i]);
+    }
+
+    // nothing reads the job from here on, the slot can be handed out again
+    atomic_store_explicit(&job->busy, false, memory_order_release);
+
+    if (parent) {
+        _job_finish(parent);
+    }
+
+    if (owner) {
+        atomic_fetch_sub(&owner->jobs.in_flight, 1);
+    }
+}
+
+static void _job_execute(r_job *job) {
+    uint8_t waiting = JOB_WAITING;
+
+    // a cancelled job only releases what waits on it, its code may have been unloaded
+    if (atomic_compare_exchange_strong(&job->state, &waiting, JOB_STARTED)) {
+        r_module_properties *previous = r_module_context_get();
+
+        // attribute the work to the module which created the job
+        r_module_context_set(job->owner);
+
+        if (job->range_fn) {
+            job->range_fn(job->data, job->begin, job->end);
+        } else if (job->fn) {
+            job->fn(job->data);
+        }
+
+        r_module_context_set(previous);
+    }
+
+    _job_finish(job);
+}
+
+static void * _job_worker(void *arg) {
+    worker_index = (int32_t)(intptr_t)arg;
+    uint32_t idle = 0;
+
+    // jobs run module code which is worth profiling
+    r_profile_thread_init();
+
+    while (atomic_load(&jobs->running)) {
+        r_job *job = _job_take();
+
+        if (job) {
+            _job_execute(job);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < JOB_IDLE_SPINS) {
+            sched_yield();
+            continue;
+        }
+
+        // nothing to do, sleep until a job is queued
+        pthread_mutex_lock(&jobs->sleep_lock);
+        atomic_fetch_add(&jobs->sleeping, 1);
+        while (atomic_load(&jobs->queued) <= 0 && atomic_load(&jobs->running)) {
+            pthread_cond_wait(&jobs->wake, &jobs->sleep_lock);
+        }
+        atomic_fetch_sub(&jobs->sleeping, 1);
+        pthread_mutex_unlock(&jobs->sleep_lock);
+        idle = 0;
+    }
+
+    return NULL;
+}
+
+// Public
+// ------
+
+void r_job_system_create(uint32_t worker_count) {
+
+    if (worker_count == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        worker_count = cores > 1 ? (uint32_t)cores : 1;
+    }
+    if (worker_count > MAX_JOB_WORKERS) {
+        worker_count = MAX_JOB_WORKERS;
+    }
+
+    jobs = MALLOC(r_job_system, 1);
+    memset(jobs, 0, sizeof(r_job_system));
+
+    jobs->count = worker_count;
+    atomic_store(&jobs->running, true);
+    pthread_mutex_init(&jobs->inject_lock, NULL);
+    pthread_mutex_init(&jobs->sleep_lock, NULL);
+    pthread_cond_init(&jobs->wake, NULL);
+    jobs->inject_ring = MALLOC(r_job, MAX_JOBS_PER_THREAD);
+
+    for (uint32_t i = 0; i < worker_count; i++) {
+        jobs->workers[i].ring = MALLOC(r_job, MAX_JOBS_PER_THREAD);
+        jobs->workers[i].seed = i + 1;
+    }
+
+    // the creating thread is worker 0, the rest get their own threads
+    worker_index = 0;
+    for (uint32_t i = 1; i < worker_count; i++) {
+        pthread_create(&jobs->workers[i].thread, NULL, _job_worker, (void *)(intptr_t)i);
+    }
+
+    r_log(R_LOG_INFO, "Job system started with %u workers\n", worker_count);
+}
+
+void r_job_system_destroy() {
+    if (jobs == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&jobs->sleep_lock);
+    atomic_store(&jobs->running, false);
+    pthread_cond_broadcast(&jobs->wake);
+    pthread_mutex_unlock(&jobs->sleep_lock);
+
+    for (uint32_t i = 1; i < jobs->count; i++) {
+        pthread_join(jobs->workers[i].thread, NULL);
+    }
+
+    for (uint32_t i = 0; i < jobs->count; i++) {
+        FREE(r_job, jobs->workers[i].ring);
+    }
+    FREE(r_job, jobs->inject_ring);
+
+    pthread_mutex_destroy(&jobs->inject_lock);
+    pthread_mutex_destroy(&jobs->sleep_lock);
+    pthread_cond_destroy(&jobs->wake);
+
+    worker_index = -1;
+    FREE(r_job_system, jobs);
+}
+
+uint32_t r_job_worker_count() {
+    return jobs ? jobs->count : 0;
+}
+
+int32_t r_job_worker_index() {
+    return worker_index;
+}
+
+// claim the next free slot of a ring, starting at *next
+static r_job * _job_claim(r_job *ring, uint32_t *next) {
+    for (uint32_t i = 0; i < MAX_JOBS_PER_THREAD; i++) {
+        r_job *job = &ring[(*next)++ & JOB_DEQUE_MASK];
+        if (!atomic_load_explicit(&job->busy, memory_order_acquire)) {
+            atomic_store_explicit(&job->busy, true, memory_order_relaxed);
+            atomic_fetch_add_explicit(&job->generation, 1, memory_order_release);
+            return job;
+        }
+    }
+    return NULL;
+}
+
+static r_job * _job_alloc() {
+    uint64_t start = 0;
+
+    while (true) {
+        r_job *job;
+
+        if (worker_index >= 0) {
+            r_job_worker *worker = &jobs->workers[worker_index];
+            job = _job_claim(worker->ring, &worker->ring_next);
+        } else {
+            pthread_mutex_lock(&jobs->inject_lock);
+            job = _job_claim(jobs->inject_ring, &jobs->inject_ring_next);
+            pthread_mutex_unlock(&jobs->inject_lock);
+        }
+
+        if (job) {
+            return job;
+        }
+
+        // every slot is in flight, help them along until one frees up
+        uint64_t now = r_time_now_ns();
+        if (start == 0) {
+            start = now;
+        } else if (now - start > JOB_CREATE_TIMEOUT_NS) {
+            r_log(R_LOG_ERROR, "job: more than %u jobs in flight from one thread\n", MAX_JOBS_PER_THREAD);
+            return NULL;
+        }
+
+        r_job *other = _job_take();
+        if (other) {
+            _job_execute(other);
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+r_job * r_job_create(r_module_properties *owner, r_job_fn fn, void *data, r_job *parent) {
+    r_job *job = _job_alloc();
+
+    if (job == NULL) {
+        return NULL;
+    }
+
+    job->fn = fn;
+    job->data = data;
+    job->range_fn = NULL;
+    job->parent = parent;
+    job->owner = owner;
+    job->done = false;
+    job->continuation_count = 0;
+    atomic_flag_clear(&job->lock);
+    atomic_store(&job->state, JOB_CREATED);
+    atomic_store(&job->unfinished, 1);
+    atomic_store(&job->dependencies, 1);
+
+    if (parent) {
+        atomic_fetch_add(&parent->unfinished, 1);
+    }
+
+    return job;
+}
+
+uint32_t r_job_generation(r_job *job) {
+    return job ? atomic_load_explicit(&job->generation, memory_order_acquire) : 0;
+}
+
+void r_job_depends_on(r_job *job, r_job *dependency) {
+
+    if (job == NULL || dependency == NULL) {
+        return;
+    }
+
+    while (atomic_flag_test_and_set_explicit(&dependency->lock, memory_order_acquire)) {}
+
+    if (!dependency->done && dependency->continuation_count < MAX_JOB_CONTINUATIONS) {
+        atomic_fetch_add(&job->dependencies, 1);
+        dependency->continuations[dependency->continuation_count++] = job;
+        atomic_flag_clear_explicit(&dependency->lock, memory_order_release);
+        return;
+    }
+
+    bool done = dependency->done;
+    atomic_flag_clear_explicit(&dependency->lock, memory_order_release);
+
+    if (done) {
+        return;
+    }
+
+    // out of continuations, chain a relay job in place of the last one which
+    // releases it along with this job. It's created outside the lock as
+    // creating may run other jobs
+    r_job *relay = r_job_create(NULL, NULL, NULL, NULL);
+
+    if (relay == NULL) {
+        r_log(R_LOG_ERROR, "job: unable to chain another job onto a job with %u dependents, waiting for it instead\n", MAX_JOB_CONTINUATIONS);
+        r_job_wait(dependency);
+        return;
+    }
+
+    r_job_depends_on(job, relay);
+
+    while (atomic_flag_test_and_set_explicit(&dependency->lock, memory_order_acquire)) {}
+
+    if (!dependency->done) {
+        uint32_t last = dependency->continuation_count - 1;
+        relay->continuations[relay->continuation_count++] = dependency->continuations[last];
+        dependency->continuations[last] = relay;
+        atomic_fetch_add(&relay->dependencies, 1);
+    }
+
+    atomic_flag_clear_explicit(&dependency->lock, memory_order_release);
+
+    r_job_run(relay);
+}
+
+void r_job_run(r_job *job) {
+    if (job == NULL) {
+        return;
+    }
+
+    // the owner waits for the jobs it ran, one it only created never holds up a drain
+    if (job->owner) {
+        atomic_fetch_add(&job->owner->jobs.in_flight, 1);
+    }
+    atomic_store(&job->state, JOB_WAITING);
+    _job_release(job);
+}
+
+bool r_job_finished(r_job *job) {
+    return job == NULL || atomic_load(&job->unfinished) == 0;
+}
+
+void r_job_wait(r_job *job) {
+    // help out with other jobs until it's done
+    while (!r_job_finished(job)) {
+        r_job *other = _job_take();
+
+        if (other) {
+            _job_execute(other);
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+void r_job_parallel_for(r_module_properties *owner, r_job_range_fn fn, void *data, uint32_t count, uint32_t grain) {
+
+    if (count == 0) {
+        return;
+    }
+
+    if (grain == 0) {
+        // aim for a few ranges per worker to balance the load
+        grain = count / (jobs->count * 4);
+        if (grain == 0) {
+            grain = 1;
+        }
+    }
+
+    r_job *root = r_job_create(owner, NULL, NULL, NULL);
+
+    for (uint32_t begin = 0; begin < count; begin += grain) {
+        uint32_t end = begin + grain < count ? begin + grain : count;
+        r_job   *range = root ? r_job_create(owner, NULL, data, root) : NULL;
+
+        // no slot to spare, do the range here
+        if (range == NULL) {
+            fn(data, begin, end);
+            continue;
+        }
+
+        range->range_fn = fn;
+        range->begin = begin;
+        range->end = end;
+        r_job_run(range);
+    }
+
+    r_job_run(root);
+    r_job_wait(root);
+}
+
+// cancel the owner's jobs which were run but haven't started, returns how many were
+static uint32_t _job_cancel(r_module_properties *owner, r_job *ring) {
+    uint32_t cancelled = 0;
+
+    for (uint32_t i = 0; i < MAX_JOBS_PER_THREAD; i++) {
+        r_job * job = &ring[i];
+        uint8_t waiting = JOB_WAITING;
+
+        if (atomic_load_explicit(&job->busy, memory_order_acquire) && job->owner == owner &&
+            atomic_compare_exchange_strong(&job->state, &waiting, JOB_CANCELLED)) {
+            atomic_fetch_sub(&owner->jobs.in_flight, 1);
+            cancelled++;
+        }
+    }
+    return cancelled;
+}
+
+void r_job_drain(r_module_properties *owner) {
+    uint64_t start = r_time_now_ns();
+
+    while (atomic_load(&owner->jobs.in_flight) > 0) {
+        r_job *job = _job_take();
+
+        if (job) {
+            _job_execute(job);
+        } else {
+            sched_yield();
+        }
+
+        if (r_time_now_ns() - start < JOB_DRAIN_TIMEOUT_NS) {
+            continue;
+        }
+
+        // what's still waiting is blocked on work which isn't coming, what's started has to finish
+        uint32_t cancelled = _job_cancel(owner, jobs->inject_ring);
+        for (uint32_t i = 0; i < jobs->count; i++) {
+            cancelled += _job_cancel(owner, jobs->workers[i].ring);
+        }
+
+        r_log(R_LOG_ERROR, "job: %s still had jobs in flight after %llu ms, cancelled %u which hadn't started, waiting for %d running\n",
+            owner->name ? owner->name : "host", (unsigned long long)(JOB_DRAIN_TIMEOUT_NS / 1000000), cancelled, atomic_load(&owner->jobs.in_flight));
+        start = r_time_now_ns();
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef _JOB_H_
+#define _JOB_H_
+
+// r_job is a work stealing job system. Each worker owns a deque of jobs, it
+// pushes and pops at one end while idle workers steal from the other.
+//
+// Jobs are allocated from a ring per thread. A slot is only handed out again
+// once its job has finished, when every slot is in flight r_job_create helps
+// run other jobs until one frees up and returns NULL if none does. The other
+// functions accept NULL so the caller can do the work itself. A handle is
+// valid until its job has finished, r_job_generation tells whether the slot
+// has been reused since.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "module/interface.h"
+
+#define MAX_JOB_WORKERS       32
+#define MAX_JOBS_PER_THREAD   4096
+#define MAX_JOB_CONTINUATIONS 16
+#define JOB_DRAIN_TIMEOUT_NS  (2 * 1000000000ull)
+
+// start the worker threads, 0 uses one worker per core alongside the main thread
+void r_job_system_create(uint32_t worker_count);
+void r_job_system_destroy();
+
+uint32_t r_job_worker_count();
+
+// index of the worker running on this thread, 0 for the main thread and -1 for other threads
+int32_t r_job_worker_index();
+
+r_job * r_job_create(r_module_properties *owner, r_job_fn fn, void *data, r_job *parent);
+void    r_job_depends_on(r_job *job, r_job *dependency);
+void    r_job_run(r_job *job);
+void    r_job_wait(r_job *job);
+bool    r_job_finished(r_job *job);
+uint32_t r_job_generation(r_job *job);
+
+void    r_job_parallel_for(r_module_properties *owner, r_job_range_fn fn, void *data, uint32_t count, uint32_t grain);
+
+// run jobs until every job the module has run has finished, jobs it only created
+// aren't waited for. After JOB_DRAIN_TIMEOUT_NS the jobs still waiting on their
+// dependencies are cancelled, they never call into the module, and the owner is
+// logged while the drain waits for the ones which have started.
+void    r_job_drain(r_module_properties *owner);
+
+#endif
@@ -0,0 +1,613 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "log/log.h"
+#include "module/context.h"
+
+// Note: the allocator logs, so the logger allocates with malloc directly
+
+#define LOG_RECORD_HEADER (sizeof(uint64_t) + sizeof(const char *) + 3 + LOG_TAG_LENGTH)
+#define LOG_RECORD_ARGS   (LOG_RECORD_SIZE - LOG_RECORD_HEADER)
+
+typedef struct r_log_record {
+    uint64_t    timestamp;
+    const char *format;
+    uint8_t     level;
+    uint8_t     count;      // conversions packed, the rest of the format was truncated
+    uint8_t     size;       // bytes used in args
+    char        tag[LOG_TAG_LENGTH];
+    uint8_t     args[LOG_RECORD_ARGS];
+} r_log_record;
+
+_Static_assert(sizeof(r_log_record) == LOG_RECORD_SIZE, "log record layout");
+_Static_assert(LOG_RECORD_ARGS <= UINT8_MAX, "log record args");
+
+// single producer (the owning thread), single consumer (whoever holds the drain lock)
+typedef struct r_log_ring {
+    _Atomic uint64_t head;
+    _Atomic uint64_t tail;
+    _Atomic uint32_t dropped;
+    _Atomic bool     released;  // its thread has exited, freed once it's drained
+    r_log_record     records[LOG_RING_SLOTS];
+} r_log_ring;
+
+// a parsed conversion specification
+typedef struct r_log_spec {
+    const char *flags;
+    size_t      flags_length;
+    bool        width_star;
+    bool        precision_star;
+    int         precision;  // -1 when there is none or it's a '*'
+    char        length;     // 0, 'H' (hh), 'h', 'l', 'q' (ll), 'z', 'j', 't', 'L'
+    char        conversion;
+} r_log_spec;
+
+static r_log_ring * _Atomic rings[MAX_LOG_THREADS];
+
+static _Thread_local r_log_ring *ring = NULL;
+static pthread_key_t             ring_key;
+static pthread_once_t            ring_key_once = PTHREAD_ONCE_INIT;
+
+static _Atomic int  level = R_LOG_INFO;
+static _Atomic bool running = false;
+
+static FILE *          output = NULL;
+static uint64_t        start_time = 0;
+static pthread_t       thread;
+static pthread_mutex_t drain_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t wake_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  wake = PTHREAD_COND_INITIALIZER;
+
+static const char *level_names[] = {
+    "DEBUG",
+    "INFO",
+    "WARN",
+    "ERROR",
+};
+
+static uint64_t _now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Format specifications
+// ---------------------
+
+// parse the specification after a '%', returns a pointer past it or NULL for a literal '%'
+static const char * _parse_spec(const char *c, r_log_spec *spec) {
+    if (*c == '%') {
+        return NULL;
+    }
+
+    spec->flags = c;
+    while (*c && strchr("-+ #0'", *c)) c++;
+    if (*c == '*') {
+        spec->width_star = true;
+        c++;
+    } else {
+        spec->width_star = false;
+        while (*c >= '0' && *c <= '9') c++;
+    }
+
+    spec->precision_star = false;
+    spec->precision = -1;
+    if (*c == '.') {
+        c++;
+        if (*c == '*') {
+            spec->precision_star = true;
+            c++;
+        } else {
+            spec->precision = 0;
+            while (*c >= '0' && *c <= '9') {
+                spec->precision = spec->precision * 10 + (*c++ - '0');
+            }
+        }
+    }
+    spec->flags_length = (size_t)(c - spec->flags);
+
+    spec->length = 0;
+    if (c[0] == 'h' && c[1] == 'h') { spec->length = 'H'; c += 2; }
+    else if (c[0] == 'l' && c[1] == 'l') { spec->length = 'q'; c += 2; }
+    else if (*c && strchr("hlzjtL", *c)) { spec->length = *c++; }
+
+    spec->conversion = *c;
+    return *c ? c + 1 : c;
+}
+
+static bool _pack(uint8_t *args, size_t *size, const void *value, size_t value_size) {
+    if (*size + value_size > LOG_RECORD_ARGS) {
+        return false;
+    }
+    memcpy(args + *size, value, value_size);
+    *size += value_size;
+    return true;
+}
+
+static bool _pack_int(uint8_t *args, size_t *size, int value) {
+    return _pack(args, size, &value, sizeof(value));
+}
+
+// store every argument the format refers to, returns the number of conversions packed
+static uint8_t _pack_args(const char *format, va_list args, uint8_t *packed, uint8_t *packed_size) {
+    size_t  size = 0;
+    uint8_t count = 0;
+
+    for (const char *c = format; *c; c++) {
+        if (*c != '%') {
+            continue;
+        }
+
+        r_log_spec  spec;
+        const char *end = _parse_spec(c + 1, &spec);
+        if (end == NULL) {
+            c++;
+            continue;
+        }
+
+        if (spec.width_star && !_pack_int(packed, &size, va_arg(args, int))) break;
+        if (spec.precision_star) {
+            // a negative precision is taken as if it were omitted
+            spec.precision = va_arg(args, int);
+            if (!_pack_int(packed, &size, spec.precision)) break;
+        }
+
+        bool fits = true;
+        switch (spec.conversion) {
+            case 'd': case 'i': case 'u': case 'o': case 'x': case 'X': case 'c': {
+                long long value;
+                switch (spec.length) {
+                    case 'l': value = va_arg(args, long); break;
+                    case 'q': value = va_arg(args, long long); break;
+                    case 'z': value = (long long)va_arg(args, size_t); break;
+                    case 'j': value = (long long)va_arg(args, intmax_t); break;
+                    case 't': value = va_arg(args, ptrdiff_t); break;
+                    default:  value = va_arg(args, int); break;
+                }
+                fits = _pack(packed, &size, &value, sizeof(value));
+                break;
+            }
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+                double value = spec.length == 'L' ? (double)va_arg(args, long double) : va_arg(args, double);
+                fits = _pack(packed, &size, &value, sizeof(value));
+                break;
+            }
+            case 'p': {
+                void *value = va_arg(args, void *);
+                fits = _pack(packed, &size, &value, sizeof(value));
+                break;
+            }
+            case 's': {
+                const char *value = va_arg(args, const char *);
+                if (value == NULL) value = "(null)";
+
+                // only as much as the precision prints, which needn't be terminated
+                size_t length;
+                if (spec.precision >= 0) {
+                    const char *terminator = memchr(value, '\0', (size_t)spec.precision);
+                    length = terminator ? (size_t)(terminator - value) : (size_t)spec.precision;
+                } else {
+                    length = strlen(value);
+                }
+
+                // strings are truncated to the space left
+                if (size + 1 > LOG_RECORD_ARGS) {
+                    fits = false;
+                    break;
+                }
+                if (size + length + 1 > LOG_RECORD_ARGS) {
+                    length = LOG_RECORD_ARGS - size - 1;
+                }
+                memcpy(packed + size, value, length);
+                packed[size + length] = '\0';
+                size += length + 1;
+                break;
+            }
+            case 'n':
+                // the count can't be written back from the log thread, its pointer is skipped
+                (void)va_arg(args, void *);
+                break;
+            default:
+                // unknown conversions consume nothing
+                break;
+        }
+        if (!fits) {
+            break;
+        }
+
+        count++;
+        c = end - 1;
+    }
+
+    *packed_size = (uint8_t)size;
+    return count;
+}
+
+// format a record the same way printf would have
+static void _write_record(const r_log_record *record) {
+    char   message[1024];
+    size_t length = 0;
+    size_t offset = 0;
+    uint8_t count = 0;
+
+#define APPEND(...) \
+    do { \
+        if (length < sizeof(message)) { \
+            int written = snprintf(message + length, sizeof(message) - length, __VA_ARGS__); \
+            if (written > 0) length += (size_t)written; \
+        } \
+    } while (0)
+
+    const char *c = record->format;
+    while (*c) {
+        if (*c != '%') {
+            const char *next = strchr(c, '%');
+            size_t      run = next ? (size_t)(next - c) : strlen(c);
+            APPEND("%.*s", (int)run, c);
+            c += run;
+            continue;
+        }
+
+        r_log_spec  spec;
+        const char *end = _parse_spec(c + 1, &spec);
+        if (end == NULL) {
+            APPEND("%%");
+            c += 2;
+            continue;
+        }
+
+        if (count == record->count) {
+            APPEND("...");
+            break;
+        }
+
+        // rebuild the specification with a length matching the packed value
+        char    specification[32];
+        int     star[2];
+        int     stars = 0;
+        size_t  flags_length = spec.flags_length < 20 ? spec.flags_length : 20;
+
+        if (spec.width_star) {
+            memcpy(&star[stars++], record->args + offset, sizeof(int));
+            offset += sizeof(int);
+        }
+        if (spec.precision_star) {
+            memcpy(&star[stars++], record->args + offset, sizeof(int));
+            offset += sizeof(int);
+        }
+
+        switch (spec.conversion) {
+            case 'd': case 'i': case 'u': case 'o': case 'x': case 'X': case 'c': {
+                long long value;
+                memcpy(&value, record->args + offset, sizeof(value));
+                offset += sizeof(value);
+
+                if (spec.conversion == 'c') {
+                    snprintf(specification, sizeof(specification), "%%%.*sc", (int)flags_length, spec.flags);
+                    if (stars == 2) APPEND(specification, star[0], star[1], (int)value);
+                    else if (stars == 1) APPEND(specification, star[0], (int)value);
+                    else APPEND(specification, (int)value);
+                } else {
+                    snprintf(specification, sizeof(specification), "%%%.*sll%c", (int)flags_length, spec.flags, spec.conversion);
+
+                    // narrow the value back to its original width
+                    bool is_signed = spec.conversion == 'd' || spec.conversion == 'i';
+                    if (is_signed) {
+                        if (spec.length == 'H') value = (signed char)value;
+                        else if (spec.length == 'h') value = (short)value;
+                        else if (spec.length == 0) value = (int)value;
+                    } else {
+                        if (spec.length == 'H') value = (unsigned char)value;
+                        else if (spec.length == 'h') value = (unsigned short)value;
+                        else if (spec.length == 0) value = (unsigned int)value;
+                    }
+
+                    if (stars == 2) APPEND(specification, star[0], star[1], value);
+                    else if (stars == 1) APPEND(specification, star[0], value);
+                    else APPEND(specification, value);
+                }
+                break;
+            }
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+                double value;
+                memcpy(&value, record->args + offset, sizeof(value));
+                offset += sizeof(value);
+
+                snprintf(specification, sizeof(specification), "%%%.*s%c", (int)flags_length, spec.flags, spec.conversion);
+                if (stars == 2) APPEND(specification, star[0], star[1], value);
+                else if (stars == 1) APPEND(specification, star[0], value);
+                else APPEND(specification, value);
+                break;
+            }
+            case 'p': {
+                void *value;
+                memcpy(&value, record->args + offset, sizeof(value));
+                offset += sizeof(value);
+
+                snprintf(specification, sizeof(specification), "%%%.*sp", (int)flags_length, spec.flags);
+                if (stars == 2) APPEND(specification, star[0], star[1], value);
+                else if (stars == 1) APPEND(specification, star[0], value);
+                else APPEND(specification, value);
+                break;
+            }
+            case 's': {
+                const char *value = (const char *)record->args + offset;
+                offset += strlen(value) + 1;
+
+                snprintf(specification, sizeof(specification), "%%%.*ss", (int)flags_length, spec.flags);
+                if (stars == 2) APPEND(specification, star[0], star[1], value);
+                else if (stars == 1) APPEND(specification, star[0], value);
+                else APPEND(specification, value);
+                break;
+            }
+            default:
+                break;
+        }
+
+        count++;
+        c = end;
+    }
+#undef APPEND
+
+    if (length >= sizeof(message)) {
+        length = sizeof(message) - 1;
+    }
+
+    // messages carry their own newline like printf did, don't double it
+    if (length > 0 && message[length - 1] == '\n') {
+        length--;
+    }
+
+    double seconds = (double)(record->timestamp - start_time) / 1e9;
+    fprintf(output, "[%10.4f] %-5s %s: %.*s\n", seconds, level_names[record->level], record->tag, (int)length, message);
+}
+
+// Rings
+// -----
+
+// runs as the thread exits, the drain frees the ring once it has written what's left in it
+static void _ring_release(void *released) {
+    atomic_store_explicit(&((r_log_ring *)released)->released, true, memory_order_release);
+    ring = NULL;
+}
+
+static void _ring_key_create() {
+    pthread_key_create(&ring_key, _ring_release);
+}
+
+static r_log_ring * _ring() {
+    if (ring != NULL) {
+        return ring;
+    }
+
+    pthread_once(&ring_key_once, _ring_key_create);
+
+    r_log_ring *created = malloc(sizeof(r_log_ring));
+    atomic_init(&created->head, 0);
+    atomic_init(&created->tail, 0);
+    atomic_init(&created->dropped, 0);
+    atomic_init(&created->released, false);
+
+    for (uint32_t i = 0; i < MAX_LOG_THREADS; i++) {
+        r_log_ring *expected = NULL;
+        if (atomic_compare_exchange_strong_explicit(&rings[i], &expected, created, memory_order_release, memory_order_relaxed)) {
+            pthread_setspecific(ring_key, created);
+            ring = created;
+            return ring;
+        }
+    }
+
+    free(created);
+    return NULL;
+}
+
+// write every record which was logged before the call, oldest first across all threads
+static void _drain() {
+    r_log_ring *drained[MAX_LOG_THREADS];
+    uint64_t    heads[MAX_LOG_THREADS];
+
+    for (uint32_t i = 0; i < MAX_LOG_THREADS; i++) {
+        drained[i] = atomic_load_explicit(&rings[i], memory_order_acquire);
+        heads[i] = drained[i] ? atomic_load_explicit(&drained[i]->head, memory_order_acquire) : 0;
+
+        uint32_t dropped = drained[i] ? atomic_exchange(&drained[i]->dropped, 0) : 0;
+        if (dropped > 0) {
+            fprintf(output, "log: dropped %u messages\n", dropped);
+        }
+    }
+
+    for (;;) {
+        r_log_ring *oldest = NULL;
+        uint64_t    oldest_time = UINT64_MAX;
+
+        for (uint32_t i = 0; i < MAX_LOG_THREADS; i++) {
+            if (drained[i] == NULL) {
+                continue;
+            }
+
+            uint64_t tail = atomic_load_explicit(&drained[i]->tail, memory_order_relaxed);
+            if (tail == heads[i]) {
+                continue;
+            }
+
+            uint64_t timestamp = drained[i]->records[tail % LOG_RING_SLOTS].timestamp;
+            if (timestamp < oldest_time) {
+                oldest_time = timestamp;
+                oldest = drained[i];
+            }
+        }
+
+        if (oldest == NULL) {
+            break;
+        }
+
+        uint64_t tail = atomic_load_explicit(&oldest->tail, memory_order_relaxed);
+        _write_record(&oldest->records[tail % LOG_RING_SLOTS]);
+        atomic_store_explicit(&oldest->tail, tail + 1, memory_order_release);
+    }
+
+    // the rings of exited threads which have been written out make room for new threads
+    for (uint32_t i = 0; i < MAX_LOG_THREADS; i++) {
+        if (drained[i] != NULL && atomic_load_explicit(&drained[i]->released, memory_order_acquire) &&
+            atomic_load_explicit(&drained[i]->head, memory_order_acquire) == atomic_load_explicit(&drained[i]->tail, memory_order_relaxed)) {
+            atomic_store_explicit(&rings[i], NULL, memory_order_release);
+            free(drained[i]);
+        }
+    }
+}
+
+static void * _flush_thread(void *arg) {
+    (void)arg;
+
+    while (atomic_load(&running)) {
+        pthread_mutex_lock(&drain_lock);
+        _drain();
+        fflush(output);
+        pthread_mutex_unlock(&drain_lock);
+
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_nsec += LOG_FLUSH_INTERVAL_MS * 1000000l;
+        if (until.tv_nsec >= 1000000000l) {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000l;
+        }
+
+        pthread_mutex_lock(&wake_lock);
+        if (atomic_load(&running)) {
+            pthread_cond_timedwait(&wake, &wake_lock, &until);
+        }
+        pthread_mutex_unlock(&wake_lock);
+    }
+    return NULL;
+}
+
+// Public functions
+// ----------------
+
+void r_log_create(const char *path) {
+    if (atomic_load(&running)) {
+        return;
+    }
+
+    output = stdout;
+    if (path != NULL) {
+        output = fopen(path, "w");
+        if (output == NULL) {
+            fprintf(stderr, "Unable to open log file %s, logging to stdout\n", path);
+            output = stdout;
+        }
+    }
+
+    start_time = _now();
+    atomic_store(&running, true);
+
+    if (pthread_create(&thread, NULL, _flush_thread, NULL) != 0) {
+        fprintf(stderr, "Unable to start the log thread\n");
+        atomic_store(&running, false);
+    }
+}
+
+void r_log_destroy() {
+    if (!atomic_load(&running)) {
+        return;
+    }
+
+    pthread_mutex_lock(&wake_lock);
+    atomic_store(&running, false);
+    pthread_cond_signal(&wake);
+    pthread_mutex_unlock(&wake_lock);
+    pthread_join(thread, NULL);
+
+    r_log_flush();
+
+    // threads may still hold their ring, it's kept until the process exits
+    if (output != stdout) {
+        fclose(output);
+    }
+    output = NULL;
+}
+
+void r_log_set_level(r_log_level new_level) {
+    atomic_store_explicit(&level, new_level, memory_order_relaxed);
+}
+
+r_log_level r_log_get_level() {
+    return (r_log_level)atomic_load_explicit(&level, memory_order_relaxed);
+}
+
+void r_log_v(r_log_level log_level, const char *tag, const char *format, va_list args) {
+    if ((int)log_level < atomic_load_explicit(&level, memory_order_relaxed) || log_level >= R_LOG_NONE) {
+        return;
+    }
+
+    r_log_ring *log_ring = atomic_load_explicit(&running, memory_order_relaxed) ? _ring() : NULL;
+
+    // without the log thread, or with too many threads, log synchronously
+    if (log_ring == NULL) {
+        FILE *stream = log_level >= R_LOG_WARNING ? stderr : stdout;
+        fprintf(stream, "%-5s %s: ", level_names[log_level], tag);
+        vfprintf(stream, format, args);
+        if (format[0] == '\0' || format[strlen(format) - 1] != '\n') {
+            fputc('\n', stream);
+        }
+        return;
+    }
+
+    uint64_t head = atomic_load_explicit(&log_ring->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&log_ring->tail, memory_order_acquire);
+
+    if (head - tail == LOG_RING_SLOTS) {
+        atomic_fetch_add_explicit(&log_ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    r_log_record *record = &log_ring->records[head % LOG_RING_SLOTS];
+    record->timestamp = _now();
+    record->format = format;
+    record->level = (uint8_t)log_level;
+    strncpy(record->tag, tag, LOG_TAG_LENGTH - 1);
+    record->tag[LOG_TAG_LENGTH - 1] = '\0';
+
+    va_list copy;
+    va_copy(copy, args);
+    record->count = _pack_args(format, copy, record->args, &record->size);
+    va_end(copy);
+
+    atomic_store_explicit(&log_ring->head, head + 1, memory_order_release);
+}
+
+void r_log_tagged(r_log_level log_level, const char *tag, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    r_log_v(log_level, tag, format, args);
+    va_end(args);
+}
+
+void r_log(r_log_level log_level, const char *format, ...) {
+    r_module_properties *props = r_module_context_get();
+
+    va_list args;
+    va_start(args, format);
+    r_log_v(log_level, props ? props->name : "host", format, args);
+    va_end(args);
+}
+
+void r_log_flush() {
+    if (output == NULL) {
+        fflush(stdout);
+        return;
+    }
+
+    pthread_mutex_lock(&drain_lock);
+    _drain();
+    fflush(output);
+    pthread_mutex_unlock(&drain_lock);
+}
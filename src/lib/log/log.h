@@ -0,0 +1,42 @@
+#ifndef _LOG_H_
+#define _LOG_H_
+
+// r_log is an asynchronous logger. Each thread writes fixed size records into
+// its own lock free ring, a record holds the format pointer and the packed
+// arguments. A background thread merges the rings in time order, formats the
+// records and writes them to stdout or a file.
+//
+// A thread's ring is released when the thread exits and freed once it has been
+// written out, at most MAX_LOG_THREADS threads have one at a time and the rest
+// log synchronously.
+//
+// The format string must outlive the record, string arguments are copied.
+// %n writes nothing, its pointer is skipped. Call r_log_flush before unloading
+// code which owns format strings.
+
+#include <stdarg.h>
+
+#include "module/interface.h"
+
+#define MAX_LOG_THREADS        64
+#define LOG_RING_SLOTS         1024
+#define LOG_RECORD_SIZE        256
+#define LOG_TAG_LENGTH         22
+#define LOG_FLUSH_INTERVAL_MS  10
+
+// start the log thread, path NULL writes to stdout
+void r_log_create(const char *path);
+void r_log_destroy();
+
+void        r_log_set_level(r_log_level level);
+r_log_level r_log_get_level();
+
+// tagged with the current module, or "host"
+void r_log(r_log_level level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+void r_log_tagged(r_log_level level, const char *tag, const char *format, ...) __attribute__((format(printf, 3, 4)));
+void r_log_v(r_log_level level, const char *tag, const char *format, va_list args);
+
+// write out everything logged so far
+void r_log_flush();
+
+#endif
@@ -1,19 +1,38 @@
+#include <stdatomic.h>
 #include <stdio.h>
 
+#include "log/log.h"
 #include "memory/allocator.h"
 
+static _Atomic uint64_t allocations = 0;
+static _Atomic uint64_t frees = 0;
+static _Atomic uint64_t bytes_allocated = 0;
+
 void * r_malloc(const char *type, size_t size) {
     void *ptr = malloc(size);
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&bytes_allocated, size, memory_order_relaxed);
 #ifdef MEMORY_DEBUG
-    printf("malloc(%s, %zu) = %p\n", type, size, ptr);
+    r_log(R_LOG_DEBUG, "malloc(%s, %zu) = %p\n", type, size, ptr);
 #endif
     return ptr;
 }
 
 void r_free(const char *type, void *ptr) {
 #ifdef MEMORY_DEBUG
-    printf("type(%s): free(%p)\n", type, ptr);
+    r_log(R_LOG_DEBUG, "type(%s): free(%p)\n", type, ptr);
 #endif
+    if (ptr != NULL) {
+        atomic_fetch_add_explicit(&frees, 1, memory_order_relaxed);
+    }
     free(ptr);
     ptr = NULL;
+}
+
+r_mem_stats r_mem_get_stats() {
+    return (r_mem_stats){
+        .allocations     = atomic_load_explicit(&allocations, memory_order_relaxed),
+        .frees           = atomic_load_explicit(&frees, memory_order_relaxed),
+        .bytes_allocated = atomic_load_explicit(&bytes_allocated, memory_order_relaxed),
+    };
 }
\ No newline at end of file
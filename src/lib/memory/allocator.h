@@ -1,6 +1,7 @@
 #ifndef _MEMORY_ALLOCATOR_H_
 #define _MEMORY_ALLOCATOR_H_
 
+#include <stdint.h>
 #include <stdlib.h>
 
 // typedef struct r_mem_allocator {
@@ -18,7 +19,15 @@
     r_free(#type, ptr); \
     ptr = NULL;
 
+typedef struct r_mem_stats {
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t bytes_allocated;   // total requested, frees don't know their size
+} r_mem_stats;
+
 void * r_malloc(const char *type, size_t size);
 void   r_free(const char *type, void *ptr);
 
+r_mem_stats r_mem_get_stats();
+
 #endif
\ No newline at end of file
@@ -0,0 +1,644 @@
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "log/log.h"
+#include "memory/allocator.h"
+#include "memory/heap.h"
+
+#define MAX_HEAPS 64
+
+#define HEAP_ALIGN 16
+#define HEAP_ALIGN_UP(size) (((size) + HEAP_ALIGN - 1) & ~(size_t)(HEAP_ALIGN - 1))
+
+// minimum size left over when splitting a free block
+#define HEAP_MIN_SPLIT 64
+
+// allocator state, stored at the start of the heap so that snapshots include it
+typedef struct r_heap_header {
+    size_t top;       // offset of the first byte which has never been allocated
+    size_t used;
+    size_t free_list; // offset of the first free block, 0 if there isn't one
+} r_heap_header;
+
+typedef struct r_heap_block {
+    size_t size;      // size including the block header
+    size_t next;      // offset of the next free block when the block is free
+} r_heap_block;
+
+// range of pool slots holding the pre-images of a committed frame
+typedef struct r_heap_frame {
+    uint32_t start;
+    uint32_t count;
+} r_heap_frame;
+
+typedef struct r_heap {
+    uint8_t *     base;
+    size_t        reserve;
+    size_t        page_size;
+    uint32_t      page_count;
+
+    // modules allocate from their jobs and the sim thread as well
+    pthread_mutex_t   lock;
+
+    // snapshot state
+    _Atomic bool      tracking;
+    _Atomic bool      overflowed;   // the frame in progress didn't fit in the pool
+    _Atomic uint8_t * dirty;
+
+    // pre-image pool, slots are handed out in order and retired oldest frame first,
+    // the recorder and the frame boundary take turns through the snapshot lock
+    pthread_mutex_t   snapshot_lock;
+    uint8_t *         pool;
+    uint32_t *        pool_pages;
+    uint32_t          pool_capacity;
+    _Atomic uint32_t  pool_head;
+    uint32_t          pool_tail;
+
+    r_heap_frame *    frames;
+    uint32_t          frame_capacity;
+    uint32_t          frame_first;
+    uint32_t          frame_count;
+
+    // first pool slot of the frame in progress
+    uint32_t          current_start;
+} r_heap;
+
+// a write to a protected page, handed from the fault handler to the recorder
+typedef struct r_heap_fault {
+    r_heap *       heap;
+    uint8_t *      address;
+    _Atomic bool * done;
+} r_heap_fault;
+
+static r_heap * _Atomic heaps[MAX_HEAPS];
+
+// every heap, so a pointer can be traced back to the heap it came from
+static r_heap * _Atomic created[MAX_HEAPS];
+
+static struct sigaction previous_segv;
+static struct sigaction previous_bus;
+static bool             handler_installed = false;
+static int              faults[2] = { -1, -1 };
+
+static void _heap_drop_history(r_heap *heap);
+static void _heap_fault(int signum, siginfo_t *info, void *context);
+static void * _heap_recorder(void *arg);
+
+static r_heap_header * _header(r_heap *heap) {
+    return (r_heap_header *)heap->base;
+}
+
+static r_heap_block * _block(r_heap *heap, size_t offset) {
+    return (r_heap_block *)(heap->base + offset);
+}
+
+r_heap * r_heap_create(size_t reserve) {
+
+    r_heap *heap = MALLOC(r_heap, 1);
+    if (heap == NULL) {
+        return NULL;
+    }
+    memset(heap, 0, sizeof(r_heap));
+
+    heap->page_size = (size_t)sysconf(_SC_PAGESIZE);
+    heap->reserve = (reserve + heap->page_size - 1) & ~(heap->page_size - 1);
+    heap->page_count = (uint32_t)(heap->reserve / heap->page_size);
+
+    // reserve the address range, pages are only backed once they are written
+    heap->base = mmap(NULL, heap->reserve, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON | MAP_NORESERVE, -1, 0);
+
+    if (heap->base == MAP_FAILED) {
+        r_log(R_LOG_ERROR, "heap: unable to reserve %zu bytes: %s\n", heap->reserve, strerror(errno));
+        FREE(r_heap, heap);
+        return NULL;
+    }
+
+    *_header(heap) = (r_heap_header){
+        .top = HEAP_ALIGN_UP(sizeof(r_heap_header)),
+        .used = 0,
+        .free_list = 0,
+    };
+    pthread_mutex_init(&heap->lock, NULL);
+    pthread_mutex_init(&heap->snapshot_lock, NULL);
+
+    // a heap r_heap_find can't see would have its blocks handed to the wrong allocator
+    for (uint32_t i = 0; i < MAX_HEAPS; i++) {
+        r_heap *expected = NULL;
+        if (atomic_compare_exchange_strong(&created[i], &expected, heap)) {
+            return heap;
+        }
+    }
+
+    r_log(R_LOG_ERROR, "heap: more than %u heaps\n", MAX_HEAPS);
+    pthread_mutex_destroy(&heap->snapshot_lock);
+    pthread_mutex_destroy(&heap->lock);
+    munmap(heap->base, heap->reserve);
+    FREE(r_heap, heap);
+    return NULL;
+}
+
+void r_heap_destroy(r_heap *heap) {
+    r_heap_snapshot_disable(heap);
+
+    for (uint32_t i = 0; i < MAX_HEAPS; i++) {
+        r_heap *expected = heap;
+        if (atomic_compare_exchange_strong(&created[i], &expected, NULL)) {
+            break;
+        }
+    }
+
+    pthread_mutex_destroy(&heap->snapshot_lock);
+    pthread_mutex_destroy(&heap->lock);
+    munmap(heap->base, heap->reserve);
+    FREE(r_heap, heap);
+}
+
+static void * _heap_alloc(r_heap *heap, size_t size) {
+    r_heap_header *header = _header(heap);
+    size_t         needed = HEAP_ALIGN_UP(size + sizeof(r_heap_block));
+
+    // first fit from the free list, which is kept in address order
+    size_t *link = &header->free_list;
+    while (*link != 0) {
+        r_heap_block *block = _block(heap, *link);
+
+        if (block->size >= needed) {
+            size_t offset = *link;
+
+            if (block->size - needed >= HEAP_MIN_SPLIT) {
+                // split the block, leaving the remainder in the free list
+                r_heap_block *rest = _block(heap, offset + needed);
+                rest->size = block->size - needed;
+                rest->next = block->next;
+                block->size = needed;
+                *link = offset + needed;
+            } else {
+                *link = block->next;
+            }
+
+            header->used += block->size;
+            return block + 1;
+        }
+        link = &block->next;
+    }
+
+    // otherwise take it from the top of the heap
+    if (header->top + needed > heap->reserve) {
+        r_log(R_LOG_ERROR, "heap: exhausted, %zu bytes requested\n", size);
+        return NULL;
+    }
+
+    r_heap_block *block = _block(heap, header->top);
+    block->size = needed;
+    header->top += needed;
+    header->used += needed;
+
+    return block + 1;
+}
+
+void * r_heap_alloc(r_heap *heap, size_t size) {
+    pthread_mutex_lock(&heap->lock);
+    void *ptr = _heap_alloc(heap, size);
+    pthread_mutex_unlock(&heap->lock);
+    return ptr;
+}
+
+static void _heap_free(r_heap *heap, void *ptr) {
+    r_heap_header *header = _header(heap);
+    r_heap_block  *block = (r_heap_block *)ptr - 1;
+    size_t         offset = (uint8_t *)block - heap->base;
+
+    header->used -= block->size;
+
+    // find the insertion point to keep the free list in address order
+    size_t  previous = 0;
+    size_t *link = &header->free_list;
+    while (*link != 0 && *link < offset) {
+        previous = *link;
+        link = &_block(heap, *link)->next;
+    }
+
+    block->next = *link;
+    *link = offset;
+
+    // merge with the following block
+    if (block->next != 0 && offset + block->size == block->next) {
+        r_heap_block *next = _block(heap, block->next);
+        block->size += next->size;
+        block->next = next->next;
+    }
+
+    // merge with the preceding block
+    if (previous != 0) {
+        r_heap_block *prev = _block(heap, previous);
+        if (previous + prev->size == offset) {
+            prev->size += block->size;
+            prev->next = block->next;
+        }
+    }
+}
+
+void r_heap_free(r_heap *heap, void *ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&heap->lock);
+    _heap_free(heap, ptr);
+    pthread_mutex_unlock(&heap->lock);
+}
+
+r_heap * r_heap_find(const void *ptr) {
+    for (uint32_t i = 0; i < MAX_HEAPS; i++) {
+        r_heap *heap = atomic_load(&created[i]);
+
+        if (heap != NULL && (const uint8_t *)ptr >= heap->base && (const uint8_t *)ptr < heap->base + heap->reserve) {
+            return heap;
+        }
+    }
+    return NULL;
+}
+
+size_t r_heap_used(r_heap *heap) {
+    pthread_mutex_lock(&heap->lock);
+    size_t used = _header(heap)->used;
+    pthread_mutex_unlock(&heap->lock);
+    return used;
+}
+
+// Snapshots
+// ---------
+
+static bool _install_handler() {
+    if (handler_installed) {
+        return true;
+    }
+
+    // the handler only passes faults on, the recorder copies and unprotects the pages
+    pthread_t recorder;
+    if (pipe(faults) != 0) {
+        r_log(R_LOG_ERROR, "heap: unable to create the fault pipe: %s\n", strerror(errno));
+        return false;
+    }
+    if (pthread_create(&recorder, NULL, _heap_recorder, NULL) != 0) {
+        r_log(R_LOG_ERROR, "heap: unable to start the recorder\n");
+        close(faults[0]);
+        close(faults[1]);
+        return false;
+    }
+    pthread_detach(recorder);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = _heap_fault;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+
+    // macOS reports protection faults as SIGBUS
+    sigaction(SIGSEGV, &action, &previous_segv);
+    sigaction(SIGBUS, &action, &previous_bus);
+    handler_installed = true;
+    return true;
+}
+
+bool r_heap_snapshot_enable(r_heap *heap, uint32_t frames, uint32_t max_pages) {
+
+    // already enabled, after an overflow tracking resumes at the next commit
+    if (heap->dirty != NULL) {
+        return true;
+    }
+
+    if (frames == 0 || max_pages == 0 || !_install_handler()) {
+        return false;
+    }
+
+    heap->dirty = mmap(NULL, heap->page_count, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    heap->pool = mmap(NULL, (size_t)max_pages * heap->page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON | MAP_NORESERVE, -1, 0);
+
+    if (heap->dirty == MAP_FAILED || heap->pool == MAP_FAILED) {
+        r_log(R_LOG_ERROR, "heap: unable to allocate snapshots: %s\n", strerror(errno));
+        if (heap->dirty != MAP_FAILED) munmap((void *)heap->dirty, heap->page_count);
+        if (heap->pool != MAP_FAILED) munmap(heap->pool, (size_t)max_pages * heap->page_size);
+        heap->dirty = NULL;
+        heap->pool = NULL;
+        return false;
+    }
+
+    heap->pool_pages = MALLOC(uint32_t, max_pages);
+    heap->pool_capacity = max_pages;
+    heap->frames = MALLOC(r_heap_frame, frames);
+    heap->frame_capacity = frames;
+
+    _heap_drop_history(heap);
+    atomic_store(&heap->overflowed, false);
+
+    // register the heap so that the fault handler can find it
+    for (uint32_t i = 0; i < MAX_HEAPS; i++) {
+        r_heap *expected = NULL;
+        if (atomic_compare_exchange_strong(&heaps[i], &expected, heap)) {
+            break;
+        }
+    }
+
+    atomic_store(&heap->tracking, true);
+    mprotect(heap->base, heap->reserve, PROT_READ);
+
+    return true;
+}
+
+void r_heap_snapshot_disable(r_heap *heap) {
+
+    if (heap->dirty == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&heap->snapshot_lock);
+    atomic_store(&heap->tracking, false);
+    mprotect(heap->base, heap->reserve, PROT_READ | PROT_WRITE);
+    pthread_mutex_unlock(&heap->snapshot_lock);
+
+    for (uint32_t i = 0; i < MAX_HEAPS; i++) {
+        r_heap *expected = heap;
+        if (atomic_compare_exchange_strong(&heaps[i], &expected, NULL)) {
+            break;
+        }
+    }
+
+    munmap((void *)heap->dirty, heap->page_count);
+    munmap(heap->pool, (size_t)heap->pool_capacity * heap->page_size);
+    FREE(uint32_t, heap->pool_pages);
+    FREE(r_heap_frame, heap->frames);
+    heap->dirty = NULL;
+    heap->pool = NULL;
+}
+
+// forget every frame, the current state becomes the oldest restorable state
+static void _heap_drop_history(r_heap *heap) {
+    atomic_store(&heap->pool_head, 0);
+    heap->pool_tail = 0;
+    heap->frame_first = 0;
+    heap->frame_count = 0;
+    heap->current_start = 0;
+}
+
+void r_heap_snapshot_reset(r_heap *heap) {
+    if (!atomic_load(&heap->tracking)) {
+        return;
+    }
+
+    pthread_mutex_lock(&heap->snapshot_lock);
+    uint32_t head = atomic_load(&heap->pool_head);
+    for (uint32_t slot = heap->current_start; slot < head; slot++) {
+        uint32_t page = heap->pool_pages[slot % heap->pool_capacity];
+        heap->dirty[page] = 0;
+        mprotect(heap->base + (size_t)page * heap->page_size, heap->page_size, PROT_READ);
+    }
+
+    _heap_drop_history(heap);
+    pthread_mutex_unlock(&heap->snapshot_lock);
+}
+
+// retire the oldest frame, releasing its pool slots
+static void _heap_drop_oldest(r_heap *heap) {
+    r_heap_frame *oldest = &heap->frames[heap->frame_first];
+
+    heap->pool_tail = oldest->start + oldest->count;
+    heap->frame_first = (heap->frame_first + 1) % heap->frame_capacity;
+    heap->frame_count--;
+}
+
+bool r_heap_snapshot_commit(r_heap *heap) {
+    if (heap->dirty == NULL) {
+        return true;
+    }
+
+    pthread_mutex_lock(&heap->snapshot_lock);
+
+    // the frame didn't fit, start over from the current state
+    if (atomic_load(&heap->overflowed)) {
+        memset((void *)heap->dirty, 0, heap->page_count);
+        _heap_drop_history(heap);
+        atomic_store(&heap->overflowed, false);
+        atomic_store(&heap->tracking, true);
+        mprotect(heap->base, heap->reserve, PROT_READ);
+
+        pthread_mutex_unlock(&heap->snapshot_lock);
+        return false;
+    }
+
+    uint32_t head = atomic_load(&heap->pool_head);
+
+    if (heap->frame_count == heap->frame_capacity) {
+        _heap_drop_oldest(heap);
+    }
+
+    uint32_t index = (heap->frame_first + heap->frame_count) % heap->frame_capacity;
+    heap->frames[index] = (r_heap_frame){
+        .start = heap->current_start,
+        .count = head - heap->current_start,
+    };
+    heap->frame_count++;
+
+    // write protect only the pages written during the frame
+    for (uint32_t slot = heap->current_start; slot < head; slot++) {
+        uint32_t page = heap->pool_pages[slot % heap->pool_capacity];
+        heap->dirty[page] = 0;
+        mprotect(heap->base + (size_t)page * heap->page_size, heap->page_size, PROT_READ);
+    }
+
+    heap->current_start = head;
+    pthread_mutex_unlock(&heap->snapshot_lock);
+    return true;
+}
+
+uint32_t r_heap_snapshot_frames(r_heap *heap) {
+    return atomic_load(&heap->tracking) ? heap->frame_count : 0;
+}
+
+bool r_heap_snapshot_rewind(r_heap *heap, uint32_t frames) {
+    if (!atomic_load(&heap->tracking)) {
+        return false;
+    }
+
+    pthread_mutex_lock(&heap->snapshot_lock);
+    if (frames > heap->frame_count) {
+        pthread_mutex_unlock(&heap->snapshot_lock);
+        return false;
+    }
+
+    uint32_t head = atomic_load(&heap->pool_head);
+
+    // first slot to undo, the start of the oldest frame being rewound
+    uint32_t first = heap->current_start;
+    if (frames > 0) {
+        uint32_t index = (heap->frame_first + heap->frame_count - frames) % heap->frame_capacity;
+        first = heap->frames[index].start;
+    }
+
+    mprotect(heap->base, heap->reserve, PROT_READ | PROT_WRITE);
+
+    // apply the pre-images newest first, so each page ends up with its oldest copy
+    for (uint32_t slot = head; slot > first; slot--) {
+        uint32_t pool_index = (slot - 1) % heap->pool_capacity;
+        uint32_t page = heap->pool_pages[pool_index];
+
+        memcpy(heap->base + (size_t)page * heap->page_size, heap->pool + (size_t)pool_index * heap->page_size, heap->page_size);
+    }
+
+    memset((void *)heap->dirty, 0, heap->page_count);
+    heap->frame_count -= frames;
+    heap->current_start = first;
+    atomic_store(&heap->pool_head, first);
+
+    mprotect(heap->base, heap->reserve, PROT_READ);
+
+    pthread_mutex_unlock(&heap->snapshot_lock);
+    return true;
+}
+
+uint32_t r_heap_snapshot_diff(r_heap *heap, uint32_t frames, size_t *offsets, uint32_t max_offsets) {
+    if (!atomic_load(&heap->tracking)) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&heap->snapshot_lock);
+    if (frames > heap->frame_count) {
+        pthread_mutex_unlock(&heap->snapshot_lock);
+        return 0;
+    }
+
+    uint32_t head = atomic_load(&heap->pool_head);
+    uint32_t first = heap->current_start;
+    if (frames > 0) {
+        uint32_t index = (heap->frame_first + heap->frame_count - frames) % heap->frame_capacity;
+        first = heap->frames[index].start;
+    }
+
+    uint8_t *seen = MALLOC(uint8_t, heap->page_count);
+    uint32_t changed = 0;
+
+    memset(seen, 0, heap->page_count);
+
+    for (uint32_t slot = first; slot < head; slot++) {
+        uint32_t page = heap->pool_pages[slot % heap->pool_capacity];
+
+        if (!seen[page]) {
+            seen[page] = 1;
+            if (changed < max_offsets && offsets != NULL) {
+                offsets[changed] = (size_t)page * heap->page_size;
+            }
+            changed++;
+        }
+    }
+
+    pthread_mutex_unlock(&heap->snapshot_lock);
+
+    FREE(uint8_t, seen);
+    return changed;
+}
+
+// Fault handler
+// -------------
+
+static void _heap_chain(struct sigaction *previous, int signum, siginfo_t *info, void *context) {
+    if (previous->sa_flags & SA_SIGINFO) {
+        previous->sa_sigaction(signum, info, context);
+    } else if (previous->sa_handler == SIG_DFL || previous->sa_handler == SIG_IGN) {
+        // restore the default and let the fault happen again
+        signal(signum, SIG_DFL);
+    } else {
+        previous->sa_handler(signum);
+    }
+}
+
+// Copy the page into the pool and make it writable, on the recorder thread
+static void _heap_record(r_heap *heap, uint8_t *address) {
+    uint32_t page = (uint32_t)((address - heap->base) / heap->page_size);
+    uint8_t *page_start = heap->base + (size_t)page * heap->page_size;
+
+    pthread_mutex_lock(&heap->snapshot_lock);
+
+    // another write recorded the page already, or the heap isn't tracked anymore
+    if (!atomic_load(&heap->tracking) || atomic_exchange(&heap->dirty[page], 1) != 0) {
+        pthread_mutex_unlock(&heap->snapshot_lock);
+        return;
+    }
+
+    uint32_t slot = atomic_fetch_add(&heap->pool_head, 1);
+
+    if (slot - heap->current_start >= heap->pool_capacity) {
+        // the frame in progress doesn't fit in the pool, the history is lost
+        // and tracking resumes at the next commit
+        atomic_store(&heap->tracking, false);
+        atomic_store(&heap->overflowed, true);
+        _heap_drop_history(heap);
+        mprotect(heap->base, heap->reserve, PROT_READ | PROT_WRITE);
+
+        pthread_mutex_unlock(&heap->snapshot_lock);
+        return;
+    }
+
+    // make room by retiring the oldest frames
+    while (slot - heap->pool_tail >= heap->pool_capacity && heap->frame_count > 0) {
+        _heap_drop_oldest(heap);
+    }
+
+    uint32_t pool_index = slot % heap->pool_capacity;
+    memcpy(heap->pool + (size_t)pool_index * heap->page_size, page_start, heap->page_size);
+    heap->pool_pages[pool_index] = page;
+
+    mprotect(page_start, heap->page_size, PROT_READ | PROT_WRITE);
+    pthread_mutex_unlock(&heap->snapshot_lock);
+}
+
+static void * _heap_recorder(void *arg) {
+    (void)arg;
+    r_heap_fault fault;
+
+    while (true) {
+        ssize_t size = read(faults[0], &fault, sizeof(fault));
+
+        if (size == sizeof(fault)) {
+            _heap_record(fault.heap, fault.address);
+            atomic_store_explicit(fault.done, true, memory_order_release);
+        } else if (size < 0 && errno != EINTR) {
+            r_log(R_LOG_ERROR, "heap: the recorder stopped: %s\n", strerror(errno));
+            return NULL;
+        }
+    }
+}
+
+// Hand the write to the recorder and wait until it's been made writable. Only
+// uses async signal safe calls, a write to the pipe and lock free atomics.
+static void _heap_fault(int signum, siginfo_t *info, void *context) {
+    uint8_t *address = (uint8_t *)info->si_addr;
+    int      saved_errno = errno;
+
+    for (uint32_t i = 0; i < MAX_HEAPS; i++) {
+        r_heap *heap = atomic_load(&heaps[i]);
+
+        // a heap which stopped tracking is unprotected by the recorder, the write is retried
+        if (heap != NULL && address >= heap->base && address < heap->base + heap->reserve) {
+            _Atomic bool done = false;
+            r_heap_fault fault = { .heap = heap, .address = address, .done = &done };
+
+            ssize_t written;
+            while ((written = write(faults[1], &fault, sizeof(fault))) < 0 && errno == EINTR) {}
+
+            if (written == sizeof(fault)) {
+                while (!atomic_load_explicit(&done, memory_order_acquire)) {}
+                errno = saved_errno;
+                return;
+            }
+            break;
+        }
+    }
+
+    // not one of ours
+    _heap_chain(signum == SIGBUS ? &previous_bus : &previous_segv, signum, info, context);
+}
@@ -0,0 +1,57 @@
+#ifndef _MEMORY_HEAP_H_
+#define _MEMORY_HEAP_H_
+
+// r_heap is a reserved, fixed address region used for a module's persistent
+// memory. Because the allocator state lives inside the region, the whole heap
+// can be snapshotted and restored.
+//
+// Allocating and freeing are thread safe.
+//
+// Snapshots track dirty pages by write protecting the heap at each frame
+// boundary. The first write to a page in a frame faults, the fault handler
+// hands the page to a recorder thread, which copies it into a pre-allocated
+// pool and makes it writable again. Only pages which were written are copied
+// and re-protected, so the cost per frame is proportional to the pages
+// actually written. A frame which writes more pages than the pool holds
+// drops the history, tracking starts over at the next commit.
+//
+// Note: the kernel doesn't fault on writes from system calls, reading
+// directly into the heap (e.g. read(2)) fails with EFAULT while tracking.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct r_heap r_heap;
+
+r_heap * r_heap_create(size_t reserve);
+void     r_heap_destroy(r_heap *heap);
+
+void *   r_heap_alloc(r_heap *heap, size_t size);
+void     r_heap_free(r_heap *heap, void *ptr);
+size_t   r_heap_used(r_heap *heap);
+
+// the heap whose reserved range holds ptr, NULL if it wasn't allocated from one
+r_heap * r_heap_find(const void *ptr);
+
+// keep the pages written in the last `frames` frames, using at most `max_pages` pages of storage
+bool     r_heap_snapshot_enable(r_heap *heap, uint32_t frames, uint32_t max_pages);
+void     r_heap_snapshot_disable(r_heap *heap);
+
+// drop the history, e.g. when the layout of the data changes
+void     r_heap_snapshot_reset(r_heap *heap);
+
+// close the current frame, called at the frame boundary, false when the frame
+// overflowed the pool and the history was dropped
+bool     r_heap_snapshot_commit(r_heap *heap);
+
+// number of frames which can be rewound
+uint32_t r_heap_snapshot_frames(r_heap *heap);
+
+// restore the heap to the state it was in `frames` commits ago, 0 discards the current frame's writes
+bool     r_heap_snapshot_rewind(r_heap *heap, uint32_t frames);
+
+// offsets of the pages which changed since `frames` commits ago, returns the number of changed pages
+uint32_t r_heap_snapshot_diff(r_heap *heap, uint32_t frames, size_t *offsets, uint32_t max_offsets);
+
+#endif
@@ -0,0 +1,31 @@
+#include <stdlib.h>
+
+#include "rlalloc.h"
+
+// built into raylib, the host links against this copy
+static r_rl_allocator current = {
+    .allocate = malloc,
+    .allocate_zeroed = calloc,
+    .reallocate = realloc,
+    .release = free,
+};
+
+void r_rl_set_allocator(const r_rl_allocator *allocator) {
+    current = *allocator;
+}
+
+void * r_rl_malloc(size_t size) {
+    return current.allocate(size);
+}
+
+void * r_rl_calloc(size_t count, size_t size) {
+    return current.allocate_zeroed(count, size);
+}
+
+void * r_rl_realloc(void *ptr, size_t size) {
+    return current.reallocate(ptr, size);
+}
+
+void r_rl_free(void *ptr) {
+    current.release(ptr);
+}
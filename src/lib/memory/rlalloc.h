@@ -0,0 +1,31 @@
+#ifndef _MEMORY_RLALLOC_H_
+#define _MEMORY_RLALLOC_H_
+
+// raylib is built with this header forced in, which points RL_MALLOC,
+// RL_CALLOC, RL_REALLOC and RL_FREE at an allocator the host can replace.
+// raylib is shared by the host and the modules, so replacing it once covers
+// everything loaded through raylib. It has to be replaced before raylib
+// allocates anything, memory can't move between allocators.
+
+#include <stddef.h>
+
+typedef struct r_rl_allocator {
+    void * (*allocate)(size_t size);
+    void * (*allocate_zeroed)(size_t count, size_t size);
+    void * (*reallocate)(void *ptr, size_t size);
+    void   (*release)(void *ptr);
+} r_rl_allocator;
+
+void r_rl_set_allocator(const r_rl_allocator *allocator);
+
+void * r_rl_malloc(size_t size);
+void * r_rl_calloc(size_t count, size_t size);
+void * r_rl_realloc(void *ptr, size_t size);
+void   r_rl_free(void *ptr);
+
+#define RL_MALLOC(sz)       r_rl_malloc(sz)
+#define RL_CALLOC(n, sz)    r_rl_calloc(n, sz)
+#define RL_REALLOC(ptr, sz) r_rl_realloc(ptr, sz)
+#define RL_FREE(ptr)        r_rl_free(ptr)
+
+#endif
@@ -0,0 +1,275 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log/log.h"
+#include "memory/rlalloc.h"
+#include "memory/tagged.h"
+#include "module/context.h"
+
+#define TAGGED_LARGE 0xFF
+
+// sits in front of every block, keeps the payload 16 byte aligned
+typedef struct r_tagged_header {
+    uint64_t size;
+    uint16_t tag;
+    uint8_t  class;
+    uint8_t  pad[5];
+} r_tagged_header;
+
+_Static_assert(sizeof(r_tagged_header) == 16, "the header must keep blocks aligned");
+
+typedef struct r_tagged_free_block {
+    struct r_tagged_free_block *next;
+} r_tagged_free_block;
+
+// blocks of one size, carved from chunks which are never returned
+typedef struct r_tagged_pool {
+    pthread_mutex_t       lock;
+    r_tagged_free_block * free;
+    uint8_t *             cursor;
+    uint8_t *             end;
+} r_tagged_pool;
+
+typedef struct r_tagged_tag {
+    char             name[MAX_MODULE_FN_NAME];
+    _Atomic int64_t  bytes;
+    _Atomic int64_t  blocks;
+} r_tagged_tag;
+
+static r_tagged_pool    pools[TAGGED_CLASSES];
+static pthread_once_t   pools_once = PTHREAD_ONCE_INIT;
+
+// tag 0 is the host
+static r_tagged_tag     tags[MAX_MEMORY_TAGS] = { { .name = "host" } };
+static _Atomic uint32_t tag_count = 1;
+static pthread_mutex_t  tag_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// the last owner looked up on this thread, its name string identifies it
+static _Thread_local const char *cached_name = NULL;
+static _Thread_local uint16_t    cached_tag = 0;
+
+static size_t _class_size(uint8_t class) {
+    return (size_t)16 << class;
+}
+
+static uint8_t _class(size_t size) {
+    size_t total = size + sizeof(r_tagged_header);
+    if (total > TAGGED_MAX_POOLED) {
+        return TAGGED_LARGE;
+    }
+
+    uint8_t class = 0;
+    while (_class_size(class) < total) {
+        class++;
+    }
+    return class;
+}
+
+static uint16_t _tag(r_module_properties *owner) {
+    if (owner == NULL || owner->name == NULL) {
+        return 0;
+    }
+    // the name may have been freed and its address reused by another module
+    if (owner->name == cached_name && strcmp(tags[cached_tag].name, owner->name) == 0) {
+        return cached_tag;
+    }
+
+    uint16_t tag = 0;
+    uint32_t count = atomic_load_explicit(&tag_count, memory_order_acquire);
+    for (uint32_t i = 1; i < count; i++) {
+        if (strcmp(tags[i].name, owner->name) == 0) {
+            tag = (uint16_t)i;
+            break;
+        }
+    }
+
+    // modules keep their tag across reloads and re-registration
+    if (tag == 0) {
+        pthread_mutex_lock(&tag_lock);
+        count = atomic_load_explicit(&tag_count, memory_order_relaxed);
+        for (uint32_t i = 1; i < count && tag == 0; i++) {
+            if (strcmp(tags[i].name, owner->name) == 0) {
+                tag = (uint16_t)i;
+            }
+        }
+        if (tag == 0 && count < MAX_MEMORY_TAGS) {
+            snprintf(tags[count].name, sizeof(tags[count].name), "%s", owner->name);
+            atomic_store_explicit(&tag_count, count + 1, memory_order_release);
+            tag = (uint16_t)count;
+        }
+        pthread_mutex_unlock(&tag_lock);
+    }
+
+    cached_name = owner->name;
+    cached_tag = tag;
+    return tag;
+}
+
+static void _charge(uint16_t tag, int64_t bytes, int64_t blocks) {
+    atomic_fetch_add_explicit(&tags[tag].bytes, bytes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&tags[tag].blocks, blocks, memory_order_relaxed);
+}
+
+static void _pools_init() {
+    for (uint32_t i = 0; i < TAGGED_CLASSES; i++) {
+        pthread_mutex_init(&pools[i].lock, NULL);
+    }
+}
+
+static r_tagged_header * _pool_take(uint8_t class) {
+    pthread_once(&pools_once, _pools_init);
+
+    r_tagged_pool *pool = &pools[class];
+    size_t         size = _class_size(class);
+    void *         block = NULL;
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->free) {
+        block = pool->free;
+        pool->free = pool->free->next;
+    } else {
+        if (pool->cursor == NULL || pool->cursor + size > pool->end) {
+            uint8_t *chunk = malloc(TAGGED_CHUNK_SIZE);
+            if (chunk) {
+                pool->cursor = chunk;
+                pool->end = chunk + TAGGED_CHUNK_SIZE;
+            }
+        }
+        if (pool->cursor && pool->cursor + size <= pool->end) {
+            block = pool->cursor;
+            pool->cursor += size;
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return block;
+}
+
+static void _pool_give(uint8_t class, void *block) {
+    r_tagged_pool *      pool = &pools[class];
+    r_tagged_free_block *free_block = block;
+
+    pthread_mutex_lock(&pool->lock);
+    free_block->next = pool->free;
+    pool->free = free_block;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+static void * _allocate(uint16_t tag, size_t size) {
+    uint8_t          class = _class(size);
+    r_tagged_header *header = class == TAGGED_LARGE ? malloc(sizeof(r_tagged_header) + size) : _pool_take(class);
+
+    if (header == NULL) {
+        return NULL;
+    }
+
+    header->size = size;
+    header->tag = tag;
+    header->class = class;
+    _charge(tag, (int64_t)size, 1);
+
+    return header + 1;
+}
+
+void * r_tagged_alloc(r_module_properties *owner, size_t size) {
+    return _allocate(_tag(owner), size);
+}
+
+void * r_tagged_malloc(size_t size) {
+    return _allocate(_tag(r_module_context_get()), size);
+}
+
+void * r_tagged_calloc(size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        return NULL;
+    }
+
+    void *ptr = r_tagged_malloc(count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+void r_tagged_free(void *ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+
+    r_tagged_header *header = (r_tagged_header *)ptr - 1;
+    _charge(header->tag, -(int64_t)header->size, -1);
+
+    if (header->class == TAGGED_LARGE) {
+        free(header);
+    } else {
+        _pool_give(header->class, header);
+    }
+}
+
+void * r_tagged_realloc(void *ptr, size_t size) {
+    if (ptr == NULL) {
+        return r_tagged_malloc(size);
+    }
+
+    r_tagged_header *header = (r_tagged_header *)ptr - 1;
+
+    // still fits the block
+    if (header->class != TAGGED_LARGE && size + sizeof(r_tagged_header) <= _class_size(header->class)) {
+        _charge(header->tag, (int64_t)size - (int64_t)header->size, 0);
+        header->size = size;
+        return ptr;
+    }
+
+    void *moved = _allocate(header->tag, size);
+    if (moved) {
+        memcpy(moved, ptr, size < header->size ? size : header->size);
+        r_tagged_free(ptr);
+    }
+    return moved;
+}
+
+void r_tagged_adopt(void *ptr, r_module_properties *owner) {
+    if (ptr == NULL) {
+        return;
+    }
+
+    r_tagged_header *header = (r_tagged_header *)ptr - 1;
+    uint16_t         tag = _tag(owner);
+
+    _charge(header->tag, -(int64_t)header->size, -1);
+    _charge(tag, (int64_t)header->size, 1);
+    header->tag = tag;
+}
+
+r_tagged_usage r_tagged_get_usage(r_module_properties *owner) {
+    uint16_t tag = _tag(owner);
+
+    return (r_tagged_usage){
+        .bytes = (uint64_t)atomic_load_explicit(&tags[tag].bytes, memory_order_relaxed),
+        .blocks = (uint64_t)atomic_load_explicit(&tags[tag].blocks, memory_order_relaxed),
+    };
+}
+
+bool r_tagged_report(r_module_properties *owner) {
+    r_tagged_usage usage = r_tagged_get_usage(owner);
+
+    if (usage.blocks == 0) {
+        return false;
+    }
+
+    r_log(R_LOG_WARNING, "module %s left %llu raylib allocations behind, %llu bytes\n",
+          owner ? owner->name : "host", (unsigned long long)usage.blocks, (unsigned long long)usage.bytes);
+    return true;
+}
+
+void r_tagged_hook_raylib() {
+    r_rl_set_allocator(&(r_rl_allocator){
+        .allocate = r_tagged_malloc,
+        .allocate_zeroed = r_tagged_calloc,
+        .reallocate = r_tagged_realloc,
+        .release = r_tagged_free,
+    });
+}
@@ -0,0 +1,48 @@
+#ifndef _MEMORY_TAGGED_H_
+#define _MEMORY_TAGGED_H_
+
+// r_tagged is the host allocator behind raylib's allocations. Every block
+// carries a small header naming the module it is charged to, by default the
+// module running on the allocating thread, so the memory of loaded assets
+// shows up in the module's stats and what a module leaves behind is reported
+// when it goes away.
+//
+// Blocks up to TAGGED_MAX_POOLED bytes come from size class pools which are
+// kept for the lifetime of the process, larger ones go to malloc.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "module/interface.h"
+
+#define MAX_MEMORY_TAGS    (MAX_MODULES + 1)
+#define TAGGED_CLASSES     9
+#define TAGGED_MAX_POOLED  4096
+#define TAGGED_CHUNK_SIZE  (64 * 1024)
+
+typedef struct r_tagged_usage {
+    uint64_t bytes;
+    uint64_t blocks;
+} r_tagged_usage;
+
+// charged to the module running on this thread, or the host
+void * r_tagged_malloc(size_t size);
+void * r_tagged_calloc(size_t count, size_t size);
+// a block keeps its owner when it is resized
+void * r_tagged_realloc(void *ptr, size_t size);
+void   r_tagged_free(void *ptr);
+
+// charged to owner, NULL for the host
+void * r_tagged_alloc(r_module_properties *owner, size_t size);
+// charge a block to another owner
+void   r_tagged_adopt(void *ptr, r_module_properties *owner);
+
+r_tagged_usage r_tagged_get_usage(r_module_properties *owner);
+// log what the module still holds, true if anything
+bool r_tagged_report(r_module_properties *owner);
+
+// route raylib's allocations through r_tagged, before raylib allocates anything
+void r_tagged_hook_raylib();
+
+#endif
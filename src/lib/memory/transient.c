@@ -0,0 +1,146 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "log/log.h"
+#include "memory/allocator.h"
+#include "memory/transient.h"
+
+#define TRANSIENT_ALIGN 16
+
+typedef struct r_transient_arena {
+    // held by the owning thread while allocating and by the frame boundary while recycling
+    atomic_flag lock;
+
+    uint8_t * buffers[2];
+    size_t    used[2];
+    uint32_t  current;
+    uint64_t  frame;
+    bool      exhausted;
+
+    struct r_transient_arena *next;
+} r_transient_arena;
+
+static _Atomic uint64_t frame = 0;
+
+static _Thread_local r_transient_arena *arena = NULL;
+
+// every arena, so that they can be released
+static r_transient_arena *arenas = NULL;
+static pthread_mutex_t    arenas_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static r_transient_arena * _arena_create() {
+    r_transient_arena *created = MALLOC(r_transient_arena, 1);
+    memset(created, 0, sizeof(r_transient_arena));
+
+    for (int i = 0; i < 2; i++) {
+        created->buffers[i] = mmap(NULL, TRANSIENT_BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+
+        if (created->buffers[i] == MAP_FAILED) {
+            r_log(R_LOG_ERROR, "transient: unable to allocate a buffer: %s\n", strerror(errno));
+            created->buffers[i] = NULL;
+        }
+    }
+    atomic_flag_clear(&created->lock);
+
+    pthread_mutex_lock(&arenas_lock);
+    created->frame = atomic_load(&frame);
+    created->next = arenas;
+    arenas = created;
+    pthread_mutex_unlock(&arenas_lock);
+
+    return created;
+}
+
+// hand out the buffer which expired at the end of the last frame
+static void _arena_recycle(r_transient_arena *arena, uint64_t now) {
+
+    // if more than a frame has passed both buffers have expired
+    uint32_t expired = now - arena->frame > 1 ? 2 : 1;
+
+    for (uint32_t i = 0; i < expired; i++) {
+        arena->current ^= 1;
+#ifdef _DEBUG
+        if (arena->buffers[arena->current]) {
+            memset(arena->buffers[arena->current], TRANSIENT_POISON, arena->used[arena->current]);
+        }
+#endif
+        arena->used[arena->current] = 0;
+    }
+
+    arena->frame = now;
+    arena->exhausted = false;
+}
+
+void * r_transient_alloc(size_t size) {
+
+    if (arena == NULL) {
+        arena = _arena_create();
+    }
+
+    while (atomic_flag_test_and_set_explicit(&arena->lock, memory_order_acquire)) {}
+
+    // the frame boundary may not have got to this arena yet
+    uint64_t now = atomic_load_explicit(&frame, memory_order_acquire);
+    if (arena->frame != now) {
+        _arena_recycle(arena, now);
+    }
+
+    size_t offset = (arena->used[arena->current] + TRANSIENT_ALIGN - 1) & ~(size_t)(TRANSIENT_ALIGN - 1);
+    void * memory = NULL;
+
+    if (arena->buffers[arena->current] == NULL || offset + size > TRANSIENT_BUFFER_SIZE) {
+        if (!arena->exhausted) {
+            r_log(R_LOG_ERROR, "transient: exhausted, %zu bytes requested\n", size);
+            arena->exhausted = true;
+        }
+    } else {
+        arena->used[arena->current] = offset + size;
+        memory = arena->buffers[arena->current] + offset;
+    }
+
+    atomic_flag_clear_explicit(&arena->lock, memory_order_release);
+    return memory;
+}
+
+void r_transient_next_frame() {
+    pthread_mutex_lock(&arenas_lock);
+    uint64_t now = atomic_fetch_add_explicit(&frame, 1, memory_order_acq_rel) + 1;
+
+    // recycle every arena now rather than at its next allocation, so expired
+    // allocations are poisoned as soon as they expire
+    for (r_transient_arena *it = arenas; it; it = it->next) {
+        while (atomic_flag_test_and_set_explicit(&it->lock, memory_order_acquire)) {}
+        if (it->frame != now) {
+            _arena_recycle(it, now);
+        }
+        atomic_flag_clear_explicit(&it->lock, memory_order_release);
+    }
+    pthread_mutex_unlock(&arenas_lock);
+}
+
+uint64_t r_transient_frame() {
+    return atomic_load_explicit(&frame, memory_order_relaxed);
+}
+
+void r_transient_destroy() {
+    pthread_mutex_lock(&arenas_lock);
+    while (arenas) {
+        r_transient_arena *next = arenas->next;
+
+        for (int i = 0; i < 2; i++) {
+            if (arenas->buffers[i]) {
+                munmap(arenas->buffers[i], TRANSIENT_BUFFER_SIZE);
+            }
+        }
+        FREE(r_transient_arena, arenas);
+        arenas = next;
+    }
+    pthread_mutex_unlock(&arenas_lock);
+
+    // the calling thread's arena is gone with the rest
+    arena = NULL;
+}
@@ -0,0 +1,24 @@
+#ifndef _MEMORY_TRANSIENT_H_
+#define _MEMORY_TRANSIENT_H_
+
+// Per-frame transient memory. Each thread bump allocates from its own pair of
+// buffers, allocations stay valid until the end of the following frame and
+// are never freed individually. In debug builds expired allocations are
+// poisoned at the frame boundary where they expire to catch late use.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TRANSIENT_BUFFER_SIZE ((size_t)4 * 1024 * 1024)
+#define TRANSIENT_POISON      0xDD
+
+void * r_transient_alloc(size_t size);
+
+// start a new frame, called at the frame boundary
+void   r_transient_next_frame();
+uint64_t r_transient_frame();
+
+// release the buffers of every thread
+void   r_transient_destroy();
+
+#endif
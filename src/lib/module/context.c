@@ -0,0 +1,13 @@
+#include <stddef.h>
+
+#include "module/context.h"
+
+static _Thread_local r_module_properties *current = NULL;
+
+void r_module_context_set(r_module_properties *props) {
+    current = props;
+}
+
+r_module_properties * r_module_context_get() {
+    return current;
+}
@@ -0,0 +1,12 @@
+#ifndef _MODULE_CONTEXT_H_
+#define _MODULE_CONTEXT_H_
+
+// Tracks the module whose code is currently running on this thread, so that
+// host services called without a props pointer can attribute work to it.
+
+#include "module/interface.h"
+
+void r_module_context_set(r_module_properties *props);
+r_module_properties * r_module_context_get();
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE   // dladdr1, dlinfo
+#endif
+
+#include <dlfcn.h>
+#include <link.h>
+#include <string.h>
+
+#include "log/log.h"
+#include "module/function.h"
+
+// Handles embedded in the properties (memory.create / memory.destroy) move
+// with the interface when the lifecycle shuffles its array, so they aren't
+// tracked by address and are always resolved directly instead.
+static bool _is_embedded(r_module_properties *props, r_module_fn *handle) {
+    return (char *)handle >= (char *)props && (char *)handle < (char *)(props + 1);
+}
+
+// Storage in the module's image (a static or global) belongs to the old image
+// after a reload, the tracked pointer to the handle would dangle.
+static bool _in_image(r_module_properties *props, const void *address) {
+    struct link_map *image = NULL;
+    struct link_map *owner = NULL;
+    Dl_info          info;
+
+    if (dlinfo(props->library_handle, RTLD_DI_LINKMAP, &image) != 0) {
+        return false;
+    }
+    return dladdr1(address, &info, (void **)&owner, RTLD_DL_LINKMAP) != 0 && owner == image;
+}
+
+static void _resolve(r_module_properties *props, r_module_fn *handle) {
+    if (handle->name[0] == '\0') {
+        return;
+    }
+
+    handle->ptr = dlsym(props->library_handle, handle->name);
+
+    if (handle->ptr == NULL) {
+        r_log(R_LOG_ERROR, "module %s: unable to resolve function: %s\n", props->name, handle->name);
+    }
+}
+
+bool r_module_fn_bind(r_module_properties *props, r_module_fn *handle, const char *symbol, void *address) {
+
+    if (strlen(symbol) >= MAX_MODULE_FN_NAME) {
+        r_log(R_LOG_ERROR, "module %s: function name too long: %s\n", props->name, symbol);
+        return false;
+    }
+
+    if (props->library_handle != NULL) {
+        if (!_is_embedded(props, handle) && _in_image(props, handle)) {
+            r_log(R_LOG_ERROR, "module %s: the handle for %s is in the module's image, keep it in persistent memory\n", props->name, symbol);
+            return false;
+        }
+
+        // a static function has no symbol to find again in the next image
+        if (address != NULL && dlsym(props->library_handle, symbol) != address) {
+            r_log(R_LOG_ERROR, "module %s: %s isn't exported, it can't be re-resolved on reload\n", props->name, symbol);
+            return false;
+        }
+    }
+
+    if (!_is_embedded(props, handle)) {
+        // check if the handle is already bound
+        bool found = false;
+        for (uint32_t i = 0; i < props->functions.count; i++) {
+            if (props->functions.handles[i] == handle) {
+                found = true;
+                break;
+            }
+        }
+
+        if (!found) {
+            if (props->functions.count == MAX_MODULE_FUNCTIONS) {
+                r_log(R_LOG_ERROR, "module %s: too many function handles\n", props->name);
+                return false;
+            }
+            props->functions.handles[props->functions.count++] = handle;
+        }
+    }
+
+    strcpy(handle->name, symbol);
+    handle->ptr = address;
+
+    // no address supplied, look it up in the current image
+    if (handle->ptr == NULL) {
+        _resolve(props, handle);
+    }
+
+    return handle->ptr != NULL;
+}
+
+void r_module_fn_unbind(r_module_properties *props, r_module_fn *handle) {
+
+    for (uint32_t i = 0; i < props->functions.count; i++) {
+        if (props->functions.handles[i] == handle) {
+            // shuffle the handles down and decrement the count
+            for (uint32_t j = i; j < props->functions.count - 1; j++) {
+                props->functions.handles[j] = props->functions.handles[j + 1];
+            }
+            props->functions.count--;
+            break;
+        }
+    }
+
+    handle->name[0] = '\0';
+    handle->ptr = NULL;
+}
+
+void r_module_fn_resolve(r_module_properties *props) {
+
+    _resolve(props, &props->memory.create);
+    _resolve(props, &props->memory.destroy);
+
+    for (uint32_t i = 0; i < props->functions.count; i++) {
+        _resolve(props, props->functions.handles[i]);
+    }
+}
+
+void r_module_fn_reset(r_module_properties *props) {
+    props->functions.count = 0;
+}
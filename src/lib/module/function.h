@@ -0,0 +1,21 @@
+#ifndef _MODULE_FUNCTION_H_
+#define _MODULE_FUNCTION_H_
+
+// r_module_fn handles are bound by a module and re-resolved by the host
+// every time the module's library is loaded.
+
+#include <stdbool.h>
+
+#include "module/interface.h"
+
+bool r_module_fn_bind(r_module_properties *props, r_module_fn *handle, const char *symbol, void *address);
+void r_module_fn_unbind(r_module_properties *props, r_module_fn *handle);
+
+// re-resolve every bound handle against the currently loaded library
+void r_module_fn_resolve(r_module_properties *props);
+
+// forget every bound handle, used when the persistent memory holding
+// the handles is destroyed
+void r_module_fn_reset(r_module_properties *props);
+
+#endif
@@ -1,21 +1,58 @@
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE   // asprintf
+#endif
+
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
+#include "asset/asset.h"
+#include "bus/bus.h"
+#include "cluster/cluster.h"
+#include "draw/draw.h"
+#include "fiber/fiber.h"
 #include "filetracker/filetracker.h"
+#include "io/io.h"
+#include "job/job.h"
+#include "log/log.h"
 #include "memory/allocator.h"
+#include "memory/heap.h"
+#include "memory/transient.h"
+#include "module/function.h"
 #include "module/helper.h"
 #include "module/module.h"
+#include "module/persistent.h"
+#include "module/pipeline.h"
+#include "module/service.h"
+#include "module/tweak.h"
+#include "profile/profile.h"
+#include "replay/replay.h"
+#include "state/state.h"
+#include "telemetry/telemetry.h"
 
 static r_module_lifecycle *lifecycle;
 static r_filetracker *filetracker;
+static bool           batching = false;
 
 void r_module_create() {
+    // Start the job system shared by the modules
+    r_job_system_create(0);
+
+    // and the I/O service, modules may read files from init
+    r_io_create();
+
     // Create a module lifecycle instance
     lifecycle = r_module_lifecycle_create();
 
     // Create a filetracker instance
     filetracker = r_filetracker_create();
+
+    // Assets are reloaded when the files they came from change
+    r_asset_create(filetracker);
+
+    // Publish the frame metrics for external tools
+    r_telemetry_create();
 }
 
 void r_module_add(const char *module_name) {
@@ -25,14 +62,77 @@ void r_module_add(const char *module_name) {
         .last_modified = 0,
         .needs_reload = false,
         .memory = (r_module_memory){
-            .create = NULL,
-            .destroy = NULL,
+            .create = { .ptr = NULL },
+            .destroy = { .ptr = NULL },
             .data_version = 0,
-            .allocate = r_malloc,
-            .free = r_free,
+            .allocate = r_module_persistent_allocate,
+            .free = r_module_persistent_free,
+            .transient = r_transient_alloc,
             .p_mem = NULL,
+            .heap = r_heap_create(MODULE_HEAP_RESERVE),
+        },
+        .functions = (r_module_functions){
+            .bind = r_module_fn_bind,
+            .unbind = r_module_fn_unbind,
+            .count = 0,
+        },
+        .services = (r_module_services){
+            .publish = r_service_publish,
+            .acquire = r_service_acquire,
+        },
+        .tweaks = (r_module_tweaks){
+            .bind = r_tweak_bind,
+            .set = NULL,
+        },
+        .jobs = (r_module_jobs){
+            .create = r_job_create,
+            .depends_on = r_job_depends_on,
+            .run = r_job_run,
+            .wait = r_job_wait,
+            .parallel_for = r_job_parallel_for,
+            .in_flight = 0,
+        },
+        .fibers = (r_module_fibers){
+            .spawn = r_fiber_spawn,
+            .spawn_bound = r_fiber_spawn_bound,
+            .yield = r_fiber_yield,
+            .wait_job = r_fiber_wait_job,
+            .wait_fd = r_fiber_wait_fd,
+        },
+        .io = (r_module_io){
+            .read_file = r_io_read_file,
+            .write_file = r_io_write_file,
+            .in_flight = 0,
+        },
+        .draw = (r_module_draw){
+            .begin = r_draw_list_begin,
+            .submit = r_draw_list_submit,
+        },
+        .log = (r_module_log){
+            .write = r_log,
+            .set_level = r_log_set_level,
+        },
+        .bus = (r_module_bus){
+            .channel = r_bus_channel_get,
+            .post = r_bus_post,
+            .messages = r_bus_messages,
+        },
+        .state = (r_module_state){
+            .topic = r_state_topic_get,
+            .write = r_state_write,
+            .publish = r_state_publish,
+            .read = r_state_read,
+            .release = r_state_release,
+        },
+        .assets = (r_module_assets){
+            .load = r_asset_load,
+            .release = r_asset_release,
+            .get = r_asset_get,
         },
         .previous_data_version = 0,
+        .dependency_count = 0,
+        .needs_rebuild = false,
+        .build_pid = 0,
     };
 
     // allocate memory for the module name, library path, and library files root
@@ -44,38 +144,195 @@ void r_module_add(const char *module_name) {
     asprintf(&props.library_files_root, "./src/modules/%s", module_name);
 
     // Now create an instance of the basic module and add it to the module lifecycles
-    r_module_interface *basic_interface = r_module_lifecycle_register(
-        lifecycle,
-        props
-    );
+    r_module_interface *basic_interface = batching
+        ? r_module_lifecycle_register_deferred(lifecycle, props)
+        : r_module_lifecycle_register(lifecycle, props);
     // Add the basic module to the filetracker
     r_filetracker_add_module(filetracker, basic_interface);
 }
 
+void r_module_add_dependency(const char *module_name, const char *dependency_name) {
+    r_module_interface *interface = r_module_lifecycle_find(lifecycle, module_name);
+
+    if (interface == NULL) {
+        r_log(R_LOG_ERROR, "Unable to add dependency, unknown module: %s\n", module_name);
+        return;
+    }
+
+    r_module_lifecycle_add_dependency(lifecycle, interface, dependency_name);
+}
+
+void r_module_load_begin() {
+    batching = true;
+}
+
+void r_module_load_end(const char *timeline_path) {
+    batching = false;
+    r_module_lifecycle_load_pending(lifecycle, timeline_path);
+}
+
+bool r_module_snapshot_enable(const char *module_name, uint32_t frames, uint32_t max_pages) {
+    r_module_interface *interface = r_module_lifecycle_find(lifecycle, module_name);
+
+    if (interface == NULL || interface->properties.memory.heap == NULL) {
+        r_log(R_LOG_ERROR, "Unable to enable snapshots, unknown module: %s\n", module_name);
+        return false;
+    }
+
+    return r_heap_snapshot_enable(interface->properties.memory.heap, frames, max_pages);
+}
+
+bool r_module_rewind(const char *module_name, uint32_t frames) {
+    r_module_interface *interface = r_module_lifecycle_find(lifecycle, module_name);
+
+    if (interface == NULL || interface->properties.memory.heap == NULL) {
+        return false;
+    }
+
+    r_heap *heap = interface->properties.memory.heap;
+
+    // rewind as far as the history allows
+    uint32_t available = r_heap_snapshot_frames(heap);
+    if (frames > available) {
+        frames = available;
+    }
+
+    r_log(R_LOG_INFO, "Rewinding module %s by %u frames\n", module_name, frames);
+    return r_heap_snapshot_rewind(heap, frames);
+}
+
+uint64_t r_module_build() {
+    uint64_t hash = 14695981039346656037ull;
+    uint8_t  buffer[4096];
+
+    for (uint32_t i = 0; i < r_module_lifecycle_count(lifecycle); i++) {
+        r_module_properties *props = &r_module_lifecycle_get(lifecycle, i)->properties;
+        FILE *               file = fopen(props->library_path, "rb");
+
+        for (const char *c = props->name; *c; c++) {
+            hash = (hash ^ (uint8_t)*c) * 1099511628211ull;
+        }
+        if (file == NULL) {
+            continue;
+        }
+
+        size_t size;
+        while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            for (size_t j = 0; j < size; j++) {
+                hash = (hash ^ buffer[j]) * 1099511628211ull;
+            }
+        }
+        fclose(file);
+    }
+
+    return hash;
+}
+
+// A follower reloads what the leader has built
+static void _cluster_ready(const char *module, uint32_t version, const char *path, void *data) {
+    (void)data;
+    r_module_interface *interface = r_module_lifecycle_find(lifecycle, module);
+
+    if (interface == NULL) {
+        r_log(R_LOG_WARNING, "cluster: unknown module %s announced\n", module);
+        return;
+    }
+
+    if (strcmp(interface->properties.library_path, path) != 0) {
+        FREE(char, interface->properties.library_path);
+        asprintf(&interface->properties.library_path, "%s", path);
+    }
+
+    r_log(R_LOG_INFO, "cluster: reloading module %s version %u\n", module, version);
+    interface->properties.needs_reload = true;
+}
+
+// the pipeline's stages overlap, there its state only advances at the hand-off in post_frame
+static void _state_advance() {
+    if (!r_module_pipeline_running()) {
+        r_state_advance();
+    }
+}
+
 void r_module_pre_frame(float delta_time) {
+    delta_time = r_replay_delta(R_MODULE_PHASE_PRE_FRAME, delta_time);
+
+    _state_advance();
+    r_bus_deliver(R_MODULE_PHASE_PRE_FRAME);
+    r_fiber_resume(R_MODULE_PHASE_PRE_FRAME);
     r_module_lifecycle_pre_frame(lifecycle, delta_time);
 }
 
 void r_module_update(float delta_time) {
+    delta_time = r_replay_delta(R_MODULE_PHASE_UPDATE, delta_time);
+
+    _state_advance();
+    r_bus_deliver(R_MODULE_PHASE_UPDATE);
+    r_fiber_resume(R_MODULE_PHASE_UPDATE);
     r_module_lifecycle_update(lifecycle, delta_time);
 }
 
 void r_module_ui_update(float delta_time) {
+    delta_time = r_replay_delta(R_MODULE_PHASE_UI_UPDATE, delta_time);
+
+    _state_advance();
+    r_bus_deliver(R_MODULE_PHASE_UI_UPDATE);
+    r_fiber_resume(R_MODULE_PHASE_UI_UPDATE);
     r_module_lifecycle_ui_update(lifecycle, delta_time);
 }
 
 void r_module_post_frame(float delta_time) {
-    // Check for module changes
+    delta_time = r_replay_delta(R_MODULE_PHASE_POST_FRAME, delta_time);
+
+    // Check for module changes, followers take the builds from the leader
+    // but still patch tweaks and reload assets themselves
+    r_cluster_poll(_cluster_ready, NULL);
     r_filetracker_check(filetracker, delta_time);
 
+    // Hand over this frame's I/O and complete what has landed
+    r_io_submit();
+    r_io_dispatch();
+
+    // Swap in the assets which finished decoding while the frame ran
+    r_asset_update(ASSET_UPLOAD_BUDGET_NS);
+
     // Run the post update
+    r_state_advance();
+    r_bus_deliver(R_MODULE_PHASE_POST_FRAME);
+    r_fiber_resume(R_MODULE_PHASE_POST_FRAME);
     r_module_lifecycle_post_frame(lifecycle, delta_time);
+
+    // Expire the transient memory of the previous frame
+    r_transient_next_frame();
+
+    // keep the sample buffers from filling up
+    if (r_profile_running()) {
+        r_profile_collect();
+    }
+
+    r_telemetry_update(lifecycle);
 }
 
 void r_module_destroy() {
+    // Destroy the module lifecycle instance
+    r_module_lifecycle_destroy(lifecycle);
+
+    // the modules have released what they loaded, the rest goes while there's a GL context
+    r_asset_destroy();
+
     // Destroy the filetracker instance
     r_filetracker_destroy(filetracker);
 
-    // Destroy the module lifecycle instance
-    r_module_lifecycle_destroy(lifecycle);
+    // Stop the job system once nothing can queue jobs
+    r_job_system_destroy();
+    r_io_destroy();
+
+    r_fiber_destroy();
+
+    r_transient_destroy();
+    r_bus_destroy();
+    r_state_destroy();
+    r_draw_destroy();
+    r_profile_destroy();
+    r_telemetry_destroy();
 }
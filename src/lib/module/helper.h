@@ -1,11 +1,27 @@
 #ifndef _MODULE_HELPER_H_
 #define _MODULE_HELPER_H_
 
+#include <stdbool.h>
+#include <stdint.h>
 
 void r_module_create();
 void r_module_destroy();
 
 void r_module_add(const char *module_name);
+void r_module_add_dependency(const char *module_name, const char *dependency_name);
+
+// Modules added between r_module_load_begin and r_module_load_end are loaded
+// together, in parallel where their dependencies allow. The startup timeline is
+// written to timeline_path unless it's NULL.
+void r_module_load_begin();
+void r_module_load_end(const char *timeline_path);
+
+// Keep per-frame snapshots of a module's persistent memory, allowing it to be rewound
+bool r_module_snapshot_enable(const char *module_name, uint32_t frames, uint32_t max_pages);
+bool r_module_rewind(const char *module_name, uint32_t frames);
+
+// a hash of the module libraries loaded, a replay is checked against the one it was recorded with
+uint64_t r_module_build();
 
 void r_module_pre_frame(float delta_time);
 void r_module_update(float delta_time);
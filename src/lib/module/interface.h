@@ -1,10 +1,14 @@
 #ifndef _MODULE_INTERFACE_H_
 #define _MODULE_INTERFACE_H_
 
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <sys/types.h>
 
 #define MAX_MODULES 64
+#define MAX_MODULE_DEPENDENCIES 16
 
 // Module Interface is a structure of function pointers
 // which provide access to lifecycle functions for a library
@@ -25,19 +29,250 @@
 #define MMALLOC(type, count) (type *)props->memory.allocate(#type, sizeof(type) * count)
 #define MFREE(type, ptr) props->memory.free(#type, ptr)
 
+// Per-frame scratch memory, valid until the end of the next frame and never freed
+#define TMALLOC(type, count) (type *)props->memory.transient(sizeof(type) * (count))
+
+// Bind a function handle to a function exported by the calling module
+// e.g. MBIND(props->memory.create, _basic_int_create);
+#define MBIND(handle, symbol) props->functions.bind(props, &(handle), #symbol, (void *)(symbol))
+#define MUNBIND(handle) props->functions.unbind(props, &(handle))
+
+// Call through a bound function handle
+// e.g. MFN(r_module_destroy_fn, props->memory.destroy)(props);
+#define MFN(type, handle) ((type)(handle).ptr)
+
+#define MAX_MODULE_FUNCTIONS 128
+#define MAX_MODULE_FN_NAME   64
+
+// Log through the host, formatting happens on the log thread
+#define MLOG(level, ...) props->log.write(level, __VA_ARGS__)
+
+// Message bus channels, see r_module_bus
+#define MCHANNEL(name, type, phase) props->bus.channel(props, name, #type, sizeof(type), phase)
+#define MPOST(channel, message) props->bus.post(channel, message)
+#define MMESSAGES(type, channel, count) (const type *)props->bus.messages(channel, count)
+
+// Shared state topics, see r_module_state
+#define MTOPIC(name, type) props->state.topic(props, name, #type, sizeof(type))
+#define MWRITE(type, topic) (type *)props->state.write(topic)
+#define MREAD(type, topic, version) (const type *)props->state.read(topic, version)
+
+// Assets, see r_module_assets
+// e.g. r_asset *logo = MLOAD("resources/logo.png", R_ASSET_TEXTURE, NULL);
+//      const Texture2D *texture = MASSET(Texture2D, logo);
+#define MLOAD(path, type, options) props->assets.load(props, path, type, options)
+#define MASSET(type, asset) (const type *)props->assets.get(asset, NULL)
+
+// Call into a service through its function table, NULL while its provider isn't loaded.
+// Look the table up for every use, one kept across a reload points at the unmapped image.
+// e.g. const math_api *math = MSERVICE(math_api, props->math);
+//      if (math) math->add(1, 2);
+#define MSERVICE(type, service) (const type *)atomic_load_explicit(&(service)->table, memory_order_acquire)
+
+#define MAX_SERVICES          64
+#define MAX_SERVICE_FUNCTIONS 32
+
 typedef struct r_module_properties r_module_properties;
 
+// Lifecycle phases of a frame, in the order they run
+typedef enum r_module_phase {
+    R_MODULE_PHASE_PRE_FRAME,
+    R_MODULE_PHASE_UPDATE,
+    R_MODULE_PHASE_UI_UPDATE,
+    R_MODULE_PHASE_POST_FRAME,
+    R_MODULE_PHASE_COUNT
+} r_module_phase;
+
+// Function handle which survives a reload.
+//
+// Raw function pointers into a module point at the unmapped image once
+// the library has been reloaded. A handle keeps the symbol name alongside
+// the cached address, and the host re-resolves every bound handle against
+// the new image straight after it has been loaded. Handles are kept in
+// persistent or host memory, binding one which lives in the module's own
+// image or targets a function which isn't exported fails. They are called
+// through the cached pointer, so there is no lookup per call.
+typedef struct r_module_fn {
+    char   name[MAX_MODULE_FN_NAME];
+    void * ptr;
+} r_module_fn;
+
+typedef void * (*r_module_create_fn)(r_module_properties *props);
+typedef void   (*r_module_destroy_fn)(r_module_properties *props);
+
+typedef struct r_module_functions {
+    // bind / unbind a handle, provided by the host
+    bool (*bind)(r_module_properties *props, r_module_fn *handle, const char *symbol, void *address);
+    void (*unbind)(r_module_properties *props, r_module_fn *handle);
+
+    // handles bound by the module which are re-resolved on reload
+    r_module_fn * handles[MAX_MODULE_FUNCTIONS];
+    uint32_t      count;
+} r_module_functions;
+
+// Service published by a module for other modules to call.
+//
+// The provider publishes a named, versioned list of its exported functions,
+// the host resolves them into a function table which lives in host memory.
+// Consumers keep the r_service pointer, which is stable for the lifetime of
+// the process, and call through the table. When the provider is reloaded
+// the host resolves the new image into the spare table and re-points
+// `table` in a single store. While the provider isn't loaded, or a symbol
+// didn't resolve, the service is unavailable and `table` is NULL.
+//
+// The order of the symbols must match the layout of the struct of function
+// pointers which consumers cast the table to.
+typedef struct r_service {
+    void ** _Atomic table;
+    uint32_t        version;
+
+    // host owned
+    char     name[MAX_MODULE_FN_NAME];
+    char     provider[MAX_MODULE_FN_NAME];
+    char     symbols[MAX_SERVICE_FUNCTIONS][MAX_MODULE_FN_NAME];
+    uint32_t count;
+    void *   tables[2][MAX_SERVICE_FUNCTIONS];
+    uint32_t front;
+} r_service;
+
+typedef struct r_module_services {
+    // publish functions exported by the calling module as a service
+    r_service * (*publish)(r_module_properties *props, const char *name, uint32_t version, const char **symbols, uint32_t count);
+    // find a published service, NULL if it doesn't exist or the version differs
+    r_service * (*acquire)(r_module_properties *props, const char *name, uint32_t version);
+} r_module_services;
+
+typedef enum r_tweak_type {
+    R_TWEAK_INT,
+    R_TWEAK_FLOAT,
+} r_tweak_type;
+
+typedef struct r_module_tweaks {
+    // returns the host owned storage for the tweak at file:line, see module/tweak.h
+    void * (*bind)(r_module_properties *props, const char *file, int line, r_tweak_type type, const void *value);
+
+    // host owned tweak values and source snapshots
+    struct r_tweak_set * set;
+} r_module_tweaks;
+
+typedef struct r_job r_job;
+typedef void (*r_job_fn)(void *data);
+typedef void (*r_job_range_fn)(void *data, uint32_t begin, uint32_t end);
+
+// Host job system. Jobs run on a pool of worker threads, a job created with
+// a parent keeps the parent from finishing until it is done, and a job made
+// to depend on another only starts once the other has finished.
+// The host waits for all of a module's jobs before it is unloaded.
+typedef struct r_module_jobs {
+    r_job * (*create)(r_module_properties *props, r_job_fn fn, void *data, r_job *parent);
+    void    (*depends_on)(r_job *job, r_job *dependency);
+    void    (*run)(r_job *job);
+    void    (*wait)(r_job *job);
+
+    // split [0, count) into ranges of at most grain items and run them in parallel, returns when all are done
+    void    (*parallel_for)(r_module_properties *props, r_job_range_fn fn, void *data, uint32_t count, uint32_t grain);
+
+    // host owned, jobs run by the module which haven't finished
+    _Atomic int32_t in_flight;
+} r_module_jobs;
+
+typedef void (*r_fiber_fn)(void *data);
+
+// Host fibers. A fiber runs module logic which waits across frames as plain
+// sequential code: it is resumed by the host at its phase each frame, before
+// the modules' callbacks for that phase, and suspends itself with one of the
+// waits below. Waits may only be called from inside a fiber.
+//
+// A module isn't reloaded while a fiber spawned with a plain function pointer
+// is alive, since its stack points into the old image. Fibers spawned from a
+// bound handle migrate instead: they are restarted from the re-resolved entry
+// point with the same data, which should live in persistent memory.
+typedef struct r_module_fibers {
+    bool (*spawn)(r_module_properties *props, r_fiber_fn fn, void *data, r_module_phase phase);
+    bool (*spawn_bound)(r_module_properties *props, r_module_fn *entry, void *data, r_module_phase phase);
+
+    // suspend until the phase comes round again next frame
+    void (*yield)();
+    // suspend until the job has finished
+    void (*wait_job)(r_job *job);
+    // suspend until poll reports one of the events on the descriptor
+    void (*wait_fd)(int fd, short events);
+} r_module_fibers;
+
+typedef struct r_io_request r_io_request;
+typedef void (*r_io_callback)(void *data, int64_t result, void *buffer, size_t size);
+
+// Host asynchronous file I/O. The callback runs on the main thread at a frame
+// boundary with the number of bytes transferred or a negative errno. A read
+// hands over the file's contents, which are freed once the callback returns.
+// Requests still in flight are completed before the module is unloaded.
+typedef struct r_module_io {
+    r_io_request * (*read_file)(r_module_properties *props, const char *path, r_io_callback callback, void *data);
+    r_io_request * (*write_file)(r_module_properties *props, const char *path, const void *buffer, size_t size, r_io_callback callback, void *data);
+
+    // host owned, requests created by the module which haven't completed
+    _Atomic int32_t in_flight;
+} r_module_io;
+
+typedef enum r_log_level {
+    R_LOG_DEBUG,
+    R_LOG_INFO,
+    R_LOG_WARNING,
+    R_LOG_ERROR,
+    R_LOG_NONE
+} r_log_level;
+
+// Host logging. Messages are tagged with the module's name, the format string
+// and arguments are stored and only formatted on the log thread.
+typedef struct r_module_log {
+    void (*write)(r_log_level level, const char *format, ...);
+    void (*set_level)(r_log_level level);
+} r_module_log;
+
+typedef struct r_draw_list r_draw_list;
+
+// Deferred drawing. Any thread can record raylib draw calls into a list (see
+// draw/commands.h), submitted lists are replayed on the main thread ordered
+// by key, then owner name, then submission order. Give lists recorded in
+// parallel distinct keys to keep the order deterministic.
+typedef struct r_module_draw {
+    r_draw_list * (*begin)(r_module_properties *props, uint32_t key);
+    void          (*submit)(r_draw_list *list);
+} r_module_draw;
+
+typedef struct r_bus_channel r_bus_channel;
+
+// Host message bus. A channel carries messages of a single type, they can be
+// posted from any thread without locks and are delivered as one batch at the
+// start of the channel's delivery phase. The batch stays readable until the
+// next delivery. Messages are copied into host memory so they survive a reload
+// of the sender.
+typedef struct r_module_bus {
+    // find or create a channel, NULL if it exists with a different type
+    r_bus_channel * (*channel)(r_module_properties *props, const char *name, const char *type, uint32_t size, r_module_phase delivery);
+    // copy a message into the channel, false if the channel is full
+    bool            (*post)(r_bus_channel *channel, const void *message);
+    // the messages delivered in the last batch
+    const void *    (*messages)(r_bus_channel *channel, uint32_t *count);
+} r_module_bus;
+
 typedef struct r_module_memory {
     // persistent memory
     void * p_mem; 
-    // void * transient_memory;
+    // host owned heap which persistent memory is allocated from
+    struct r_heap * heap;
+
+    // per-frame scratch memory, see TMALLOC
+    void * (*transient)(size_t size);
 
     // memory management functions
     void * (*allocate)(const char *type, size_t size);
     void   (*free)(const char *type, void *memory);
 
-    void * (*create)(r_module_properties *props);
-    void (*destroy)(r_module_properties *props);
+    // handles to the create / destroy functions for the persistent memory
+    // these are re-resolved on reload so they are always safe to call
+    r_module_fn create;
+    r_module_fn destroy;
 
     // Data version number, used to determine if the data
     // in the persistent memory is compatible with the current
@@ -46,10 +281,74 @@ typedef struct r_module_memory {
     int data_version;
 } r_module_memory;
 
+typedef struct r_state_topic r_state_topic;
+
+// Shared state. A topic holds the latest published snapshot of one type, e.g.
+// the camera of one module which the others read. A writer fills a private
+// copy and publishes it, it becomes the current snapshot at the next phase
+// boundary. Readers on any thread get the current snapshot without locks and
+// keep it alive until they release it, snapshots are never written once
+// published. Holding one across frames keeps old snapshots from being freed.
+typedef struct r_module_state {
+    // find or create a topic, NULL if it exists with a different type
+    r_state_topic * (*topic)(r_module_properties *props, const char *name, const char *type, uint32_t size);
+    // a snapshot to fill, starting as a copy of the current one
+    void *          (*write)(r_state_topic *topic);
+    // replace the current snapshot at the next phase boundary, a snapshot not yet current is dropped
+    void            (*publish)(r_state_topic *topic, void *snapshot);
+    // the current snapshot, NULL if none has been published
+    const void *    (*read)(r_state_topic *topic, uint64_t *version);
+    void            (*release)(const void *snapshot);
+} r_module_state;
+
+typedef struct r_asset r_asset;
+
+typedef enum r_asset_type {
+    R_ASSET_TEXTURE,    // Texture2D
+    R_ASSET_MODEL,      // Model
+    R_ASSET_FONT,       // Font
+    R_ASSET_SHADER,     // Shader
+    R_ASSET_SOUND,      // Sound
+    R_ASSET_TYPE_COUNT
+} r_asset_type;
+
+// How an asset is loaded, assets with the same path and options are shared
+typedef struct r_asset_options {
+    int          font_size;     // fonts: size the glyphs are rasterised at, 0 for raylib's default
+    const char * vertex_path;   // shaders: the path is the fragment shader, NULL for raylib's default vertex shader
+} r_asset_options;
+
+// Host assets. A handle stands for a raylib resource loaded from files which
+// are watched: when they change, the new version is decoded on a worker and
+// uploaded on the main thread within a per-frame budget, then the handle
+// switches over without the module reloading. Handles live in host memory and
+// survive reloads, get() returns NULL until the first version has been uploaded.
+// Textures, models and sounds which go unused may be evicted to stay within a
+// memory budget, get() returns NULL for those too and they're back a frame or
+// so later, so the result is best looked up every frame rather than kept.
+typedef struct r_module_assets {
+    // find or start loading the asset, options may be NULL
+    r_asset *    (*load)(r_module_properties *props, const char *path, r_asset_type type, const r_asset_options *options);
+    void         (*release)(r_asset *asset);
+    // the resource of the current version, valid until the end of the frame, version counts the uploads
+    const void * (*get)(r_asset *asset, uint32_t *version);
+} r_module_assets;
+
 typedef struct r_module_properties {
     // module properties
     char * name;
     r_module_memory memory;
+    r_module_functions functions;
+    r_module_services services;
+    r_module_tweaks tweaks;
+    r_module_jobs jobs;
+    r_module_fibers fibers;
+    r_module_io io;
+    r_module_bus bus;
+    r_module_state state;
+    r_module_assets assets;
+    r_module_log log;
+    r_module_draw draw;
 
     char *   library_path;
     char *   library_files_root;
@@ -58,6 +357,17 @@ typedef struct r_module_properties {
     bool     needs_reload;
     bool     files_changed;
     int      previous_data_version;
+    // a failed load keeps the persistent memory for the next image's on_reload
+    bool     awaiting_reload;
+
+    // names of the modules which must be rebuilt and reloaded before this one
+    char *   dependencies[MAX_MODULE_DEPENDENCIES];
+    uint32_t dependency_count;
+
+    // background build state, a failed build holds back its dependents
+    bool     needs_rebuild;
+    bool     build_failed;
+    pid_t    build_pid;
 } r_module_properties;
 
 typedef struct r_module_callbacks {
@@ -73,12 +383,20 @@ typedef struct r_module_callbacks {
     bool (*on_reload)(r_module_properties *props);
 } r_module_callbacks;
 
+// Measured by the lifecycle for telemetry
+typedef struct r_module_stats {
+    uint64_t callback_ns[R_MODULE_PHASE_COUNT];   // last frame
+    uint32_t reloads;
+} r_module_stats;
+
 typedef struct r_module_interface {
     // lifecycle properties
     r_module_properties properties;
 
     // entry points
     r_module_callbacks cb;
+
+    r_module_stats stats;
 } r_module_interface;
 
 r_module_interface * r_module_interface_create();
@@ -1,27 +1,64 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE   // asprintf
+#endif
+
 #include <dlfcn.h>
+#include <limits.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
-
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "cluster/cluster.h"
+#include "fiber/fiber.h"
+#include "io/io.h"
+#include "job/job.h"
+#include "log/log.h"
 #include "memory/allocator.h"
+#include "memory/heap.h"
+#include "memory/tagged.h"
+#include "module/context.h"
+#include "module/function.h"
 #include "module/module.h"
+#include "module/service.h"
+#include "module/tweak.h"
+#include "profile/profile.h"
+#include "time/time.h"
 
+// interfaces are allocated one at a time so their properties stay at the same
+// address, jobs, I/O and fibers hold on to them while other modules come and go
 typedef struct {
-    r_module_interface interfaces[MAX_MODULES];
+    r_module_interface *interfaces[MAX_MODULES];
     uint32_t           count;
 } r_module_interface_array;
 
 typedef struct r_module_lifecycle {
     r_module_interface_array modules;
+
+    // module indices in topological order, dependencies before dependents
+    uint32_t order[MAX_MODULES];
+
+    // a pending reload is held back by fibers suspended in module code
+    bool     reload_blocked;
     // void    *persistent_memory;
     // uint32_t persistent_memory_size;
 } r_module_lifecycle;
 
 void _module_destroy(r_module_interface *interface);
-void _module_reload(r_module_interface *interface);
-void _module_rebuild(r_module_interface *interface);
+bool _module_unload(r_module_interface *interface);
+bool _module_load(r_module_interface *interface, bool call_reload);
+static bool _module_open(r_module_interface *interface);
+static void _module_attach(r_module_interface *interface);
+static void _module_start(r_module_interface *interface, bool call_reload);
+pid_t _module_rebuild(r_module_interface *interface);
+
+static bool _module_sort(r_module_lifecycle *lifecycle);
+static void _module_schedule_builds(r_module_lifecycle *lifecycle);
+static void _module_reload_transaction(r_module_lifecycle *lifecycle);
 
 // Create a new lifecyle instance
 r_module_lifecycle * r_module_lifecycle_create() {
@@ -29,23 +66,25 @@ r_module_lifecycle * r_module_lifecycle_create() {
     // Allocate memory for the lifecycle
     r_module_lifecycle *lifecycle = MALLOC(r_module_lifecycle, 1);
     lifecycle->modules.count = 0;
+    lifecycle->reload_blocked = false;
     return lifecycle;
 
 }
 void r_module_lifecycle_destroy(r_module_lifecycle *lifecycle) {
 
-    // clean up any instances
-    for (uint32_t i = 0; i < lifecycle->modules.count; i++) {
-        r_module_interface *interface = &lifecycle->modules.interfaces[i];
-        
+    // clean up any instances, dependents first
+    for (uint32_t i = lifecycle->modules.count; i > 0; i--) {
+        r_module_interface *interface = lifecycle->modules.interfaces[lifecycle->order[i - 1]];
+
         _module_destroy(interface);
+        FREE(r_module_interface, interface);
     }
 
     // Free the lifecycle
     FREE(r_module_lifecycle, lifecycle);
 }
 
-r_module_interface * r_module_lifecycle_register(r_module_lifecycle *lifecycle, r_module_properties properties) {
+static r_module_interface * _module_register(r_module_lifecycle *lifecycle, r_module_properties properties) {
 
         // Check if we've hit MAX_MODULES
         if (lifecycle->modules.count == MAX_MODULES) {
@@ -55,154 +94,555 @@ r_module_interface * r_module_lifecycle_register(r_module_lifecycle *lifecycle,
         // Check if the interface is already registered
         for (uint32_t i = 0; i < lifecycle->modules.count; i++) {
             // if the module name already exists
-            if (strcmp(lifecycle->modules.interfaces[i].properties.name, properties.name) == 0) {
+            if (strcmp(lifecycle->modules.interfaces[i]->properties.name, properties.name) == 0) {
                 return NULL;
             }
         }
 
-        r_module_interface *interface = &lifecycle->modules.interfaces[lifecycle->modules.count++];
+        r_module_interface *interface = MALLOC(r_module_interface, 1);
+        lifecycle->modules.interfaces[lifecycle->modules.count++] = interface;
         interface->properties = properties;
-        
-        // Load the module
-        _module_reload(interface);
+        interface->cb = (r_module_callbacks){ .init = NULL };
+        interface->stats = (r_module_stats){ .reloads = 0 };
+
+        _module_sort(lifecycle);
 
         return interface;
 }
+
+r_module_interface * r_module_lifecycle_register(r_module_lifecycle *lifecycle, r_module_properties properties) {
+    r_module_interface *interface = _module_register(lifecycle, properties);
+
+    // Load the module
+    if (interface) {
+        _module_load(interface, false);
+    }
+
+    return interface;
+}
+
+r_module_interface * r_module_lifecycle_register_deferred(r_module_lifecycle *lifecycle, r_module_properties properties) {
+    return _module_register(lifecycle, properties);
+}
+
 void r_module_lifecycle_unregister(r_module_lifecycle *lifecycle, r_module_interface *interface) {
 
     // Remove the interface from the lifecycle
     for (uint32_t i = 0; i < lifecycle->modules.count; i++) {
-        if (&lifecycle->modules.interfaces[i] == interface) {
+        if (lifecycle->modules.interfaces[i] == interface) {
 
             // Clean up the interface and unload the library
             _module_destroy(interface);
+            FREE(r_module_interface, interface);
 
             // shuffle the modules down and decrement the count
             for (uint32_t j = i; j < lifecycle->modules.count - 1; j++) {
                 lifecycle->modules.interfaces[j] = lifecycle->modules.interfaces[j + 1];
             }
             lifecycle->modules.count--;
+
+            _module_sort(lifecycle);
             break;
         }
     }
 }
 
+uint32_t r_module_lifecycle_count(r_module_lifecycle *lifecycle) {
+    return lifecycle->modules.count;
+}
+
+r_module_interface * r_module_lifecycle_get(r_module_lifecycle *lifecycle, uint32_t index) {
+    return index < lifecycle->modules.count ? lifecycle->modules.interfaces[index] : NULL;
+}
+
+r_module_interface * r_module_lifecycle_find(r_module_lifecycle *lifecycle, const char *name) {
+    for (uint32_t i = 0; i < lifecycle->modules.count; i++) {
+        if (strcmp(lifecycle->modules.interfaces[i]->properties.name, name) == 0) {
+            return lifecycle->modules.interfaces[i];
+        }
+    }
+    return NULL;
+}
+
+bool r_module_lifecycle_add_dependency(r_module_lifecycle *lifecycle, r_module_interface *interface, const char *dependency) {
+    r_module_properties *props = &interface->properties;
+
+    if (props->dependency_count == MAX_MODULE_DEPENDENCIES) {
+        r_log(R_LOG_ERROR, "module %s: too many dependencies\n", props->name);
+        return false;
+    }
+
+    for (uint32_t i = 0; i < props->dependency_count; i++) {
+        if (strcmp(props->dependencies[i], dependency) == 0) {
+            return true;
+        }
+    }
+
+    asprintf(&props->dependencies[props->dependency_count++], "%s", dependency);
+
+    // a dependency which introduces a cycle is rejected
+    if (!_module_sort(lifecycle)) {
+        r_log(R_LOG_ERROR, "module %s: dependency on %s creates a cycle\n", props->name, dependency);
+
+        props->dependency_count--;
+        FREE(char, props->dependencies[props->dependency_count]);
+        _module_sort(lifecycle);
+        return false;
+    }
+
+    return true;
+}
+
 void r_module_lifecycle_pre_frame(r_module_lifecycle *lifecycle, float delta_time) {
 
     // Update all the interfaces
     for (uint32_t i = 0; i < lifecycle->modules.count; i++) {
-        r_module_interface *interface = &lifecycle->modules.interfaces[i];
+        r_module_interface *interface = lifecycle->modules.interfaces[lifecycle->order[i]];
 
         // Now update the module
         if (interface->cb.pre_frame) {
+            uint64_t start = r_time_now_ns();
+            r_module_context_set(&interface->properties);
             interface->cb.pre_frame(&interface->properties, delta_time);
+            interface->stats.callback_ns[R_MODULE_PHASE_PRE_FRAME] = r_time_now_ns() - start;
         }
     }
+    r_module_context_set(NULL);
 }
 
 void r_module_lifecycle_update(r_module_lifecycle *lifecycle, float delta_time) {
 
     // Update all the interfaces
     for (uint32_t i = 0; i < lifecycle->modules.count; i++) {
-        r_module_interface *interface = &lifecycle->modules.interfaces[i];
+        r_module_interface *interface = lifecycle->modules.interfaces[lifecycle->order[i]];
 
         // Now update the module
         if (interface->cb.update) {
+            uint64_t start = r_time_now_ns();
+            r_module_context_set(&interface->properties);
             interface->cb.update(&interface->properties, delta_time);
+            interface->stats.callback_ns[R_MODULE_PHASE_UPDATE] = r_time_now_ns() - start;
         }
     }
+    r_module_context_set(NULL);
 }
 
 void r_module_lifecycle_ui_update(r_module_lifecycle *lifecycle, float delta_time) {
 
     // Update all the interfaces
     for (uint32_t i = 0; i < lifecycle->modules.count; i++) {
-        r_module_interface *interface = &lifecycle->modules.interfaces[i];
+        r_module_interface *interface = lifecycle->modules.interfaces[lifecycle->order[i]];
 
         // Run the UI update for the module
         if (interface->cb.ui_update) {
+            uint64_t start = r_time_now_ns();
+            r_module_context_set(&interface->properties);
             interface->cb.ui_update(&interface->properties, delta_time);
+            interface->stats.callback_ns[R_MODULE_PHASE_UI_UPDATE] = r_time_now_ns() - start;
         }
     }
+    r_module_context_set(NULL);
 }
 
 void r_module_lifecycle_post_frame(r_module_lifecycle *lifecycle, float delta_time) {
 
+    // Start builds for changed modules and their dependents
+    _module_schedule_builds(lifecycle);
+
+    // Reload everything which has been rebuilt at this frame boundary
+    _module_reload_transaction(lifecycle);
+
     // Update all the interfaces
     for (uint32_t i = 0; i < lifecycle->modules.count; i++) {
-        r_module_interface *interface = &lifecycle->modules.interfaces[i];
+        r_module_interface *interface = lifecycle->modules.interfaces[lifecycle->order[i]];
 
-        // Check if the files have been modified
-        if (interface->properties.files_changed) {
-            _module_rebuild(interface);
+        // Now update the module
+        if (interface->cb.post_frame) {
+            uint64_t start = r_time_now_ns();
+            r_module_context_set(&interface->properties);
+            interface->cb.post_frame(&interface->properties, delta_time);
+            interface->stats.callback_ns[R_MODULE_PHASE_POST_FRAME] = r_time_now_ns() - start;
         }
+    }
+    r_module_context_set(NULL);
 
-        // Check if the interface needs to be reloaded
-        if (interface->properties.needs_reload) {
-            _module_reload(interface);
+    // Close the frame for any module state snapshots
+    for (uint32_t i = 0; i < lifecycle->modules.count; i++) {
+        r_module_properties *props = &lifecycle->modules.interfaces[i]->properties;
+        if (props->memory.heap && !r_heap_snapshot_commit(props->memory.heap)) {
+            r_log(R_LOG_WARNING, "Module %s wrote more pages than its snapshots keep, its history was dropped\n", props->name);
         }
+    }
+}
 
-        // Now update the module
-        if (interface->cb.post_frame) {
-            interface->cb.post_frame(&interface->properties, delta_time);
+static bool _module_depends_on(r_module_lifecycle *lifecycle, uint32_t module, uint32_t dependency) {
+    r_module_properties *props = &lifecycle->modules.interfaces[module]->properties;
+    const char *name = lifecycle->modules.interfaces[dependency]->properties.name;
+
+    for (uint32_t i = 0; i < props->dependency_count; i++) {
+        if (strcmp(props->dependencies[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Sort the modules topologically, keeping registration order between independent modules.
+// Returns false if the dependencies contain a cycle, in which case the order is left as is.
+static bool _module_sort(r_module_lifecycle *lifecycle) {
+    uint32_t count = lifecycle->modules.count;
+    uint32_t order[MAX_MODULES];
+    bool     placed[MAX_MODULES] = { false };
+
+    for (uint32_t n = 0; n < count; n++) {
+        bool found = false;
+
+        // take the first module which has all of its registered dependencies placed
+        for (uint32_t i = 0; i < count && !found; i++) {
+            if (placed[i]) {
+                continue;
+            }
+
+            bool ready = true;
+            for (uint32_t j = 0; j < count && ready; j++) {
+                if (!placed[j] && j != i && _module_depends_on(lifecycle, i, j)) {
+                    ready = false;
+                }
+            }
+
+            if (ready) {
+                order[n] = i;
+                placed[i] = true;
+                found = true;
+            }
+        }
+
+        if (!found) {
+            return false;
+        }
+    }
+
+    memcpy(lifecycle->order, order, sizeof(uint32_t) * count);
+    return true;
+}
+
+// Propagate a flag from every module to its dependents, walking the topological order
+static void _module_mark_dependents(r_module_lifecycle *lifecycle, bool *marked) {
+    for (uint32_t i = 0; i < lifecycle->modules.count; i++) {
+        uint32_t module = lifecycle->order[i];
+
+        for (uint32_t j = 0; j < i && !marked[module]; j++) {
+            uint32_t dependency = lifecycle->order[j];
+            if (marked[dependency] && _module_depends_on(lifecycle, module, dependency)) {
+                marked[module] = true;
+            }
         }
     }
 }
 
+static void _module_schedule_builds(r_module_lifecycle *lifecycle) {
+    uint32_t count = lifecycle->modules.count;
+    bool     changed[MAX_MODULES] = { false };
+
+    // A change in a module requires its dependents to be rebuilt as well,
+    // a follower leaves the build to the leader and reloads what it announces
+    bool following = r_cluster_get_role() == R_CLUSTER_FOLLOWER;
+    for (uint32_t i = 0; i < count; i++) {
+        r_module_properties *props = &lifecycle->modules.interfaces[i]->properties;
+        changed[i] = props->files_changed && !following;
+        props->files_changed = false;
+    }
+    _module_mark_dependents(lifecycle, changed);
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (changed[i]) {
+            lifecycle->modules.interfaces[i]->properties.needs_rebuild = true;
+        }
+    }
+
+    // Collect any finished builds
+    for (uint32_t i = 0; i < count; i++) {
+        r_module_properties *props = &lifecycle->modules.interfaces[i]->properties;
+
+        if (props->build_pid <= 0) {
+            continue;
+        }
+
+        int status = 0;
+        if (waitpid(props->build_pid, &status, WNOHANG) != props->build_pid) {
+            continue;
+        }
+        props->build_pid = 0;
+
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+            r_log(R_LOG_INFO, "Finished background build of module: %s\n", props->name);
+            props->needs_reload = true;
+        } else {
+            r_log(R_LOG_ERROR, "Background build of module %s failed\n", props->name);
+            props->build_failed = true;
+        }
+    }
+
+    // Start every build which isn't waiting on one of its dependencies,
+    // independent branches of the graph build in parallel
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t module = lifecycle->order[i];
+        r_module_interface *interface = lifecycle->modules.interfaces[module];
+
+        if (!interface->properties.needs_rebuild || interface->properties.build_pid > 0) {
+            continue;
+        }
+
+        bool                 blocked = false;
+        r_module_properties *failed = NULL;
+        for (uint32_t j = 0; j < i && !blocked; j++) {
+            uint32_t dependency = lifecycle->order[j];
+            r_module_properties *dep = &lifecycle->modules.interfaces[dependency]->properties;
+
+            if (!_module_depends_on(lifecycle, module, dependency)) {
+                continue;
+            }
+            if (dep->needs_rebuild || dep->build_pid > 0) {
+                blocked = true;
+            } else if (dep->build_failed) {
+                failed = dep;
+            }
+        }
+
+        if (blocked) {
+            continue;
+        }
+
+        // building against the dependency's old library would only be reloaded
+        // against it, the module waits for the dependency's next change instead
+        if (failed != NULL) {
+            r_log(R_LOG_WARNING, "Skipping build of module %s, its dependency %s failed to build\n", interface->properties.name, failed->name);
+            interface->properties.needs_rebuild = false;
+            interface->properties.build_failed = true;
+            continue;
+        }
+
+        interface->properties.build_pid = _module_rebuild(interface);
+        interface->properties.needs_rebuild = false;
+        interface->properties.build_failed = false;
+    }
+}
+
+// Reload every module which needs it, along with its dependents, as one transaction.
+// Modules are unloaded in reverse topological order and loaded in forward order.
+static void _module_reload_transaction(r_module_lifecycle *lifecycle) {
+    uint32_t count = lifecycle->modules.count;
+    bool     reload[MAX_MODULES] = { false };
+    bool     call_reload[MAX_MODULES] = { false };
+    bool     built[MAX_MODULES] = { false };
+    bool     loaded[MAX_MODULES] = { false };
+    bool     any = false;
+
+    for (uint32_t i = 0; i < count; i++) {
+        r_module_properties *props = &lifecycle->modules.interfaces[i]->properties;
+
+        // wait until every pending build has finished
+        if (props->needs_rebuild || props->build_pid > 0) {
+            return;
+        }
+
+        reload[i] = props->needs_reload;
+        built[i] = props->needs_reload;
+        any = any || reload[i];
+    }
+
+    if (!any) {
+        return;
+    }
+
+    _module_mark_dependents(lifecycle, reload);
+
+    // what failed to build, or was skipped for it, keeps running its old library
+    for (uint32_t i = 0; i < count; i++) {
+        if (lifecycle->modules.interfaces[i]->properties.build_failed) {
+            reload[i] = false;
+        }
+    }
+
+    // fibers suspended in a module's code hold back the whole set until they finish
+    for (uint32_t i = 0; i < count; i++) {
+        r_module_properties *props = &lifecycle->modules.interfaces[i]->properties;
+        uint32_t pinned = reload[i] ? r_fiber_pinned(props) : 0;
+
+        if (pinned > 0) {
+            if (!lifecycle->reload_blocked) {
+                r_log(R_LOG_WARNING, "Reload held back, module %s has %u fibers in its code\n", props->name, pinned);
+            }
+            lifecycle->reload_blocked = true;
+            return;
+        }
+    }
+    lifecycle->reload_blocked = false;
+
+    for (uint32_t i = count; i > 0; i--) {
+        uint32_t module = lifecycle->order[i - 1];
+        if (reload[module]) {
+            call_reload[module] = _module_unload(lifecycle->modules.interfaces[module]);
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t module = lifecycle->order[i];
+        if (reload[module]) {
+            // a library which failed to load isn't counted or announced
+            loaded[module] = _module_load(lifecycle->modules.interfaces[module], call_reload[module]);
+            if (loaded[module]) {
+                lifecycle->modules.interfaces[module]->stats.reloads++;
+            }
+        }
+    }
+
+    // followers work out the dependents themselves, they only need what was built
+    if (r_cluster_get_role() == R_CLUSTER_LEADER) {
+        for (uint32_t i = 0; i < count; i++) {
+            r_module_interface *interface = lifecycle->modules.interfaces[lifecycle->order[i]];
+            char                path[PATH_MAX];
+
+            // followers may have been started from elsewhere
+            if (built[lifecycle->order[i]] && loaded[lifecycle->order[i]]) {
+                const char *library = realpath(interface->properties.library_path, path) ? path : interface->properties.library_path;
+                r_cluster_publish(interface->properties.name, interface->stats.reloads, library);
+            }
+        }
+        r_cluster_commit();
+    }
+}
+
 void _module_destroy(r_module_interface *interface) {
+    // no job or I/O callback may run code from the library once it is unloaded
+    r_job_drain(&interface->properties);
+    r_io_drain(&interface->properties);
+
     if (interface->cb.destroy) {
+        r_module_context_set(&interface->properties);
         interface->cb.destroy(&interface->properties);
+        r_module_context_set(NULL);
     }
 
+    // consumers can no longer call into this module
+    r_service_revoke(&interface->properties);
+    r_fiber_cancel(&interface->properties);
+
+    // pending log records may point at format strings in the library
+    r_log_flush();
+    r_profile_image_unload(interface->properties.library_handle);
+
     // unload the library
     dlclose(interface->properties.library_handle);
     interface->properties.library_handle = NULL;
 
+    // assets the module never unloaded
+    r_tagged_report(&interface->properties);
+
+    r_module_fn_reset(&interface->properties);
+    r_tweak_destroy(&interface->properties);
+
+    if (interface->properties.memory.heap) {
+        r_heap_destroy(interface->properties.memory.heap);
+        interface->properties.memory.heap = NULL;
+    }
+
+    for (uint32_t i = 0; i < interface->properties.dependency_count; i++) {
+        FREE(char, interface->properties.dependencies[i]);
+    }
+    interface->properties.dependency_count = 0;
+
     FREE(char, interface->properties.name);
     FREE(char, interface->properties.library_path);
     FREE(char, interface->properties.library_files_root);
-    
+
 }
 
-void _module_reload(r_module_interface *interface) {
+// Unload the module's library, returns true if the module should be
+// handed its persistent memory with on_reload rather than re-initialised
+bool _module_unload(r_module_interface *interface) {
+
+    // if the library hasn't been loaded, memory kept from before a failed load still wants on_reload
+    if (interface->properties.library_handle == NULL) {
+        return interface->properties.awaiting_reload;
+    }
 
-    bool call_reload = false;
+    bool call_reload = true;
 
-    // if the library has been loaded before
-    if (interface->properties.library_handle != NULL) {
-        call_reload = true;
+    // no job or I/O callback may run code from the library once it is unloaded
+    r_job_drain(&interface->properties);
+    r_io_drain(&interface->properties);
 
-        // fire the unload first to allow the module to get itself ready
-        if (interface->cb.on_unload) {
-            interface->cb.on_unload(&interface->properties);
+    r_module_context_set(&interface->properties);
 
-            // check if the data version has changed
-            if (interface->properties.memory.data_version != interface->properties.previous_data_version) {
-                interface->properties.previous_data_version = interface->properties.memory.data_version;
+    // fire the unload first to allow the module to get itself ready
+    if (interface->cb.on_unload) {
+        interface->cb.on_unload(&interface->properties);
 
-                // disabling reload will force the module to be re-initalised
-                call_reload = false;
+        // check if the data version has changed
+        if (interface->properties.memory.data_version != interface->properties.previous_data_version) {
+            interface->properties.previous_data_version = interface->properties.memory.data_version;
 
-                // call the destructor for the previous data version
-                if (interface->properties.memory.destroy) {
-                    interface->properties.memory.destroy(&interface->properties);
-                }
+            // disabling reload will force the module to be re-initalised
+            call_reload = false;
+
+            // call the destructor for the previous data version
+            // the handle was resolved against the library that is still loaded
+            if (interface->properties.memory.destroy.ptr) {
+                MFN(r_module_destroy_fn, interface->properties.memory.destroy)(&interface->properties);
             }
+            interface->properties.memory.p_mem = NULL;
+
+            // any handles bound inside the persistent memory are gone with it
+            r_module_fn_reset(&interface->properties);
         }
+    }
+
+    r_module_context_set(NULL);
+
+    // bound fibers start over in the new image, unless their data went with the old version
+    if (call_reload) {
+        r_fiber_migrate(&interface->properties);
+    } else {
+        r_fiber_cancel(&interface->properties);
+    }
 
-        // unload the library
-        dlclose(interface->properties.library_handle);
-        interface->properties.library_handle = NULL;
+    // snapshots can't be restored across a reload
+    if (interface->properties.memory.heap) {
+        r_heap_snapshot_reset(interface->properties.memory.heap);
     }
 
+    // consumers see the services as unavailable until the next image resolves them
+    r_service_withdraw(&interface->properties);
+
+    // pending log records may point at format strings in the library
+    r_log_flush();
+    r_profile_image_unload(interface->properties.library_handle);
+
+    // unload the library
+    dlclose(interface->properties.library_handle);
+    interface->properties.library_handle = NULL;
+
+    return call_reload;
+}
+
+// open the library and look up its entry points, safe to run on any thread
+static bool _module_open(r_module_interface *interface) {
+
     // load the library
     interface->properties.library_handle = dlopen(interface->properties.library_path, RTLD_NOW | RTLD_LOCAL);
 
     if (!interface->properties.library_handle) {
         // display an error and return
-        fprintf(stderr, "%s\n", dlerror());
-        return;
-    }   
+        r_log(R_LOG_ERROR, "%s\n", dlerror());
+        return false;
+    }
+
+    // the filetracker compares against the library that is now loaded
+    struct stat statbuf;
+    if (stat(interface->properties.library_path, &statbuf) == 0) {
+        interface->properties.last_modified = statbuf.st_mtime;
+    }
 
     // Obtain the module's entry points
     interface->cb = (r_module_callbacks){
@@ -213,11 +653,37 @@ void _module_reload(r_module_interface *interface) {
         .update     = dlsym(interface->properties.library_handle, "update"),
         .ui_update  = dlsym(interface->properties.library_handle, "ui_update"),
         .post_frame = dlsym(interface->properties.library_handle, "post_frame"),
-        
+
         .on_unload  = dlsym(interface->properties.library_handle, "on_unload"),
         .on_reload  = dlsym(interface->properties.library_handle, "on_reload")
     };
 
+    return true;
+}
+
+// hook the opened image up to the host, one module at a time
+static void _module_attach(r_module_interface *interface) {
+    static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+    pthread_mutex_lock(&lock);
+
+    // samples in this image are attributed to the module's new version
+    void *entry = interface->cb.init ? (void *)interface->cb.init : (void *)interface->cb.update;
+    r_profile_image_load(interface->properties.name, interface->properties.library_handle, entry, interface->properties.library_path);
+
+    // point the function handles and services at the new image before the module runs
+    r_module_fn_resolve(&interface->properties);
+    r_service_resolve(&interface->properties);
+
+    // the new image binds its tweaks again with its compiled values
+    r_tweak_track(&interface->properties);
+
+    pthread_mutex_unlock(&lock);
+}
+
+static void _module_start(r_module_interface *interface, bool call_reload) {
+    r_module_context_set(&interface->properties);
+
     // if this is the first time that we're calling this module
     if (!call_reload) {
         if (interface->cb.init) {
@@ -229,20 +695,211 @@ void _module_reload(r_module_interface *interface) {
         }
     }
 
+    r_module_context_set(NULL);
+
     interface->properties.needs_reload = false;
 }
 
-void _module_rebuild(r_module_interface *interface) {
+// returns false if the library couldn't be opened
+bool _module_load(r_module_interface *interface, bool call_reload) {
+    interface->properties.awaiting_reload = call_reload;
+
+    if (!_module_open(interface)) {
+        return false;
+    }
+
+    _module_attach(interface);
+    _module_start(interface, call_reload);
+    interface->properties.awaiting_reload = false;
+
+    return true;
+}
+
+// Batched loading
+// ---------------
+
+typedef struct r_module_load {
+    r_module_interface *interface;
+    bool                opened;
+    bool                main_thread;
+
+    r_job *             open;
+    // finishes once the module has initialised
+    r_job *             ready;
+
+    uint64_t            open_begin, open_end;
+    uint64_t            init_begin, init_end;
+    int32_t             open_worker, init_worker;
+} r_module_load;
+
+static void _module_load_open(void *data) {
+    r_module_load *load = data;
+
+    load->open_worker = r_job_worker_index();
+    load->open_begin = r_time_now_ns();
+
+    load->opened = _module_open(load->interface);
+    if (load->opened) {
+        _module_attach(load->interface);
+
+        // modules which touch the window or the GL context during init say so
+        load->main_thread = dlsym(load->interface->properties.library_handle, "init_main_thread") != NULL;
+    }
+
+    load->open_end = r_time_now_ns();
+}
+
+static void _module_load_init(void *data) {
+    r_module_load *load = data;
+
+    load->init_worker = r_job_worker_index();
+    load->init_begin = r_time_now_ns();
+
+    if (load->opened) {
+        _module_start(load->interface, false);
+    }
+
+    load->init_end = r_time_now_ns();
+}
+
+// the loaded modules and whatever the jobs did in between, in the chrome trace event format
+static void _module_write_timeline(const char *path, r_module_load *loads, uint32_t count, uint64_t start, uint64_t end) {
+    FILE *file = fopen(path, "w");
+
+    if (file == NULL) {
+        r_log(R_LOG_ERROR, "Unable to write the startup timeline: %s\n", path);
+        return;
+    }
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"startup\",\"ph\":\"X\",\"pid\":1,\"tid\":-1,\"ts\":0,\"dur\":%.3f}", (end - start) / 1000.0);
+
+    for (uint32_t i = 0; i < count; i++) {
+        r_module_load *load = &loads[i];
+        const char *   name = load->interface->properties.name;
+
+        fprintf(file, ",\n{\"name\":\"open %s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+            name, load->open_worker, (load->open_begin - start) / 1000.0, (load->open_end - load->open_begin) / 1000.0);
+        fprintf(file, ",\n{\"name\":\"init %s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+            name, load->init_worker, (load->init_begin - start) / 1000.0, (load->init_end - load->init_begin) / 1000.0);
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+}
+
+void r_module_lifecycle_load_pending(r_module_lifecycle *lifecycle, const char *timeline_path) {
+    r_module_load loads[MAX_MODULES];
+    uint32_t      count = 0;
+    // indexed by module, NULL for the modules which are loaded already
+    r_module_load *pending[MAX_MODULES] = { NULL };
+
+    uint64_t start = r_time_now_ns();
+
+    // open every library at once, in dependency order so the earliest inits can start first
+    for (uint32_t i = 0; i < lifecycle->modules.count; i++) {
+        uint32_t            module = lifecycle->order[i];
+        r_module_interface *interface = lifecycle->modules.interfaces[module];
+
+        if (interface->properties.library_handle != NULL) {
+            continue;
+        }
+
+        r_module_load *load = &loads[count++];
+        *load = (r_module_load){ .interface = interface, .open_worker = -1, .init_worker = -1 };
+        pending[module] = load;
+
+        load->open = r_job_create(NULL, _module_load_open, load, NULL);
+        if (load->open == NULL) {
+            _module_load_open(load);
+        }
+        r_job_run(load->open);
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    // chain the inits behind the libraries and the modules they depend on
+    for (uint32_t i = 0; i < lifecycle->modules.count; i++) {
+        uint32_t       module = lifecycle->order[i];
+        r_module_load *load = pending[module];
+
+        if (load == NULL) {
+            continue;
+        }
+
+        // whether init has to run on the main thread is only known once the library is open
+        r_job_wait(load->open);
+
+        load->ready = r_job_create(NULL, load->main_thread ? NULL : _module_load_init, load, NULL);
+        r_job_depends_on(load->ready, load->open);
+
+        for (uint32_t j = 0; j < i; j++) {
+            uint32_t dependency = lifecycle->order[j];
+            if (pending[dependency] && _module_depends_on(lifecycle, module, dependency)) {
+                r_job_depends_on(load->ready, pending[dependency]->ready);
+            }
+        }
+
+        if (!load->main_thread && load->ready) {
+            r_job_run(load->ready);
+            continue;
+        }
+
+        // init runs here, on the main thread or when there was no job to spare.
+        // everything it depends on comes earlier in the order, so waiting here can't deadlock
+        for (uint32_t j = 0; j < i; j++) {
+            uint32_t dependency = lifecycle->order[j];
+            if (pending[dependency] && _module_depends_on(lifecycle, module, dependency)) {
+                r_job_wait(pending[dependency]->ready);
+            }
+        }
+
+        _module_load_init(load);
+        r_job_run(load->ready);
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        r_job_wait(loads[i].ready);
+    }
+
+    uint64_t end = r_time_now_ns();
+
+    // the timeline, in dependency order
+    for (uint32_t i = 0; i < count; i++) {
+        r_module_load *load = &loads[i];
+
+        r_log(R_LOG_INFO, "startup: %-20s open %7.2fms init %7.2fms at %7.2fms%s\n",
+            load->interface->properties.name,
+            (load->open_end - load->open_begin) / 1e6,
+            (load->init_end - load->init_begin) / 1e6,
+            (load->init_end - start) / 1e6,
+            load->main_thread ? " (main thread)" : "");
+    }
+    r_log(R_LOG_INFO, "startup: %u modules loaded in %.2fms\n", count, (end - start) / 1e6);
+
+    if (timeline_path) {
+        _module_write_timeline(timeline_path, loads, count, start, end);
+    }
+}
+
+// Start a background build of the module, returns the pid of the build process
+pid_t _module_rebuild(r_module_interface *interface) {
     // Now run a build of the module
     char *command = NULL;
     asprintf(&command, "./build/build module:%s", interface->properties.name);
 
+    // write out pending output so the child doesn't inherit it
+    r_log_flush();
+
     // create a new subprocess to run the build
     pid_t buildPid = fork();
-    
+
     if (buildPid == -1) {
-        fprintf(stderr, "Failed to fork process\n");
-        return;
+        r_log(R_LOG_ERROR, "Failed to fork process\n");
+        free(command);
+        return 0;
     }
 
     // if we're the child process
@@ -263,18 +920,17 @@ void _module_rebuild(r_module_interface *interface) {
             printf("%s", buffer);
         }
 
-        // close the output
-        pclose(buildOutput);
+        // close the output and hand the build result back to the lifecycle
+        int status = pclose(buildOutput);
 
-        exit(0);
+        exit(WIFEXITED(status) ? WEXITSTATUS(status) : 1);
     } else {
-        printf("Triggered background build of module: %s\n", interface->properties.name);
+        r_log(R_LOG_INFO, "Triggered background build of module: %s\n", interface->properties.name);
 
     }
 
-    // cleanup the command now that we don't need it anymore    
+    // cleanup the command now that we don't need it anymore
     free(command);
-    
-    // now the module should be detected as having been reloaded
-    interface->properties.files_changed = false;
+
+    return buildPid;
 }
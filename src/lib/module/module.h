@@ -15,7 +15,24 @@ r_module_lifecycle * r_module_lifecycle_create();
 void r_module_lifecycle_destroy(r_module_lifecycle *lifecycle);
 
 r_module_interface * r_module_lifecycle_register(r_module_lifecycle *lifecycle, r_module_properties properties);
+
+// Register a module without loading it, it's loaded by r_module_lifecycle_load_pending
+r_module_interface * r_module_lifecycle_register_deferred(r_module_lifecycle *lifecycle, r_module_properties properties);
+
+// Load every registered module which isn't loaded yet. The libraries are opened
+// concurrently on the job system and each init runs once the modules it depends
+// on have initialised. Modules exporting an `init_main_thread` symbol are
+// initialised on the calling thread. Writes a chrome trace of the startup to
+// timeline_path unless it's NULL.
+void r_module_lifecycle_load_pending(r_module_lifecycle *lifecycle, const char *timeline_path);
 void r_module_lifecycle_unregister(r_module_lifecycle *lifecycle, r_module_interface *interface);
+r_module_interface * r_module_lifecycle_find(r_module_lifecycle *lifecycle, const char *name);
+uint32_t r_module_lifecycle_count(r_module_lifecycle *lifecycle);
+r_module_interface * r_module_lifecycle_get(r_module_lifecycle *lifecycle, uint32_t index);
+
+// Declare that a module depends on another. When a module changes, its dependents
+// are rebuilt after it and the whole set is reloaded together at one frame boundary.
+bool r_module_lifecycle_add_dependency(r_module_lifecycle *lifecycle, r_module_interface *interface, const char *dependency);
 
 void r_module_lifecycle_pre_frame(r_module_lifecycle *lifecycle, float delta_ms);
 void r_module_lifecycle_update(r_module_lifecycle *lifecycle, float delta_ms);
@@ -0,0 +1,38 @@
+#include <stdio.h>
+
+#include "log/log.h"
+#include "memory/allocator.h"
+#include "memory/heap.h"
+#include "module/context.h"
+#include "module/persistent.h"
+
+void * r_module_persistent_allocate(const char *type, size_t size) {
+    r_module_properties *props = r_module_context_get();
+
+    // outside of a module callback fall back to the general allocator
+    if (props == NULL || props->memory.heap == NULL) {
+        return r_malloc(type, size);
+    }
+
+    void *ptr = r_heap_alloc(props->memory.heap, size);
+#ifdef MEMORY_DEBUG
+    r_log(R_LOG_DEBUG, "heap_alloc(%s, %zu) = %p\n", type, size, ptr);
+#endif
+    return ptr;
+}
+
+// the allocator follows the pointer rather than the calling context, memory
+// allocated outside of a callback may be freed inside one and the reverse
+void r_module_persistent_free(const char *type, void *ptr) {
+    r_heap *heap = r_heap_find(ptr);
+
+    if (heap == NULL) {
+        r_free(type, ptr);
+        return;
+    }
+
+#ifdef MEMORY_DEBUG
+    r_log(R_LOG_DEBUG, "type(%s): heap_free(%p)\n", type, ptr);
+#endif
+    r_heap_free(heap, ptr);
+}
@@ -0,0 +1,16 @@
+#ifndef _MODULE_PERSISTENT_H_
+#define _MODULE_PERSISTENT_H_
+
+// Persistent memory allocation for modules. Allocations come from the heap of
+// the module which is currently running, so they can be snapshotted with it.
+// Outside of a callback they come from r_malloc, a free goes back to whichever
+// allocator the pointer came from.
+
+#include <stddef.h>
+
+#define MODULE_HEAP_RESERVE   ((size_t)256 * 1024 * 1024)
+
+void * r_module_persistent_allocate(const char *type, size_t size);
+void   r_module_persistent_free(const char *type, void *ptr);
+
+#endif
@@ -0,0 +1,124 @@
+#include <pthread.h>
+
+#include "raylib.h"
+
+#include "log/log.h"
+#include "memory/allocator.h"
+#include "module/helper.h"
+#include "module/pipeline.h"
+#include "profile/profile.h"
+
+typedef enum r_pipeline_state {
+    R_PIPELINE_IDLE,
+    R_PIPELINE_KICKED,
+    R_PIPELINE_STOPPING,
+} r_pipeline_state;
+
+static pthread_t        thread;
+static pthread_mutex_t  lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   kicked = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t   done = PTHREAD_COND_INITIALIZER;
+static r_pipeline_state state = R_PIPELINE_IDLE;
+static float            frame_delta = 0.f;
+static bool             running = false;
+
+// the input the simulation reads, copied from raylib's at every kick
+static uint8_t *        input = NULL;
+
+static void * _pipeline_thread(void *arg) {
+    (void)arg;
+    r_profile_thread_init();
+
+    // raylib's own input is written by the main thread as it polls
+    SetThreadInputState(input);
+
+    pthread_mutex_lock(&lock);
+    for (;;) {
+        while (state == R_PIPELINE_IDLE) {
+            pthread_cond_wait(&kicked, &lock);
+        }
+        if (state == R_PIPELINE_STOPPING) {
+            break;
+        }
+
+        float delta_time = frame_delta;
+        pthread_mutex_unlock(&lock);
+
+        r_module_pre_frame(delta_time);
+        r_module_update(delta_time);
+
+        pthread_mutex_lock(&lock);
+        state = R_PIPELINE_IDLE;
+        pthread_cond_signal(&done);
+    }
+    pthread_mutex_unlock(&lock);
+
+    return NULL;
+}
+
+bool r_module_pipeline_create() {
+    if (running) {
+        return true;
+    }
+
+    state = R_PIPELINE_IDLE;
+    input = MALLOC(uint8_t, GetInputStateSize());
+    CopyInputState(input);
+
+    if (pthread_create(&thread, NULL, _pipeline_thread, NULL) != 0) {
+        r_log(R_LOG_ERROR, "pipeline: unable to start the simulation thread\n");
+        FREE(uint8_t, input);
+        return false;
+    }
+
+    running = true;
+    r_log(R_LOG_INFO, "pipeline: simulating a frame ahead of rendering\n");
+    return true;
+}
+
+void r_module_pipeline_kick(float delta_time) {
+    if (!running) {
+        return;
+    }
+
+    pthread_mutex_lock(&lock);
+    // the simulation is idle, hand it the input polled at the end of the last frame
+    CopyInputState(input);
+    frame_delta = delta_time;
+    state = R_PIPELINE_KICKED;
+    pthread_cond_signal(&kicked);
+    pthread_mutex_unlock(&lock);
+}
+
+void r_module_pipeline_wait() {
+    if (!running) {
+        return;
+    }
+
+    pthread_mutex_lock(&lock);
+    while (state == R_PIPELINE_KICKED) {
+        pthread_cond_wait(&done, &lock);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void r_module_pipeline_destroy() {
+    if (!running) {
+        return;
+    }
+
+    r_module_pipeline_wait();
+
+    pthread_mutex_lock(&lock);
+    state = R_PIPELINE_STOPPING;
+    pthread_cond_signal(&kicked);
+    pthread_mutex_unlock(&lock);
+
+    pthread_join(thread, NULL);
+    running = false;
+    FREE(uint8_t, input);
+}
+
+bool r_module_pipeline_running() {
+    return running;
+}
@@ -0,0 +1,39 @@
+#ifndef _MODULE_PIPELINE_H_
+#define _MODULE_PIPELINE_H_
+
+// r_module_pipeline runs the simulation of the next frame on its own thread
+// while the main thread draws and presents the current one.
+//
+// The simulation stage is pre_frame and update, which must only record draw
+// lists. The main thread seals those lists (r_draw_frame_end) once the stage
+// has finished and replays them while the next stage runs. ui_update and
+// post_frame stay on the main thread, so ui_update runs alongside the update
+// of the following frame, and post_frame (and with it every reload) runs at
+// the hand-off while neither stage is running.
+//
+// The simulation stage reads a copy of raylib's input taken at the hand-off,
+// the main thread polls the live input while presenting. Input read during the
+// simulation stage is at most a frame old. Module state which update uses is
+// owned by the simulation, ui_update must not write it.
+//
+// State publications (r_module_state) are made current once a frame at the
+// hand-off rather than at every phase boundary, so neither stage sees the
+// state change while it runs.
+//
+// The gain is bounded by the shorter of the two stages, a frame spends the
+// longer of the simulation and the main thread's work instead of their sum.
+
+#include <stdbool.h>
+
+bool r_module_pipeline_create();
+void r_module_pipeline_destroy();
+
+// start simulating the next frame on the pipeline thread
+void r_module_pipeline_kick(float delta_time);
+
+// wait for the frame being simulated, returns at once when none is
+void r_module_pipeline_wait();
+
+bool r_module_pipeline_running();
+
+#endif
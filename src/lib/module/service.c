@@ -0,0 +1,153 @@
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "log/log.h"
+#include "module/service.h"
+
+static r_service services[MAX_SERVICES];
+static uint32_t  service_count = 0;
+
+// modules may initialise concurrently at startup, publishing and acquiring
+// are serialised while the tables themselves are read without it
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+static r_service * _find(const char *name) {
+    for (uint32_t i = 0; i < service_count; i++) {
+        if (strcmp(services[i].name, name) == 0) {
+            return &services[i];
+        }
+    }
+    return NULL;
+}
+
+// resolve the symbols into the spare table and then swap it in, a table
+// with a missing function isn't handed out
+static bool _swap_table(r_service *service, void *library_handle) {
+    uint32_t back = service->front ^ 1;
+    bool     resolved = true;
+
+    for (uint32_t i = 0; i < service->count; i++) {
+        service->tables[back][i] = dlsym(library_handle, service->symbols[i]);
+
+        if (service->tables[back][i] == NULL) {
+            r_log(R_LOG_ERROR, "service %s: unable to resolve function: %s\n", service->name, service->symbols[i]);
+            resolved = false;
+        }
+    }
+
+    if (!resolved) {
+        atomic_store_explicit(&service->table, NULL, memory_order_release);
+        return false;
+    }
+
+    atomic_store_explicit(&service->table, service->tables[back], memory_order_release);
+    service->front = back;
+
+    return true;
+}
+
+static r_service * _publish(r_module_properties *props, const char *name, uint32_t version, const char **symbols, uint32_t count) {
+
+    if (count > MAX_SERVICE_FUNCTIONS || strlen(name) >= MAX_MODULE_FN_NAME) {
+        r_log(R_LOG_ERROR, "module %s: invalid service: %s\n", props->name, name);
+        return NULL;
+    }
+
+    r_service *service = _find(name);
+
+    if (service == NULL) {
+        if (service_count == MAX_SERVICES) {
+            r_log(R_LOG_ERROR, "module %s: too many services\n", props->name);
+            return NULL;
+        }
+        service = &services[service_count++];
+        *service = (r_service){
+            .front = 0,
+        };
+        atomic_init(&service->table, NULL);
+        strcpy(service->name, name);
+
+    // a revoked service can be provided by another module
+    } else if (service->provider[0] != '\0' && strcmp(service->provider, props->name) != 0) {
+        r_log(R_LOG_ERROR, "module %s: service %s is already provided by %s\n", props->name, name, service->provider);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (strlen(symbols[i]) >= MAX_MODULE_FN_NAME) {
+            r_log(R_LOG_ERROR, "module %s: function name too long: %s\n", props->name, symbols[i]);
+            return NULL;
+        }
+        strcpy(service->symbols[i], symbols[i]);
+    }
+    snprintf(service->provider, MAX_MODULE_FN_NAME, "%s", props->name);
+    service->count = count;
+    service->version = version;
+
+    _swap_table(service, props->library_handle);
+
+    return service;
+}
+
+static r_service * _acquire(r_module_properties *props, const char *name, uint32_t version) {
+    r_service *service = _find(name);
+
+    if (service == NULL || atomic_load(&service->table) == NULL) {
+        return NULL;
+    }
+
+    if (service->version != version) {
+        r_log(R_LOG_ERROR, "module %s: service %s version %u requested, %u published\n", props->name, name, version, service->version);
+        return NULL;
+    }
+
+    return service;
+}
+
+r_service * r_service_publish(r_module_properties *props, const char *name, uint32_t version, const char **symbols, uint32_t count) {
+    pthread_mutex_lock(&lock);
+    r_service *service = _publish(props, name, version, symbols, count);
+    pthread_mutex_unlock(&lock);
+    return service;
+}
+
+r_service * r_service_acquire(r_module_properties *props, const char *name, uint32_t version) {
+    pthread_mutex_lock(&lock);
+    r_service *service = _acquire(props, name, version);
+    pthread_mutex_unlock(&lock);
+    return service;
+}
+
+void r_service_resolve(r_module_properties *props) {
+    pthread_mutex_lock(&lock);
+    for (uint32_t i = 0; i < service_count; i++) {
+        if (strcmp(services[i].provider, props->name) == 0) {
+            _swap_table(&services[i], props->library_handle);
+        }
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void r_service_withdraw(r_module_properties *props) {
+    pthread_mutex_lock(&lock);
+    for (uint32_t i = 0; i < service_count; i++) {
+        if (strcmp(services[i].provider, props->name) == 0) {
+            atomic_store_explicit(&services[i].table, NULL, memory_order_release);
+        }
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void r_service_revoke(r_module_properties *props) {
+    pthread_mutex_lock(&lock);
+    for (uint32_t i = 0; i < service_count; i++) {
+        if (strcmp(services[i].provider, props->name) == 0) {
+            atomic_store_explicit(&services[i].table, NULL, memory_order_release);
+            services[i].provider[0] = '\0';
+        }
+    }
+    pthread_mutex_unlock(&lock);
+}
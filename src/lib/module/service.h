@@ -0,0 +1,22 @@
+#ifndef _MODULE_SERVICE_H_
+#define _MODULE_SERVICE_H_
+
+// r_service registry allows modules to call each other through function
+// tables which are kept up to date by the host across reloads.
+
+#include "module/interface.h"
+
+r_service * r_service_publish(r_module_properties *props, const char *name, uint32_t version, const char **symbols, uint32_t count);
+r_service * r_service_acquire(r_module_properties *props, const char *name, uint32_t version);
+
+// re-point the tables of every service provided by the module at its newly loaded library
+void r_service_resolve(r_module_properties *props);
+
+// mark every service provided by the module as unavailable until it's resolved again,
+// done before its library is closed so no consumer calls into the unmapped image
+void r_service_withdraw(r_module_properties *props);
+
+// mark every service provided by the module as unavailable and forget its provider
+void r_service_revoke(r_module_properties *props);
+
+#endif
@@ -0,0 +1,414 @@
+#include <dirent.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "log/log.h"
+#include "memory/allocator.h"
+#include "module/tweak.h"
+
+typedef struct r_tweak {
+    char *          file;   // __FILE__ as passed to the compiler, or the source's path until bound
+    int             line;
+    r_tweak_type    type;
+    bool            bound;  // patched before the module got to it otherwise
+    union {
+        int   i;
+        float f;
+    } value;
+    struct r_tweak *next;
+} r_tweak;
+
+typedef struct r_tweak_source {
+    char *                 path;   // path relative to the module's files root
+    char *                 text;
+    struct r_tweak_source *next;
+} r_tweak_source;
+
+typedef struct r_tweak_set {
+    r_tweak *        tweaks;
+    r_tweak_source * sources;
+} r_tweak_set;
+
+// in the order of r_tweak_type
+static const char *macros[] = {
+    "TWEAK_INT(",
+    "TWEAK_FLOAT(",
+};
+#define MACRO_COUNT (sizeof(macros) / sizeof(macros[0]))
+
+// modules bind from the sim thread and their jobs while the main thread patches,
+// the lists of every set and the tweaks in them are only touched under the lock
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Source helpers
+// --------------
+
+static char * _format(const char *format, ...) {
+    va_list args, copy;
+    va_start(args, format);
+    va_copy(copy, args);
+
+    int   length = vsnprintf(NULL, 0, format, copy);
+    char *text = MALLOC(char, (length + 1));
+    vsnprintf(text, (size_t)length + 1, format, args);
+
+    va_end(copy);
+    va_end(args);
+    return text;
+}
+
+static char * _read_file(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *text = MALLOC(char, size + 1);
+    size_t read = fread(text, 1, size, file);
+    text[read] = '\0';
+    fclose(file);
+
+    return text;
+}
+
+// returns the macro starting at text, if any
+static const char * _macro_at(const char *text, r_tweak_type *type) {
+    for (size_t i = 0; i < MACRO_COUNT; i++) {
+        if (strncmp(text, macros[i], strlen(macros[i])) == 0) {
+            if (type != NULL) {
+                *type = (r_tweak_type)i;
+            }
+            return macros[i];
+        }
+    }
+    return NULL;
+}
+
+// returns a pointer to the closing parenthesis of a macro, args points after the opening one
+static const char * _macro_end(const char *args) {
+    int depth = 1;
+    for (const char *c = args; *c; c++) {
+        if (*c == '(') depth++;
+        if (*c == ')' && --depth == 0) return c;
+    }
+    return NULL;
+}
+
+// copy of the text with the arguments of every tweak macro removed
+static char * _mask_tweaks(const char *text) {
+    char *masked = MALLOC(char, strlen(text) + 1);
+    char *out = masked;
+
+    for (const char *c = text; *c; ) {
+        const char *macro = _macro_at(c, NULL);
+        const char *end = macro ? _macro_end(c + strlen(macro)) : NULL;
+
+        if (end != NULL) {
+            size_t length = strlen(macro);
+            memcpy(out, c, length);
+            out += length;
+            c = end;
+        } else {
+            *out++ = *c++;
+        }
+    }
+    *out = '\0';
+
+    return masked;
+}
+
+static bool _same_apart_from_tweaks(const char *before, const char *after) {
+    char *a = _mask_tweaks(before);
+    char *b = _mask_tweaks(after);
+    bool  same = strcmp(a, b) == 0;
+
+    FREE(char, a);
+    FREE(char, b);
+    return same;
+}
+
+// does the compiler's view of a file refer to the tracked source
+static bool _file_matches(const char *file, const char *path) {
+    size_t file_length = strlen(file);
+    size_t path_length = strlen(path);
+
+    if (path_length > file_length || strcmp(file + file_length - path_length, path) != 0) {
+        return false;
+    }
+    return path_length == file_length || file[file_length - path_length - 1] == '/';
+}
+
+// a single store, the module reads the value without the lock and sees the old or the new one
+static void _set_value(r_tweak *tweak, const char *args) {
+    int bits;
+
+    if (tweak->type == R_TWEAK_INT) {
+        bits = (int)strtol(args, NULL, 0);
+    } else {
+        float value = strtof(args, NULL);
+        memcpy(&bits, &value, sizeof(bits));
+    }
+    __atomic_store_n(&tweak->value.i, bits, __ATOMIC_RELAXED);
+}
+
+static void _log_value(r_module_properties *props, r_tweak *tweak, const char *path) {
+    if (tweak->type == R_TWEAK_INT) {
+        r_log(R_LOG_INFO, "%s: tweak %s:%d = %d%s\n", props->name, path, tweak->line, tweak->value.i, tweak->bound ? "" : " (pending)");
+    } else {
+        r_log(R_LOG_INFO, "%s: tweak %s:%d = %f%s\n", props->name, path, tweak->line, tweak->value.f, tweak->bound ? "" : " (pending)");
+    }
+}
+
+// does the tweak stand for the macro on the line of the source
+static bool _tweak_at(r_tweak *tweak, const char *path, int line) {
+    if (tweak->line != line) {
+        return false;
+    }
+    return tweak->bound ? _file_matches(tweak->file, path) : strcmp(tweak->file, path) == 0;
+}
+
+// write the values found in the new text into the tweaks, the ones which
+// haven't been bound yet are kept until they are
+static void _patch_tweaks(r_module_properties *props, r_tweak_source *source, const char *text) {
+    int line = 1;
+
+    for (const char *c = text; *c; c++) {
+        if (*c == '\n') {
+            line++;
+            continue;
+        }
+
+        r_tweak_type type;
+        const char * macro = _macro_at(c, &type);
+        if (macro == NULL) {
+            continue;
+        }
+
+        const char *args = c + strlen(macro);
+        r_tweak *   tweak = props->tweaks.set->tweaks;
+
+        while (tweak != NULL && !_tweak_at(tweak, source->path, line)) {
+            tweak = tweak->next;
+        }
+
+        if (tweak == NULL) {
+            tweak = MALLOC(r_tweak, 1);
+            tweak->file = _format("%s", source->path);
+            tweak->line = line;
+            tweak->type = type;
+            tweak->bound = false;
+            tweak->next = props->tweaks.set->tweaks;
+            props->tweaks.set->tweaks = tweak;
+        }
+
+        _set_value(tweak, args);
+        _log_value(props, tweak, source->path);
+        c = args;
+    }
+}
+
+// Snapshot every file below the directory, paths are relative to root
+static void _snapshot_dir(r_tweak_set *set, const char *root, const char *relative) {
+    char *dir_path = _format("%s%s%s", root, relative[0] ? "/" : "", relative);
+
+    DIR *dir = opendir(dir_path);
+    if (dir == NULL) {
+        FREE(char, dir_path);
+        return;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+
+        char *path = _format("%s%s%s", relative, relative[0] ? "/" : "", entry->d_name);
+        char *full_path = _format("%s/%s", root, path);
+
+        struct stat statbuf;
+        if (stat(full_path, &statbuf) == 0 && S_ISDIR(statbuf.st_mode)) {
+            _snapshot_dir(set, root, path);
+            FREE(char, path);
+        } else {
+            r_tweak_source *source = MALLOC(r_tweak_source, 1);
+            source->path = path;
+            source->text = _read_file(full_path);
+            source->next = set->sources;
+            set->sources = source;
+        }
+        FREE(char, full_path);
+    }
+
+    closedir(dir);
+    FREE(char, dir_path);
+}
+
+static void _free_sources(r_tweak_set *set) {
+    while (set->sources) {
+        r_tweak_source *next = set->sources->next;
+        FREE(char, set->sources->path);
+        if (set->sources->text) {
+            FREE(char, set->sources->text);
+        }
+        FREE(r_tweak_source, set->sources);
+        set->sources = next;
+    }
+}
+
+static void _free_tweaks(r_tweak_set *set) {
+    while (set->tweaks) {
+        r_tweak *next = set->tweaks->next;
+        FREE(char, set->tweaks->file);
+        FREE(r_tweak, set->tweaks);
+        set->tweaks = next;
+    }
+}
+
+static void _track(r_module_properties *props) {
+    if (props->tweaks.set == NULL) {
+        props->tweaks.set = MALLOC(r_tweak_set, 1);
+        props->tweaks.set->tweaks = NULL;
+        props->tweaks.set->sources = NULL;
+    }
+
+    // a freshly loaded image starts with its compiled values
+    _free_tweaks(props->tweaks.set);
+    _free_sources(props->tweaks.set);
+
+    _snapshot_dir(props->tweaks.set, props->library_files_root, "");
+}
+
+static void * _bind(r_module_properties *props, const char *file, int line, r_tweak_type type, const void *value) {
+
+    if (props->tweaks.set == NULL) {
+        _track(props);
+    }
+
+    // another translation unit can't share the line, but a cache miss can bind twice
+    for (r_tweak *tweak = props->tweaks.set->tweaks; tweak; tweak = tweak->next) {
+        if (tweak->bound && tweak->line == line && strcmp(tweak->file, file) == 0) {
+            return &tweak->value;
+        }
+    }
+
+    // a value patched in before the tweak first ran replaces the compiled one
+    for (r_tweak *tweak = props->tweaks.set->tweaks; tweak; tweak = tweak->next) {
+        if (!tweak->bound && tweak->line == line && tweak->type == type && _file_matches(file, tweak->file)) {
+            FREE(char, tweak->file);
+            tweak->file = _format("%s", file);
+            tweak->bound = true;
+            return &tweak->value;
+        }
+    }
+
+    r_tweak *tweak = MALLOC(r_tweak, 1);
+    tweak->file = _format("%s", file);
+    tweak->line = line;
+    tweak->type = type;
+    tweak->bound = true;
+
+    if (type == R_TWEAK_INT) {
+        tweak->value.i = *(const int *)value;
+    } else {
+        tweak->value.f = *(const float *)value;
+    }
+
+    tweak->next = props->tweaks.set->tweaks;
+    props->tweaks.set->tweaks = tweak;
+
+    return &tweak->value;
+}
+
+// Host functions
+// --------------
+
+void * r_tweak_bind(r_module_properties *props, const char *file, int line, r_tweak_type type, const void *value) {
+    pthread_mutex_lock(&lock);
+    void *storage = _bind(props, file, line, type, value);
+    pthread_mutex_unlock(&lock);
+    return storage;
+}
+
+void r_tweak_track(r_module_properties *props) {
+    pthread_mutex_lock(&lock);
+    _track(props);
+    pthread_mutex_unlock(&lock);
+}
+
+bool r_tweak_apply(r_module_properties *props) {
+    pthread_mutex_lock(&lock);
+    r_tweak_set *set = props->tweaks.set;
+    pthread_mutex_unlock(&lock);
+
+    if (set == NULL) {
+        return false;
+    }
+
+    // compare the current sources against the snapshot
+    r_tweak_set current = { .tweaks = NULL, .sources = NULL };
+    _snapshot_dir(&current, props->library_files_root, "");
+
+    bool tweak_only = true;
+    uint32_t current_count = 0;
+    uint32_t snapshot_count = 0;
+
+    for (r_tweak_source *source = set->sources; source; source = source->next) {
+        snapshot_count++;
+    }
+
+    for (r_tweak_source *source = current.sources; source && tweak_only; source = source->next) {
+        current_count++;
+
+        r_tweak_source *previous = set->sources;
+        while (previous && strcmp(previous->path, source->path) != 0) {
+            previous = previous->next;
+        }
+
+        // new files, or files which couldn't be read need a build
+        if (previous == NULL || previous->text == NULL || source->text == NULL) {
+            tweak_only = false;
+        } else if (strcmp(previous->text, source->text) != 0) {
+            tweak_only = _same_apart_from_tweaks(previous->text, source->text);
+        }
+    }
+
+    // a removed file needs a build
+    if (tweak_only && current_count != snapshot_count) {
+        tweak_only = false;
+    }
+
+    if (tweak_only) {
+        pthread_mutex_lock(&lock);
+        for (r_tweak_source *source = current.sources; source; source = source->next) {
+            _patch_tweaks(props, source, source->text);
+        }
+
+        // the patched sources become the new snapshot
+        _free_sources(set);
+        set->sources = current.sources;
+        pthread_mutex_unlock(&lock);
+    } else {
+        _free_sources(&current);
+    }
+
+    return tweak_only;
+}
+
+void r_tweak_destroy(r_module_properties *props) {
+    pthread_mutex_lock(&lock);
+    if (props->tweaks.set != NULL) {
+        _free_tweaks(props->tweaks.set);
+        _free_sources(props->tweaks.set);
+        FREE(r_tweak_set, props->tweaks.set);
+    }
+    pthread_mutex_unlock(&lock);
+}
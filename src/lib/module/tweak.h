@@ -0,0 +1,43 @@
+#ifndef _MODULE_TWEAK_H_
+#define _MODULE_TWEAK_H_
+
+// Tweakable constants
+//
+// Literals wrapped in a tweak macro are read from host memory. When the only
+// change to a module's sources is to the values inside tweak macros, the
+// filetracker patches the new values into the running module instead of
+// triggering a rebuild.
+//
+//     int speed = TWEAK_INT(200);
+//     float ball_speed = TWEAK_FLOAT(2.f);
+//
+// Tweaks are identified by file and line, so only one tweak per line is supported.
+// A tweak which hadn't run yet when its value was patched starts with the
+// patched value. The macros expect `props` to be in scope, like MMALLOC.
+
+#include <stdbool.h>
+
+#include "module/interface.h"
+
+// the storage pointer is cached where the tweak is used, looked up once per image
+#define _R_TWEAK(type, ctype, value) (*({ \
+    static void *_r_tweak = NULL; \
+    (ctype *)(_r_tweak ? _r_tweak : (_r_tweak = props->tweaks.bind(props, __FILE__, __LINE__, type, &(ctype){ value }))); \
+}))
+
+#define TWEAK_INT(value)   _R_TWEAK(R_TWEAK_INT, int, value)
+#define TWEAK_FLOAT(value) _R_TWEAK(R_TWEAK_FLOAT, float, value)
+
+// host functions
+
+void * r_tweak_bind(r_module_properties *props, const char *file, int line, r_tweak_type type, const void *value);
+
+// snapshot the module's sources and forget the tweaks bound by the previous image
+void   r_tweak_track(r_module_properties *props);
+
+// returns true if the only source changes were to tweak values, which are then patched
+bool   r_tweak_apply(r_module_properties *props);
+
+void   r_tweak_destroy(r_module_properties *props);
+
+#endif
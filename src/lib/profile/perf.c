@@ -0,0 +1,186 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "log/log.h"
+#include "profile/perf.h"
+#include "time/time.h"
+
+// see tools/perf/Documentation/jitdump-specification.txt in the linux tree
+#define JITDUMP_MAGIC     0x4A695444
+#define JITDUMP_VERSION   1
+#define JIT_CODE_LOAD     0
+#define JIT_CODE_CLOSE    3
+
+#if defined(__x86_64__)
+#define JITDUMP_MACHINE   62    // EM_X86_64
+#elif defined(__aarch64__)
+#define JITDUMP_MACHINE   183   // EM_AARCH64
+#else
+#define JITDUMP_MACHINE   0
+#endif
+
+typedef struct r_jitdump_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t total_size;
+    uint32_t elf_mach;
+    uint32_t pad1;
+    uint32_t pid;
+    uint64_t timestamp;
+    uint64_t flags;
+} r_jitdump_header;
+
+typedef struct r_jitdump_record {
+    uint32_t id;
+    uint32_t total_size;
+    uint64_t timestamp;
+} r_jitdump_record;
+
+// followed by the name and the code
+typedef struct r_jitdump_code_load {
+    r_jitdump_record record;
+    uint32_t         pid;
+    uint32_t         tid;
+    uint64_t         vma;
+    uint64_t         code_addr;
+    uint64_t         code_size;
+    uint64_t         code_index;
+} r_jitdump_code_load;
+
+static FILE *    map = NULL;
+static FILE *    jitdump = NULL;
+static void *    marker = NULL;
+static uint64_t  code_index = 0;
+
+bool r_perf_create() {
+    if (map != NULL) {
+        return true;
+    }
+
+    char path[64];
+    pid_t pid = getpid();
+
+    snprintf(path, sizeof(path), "/tmp/perf-%d.map", (int)pid);
+    map = fopen(path, "w");
+    if (map == NULL) {
+        r_log(R_LOG_ERROR, "perf: unable to create %s\n", path);
+        return false;
+    }
+
+    snprintf(path, sizeof(path), "/tmp/jit-%d.dump", (int)pid);
+    int fd = open(path, O_CREAT | O_TRUNC | O_RDWR, 0666);
+    if (fd < 0) {
+        r_log(R_LOG_ERROR, "perf: unable to create %s\n", path);
+        return true;
+    }
+
+    // perf finds the dump through an executable mapping of it
+    marker = mmap(NULL, sysconf(_SC_PAGESIZE), PROT_READ | PROT_EXEC, MAP_PRIVATE, fd, 0);
+    if (marker == MAP_FAILED) {
+        marker = NULL;
+    }
+
+    jitdump = fdopen(fd, "wb");
+
+    r_jitdump_header header = {
+        .magic      = JITDUMP_MAGIC,
+        .version    = JITDUMP_VERSION,
+        .total_size = sizeof(r_jitdump_header),
+        .elf_mach   = JITDUMP_MACHINE,
+        .pad1       = 0,
+        .pid        = (uint32_t)pid,
+        .timestamp  = r_time_now_ns(),
+        .flags      = 0,
+    };
+    fwrite(&header, sizeof(header), 1, jitdump);
+    fflush(jitdump);
+
+    r_log(R_LOG_INFO, "perf: writing /tmp/perf-%d.map and %s\n", (int)pid, path);
+    return true;
+}
+
+void r_perf_destroy() {
+    if (jitdump != NULL) {
+        r_jitdump_record record = {
+            .id         = JIT_CODE_CLOSE,
+            .total_size = sizeof(r_jitdump_record),
+            .timestamp  = r_time_now_ns(),
+        };
+        fwrite(&record, sizeof(record), 1, jitdump);
+        fclose(jitdump);
+        jitdump = NULL;
+    }
+
+    if (marker != NULL) {
+        munmap(marker, sysconf(_SC_PAGESIZE));
+        marker = NULL;
+    }
+
+    if (map != NULL) {
+        fclose(map);
+        map = NULL;
+    }
+}
+
+bool r_perf_enabled() {
+    return map != NULL;
+}
+
+void r_perf_image_load(const char *name, const r_symbol_table *symbols) {
+    if (map == NULL) {
+        return;
+    }
+
+    // perf record -k mono uses the same clock
+    uint64_t timestamp = r_time_now_ns();
+#if defined(__linux__)
+    uint32_t tid = (uint32_t)syscall(SYS_gettid);
+#else
+    uint32_t tid = 0;
+#endif
+
+    for (uint32_t i = 0; i < symbols->count; i++) {
+        const r_symbol *symbol = &symbols->symbols[i];
+        if (symbol->size == 0) {
+            continue;
+        }
+
+        char function[256];
+        snprintf(function, sizeof(function), "%s`%s", name, symbol->name);
+
+        fprintf(map, "%lx %lx %s\n", (unsigned long)symbol->address, (unsigned long)symbol->size, function);
+
+        if (jitdump == NULL) {
+            continue;
+        }
+
+        // the code is copied, the library file will be overwritten by the next build
+        size_t name_size = strlen(function) + 1;
+        r_jitdump_code_load load = {
+            .record = {
+                .id         = JIT_CODE_LOAD,
+                .total_size = (uint32_t)(sizeof(r_jitdump_code_load) + name_size + symbol->size),
+                .timestamp  = timestamp,
+            },
+            .pid        = (uint32_t)getpid(),
+            .tid        = tid,
+            .vma        = symbol->address,
+            .code_addr  = symbol->address,
+            .code_size  = symbol->size,
+            .code_index = code_index++,
+        };
+
+        fwrite(&load, sizeof(load), 1, jitdump);
+        fwrite(function, name_size, 1, jitdump);
+        fwrite((const void *)symbol->address, symbol->size, 1, jitdump);
+    }
+
+    fflush(map);
+    if (jitdump != NULL) {
+        fflush(jitdump);
+    }
+}
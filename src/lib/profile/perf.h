@@ -0,0 +1,29 @@
+#ifndef _PROFILE_PERF_H_
+#define _PROFILE_PERF_H_
+
+// r_perf describes every loaded module image to linux perf, so samples in
+// versions whose library has been rebuilt since can still be attributed.
+//
+// Two outputs are written:
+//   /tmp/perf-<pid>.map   one "start size name" line per function, for tools
+//                         which read perf maps. Addresses can be reused by a
+//                         later version, the map can't tell them apart.
+//   /tmp/jit-<pid>.dump   a jitdump with a copy of each function's code and
+//                         the time it was loaded. perf tracks the versions:
+//
+//     perf record -k mono ./build/reload
+//     perf inject --jit -i perf.data -o perf.jit.data
+//     perf report -i perf.jit.data
+
+#include <stdbool.h>
+
+#include "profile/symbols.h"
+
+bool r_perf_create();
+void r_perf_destroy();
+bool r_perf_enabled();
+
+// describe the functions of a freshly loaded image, name is module@version
+void r_perf_image_load(const char *name, const r_symbol_table *symbols);
+
+#endif
@@ -0,0 +1,689 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE   // dladdr and the register names of ucontext
+#endif
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+#include "fiber/fiber.h"
+#include "log/log.h"
+#include "memory/allocator.h"
+#include "profile/perf.h"
+#include "profile/profile.h"
+#include "profile/symbols.h"
+
+#define PROFILE_CACHE_SIZE   8192
+#define PROFILE_NAME_LENGTH  64
+#define PROFILE_FRAME_LENGTH 192
+
+typedef struct r_profile_sample {
+    uint32_t  depth;
+    uintptr_t pcs[PROFILE_MAX_DEPTH];    // leaf first
+} r_profile_sample;
+
+// written by the signal handler of one thread, read by r_profile_collect
+typedef struct r_profile_ring {
+    _Atomic uint64_t head;
+    _Atomic uint64_t tail;
+    _Atomic uint32_t dropped;
+    r_profile_sample samples[PROFILE_RING_SAMPLES];
+} r_profile_ring;
+
+typedef struct r_profile_image {
+    char              name[PROFILE_NAME_LENGTH];   // module@version
+    void *            handle;
+    uintptr_t         base;
+    r_symbol_table    symbols;
+} r_profile_image;
+
+typedef struct r_profile_version {
+    char     module[PROFILE_NAME_LENGTH];
+    uint32_t version;
+} r_profile_version;
+
+typedef struct r_profile_count {
+    char *   key;
+    uint64_t self;
+    uint64_t total;
+} r_profile_count;
+
+typedef struct r_profile_table {
+    r_profile_count *entries;
+    uint32_t         capacity;
+    uint32_t         count;
+} r_profile_table;
+
+typedef struct r_profile_frame {
+    uintptr_t pc;
+    char *    name;     // image`function
+} r_profile_frame;
+
+// Sampling state
+static r_profile_ring *  rings = NULL;
+static _Atomic uint32_t  ring_count = 0;
+static _Atomic bool      sampling = false;
+static bool              handler_installed = false;
+static _Thread_local int32_t ring_index = -1;
+
+// bounds of the thread's own stack, frame pointers outside of it aren't followed
+static _Thread_local uintptr_t stack_low = 0;
+static _Thread_local uintptr_t stack_high = 0;
+
+// Images
+static r_profile_image   images[MAX_PROFILE_IMAGES];
+static uint32_t          image_count = 0;
+static r_profile_image   host = { .name = "", .handle = NULL };
+static r_profile_version versions[MAX_PROFILE_IMAGES];
+static uint32_t          version_count = 0;
+
+// Aggregated samples
+static r_profile_frame   cache[PROFILE_CACHE_SIZE];
+static r_profile_table   functions = { NULL, 0, 0 };
+static r_profile_table   stacks = { NULL, 0, 0 };
+static r_profile_table   modules = { NULL, 0, 0 };
+static uint64_t          sample_count = 0;
+
+// Sampling
+// --------
+
+// collect the program counters of the interrupted thread, leaf first
+static uint32_t _walk(void *context, uintptr_t *pcs) {
+    ucontext_t *uc = context;
+    uintptr_t   pc, fp, sp;
+
+#if defined(__linux__) && defined(__x86_64__)
+    pc = (uintptr_t)uc->uc_mcontext.gregs[REG_RIP];
+    fp = (uintptr_t)uc->uc_mcontext.gregs[REG_RBP];
+    sp = (uintptr_t)uc->uc_mcontext.gregs[REG_RSP];
+#elif defined(__linux__) && defined(__aarch64__)
+    pc = (uintptr_t)uc->uc_mcontext.pc;
+    fp = (uintptr_t)uc->uc_mcontext.regs[29];
+    sp = (uintptr_t)uc->uc_mcontext.sp;
+#elif defined(__APPLE__) && defined(__x86_64__)
+    pc = (uintptr_t)uc->uc_mcontext->__ss.__rip;
+    fp = (uintptr_t)uc->uc_mcontext->__ss.__rbp;
+    sp = (uintptr_t)uc->uc_mcontext->__ss.__rsp;
+#elif defined(__APPLE__) && defined(__aarch64__)
+    pc = (uintptr_t)uc->uc_mcontext->__ss.__pc;
+    fp = (uintptr_t)uc->uc_mcontext->__ss.__fp;
+    sp = (uintptr_t)uc->uc_mcontext->__ss.__sp;
+#else
+    (void)uc;
+    return 0;
+#endif
+
+    uint32_t depth = 0;
+    pcs[depth++] = pc;
+
+    // the stack the thread was interrupted on, a fiber's or its own, only the
+    // leaf is recorded on a thread which hasn't called r_profile_thread_init
+    uintptr_t low, high;
+    if (!r_fiber_stack(&low, &high) || sp < low || sp >= high) {
+        low = stack_low;
+        high = stack_high;
+        if (sp < low || sp >= high) {
+            return depth;
+        }
+    }
+
+    // frame records are {previous frame, return address} and grow towards the stack pointer
+    while (depth < PROFILE_MAX_DEPTH && fp >= sp && fp + 2 * sizeof(uintptr_t) <= high && (fp & (sizeof(uintptr_t) - 1)) == 0) {
+        uintptr_t *frame = (uintptr_t *)fp;
+        uintptr_t  next = frame[0];
+        uintptr_t  ret = frame[1];
+
+        if (ret == 0) {
+            break;
+        }
+        pcs[depth++] = ret;
+
+        if (next <= fp) {
+            break;
+        }
+        fp = next;
+    }
+
+    return depth;
+}
+
+static void _profile_signal(int signum, siginfo_t *info, void *context) {
+    (void)signum;
+    (void)info;
+    int saved_errno = errno;
+
+    if (!atomic_load_explicit(&sampling, memory_order_relaxed)) {
+        errno = saved_errno;
+        return;
+    }
+
+    // the first sample of a thread claims a ring
+    if (ring_index < 0) {
+        uint32_t index = atomic_fetch_add_explicit(&ring_count, 1, memory_order_relaxed);
+        ring_index = index < MAX_PROFILE_THREADS ? (int32_t)index : MAX_PROFILE_THREADS;
+    }
+
+    if (ring_index < MAX_PROFILE_THREADS) {
+        r_profile_ring *ring = &rings[ring_index];
+        uint64_t        head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        uint64_t        tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+        if (head - tail < PROFILE_RING_SAMPLES) {
+            r_profile_sample *sample = &ring->samples[head % PROFILE_RING_SAMPLES];
+            sample->depth = _walk(context, sample->pcs);
+            atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+        } else {
+            atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        }
+    }
+
+    errno = saved_errno;
+}
+
+// Images
+// ------
+
+static void _register_host() {
+    if (host.name[0] != '\0') {
+        return;
+    }
+
+    Dl_info info;
+    if (dladdr((void *)_register_host, &info) == 0) {
+        return;
+    }
+
+    const char *slash = strrchr(info.dli_fname, '/');
+    snprintf(host.name, sizeof(host.name), "%s", slash ? slash + 1 : info.dli_fname);
+    host.base = (uintptr_t)info.dli_fbase;
+
+#if defined(__linux__)
+    r_symbols_read(&host.symbols, "/proc/self/exe", host.base);
+#endif
+}
+
+// Aggregation
+// -----------
+
+static char * _copy(const char *text) {
+    size_t length = strlen(text);
+    char * copy = MALLOC(char, (length + 1));
+    memcpy(copy, text, length + 1);
+    return copy;
+}
+
+static uint64_t _hash(const char *key) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const char *c = key; *c; c++) {
+        hash = (hash ^ (uint8_t)*c) * 1099511628211ull;
+    }
+    return hash;
+}
+
+static r_profile_count * _table_get(r_profile_table *table, const char *key) {
+
+    // keep the table at most half full
+    if ((table->count + 1) * 2 > table->capacity) {
+        r_profile_table grown = {
+            .capacity = table->capacity ? table->capacity * 2 : 256,
+            .count = table->count,
+        };
+        grown.entries = MALLOC(r_profile_count, grown.capacity);
+        memset(grown.entries, 0, sizeof(r_profile_count) * grown.capacity);
+
+        for (uint32_t i = 0; i < table->capacity; i++) {
+            if (table->entries[i].key == NULL) {
+                continue;
+            }
+
+            uint32_t slot = _hash(table->entries[i].key) & (grown.capacity - 1);
+            while (grown.entries[slot].key != NULL) {
+                slot = (slot + 1) & (grown.capacity - 1);
+            }
+            grown.entries[slot] = table->entries[i];
+        }
+
+        if (table->entries) {
+            FREE(r_profile_count, table->entries);
+        }
+        *table = grown;
+    }
+
+    uint32_t slot = _hash(key) & (table->capacity - 1);
+    while (table->entries[slot].key != NULL) {
+        if (strcmp(table->entries[slot].key, key) == 0) {
+            return &table->entries[slot];
+        }
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+
+    table->entries[slot].key = _copy(key);
+    table->entries[slot].self = 0;
+    table->entries[slot].total = 0;
+    table->count++;
+
+    return &table->entries[slot];
+}
+
+static void _table_clear(r_profile_table *table) {
+    for (uint32_t i = 0; i < table->capacity; i++) {
+        if (table->entries[i].key) {
+            FREE(char, table->entries[i].key);
+        }
+    }
+    if (table->entries) {
+        FREE(r_profile_count, table->entries);
+    }
+    table->capacity = 0;
+    table->count = 0;
+}
+
+static void _cache_clear() {
+    for (uint32_t i = 0; i < PROFILE_CACHE_SIZE; i++) {
+        if (cache[i].name) {
+            FREE(char, cache[i].name);
+        }
+        cache[i].pc = 0;
+    }
+}
+
+// name a program counter as image`function, while its image is still loaded
+static const char * _symbolize(uintptr_t pc) {
+    uint32_t slot = (uint32_t)((pc >> 2) * 2654435761u) & (PROFILE_CACHE_SIZE - 1);
+    if (cache[slot].name != NULL && cache[slot].pc == pc) {
+        return cache[slot].name;
+    }
+
+    char        frame[PROFILE_FRAME_LENGTH];
+    const char *image_name = NULL;
+    const char *function = NULL;
+
+    Dl_info info;
+    if (dladdr((void *)pc, &info) != 0) {
+        r_profile_image *image = NULL;
+
+        for (uint32_t i = 0; i < image_count && image == NULL; i++) {
+            if (images[i].base == (uintptr_t)info.dli_fbase) {
+                image = &images[i];
+            }
+        }
+        if (image == NULL && host.base == (uintptr_t)info.dli_fbase) {
+            image = &host;
+        }
+
+        if (image != NULL) {
+            image_name = image->name;
+            function = r_symbols_find(&image->symbols, pc);
+        } else {
+            const char *slash = info.dli_fname ? strrchr(info.dli_fname, '/') : NULL;
+            image_name = slash ? slash + 1 : info.dli_fname;
+        }
+
+        if (function == NULL) {
+            function = info.dli_sname;
+        }
+
+        if (function != NULL) {
+            snprintf(frame, sizeof(frame), "%s`%s", image_name ? image_name : "?", function);
+        } else {
+            snprintf(frame, sizeof(frame), "%s`0x%lx", image_name ? image_name : "?", (unsigned long)(pc - (uintptr_t)info.dli_fbase));
+        }
+    } else {
+        snprintf(frame, sizeof(frame), "?`0x%lx", (unsigned long)pc);
+    }
+
+    if (cache[slot].name) {
+        FREE(char, cache[slot].name);
+    }
+    cache[slot].pc = pc;
+    cache[slot].name = _copy(frame);
+
+    return cache[slot].name;
+}
+
+static void _aggregate(const r_profile_sample *sample) {
+    if (sample->depth == 0) {
+        return;
+    }
+
+    const char *frames[PROFILE_MAX_DEPTH];
+    char        key[PROFILE_MAX_DEPTH * PROFILE_FRAME_LENGTH];
+    size_t      length = 0;
+
+    // return addresses point after the call, look up the call itself
+    for (uint32_t i = 0; i < sample->depth; i++) {
+        uintptr_t pc = i == 0 ? sample->pcs[i] : sample->pcs[i] - 1;
+        frames[i] = _symbolize(pc);
+    }
+
+    // collapsed stacks are written root first
+    key[0] = '\0';
+    for (uint32_t i = sample->depth; i-- > 0; ) {
+        int written = snprintf(key + length, sizeof(key) - length, "%s%s", length ? ";" : "", frames[i]);
+        if (written < 0 || (size_t)written >= sizeof(key) - length) {
+            break;
+        }
+        length += (size_t)written;
+    }
+    _table_get(&stacks, key)->self++;
+
+    for (uint32_t i = 0; i < sample->depth; i++) {
+        char   module[PROFILE_NAME_LENGTH];
+        size_t module_length = strcspn(frames[i], "`");
+        snprintf(module, sizeof(module), "%.*s", (int)module_length, frames[i]);
+
+        bool seen_function = false;
+        bool seen_module = false;
+        for (uint32_t j = 0; j < i; j++) {
+            seen_function |= strcmp(frames[j], frames[i]) == 0;
+            seen_module |= strncmp(frames[j], frames[i], module_length + 1) == 0;
+        }
+
+        // recursion only counts once towards the total
+        r_profile_count *function = _table_get(&functions, frames[i]);
+        r_profile_count *image = _table_get(&modules, module);
+        if (i == 0) {
+            function->self++;
+            image->self++;
+        }
+        if (!seen_function) {
+            function->total++;
+        }
+        if (!seen_module) {
+            image->total++;
+        }
+    }
+
+    sample_count++;
+}
+
+static int _count_compare(const void *a, const void *b) {
+    const r_profile_count *x = *(const r_profile_count * const *)a;
+    const r_profile_count *y = *(const r_profile_count * const *)b;
+    if (x->self != y->self) {
+        return x->self < y->self ? 1 : -1;
+    }
+    return x->total < y->total ? 1 : x->total > y->total ? -1 : 0;
+}
+
+// entries of a table sorted by self samples, the caller frees the array
+static r_profile_count ** _table_sorted(r_profile_table *table) {
+    r_profile_count **sorted = MALLOC(r_profile_count *, table->count + 1);
+    uint32_t          count = 0;
+
+    for (uint32_t i = 0; i < table->capacity; i++) {
+        if (table->entries[i].key != NULL) {
+            sorted[count++] = &table->entries[i];
+        }
+    }
+    qsort(sorted, count, sizeof(r_profile_count *), _count_compare);
+
+    return sorted;
+}
+
+// Public functions
+// ----------------
+
+void r_profile_thread_init() {
+#if defined(__linux__)
+    pthread_attr_t attributes;
+    void *         address;
+    size_t         size;
+
+    if (pthread_getattr_np(pthread_self(), &attributes) != 0) {
+        return;
+    }
+    if (pthread_attr_getstack(&attributes, &address, &size) == 0) {
+        stack_low = (uintptr_t)address;
+        stack_high = (uintptr_t)address + size;
+    }
+    pthread_attr_destroy(&attributes);
+#elif defined(__APPLE__)
+    // the address is the top of the stack
+    stack_high = (uintptr_t)pthread_get_stackaddr_np(pthread_self());
+    stack_low = stack_high - pthread_get_stacksize_np(pthread_self());
+#endif
+}
+
+bool r_profile_start(uint32_t frequency) {
+    if (atomic_load(&sampling)) {
+        return true;
+    }
+
+    if (frequency == 0) {
+        frequency = PROFILE_FREQUENCY;
+    }
+
+    // untouched rings don't take any memory
+    if (rings == NULL) {
+        void *pool = mmap(NULL, sizeof(r_profile_ring) * MAX_PROFILE_THREADS, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON | MAP_NORESERVE, -1, 0);
+        if (pool == MAP_FAILED) {
+            r_log(R_LOG_ERROR, "profile: unable to reserve the sample buffers\n");
+            return false;
+        }
+        rings = pool;
+    }
+
+    _register_host();
+    r_profile_thread_init();
+
+    // the handler stays installed, a late SIGPROF would otherwise terminate the process
+    if (!handler_installed) {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = _profile_signal;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+
+        if (sigaction(SIGPROF, &action, NULL) != 0) {
+            r_log(R_LOG_ERROR, "profile: unable to install the SIGPROF handler\n");
+            return false;
+        }
+        handler_installed = true;
+    }
+
+    atomic_store(&sampling, true);
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = frequency >= 1000000 ? 1 : (suseconds_t)(1000000 / frequency);
+    timer.it_value = timer.it_interval;
+
+    if (setitimer(ITIMER_PROF, &timer, NULL) != 0) {
+        r_log(R_LOG_ERROR, "profile: unable to start the profiling timer\n");
+        atomic_store(&sampling, false);
+        return false;
+    }
+
+    r_log(R_LOG_INFO, "profile: sampling at %u Hz\n", frequency);
+    return true;
+}
+
+void r_profile_stop() {
+    if (!atomic_load(&sampling)) {
+        return;
+    }
+
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, NULL);
+
+    atomic_store(&sampling, false);
+    r_profile_collect();
+}
+
+bool r_profile_running() {
+    return atomic_load(&sampling);
+}
+
+void r_profile_image_load(const char *module, void *handle, void *address, const char *path) {
+    Dl_info info;
+    if (address == NULL || dladdr(address, &info) == 0) {
+        return;
+    }
+
+    // every load of a module is a new version
+    r_profile_version *version = NULL;
+    for (uint32_t i = 0; i < version_count && version == NULL; i++) {
+        if (strcmp(versions[i].module, module) == 0) {
+            version = &versions[i];
+        }
+    }
+    if (version == NULL && version_count < MAX_PROFILE_IMAGES) {
+        version = &versions[version_count++];
+        snprintf(version->module, sizeof(version->module), "%s", module);
+        version->version = 0;
+    }
+
+    char           name[PROFILE_NAME_LENGTH];
+    uintptr_t      base = (uintptr_t)info.dli_fbase;
+    r_symbol_table symbols;
+
+    snprintf(name, sizeof(name), "%s@%u", module, version ? ++version->version : 0);
+    r_symbols_read(&symbols, path, base);
+
+    // perf keeps the symbols of every version, even once the profiler's own images are full
+    r_perf_image_load(name, &symbols);
+
+    if (image_count == MAX_PROFILE_IMAGES) {
+        r_log(R_LOG_WARNING, "profile: too many images loaded, samples in %s won't be named\n", name);
+        r_symbols_free(&symbols);
+        return;
+    }
+
+    r_profile_image *image = &images[image_count++];
+    memset(image, 0, sizeof(r_profile_image));
+    snprintf(image->name, sizeof(image->name), "%s", name);
+    image->handle = handle;
+    image->base = base;
+    image->symbols = symbols;
+}
+
+void r_profile_image_unload(void *handle) {
+    for (uint32_t i = 0; i < image_count; i++) {
+        if (images[i].handle != handle) {
+            continue;
+        }
+
+        // name the samples of this image while it's still mapped
+        r_profile_collect();
+
+        r_symbols_free(&images[i].symbols);
+        images[i] = images[--image_count];
+
+        // the addresses may be reused by the next image
+        _cache_clear();
+        return;
+    }
+}
+
+void r_profile_collect() {
+    if (rings == NULL) {
+        return;
+    }
+
+    uint32_t count = atomic_load_explicit(&ring_count, memory_order_relaxed);
+    if (count > MAX_PROFILE_THREADS) count = MAX_PROFILE_THREADS;
+
+    for (uint32_t i = 0; i < count; i++) {
+        r_profile_ring *ring = &rings[i];
+        uint64_t        head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t        tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+        for (; tail < head; tail++) {
+            _aggregate(&ring->samples[tail % PROFILE_RING_SAMPLES]);
+        }
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+
+        uint32_t dropped = atomic_exchange_explicit(&ring->dropped, 0, memory_order_relaxed);
+        if (dropped > 0) {
+            r_log(R_LOG_WARNING, "profile: dropped %u samples\n", dropped);
+        }
+    }
+}
+
+bool r_profile_report(const char *flat_path, const char *collapsed_path) {
+    r_profile_collect();
+
+    if (flat_path != NULL) {
+        FILE *file = fopen(flat_path, "w");
+        if (file == NULL) {
+            r_log(R_LOG_ERROR, "profile: unable to write %s\n", flat_path);
+            return false;
+        }
+
+        double            scale = sample_count ? 100.0 / (double)sample_count : 0.0;
+        r_profile_count **sorted_modules = _table_sorted(&modules);
+        r_profile_count **sorted_functions = _table_sorted(&functions);
+
+        fprintf(file, "%llu samples\n", (unsigned long long)sample_count);
+
+        for (uint32_t m = 0; m < modules.count; m++) {
+            r_profile_count *module = sorted_modules[m];
+            size_t           module_length = strlen(module->key);
+
+            fprintf(file, "\n%s  self %.1f%%  total %.1f%%\n", module->key, module->self * scale, module->total * scale);
+            fprintf(file, "  %7s %7s  %s\n", "self", "total", "function");
+
+            for (uint32_t f = 0; f < functions.count; f++) {
+                r_profile_count *function = sorted_functions[f];
+
+                if (strncmp(function->key, module->key, module_length) == 0 && function->key[module_length] == '`') {
+                    fprintf(file, "  %6.1f%% %6.1f%%  %s\n", function->self * scale, function->total * scale, function->key + module_length + 1);
+                }
+            }
+        }
+
+        FREE(r_profile_count *, sorted_modules);
+        FREE(r_profile_count *, sorted_functions);
+        fclose(file);
+    }
+
+    if (collapsed_path != NULL) {
+        FILE *file = fopen(collapsed_path, "w");
+        if (file == NULL) {
+            r_log(R_LOG_ERROR, "profile: unable to write %s\n", collapsed_path);
+            return false;
+        }
+
+        for (uint32_t i = 0; i < stacks.capacity; i++) {
+            if (stacks.entries[i].key != NULL) {
+                fprintf(file, "%s %llu\n", stacks.entries[i].key, (unsigned long long)stacks.entries[i].self);
+            }
+        }
+        fclose(file);
+    }
+
+    r_log(R_LOG_INFO, "profile: wrote %llu samples\n", (unsigned long long)sample_count);
+    return true;
+}
+
+void r_profile_clear() {
+    r_profile_collect();
+
+    _table_clear(&functions);
+    _table_clear(&stacks);
+    _table_clear(&modules);
+    sample_count = 0;
+}
+
+void r_profile_destroy() {
+    r_profile_stop();
+    r_profile_clear();
+    _cache_clear();
+
+    for (uint32_t i = 0; i < image_count; i++) {
+        r_symbols_free(&images[i].symbols);
+    }
+    image_count = 0;
+    r_symbols_free(&host.symbols);
+}
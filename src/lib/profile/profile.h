@@ -0,0 +1,50 @@
+#ifndef _PROFILE_H_
+#define _PROFILE_H_
+
+// r_profile is a sampling profiler which understands reloaded modules.
+//
+// A SIGPROF timer interrupts the running threads, the handler walks the frame
+// pointers and stores the program counters in the thread's own ring. Every
+// loaded module image is registered with its address range and a version, and
+// its function symbols are read from the library file when it's loaded. The
+// samples of an image are symbolized before it's unloaded, so the profile
+// stays correct after the code moved or the file was rebuilt.
+//
+// Stacks need frame pointers, e.g. -fno-omit-frame-pointer. Without them only
+// the sampled function is reliable. Frames are followed within the bounds of
+// the interrupted stack, so threads other than the one starting the profiler
+// call r_profile_thread_init, otherwise only their sampled function is kept.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MAX_PROFILE_THREADS     64
+#define MAX_PROFILE_IMAGES      64
+#define PROFILE_MAX_DEPTH       32
+#define PROFILE_RING_SAMPLES    2048
+#define PROFILE_FREQUENCY       1000
+
+// start sampling at the given frequency in Hz, 0 uses PROFILE_FREQUENCY
+bool r_profile_start(uint32_t frequency);
+void r_profile_stop();
+bool r_profile_running();
+
+// record the calling thread's stack bounds for walking its samples
+void r_profile_thread_init();
+
+// register a module image after dlopen, and before it's closed
+void r_profile_image_load(const char *module, void *handle, void *address, const char *path);
+void r_profile_image_unload(void *handle);
+
+// symbolize and aggregate the samples taken so far, called once a frame
+void r_profile_collect();
+
+// write a per module flat profile and the collapsed stacks, either path can be NULL
+bool r_profile_report(const char *flat_path, const char *collapsed_path);
+
+// drop the aggregated samples
+void r_profile_clear();
+
+void r_profile_destroy();
+
+#endif
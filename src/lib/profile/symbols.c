@@ -0,0 +1,143 @@
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#if defined(__linux__)
+#include <elf.h>
+#endif
+
+#include "memory/allocator.h"
+#include "profile/symbols.h"
+
+static int _symbol_compare(const void *a, const void *b) {
+    uintptr_t x = ((const r_symbol *)a)->address;
+    uintptr_t y = ((const r_symbol *)b)->address;
+    return x < y ? -1 : x > y;
+}
+
+void r_symbols_read(r_symbol_table *table, const char *path, uintptr_t base) {
+    table->symbols = NULL;
+    table->count = 0;
+    table->strings = NULL;
+
+#if defined(__linux__)
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat statbuf;
+    if (fstat(fd, &statbuf) != 0 || (size_t)statbuf.st_size < sizeof(Elf64_Ehdr)) {
+        close(fd);
+        return;
+    }
+
+    uint8_t *file = mmap(NULL, statbuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (file == MAP_FAILED) {
+        return;
+    }
+
+    Elf64_Ehdr *header = (Elf64_Ehdr *)file;
+    if (memcmp(header->e_ident, ELFMAG, SELFMAG) != 0 || header->e_ident[EI_CLASS] != ELFCLASS64 ||
+        header->e_shoff > (size_t)statbuf.st_size ||
+        (size_t)header->e_shnum * sizeof(Elf64_Shdr) > (size_t)statbuf.st_size - header->e_shoff) {
+        munmap(file, statbuf.st_size);
+        return;
+    }
+
+    // position independent images are relocated by their load address
+    uintptr_t   bias = header->e_type == ET_DYN ? base : 0;
+    Elf64_Shdr *sections = (Elf64_Shdr *)(file + header->e_shoff);
+    Elf64_Shdr *symtab = NULL;
+
+    // the full symbol table has the static functions, the dynamic one is the fallback
+    for (uint32_t i = 0; i < header->e_shnum; i++) {
+        if (sections[i].sh_type == SHT_SYMTAB) {
+            symtab = &sections[i];
+        }
+    }
+    for (uint32_t i = 0; i < header->e_shnum && symtab == NULL; i++) {
+        if (sections[i].sh_type == SHT_DYNSYM) {
+            symtab = &sections[i];
+        }
+    }
+
+    // both sections have to lie within the file
+    size_t      size = (size_t)statbuf.st_size;
+    Elf64_Shdr *strings = symtab != NULL && symtab->sh_link < header->e_shnum ? &sections[symtab->sh_link] : NULL;
+    if (strings != NULL && (symtab->sh_offset > size || symtab->sh_size > size - symtab->sh_offset ||
+                            strings->sh_offset > size || strings->sh_size > size - strings->sh_offset)) {
+        strings = NULL;
+    }
+
+    if (strings != NULL) {
+        Elf64_Sym * symbols = (Elf64_Sym *)(file + symtab->sh_offset);
+        uint32_t    count = (uint32_t)(symtab->sh_size / sizeof(Elf64_Sym));
+
+        // terminated in case the last name runs up to the end of the section
+        table->strings = MALLOC(char, (strings->sh_size + 1));
+        memcpy(table->strings, file + strings->sh_offset, strings->sh_size);
+        table->strings[strings->sh_size] = '\0';
+        table->symbols = MALLOC(r_symbol, count);
+        table->count = 0;
+
+        for (uint32_t i = 0; i < count; i++) {
+            if (ELF64_ST_TYPE(symbols[i].st_info) != STT_FUNC || symbols[i].st_value == 0 || symbols[i].st_name >= strings->sh_size) {
+                continue;
+            }
+
+            table->symbols[table->count++] = (r_symbol){
+                .address = bias + symbols[i].st_value,
+                .size    = symbols[i].st_size,
+                .name    = table->strings + symbols[i].st_name,
+            };
+        }
+
+        qsort(table->symbols, table->count, sizeof(r_symbol), _symbol_compare);
+    }
+
+    munmap(file, statbuf.st_size);
+#else
+    (void)path;
+    (void)base;
+#endif
+}
+
+void r_symbols_free(r_symbol_table *table) {
+    if (table->symbols) {
+        FREE(r_symbol, table->symbols);
+    }
+    if (table->strings) {
+        FREE(char, table->strings);
+    }
+    table->count = 0;
+}
+
+const char * r_symbols_find(const r_symbol_table *table, uintptr_t pc) {
+    uint32_t low = 0;
+    uint32_t high = table->count;
+
+    // last symbol starting at or before the pc
+    while (low < high) {
+        uint32_t middle = (low + high) / 2;
+        if (table->symbols[middle].address <= pc) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    if (low == 0) {
+        return NULL;
+    }
+
+    const r_symbol *symbol = &table->symbols[low - 1];
+    if (symbol->size != 0 && pc >= symbol->address + symbol->size) {
+        return NULL;
+    }
+    return symbol->name;
+}
@@ -0,0 +1,28 @@
+#ifndef _PROFILE_SYMBOLS_H_
+#define _PROFILE_SYMBOLS_H_
+
+// Function symbols of a loaded image, read from its file. Keep the table
+// around for as long as the code is needed, the file may be rebuilt.
+
+#include <stdint.h>
+
+typedef struct r_symbol {
+    uintptr_t   address;    // relocated to where the image is loaded
+    uintptr_t   size;
+    const char *name;
+} r_symbol;
+
+typedef struct r_symbol_table {
+    r_symbol *symbols;      // sorted by address
+    uint32_t  count;
+    char *    strings;
+} r_symbol_table;
+
+// read the functions of an ELF file loaded at base, the table is empty on other formats
+void         r_symbols_read(r_symbol_table *table, const char *path, uintptr_t base);
+void         r_symbols_free(r_symbol_table *table);
+
+// name of the function containing the address, NULL if unknown
+const char * r_symbols_find(const r_symbol_table *table, uintptr_t address);
+
+#endif
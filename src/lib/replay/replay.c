@@ -0,0 +1,439 @@
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "log/log.h"
+#include "memory/allocator.h"
+#include "replay/replay.h"
+#include "time/time.h"
+
+#include "raylib.h"
+
+#define REPLAY_WRITE_BUFFER    (64 * 1024)
+#define REPLAY_PROFILE_INITIAL 4096
+#define REPLAY_EVENTS_INITIAL  256
+#define REPLAY_EVENT_PARAMS    3
+
+typedef struct r_replay_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t phase_count;
+    uint32_t reserved;
+    uint64_t build;
+} r_replay_header;
+
+typedef struct r_replay_frame {
+    uint8_t          phases;
+    float            deltas[R_MODULE_PHASE_COUNT];
+    AutomationEvent *events;
+    int              event_count;
+    int              event_capacity;
+} r_replay_frame;
+
+static r_replay_mode  mode = R_REPLAY_NONE;
+static r_replay_frame frame;
+static uint64_t       frame_index = 0;
+
+// recording
+static FILE *         output = NULL;
+static char           output_buffer[REPLAY_WRITE_BUFFER];
+static const char *   output_path = NULL;
+
+// playback
+static uint8_t *      input = NULL;
+static size_t         input_size = 0;
+static size_t         input_offset = 0;
+static uint64_t       frame_start = 0;
+static uint64_t *     frame_ns = NULL;
+static uint64_t       frame_ns_capacity = 0;
+static const char *   profile_path = NULL;
+
+// make room for count events, what the frame held is dropped
+static void _reserve_events(int count) {
+    if (count <= frame.event_capacity) {
+        return;
+    }
+
+    int capacity = frame.event_capacity ? frame.event_capacity : REPLAY_EVENTS_INITIAL;
+    while (capacity < count) {
+        capacity *= 2;
+    }
+
+    if (frame.events != NULL) {
+        FREE(AutomationEvent, frame.events);
+    }
+    frame.events = MALLOC(AutomationEvent, capacity);
+    frame.event_capacity = capacity;
+}
+
+// the parameters an event carries, the trailing zero ones are left out
+static int _event_params(const AutomationEvent *event) {
+    int count = REPLAY_EVENT_PARAMS;
+
+    while (count > 0 && event->params[count - 1] == 0) {
+        count--;
+    }
+    return count;
+}
+
+// Writing
+// -------
+
+static void _write_varint(uint64_t value) {
+    uint8_t bytes[10];
+    int     count = 0;
+
+    do {
+        bytes[count] = value & 0x7f;
+        value >>= 7;
+        bytes[count++] |= value ? 0x80 : 0;
+    } while (value);
+
+    fwrite(bytes, 1, count, output);
+}
+
+static void _write_signed(int32_t value) {
+    _write_varint(((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+static void _write_frame() {
+    uint8_t flags = frame.phases;
+    bool    shared = true;
+    float   first = 0.f;
+
+    for (int phase = 0, seen = 0; phase < R_MODULE_PHASE_COUNT; phase++) {
+        if (frame.phases & (1 << phase)) {
+            shared = shared && (!seen || frame.deltas[phase] == first);
+            first = seen++ ? first : frame.deltas[phase];
+        }
+    }
+
+    flags |= shared ? REPLAY_FRAME_SHARED : 0;
+    flags |= frame.event_count > 0 ? REPLAY_FRAME_EVENTS : 0;
+    fwrite(&flags, 1, 1, output);
+
+    for (int phase = 0; phase < R_MODULE_PHASE_COUNT; phase++) {
+        if (frame.phases & (1 << phase)) {
+            fwrite(&frame.deltas[phase], sizeof(float), 1, output);
+            if (shared) {
+                break;
+            }
+        }
+    }
+
+    if (frame.event_count > 0) {
+        _write_varint(frame.event_count);
+
+        for (int i = 0; i < frame.event_count; i++) {
+            int params = _event_params(&frame.events[i]);
+
+            _write_varint((uint64_t)frame.events[i].type * (REPLAY_EVENT_PARAMS + 1) + params);
+            for (int param = 0; param < params; param++) {
+                _write_signed(frame.events[i].params[param]);
+            }
+        }
+    }
+}
+
+// Reading
+// -------
+
+static bool _read(void *value, size_t size) {
+    if (input_size - input_offset < size) {
+        return false;
+    }
+
+    memcpy(value, input + input_offset, size);
+    input_offset += size;
+    return true;
+}
+
+static bool _read_varint(uint64_t *value) {
+    *value = 0;
+
+    for (int shift = 0; shift < 64 && input_offset < input_size; shift += 7) {
+        uint8_t byte = input[input_offset++];
+        *value |= (uint64_t)(byte & 0x7f) << shift;
+
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool _read_signed(int *value) {
+    uint64_t encoded;
+
+    if (!_read_varint(&encoded)) {
+        return false;
+    }
+
+    *value = (int)((uint32_t)(encoded >> 1) ^ -(uint32_t)(encoded & 1));
+    return true;
+}
+
+static bool _read_frame() {
+    uint8_t flags;
+
+    if (!_read(&flags, 1)) {
+        return false;
+    }
+
+    frame.phases = flags & ((1 << R_MODULE_PHASE_COUNT) - 1);
+    frame.event_count = 0;
+
+    float shared = 0.f;
+    if ((flags & REPLAY_FRAME_SHARED) && frame.phases && !_read(&shared, sizeof(float))) {
+        return false;
+    }
+
+    for (int phase = 0; phase < R_MODULE_PHASE_COUNT; phase++) {
+        if (!(frame.phases & (1 << phase))) {
+            continue;
+        }
+
+        if (flags & REPLAY_FRAME_SHARED) {
+            frame.deltas[phase] = shared;
+        } else if (!_read(&frame.deltas[phase], sizeof(float))) {
+            return false;
+        }
+    }
+
+    if (flags & REPLAY_FRAME_EVENTS) {
+        // every event takes a byte at least
+        uint64_t count;
+        if (!_read_varint(&count) || count > input_size - input_offset) {
+            return false;
+        }
+        _reserve_events((int)count);
+
+        for (uint64_t i = 0; i < count; i++) {
+            AutomationEvent *event = &frame.events[i];
+            uint64_t         tag;
+
+            if (!_read_varint(&tag)) {
+                return false;
+            }
+
+            // raylib would skip an event it doesn't know, the input after it wouldn't be what was recorded
+            uint64_t type = tag / (REPLAY_EVENT_PARAMS + 1);
+            if (type > UINT_MAX || !IsAutomationEventSupported((unsigned int)type)) {
+                r_log(R_LOG_WARNING, "replay: unknown event type %llu in frame %llu\n", (unsigned long long)type, (unsigned long long)frame_index);
+                return false;
+            }
+
+            int params = (int)(tag % (REPLAY_EVENT_PARAMS + 1));
+            *event = (AutomationEvent){ .frame = (unsigned int)frame_index, .type = (unsigned int)type };
+            for (int param = 0; param < params; param++) {
+                if (!_read_signed(&event->params[param])) {
+                    return false;
+                }
+            }
+        }
+        frame.event_count = (int)count;
+    }
+    return true;
+}
+
+// Profile
+// -------
+
+static int _ns_compare(const void *a, const void *b) {
+    uint64_t left = *(const uint64_t *)a;
+    uint64_t right = *(const uint64_t *)b;
+    return (left > right) - (left < right);
+}
+
+static void _profile_add(uint64_t ns) {
+    if (frame_index >= frame_ns_capacity) {
+        uint64_t  capacity = frame_ns_capacity ? frame_ns_capacity * 2 : REPLAY_PROFILE_INITIAL;
+        uint64_t *grown = MALLOC(uint64_t, capacity);
+
+        if (frame_ns != NULL) {
+            memcpy(grown, frame_ns, frame_ns_capacity * sizeof(uint64_t));
+            FREE(uint64_t, frame_ns);
+        }
+        frame_ns = grown;
+        frame_ns_capacity = capacity;
+    }
+
+    frame_ns[frame_index] = ns;
+}
+
+static void _profile_report() {
+    if (frame_index == 0) {
+        return;
+    }
+
+    if (profile_path != NULL) {
+        FILE *file = fopen(profile_path, "w");
+
+        if (file != NULL) {
+            fprintf(file, "frame,ns\n");
+            for (uint64_t i = 0; i < frame_index; i++) {
+                fprintf(file, "%llu,%llu\n", (unsigned long long)i, (unsigned long long)frame_ns[i]);
+            }
+            fclose(file);
+        } else {
+            r_log(R_LOG_ERROR, "replay: unable to write the frame times: %s\n", profile_path);
+        }
+    }
+
+    uint64_t total = 0;
+    for (uint64_t i = 0; i < frame_index; i++) {
+        total += frame_ns[i];
+    }
+
+    // the percentiles are taken from the sorted times, the csv keeps the frame order
+    qsort(frame_ns, frame_index, sizeof(uint64_t), _ns_compare);
+
+    r_log(R_LOG_INFO, "replay: %llu frames in %.3f s, mean %.3f ms, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+        (unsigned long long)frame_index, total / 1e9, total / 1e6 / frame_index,
+        frame_ns[frame_index * 50 / 100] / 1e6, frame_ns[frame_index * 95 / 100] / 1e6,
+        frame_ns[frame_index * 99 / 100] / 1e6, frame_ns[frame_index - 1] / 1e6);
+}
+
+// Replay
+// ------
+
+bool r_replay_record(const char *path, uint64_t build) {
+    if (mode != R_REPLAY_NONE) {
+        return false;
+    }
+
+    output = fopen(path, "wb");
+    if (output == NULL) {
+        r_log(R_LOG_ERROR, "replay: unable to record to %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    setvbuf(output, output_buffer, _IOFBF, sizeof(output_buffer));
+
+    r_replay_header header = {
+        .magic = REPLAY_MAGIC,
+        .version = REPLAY_VERSION,
+        .phase_count = R_MODULE_PHASE_COUNT,
+        .reserved = 0,
+        .build = build,
+    };
+    fwrite(&header, sizeof(header), 1, output);
+
+    mode = R_REPLAY_RECORD;
+    output_path = path;
+    frame_index = 0;
+
+    r_log(R_LOG_INFO, "replay: recording to %s\n", path);
+    return true;
+}
+
+bool r_replay_play(const char *path, const char *profile, uint64_t build) {
+    if (mode != R_REPLAY_NONE) {
+        return false;
+    }
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        r_log(R_LOG_ERROR, "replay: unable to play %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    input = MALLOC(uint8_t, size > 0 ? size : 1);
+    input_size = size > 0 && fread(input, 1, size, file) == (size_t)size ? (size_t)size : 0;
+    input_offset = 0;
+    fclose(file);
+
+    r_replay_header header;
+    if (!_read(&header, sizeof(header)) || header.magic != REPLAY_MAGIC ||
+        header.version != REPLAY_VERSION || header.phase_count != R_MODULE_PHASE_COUNT) {
+        r_log(R_LOG_ERROR, "replay: not a recording of this version: %s\n", path);
+        FREE(uint8_t, input);
+        return false;
+    }
+
+    if (header.build != build) {
+        r_log(R_LOG_WARNING, "replay: %s was recorded with other module libraries, it may play out differently\n", path);
+    }
+
+    mode = R_REPLAY_PLAY;
+    profile_path = profile;
+    frame_index = 0;
+
+    r_log(R_LOG_INFO, "replay: playing %s\n", path);
+    return true;
+}
+
+void r_replay_stop() {
+    if (mode == R_REPLAY_RECORD) {
+        fclose(output);
+        output = NULL;
+        r_log(R_LOG_INFO, "replay: recorded %llu frames to %s\n", (unsigned long long)frame_index, output_path);
+    } else if (mode == R_REPLAY_PLAY) {
+        _profile_report();
+        FREE(uint8_t, input);
+        FREE(uint64_t, frame_ns);
+        frame_ns_capacity = 0;
+    }
+
+    if (frame.events != NULL) {
+        FREE(AutomationEvent, frame.events);
+    }
+    frame.event_capacity = 0;
+    frame.event_count = 0;
+
+    mode = R_REPLAY_NONE;
+}
+
+r_replay_mode r_replay_get_mode() {
+    return mode;
+}
+
+bool r_replay_frame_begin() {
+    if (mode == R_REPLAY_RECORD) {
+        frame.phases = 0;
+        frame.event_count = GetAutomationEvents(frame.events, frame.event_capacity);
+
+        // a busy frame gets all its events rather than losing the ones which didn't fit
+        if (frame.event_count > frame.event_capacity) {
+            _reserve_events(frame.event_count);
+            frame.event_count = GetAutomationEvents(frame.events, frame.event_capacity);
+        }
+    } else if (mode == R_REPLAY_PLAY) {
+        if (!_read_frame()) {
+            if (input_offset < input_size) {
+                r_log(R_LOG_WARNING, "replay: recording is truncated or corrupt after frame %llu\n", (unsigned long long)frame_index);
+            }
+            return false;
+        }
+
+        PlayAutomationEvents(frame.events, frame.event_count);
+        frame_start = r_time_now_ns();
+    }
+    return true;
+}
+
+void r_replay_frame_end() {
+    if (mode == R_REPLAY_RECORD) {
+        _write_frame();
+    } else if (mode == R_REPLAY_PLAY) {
+        _profile_add(r_time_now_ns() - frame_start);
+    } else {
+        return;
+    }
+
+    frame_index++;
+}
+
+float r_replay_delta(r_module_phase phase, float delta_time) {
+    if (mode == R_REPLAY_RECORD) {
+        frame.phases |= 1 << phase;
+        frame.deltas[phase] = delta_time;
+    } else if (mode == R_REPLAY_PLAY && (frame.phases & (1 << phase))) {
+        return frame.deltas[phase];
+    }
+    return delta_time;
+}
@@ -0,0 +1,51 @@
+#ifndef _REPLAY_H_
+#define _REPLAY_H_
+
+// r_replay records what a session's frames were given, the delta time passed to
+// every lifecycle phase and the input raylib polled, and plays it back with the
+// recorded clock. A played back session doesn't depend on the wall clock or on
+// the devices, so it runs as fast as the frames do and the frame times of two
+// builds can be compared. The header keeps a hash of the module libraries the
+// session ran, a playback against other libraries is reported as it may diverge.
+//
+// The log is binary, a header then one record per frame:
+//   u8     flags: the phases with a delta, REPLAY_FRAME_SHARED, REPLAY_FRAME_EVENTS
+//   f32    one delta when the phases shared it, otherwise one per phase
+//   events a varint count, then for each a varint of type * 4 + the parameters
+//          kept, and those parameters as zigzag varints
+// where the events are the input changes from raylib's GetAutomationEvents().
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "module/interface.h"
+
+#define REPLAY_MAGIC       0x4c505252   // "RRPL"
+#define REPLAY_VERSION     2
+
+#define REPLAY_FRAME_SHARED (1 << R_MODULE_PHASE_COUNT)
+#define REPLAY_FRAME_EVENTS (1 << (R_MODULE_PHASE_COUNT + 1))
+
+typedef enum r_replay_mode {
+    R_REPLAY_NONE,
+    R_REPLAY_RECORD,
+    R_REPLAY_PLAY,
+} r_replay_mode;
+
+// record the frames to come into path, build identifies the module libraries running them
+bool r_replay_record(const char *path, uint64_t build);
+// play the frames recorded in path, the time every frame took goes to profile_path as csv when it's set
+bool r_replay_play(const char *path, const char *profile_path, uint64_t build);
+// finish the log, or report the frame times of the playback
+void r_replay_stop();
+
+r_replay_mode r_replay_get_mode();
+
+// start a frame once raylib has polled the input, false when the playback has run out
+bool r_replay_frame_begin();
+void r_replay_frame_end();
+
+// the delta time a phase runs with, it's recorded or replaced by the recorded one
+float r_replay_delta(r_module_phase phase, float delta_time);
+
+#endif
@@ -0,0 +1,280 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "log/log.h"
+#include "memory/allocator.h"
+#include "state/state.h"
+
+// the payload follows the header, which keeps it aligned for any type
+typedef struct r_state_snapshot {
+    struct r_state_snapshot *next;
+    r_state_topic *          topic;
+    uint64_t                 version;
+    uint64_t                 retired;
+} __attribute__((aligned(16))) r_state_snapshot;
+
+#define SNAPSHOT(payload) ((r_state_snapshot *)((uint8_t *)(payload) - sizeof(r_state_snapshot)))
+#define PAYLOAD(snapshot) ((void *)((uint8_t *)(snapshot) + sizeof(r_state_snapshot)))
+
+struct r_state_topic {
+    char                        name[MAX_MODULE_FN_NAME];
+    char                        type[MAX_MODULE_FN_NAME];
+    uint32_t                    size;
+    uint64_t                    version;
+
+    _Atomic(r_state_snapshot *) current;
+    _Atomic(r_state_snapshot *) staged;
+};
+
+// the epoch a thread started reading in, 0 while it isn't reading
+typedef struct r_state_reader {
+    _Atomic uint64_t epoch;
+    _Atomic bool     used;      // held by a live thread, given up when it exits
+    uint8_t          padding[55];
+} r_state_reader;
+
+// added under the lock, advance counts the topics without it
+static r_state_topic     topics[MAX_STATE_TOPICS];
+static _Atomic uint32_t  topic_count = 0;
+static pthread_mutex_t   topic_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// slots below reader_count have been used, advance only looks at those
+static _Atomic uint64_t  epoch = 1;
+static r_state_reader    readers[MAX_STATE_READERS];
+static _Atomic uint32_t  reader_count = 0;
+static pthread_key_t     reader_key;
+static pthread_once_t    reader_key_once = PTHREAD_ONCE_INIT;
+
+static _Thread_local int32_t  reader_index = -1;
+static _Thread_local uint32_t nesting = 0;
+
+// snapshots which have been replaced, oldest last
+static r_state_snapshot *retired = NULL;
+static pthread_mutex_t   advance_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static r_state_snapshot * _snapshot_create(r_state_topic *topic) {
+    r_state_snapshot *snapshot = (r_state_snapshot *)MALLOC(uint8_t, sizeof(r_state_snapshot) + topic->size);
+    snapshot->next = NULL;
+    snapshot->topic = topic;
+    snapshot->version = 0;
+    snapshot->retired = 0;
+    return snapshot;
+}
+
+static void _snapshot_destroy(r_state_snapshot *snapshot) {
+    FREE(uint8_t, snapshot);
+}
+
+static void _reader_release(void *released) {
+    r_state_reader *reader = released;
+    atomic_store(&reader->epoch, 0);
+    atomic_store_explicit(&reader->used, false, memory_order_release);
+    reader_index = -1;
+}
+
+static void _reader_key_create() {
+    pthread_key_create(&reader_key, _reader_release);
+}
+
+// take the first free slot, the thread gives it back when it exits
+static bool _reader_acquire() {
+    pthread_once(&reader_key_once, _reader_key_create);
+
+    for (uint32_t i = 0; i < MAX_STATE_READERS; i++) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&readers[i].used, &expected, true)) {
+            uint32_t count = atomic_load(&reader_count);
+            while (count <= i && !atomic_compare_exchange_weak(&reader_count, &count, i + 1)) {
+            }
+
+            pthread_setspecific(reader_key, &readers[i]);
+            reader_index = (int32_t)i;
+            return true;
+        }
+    }
+
+    r_log(R_LOG_ERROR, "state: more than %d threads reading\n", MAX_STATE_READERS);
+    return false;
+}
+
+static bool _enter() {
+    if (reader_index < 0 && !_reader_acquire()) {
+        return false;
+    }
+
+    // announce the epoch before loading any snapshot, the advance which retires
+    // what we load is bound to see it
+    if (nesting++ == 0) {
+        atomic_store(&readers[reader_index].epoch, atomic_load(&epoch));
+    }
+    return true;
+}
+
+static void _leave() {
+    if (--nesting == 0) {
+        atomic_store_explicit(&readers[reader_index].epoch, 0, memory_order_release);
+    }
+}
+
+r_state_topic * r_state_topic_get(r_module_properties *props, const char *name, const char *type, uint32_t size) {
+    r_state_topic *topic = NULL;
+
+    pthread_mutex_lock(&topic_lock);
+
+    uint32_t count = atomic_load_explicit(&topic_count, memory_order_relaxed);
+    for (uint32_t i = 0; i < count; i++) {
+        if (strcmp(topics[i].name, name) == 0) {
+            topic = &topics[i];
+            break;
+        }
+    }
+
+    if (topic != NULL) {
+        if (strcmp(topic->type, type) != 0 || topic->size != size) {
+            r_log(R_LOG_ERROR, "module %s: topic %s holds %s, not %s\n", props->name, name, topic->type, type);
+            topic = NULL;
+        }
+    } else if (count == MAX_STATE_TOPICS || strlen(name) >= MAX_MODULE_FN_NAME || strlen(type) >= MAX_MODULE_FN_NAME) {
+        r_log(R_LOG_ERROR, "module %s: unable to create topic: %s\n", props->name, name);
+    } else {
+        topic = &topics[count];
+        strcpy(topic->name, name);
+        strcpy(topic->type, type);
+        topic->size = size;
+        topic->version = 0;
+        atomic_init(&topic->current, NULL);
+        atomic_init(&topic->staged, NULL);
+
+        // an advance which sees the topic sees it set up
+        atomic_store_explicit(&topic_count, count + 1, memory_order_release);
+    }
+
+    pthread_mutex_unlock(&topic_lock);
+    return topic;
+}
+
+void * r_state_write(r_state_topic *topic) {
+    r_state_snapshot *snapshot = _snapshot_create(topic);
+    uint64_t          version;
+    const void *      current = r_state_read(topic, &version);
+
+    if (current) {
+        memcpy(PAYLOAD(snapshot), current, topic->size);
+        r_state_release(current);
+    } else {
+        memset(PAYLOAD(snapshot), 0, topic->size);
+    }
+
+    return PAYLOAD(snapshot);
+}
+
+void r_state_publish(r_state_topic *topic, void *payload) {
+    r_state_snapshot *replaced = atomic_exchange_explicit(&topic->staged, SNAPSHOT(payload), memory_order_acq_rel);
+
+    // nobody could have read a snapshot which never became current
+    if (replaced) {
+        _snapshot_destroy(replaced);
+    }
+}
+
+const void * r_state_read(r_state_topic *topic, uint64_t *version) {
+    if (!_enter()) {
+        return NULL;
+    }
+
+    r_state_snapshot *snapshot = atomic_load(&topic->current);
+    if (snapshot == NULL) {
+        _leave();
+        return NULL;
+    }
+
+    if (version) {
+        *version = snapshot->version;
+    }
+    return PAYLOAD(snapshot);
+}
+
+void r_state_release(const void *payload) {
+    if (payload) {
+        _leave();
+    }
+}
+
+void r_state_advance() {
+    pthread_mutex_lock(&advance_lock);
+
+    bool     replaced = false;
+    uint32_t added = atomic_load_explicit(&topic_count, memory_order_acquire);
+    for (uint32_t i = 0; i < added; i++) {
+        r_state_topic *   topic = &topics[i];
+        r_state_snapshot *snapshot = atomic_exchange_explicit(&topic->staged, NULL, memory_order_acquire);
+
+        if (snapshot == NULL) {
+            continue;
+        }
+
+        snapshot->version = ++topic->version;
+        r_state_snapshot *previous = atomic_exchange(&topic->current, snapshot);
+
+        // readers which announced this epoch or an earlier one may still hold it
+        if (previous) {
+            previous->retired = atomic_load(&epoch);
+            previous->next = retired;
+            retired = previous;
+            replaced = true;
+        }
+    }
+
+    if (replaced) {
+        atomic_fetch_add(&epoch, 1);
+    }
+
+    if (retired) {
+        uint64_t oldest = UINT64_MAX;
+        uint32_t count = atomic_load_explicit(&reader_count, memory_order_acquire);
+
+        for (uint32_t i = 0; i < count && i < MAX_STATE_READERS; i++) {
+            uint64_t reading = atomic_load(&readers[i].epoch);
+            if (reading != 0 && reading < oldest) {
+                oldest = reading;
+            }
+        }
+
+        r_state_snapshot **link = &retired;
+        while (*link) {
+            r_state_snapshot *snapshot = *link;
+            if (snapshot->retired < oldest) {
+                *link = snapshot->next;
+                _snapshot_destroy(snapshot);
+            } else {
+                link = &snapshot->next;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&advance_lock);
+}
+
+void r_state_destroy() {
+    uint32_t count = atomic_load(&topic_count);
+    for (uint32_t i = 0; i < count; i++) {
+        r_state_snapshot *current = atomic_exchange(&topics[i].current, NULL);
+        r_state_snapshot *staged = atomic_exchange(&topics[i].staged, NULL);
+
+        if (current) {
+            _snapshot_destroy(current);
+        }
+        if (staged) {
+            _snapshot_destroy(staged);
+        }
+    }
+    atomic_store(&topic_count, 0);
+
+    while (retired) {
+        r_state_snapshot *snapshot = retired;
+        retired = snapshot->next;
+        _snapshot_destroy(snapshot);
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef _STATE_H_
+#define _STATE_H_
+
+// r_state is the shared state store behind r_module_state. Every topic holds
+// its current snapshot behind an atomic pointer. Readers announce the epoch
+// they started reading in, a replaced snapshot is retired with the epoch it
+// was replaced in and freed once every reader has moved past it. Reading
+// takes no locks and never waits for a writer.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "module/interface.h"
+
+#define MAX_STATE_TOPICS  64
+#define MAX_STATE_READERS 256
+
+r_state_topic * r_state_topic_get(r_module_properties *props, const char *name, const char *type, uint32_t size);
+void *          r_state_write(r_state_topic *topic);
+void            r_state_publish(r_state_topic *topic, void *snapshot);
+const void *    r_state_read(r_state_topic *topic, uint64_t *version);
+void            r_state_release(const void *snapshot);
+
+// make the published snapshots current and free those no reader can hold, called at every phase boundary
+void r_state_advance();
+
+void r_state_destroy();
+
+#endif
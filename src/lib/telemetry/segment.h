@@ -0,0 +1,122 @@
+#ifndef _TELEMETRY_SEGMENT_H_
+#define _TELEMETRY_SEGMENT_H_
+
+// Layout of the telemetry shared memory segment, shared by the host which
+// writes it and the readers which attach to it.
+//
+// The segment holds independent metric blocks. Each block is protected by a
+// sequence lock: the host makes the sequence odd, writes, and makes it even
+// again. A reader copies the block and retries if the sequence was odd or
+// changed meanwhile, so neither side ever blocks or enters the kernel.
+//
+// A block's version changes whenever its layout does. Blocks are only ever
+// appended to the segment, readers skip blocks they don't know.
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "module/interface.h"
+
+#define TELEMETRY_MAGIC        0x544C4452   // "RDLT"
+#define TELEMETRY_VERSION      1
+#define TELEMETRY_NAME_FORMAT  "/reload-%d"
+#define TELEMETRY_NAME_LENGTH  64
+#define TELEMETRY_READ_RETRIES 64
+
+typedef struct r_telemetry_block {
+    _Atomic uint32_t sequence;  // odd while the host writes the block
+    uint32_t         version;
+    uint32_t         size;      // including this header
+    uint32_t         pad;
+} r_telemetry_block;
+
+#define TELEMETRY_FRAME_VERSION 1
+typedef struct r_telemetry_frame {
+    r_telemetry_block block;
+    uint64_t          frame;
+    uint64_t          timestamp_ns;
+    float             frame_ms;
+    float             frame_ms_average;     // over the last second
+    float             frame_ms_max;         // over the last second
+    float             pad;
+} r_telemetry_frame;
+
+typedef struct r_telemetry_module {
+    char              name[TELEMETRY_NAME_LENGTH];
+    uint64_t          callback_ns[R_MODULE_PHASE_COUNT];
+    uint64_t          heap_used;
+    uint64_t          raylib_used;  // assets and other raylib allocations charged to the module
+    uint32_t          reloads;
+    uint32_t          pad;
+} r_telemetry_module;
+
+#define TELEMETRY_MODULES_VERSION 2
+typedef struct r_telemetry_modules {
+    r_telemetry_block  block;
+    uint32_t           count;
+    uint32_t           pad;
+    r_telemetry_module modules[MAX_MODULES];
+} r_telemetry_modules;
+
+#define TELEMETRY_MEMORY_VERSION 1
+typedef struct r_telemetry_memory {
+    r_telemetry_block block;
+    uint64_t          allocations;
+    uint64_t          frees;
+    uint64_t          bytes_allocated;
+} r_telemetry_memory;
+
+#define TELEMETRY_DRAW_VERSION 1
+typedef struct r_telemetry_draw {
+    r_telemetry_block block;
+    uint32_t          draw_calls;   // last frame
+    uint32_t          vertices;     // last frame
+} r_telemetry_draw;
+
+typedef struct r_telemetry_segment {
+    uint32_t            magic;
+    uint32_t            version;
+    uint32_t            size;
+    int32_t             pid;
+
+    r_telemetry_frame   frame;
+    r_telemetry_modules modules;
+    r_telemetry_memory  memory;
+    r_telemetry_draw    draw;
+} r_telemetry_segment;
+
+static inline void r_telemetry_write_begin(r_telemetry_block *block) {
+    uint32_t sequence = atomic_load_explicit(&block->sequence, memory_order_relaxed);
+    atomic_store_explicit(&block->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static inline void r_telemetry_write_end(r_telemetry_block *block) {
+    uint32_t sequence = atomic_load_explicit(&block->sequence, memory_order_relaxed);
+    atomic_store_explicit(&block->sequence, sequence + 1, memory_order_release);
+}
+
+// copy a consistent snapshot of a block, false if the host kept writing it
+static inline bool r_telemetry_read(const r_telemetry_block *block, void *copy, uint32_t version, size_t size) {
+    for (uint32_t attempt = 0; attempt < TELEMETRY_READ_RETRIES; attempt++) {
+        uint32_t before = atomic_load_explicit((_Atomic uint32_t *)&block->sequence, memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+
+        if (block->version != version || block->size != size) {
+            return false;
+        }
+        memcpy(copy, block, size);
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit((_Atomic uint32_t *)&block->sequence, memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
@@ -0,0 +1,162 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "rlgl.h"
+
+#include "log/log.h"
+#include "memory/allocator.h"
+#include "memory/heap.h"
+#include "memory/tagged.h"
+#include "telemetry/segment.h"
+#include "telemetry/telemetry.h"
+#include "time/time.h"
+
+// frames averaged for the frame time statistics
+#define TELEMETRY_WINDOW 60
+
+static r_telemetry_segment *segment = NULL;
+static char                 name[TELEMETRY_NAME_LENGTH];
+
+static uint64_t last_time = 0;
+static uint32_t last_draw_calls = 0;
+static uint32_t last_vertices = 0;
+static float    window[TELEMETRY_WINDOW];
+
+static void _block_init(r_telemetry_block *block, uint32_t version, uint32_t size) {
+    atomic_init(&block->sequence, 0);
+    block->version = version;
+    block->size = size;
+    block->pad = 0;
+}
+
+bool r_telemetry_create() {
+    if (segment != NULL) {
+        return true;
+    }
+
+    snprintf(name, sizeof(name), TELEMETRY_NAME_FORMAT, (int)getpid());
+
+    int fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0) {
+        r_log(R_LOG_ERROR, "telemetry: unable to create %s\n", name);
+        return false;
+    }
+
+    if (ftruncate(fd, sizeof(r_telemetry_segment)) != 0) {
+        r_log(R_LOG_ERROR, "telemetry: unable to size %s\n", name);
+        close(fd);
+        shm_unlink(name);
+        return false;
+    }
+
+    void *memory = mmap(NULL, sizeof(r_telemetry_segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (memory == MAP_FAILED) {
+        r_log(R_LOG_ERROR, "telemetry: unable to map %s\n", name);
+        shm_unlink(name);
+        return false;
+    }
+
+    segment = memory;
+    memset(segment, 0, sizeof(r_telemetry_segment));
+
+    _block_init(&segment->frame.block, TELEMETRY_FRAME_VERSION, sizeof(r_telemetry_frame));
+    _block_init(&segment->modules.block, TELEMETRY_MODULES_VERSION, sizeof(r_telemetry_modules));
+    _block_init(&segment->memory.block, TELEMETRY_MEMORY_VERSION, sizeof(r_telemetry_memory));
+    _block_init(&segment->draw.block, TELEMETRY_DRAW_VERSION, sizeof(r_telemetry_draw));
+
+    segment->version = TELEMETRY_VERSION;
+    segment->size = sizeof(r_telemetry_segment);
+    segment->pid = (int32_t)getpid();
+
+    // readers check the magic last
+    atomic_thread_fence(memory_order_release);
+    segment->magic = TELEMETRY_MAGIC;
+
+    last_time = r_time_now_ns();
+    r_log(R_LOG_INFO, "telemetry: publishing to %s\n", name);
+
+    return true;
+}
+
+void r_telemetry_destroy() {
+    if (segment == NULL) {
+        return;
+    }
+
+    munmap(segment, sizeof(r_telemetry_segment));
+    shm_unlink(name);
+    segment = NULL;
+}
+
+void r_telemetry_update(r_module_lifecycle *lifecycle) {
+    if (segment == NULL) {
+        return;
+    }
+
+    uint64_t now = r_time_now_ns();
+    float    frame_ms = (float)(now - last_time) / 1e6f;
+    last_time = now;
+
+    // Frame
+    r_telemetry_frame *frame = &segment->frame;
+    window[frame->frame % TELEMETRY_WINDOW] = frame_ms;
+
+    uint32_t samples = frame->frame + 1 < TELEMETRY_WINDOW ? (uint32_t)frame->frame + 1 : TELEMETRY_WINDOW;
+    float    sum = 0.f;
+    float    max = 0.f;
+    for (uint32_t i = 0; i < samples; i++) {
+        sum += window[i];
+        max = window[i] > max ? window[i] : max;
+    }
+
+    r_telemetry_write_begin(&frame->block);
+    frame->frame++;
+    frame->timestamp_ns = now;
+    frame->frame_ms = frame_ms;
+    frame->frame_ms_average = sum / samples;
+    frame->frame_ms_max = max;
+    r_telemetry_write_end(&frame->block);
+
+    // Modules
+    r_telemetry_modules *modules = &segment->modules;
+    uint32_t             count = r_module_lifecycle_count(lifecycle);
+
+    r_telemetry_write_begin(&modules->block);
+    modules->count = count;
+    for (uint32_t i = 0; i < count; i++) {
+        r_module_interface *interface = r_module_lifecycle_get(lifecycle, i);
+        r_telemetry_module *module = &modules->modules[i];
+
+        snprintf(module->name, sizeof(module->name), "%s", interface->properties.name);
+        memcpy(module->callback_ns, interface->stats.callback_ns, sizeof(module->callback_ns));
+        module->reloads = interface->stats.reloads;
+        module->heap_used = interface->properties.memory.heap ? r_heap_used(interface->properties.memory.heap) : 0;
+        module->raylib_used = r_tagged_get_usage(&interface->properties).bytes;
+    }
+    r_telemetry_write_end(&modules->block);
+
+    // Memory
+    r_mem_stats stats = r_mem_get_stats();
+
+    r_telemetry_write_begin(&segment->memory.block);
+    segment->memory.allocations = stats.allocations;
+    segment->memory.frees = stats.frees;
+    segment->memory.bytes_allocated = stats.bytes_allocated;
+    r_telemetry_write_end(&segment->memory.block);
+
+    // Draw, rlgl counts from initialization
+    uint32_t draw_calls = rlGetDrawCallCount();
+    uint32_t vertices = rlGetDrawVertexCount();
+
+    r_telemetry_write_begin(&segment->draw.block);
+    segment->draw.draw_calls = draw_calls - last_draw_calls;
+    segment->draw.vertices = vertices - last_vertices;
+    r_telemetry_write_end(&segment->draw.block);
+
+    last_draw_calls = draw_calls;
+    last_vertices = vertices;
+}
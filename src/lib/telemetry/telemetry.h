@@ -0,0 +1,18 @@
+#ifndef _TELEMETRY_H_
+#define _TELEMETRY_H_
+
+// r_telemetry publishes the host's metrics in a shared memory segment named
+// after the process (see segment.h). It's updated once a frame without
+// system calls, external tools like build/telemetry attach to it.
+
+#include <stdbool.h>
+
+#include "module/module.h"
+
+bool r_telemetry_create();
+void r_telemetry_destroy();
+
+// publish the metrics of the frame which just finished
+void r_telemetry_update(r_module_lifecycle *lifecycle);
+
+#endif
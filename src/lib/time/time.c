@@ -23,6 +23,12 @@ float _get_time_ms() {
     return (sec + ns);
 }
 
+uint64_t r_time_now_ns() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
 void r_time_init(float fps)  {
     _time = (_r_time){
         .start = {0},
@@ -6,6 +6,9 @@
 // initialise time
 void r_time_init(float fps);
 
+// monotonic time in nanoseconds, doesn't enter the kernel
+uint64_t r_time_now_ns();
+
 // loop helpers
 float r_time_get_delta();
 void r_time_sleep_remaining();
@@ -5,13 +5,30 @@
 
 #include "modules/basic/basic.h"
 
+#include "lib/cluster/cluster.h"
+#include "lib/draw/draw.h"
+#include "lib/io/io.h"
+#include "lib/log/log.h"
+#include "lib/memory/tagged.h"
 #include "lib/module/helper.h"
+#include "lib/module/pipeline.h"
+#include "lib/profile/perf.h"
+#include "lib/profile/profile.h"
+#include "lib/replay/replay.h"
 #include "lib/time/time.h"
 
 #include "ext/raylib/raylib.h"
 
 #define MAX_FPS 60.f
 
+// frames of module state history kept for rewinding, and the page budget for it
+#define SNAPSHOT_FRAMES 300
+#define SNAPSHOT_PAGES  4096
+
+// profiler output, written when profiling is toggled off
+#define PROFILE_FLAT_PATH      "profile.txt"
+#define PROFILE_COLLAPSED_PATH "profile.folded"
+
 static bool finished = false;
 
 void signal_handler(int signum) {
@@ -28,9 +45,137 @@ void signal_handler(int signum) {
     finished = true;
 }
 
+// route raylib's TraceLog through the logger
+void trace_log(int log_type, const char *text, va_list args) {
+    r_log_level level = R_LOG_DEBUG;
+
+    switch (log_type) {
+        case LOG_INFO:    level = R_LOG_INFO; break;
+        case LOG_WARNING: level = R_LOG_WARNING; break;
+        case LOG_ERROR:
+        case LOG_FATAL:   level = R_LOG_ERROR; break;
+        default: break;
+    }
+
+    r_log_v(level, "raylib", text, args);
+
+    if (log_type == LOG_FATAL) {
+        r_log_destroy();
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void handle_keys() {
+    // step the module state back by a second
+    if (IsKeyPressed(KEY_F9)) {
+        r_module_rewind("basic", (uint32_t)MAX_FPS);
+    }
+
+    // toggle the sampling profiler, stopping writes the report
+    if (IsKeyPressed(KEY_F10)) {
+        if (r_profile_running()) {
+            r_profile_stop();
+            r_profile_report(PROFILE_FLAT_PATH, PROFILE_COLLAPSED_PATH);
+            r_profile_clear();
+        } else {
+            r_profile_start(0);
+        }
+    }
+}
+
+static void frame(float delta_time) {
+    handle_keys();
+
+    r_module_pre_frame(delta_time);
+
+    BeginDrawing();
+    ClearBackground(RAYWHITE);
+
+    r_module_update(delta_time);
+
+    // draw the lists the modules recorded, before the UI on top of them
+    r_draw_frame_end();
+    r_draw_replay();
+
+    r_module_ui_update(delta_time);
+
+    EndDrawing();
+
+    r_module_post_frame(delta_time);
+}
+
+// the frame simulated during the previous iteration is drawn while the next
+// one is simulated on the pipeline thread
+static void frame_pipelined(float delta_time) {
+    // hand-off: nothing runs besides the main thread until the next kick, so
+    // rewinds and reloads are safe here
+    r_module_pipeline_wait();
+    r_draw_frame_end();
+
+    handle_keys();
+
+    r_module_post_frame(delta_time);
+
+    r_module_pipeline_kick(delta_time);
+
+    BeginDrawing();
+    ClearBackground(RAYWHITE);
+
+    r_draw_replay();
+
+    r_module_ui_update(delta_time);
+
+    EndDrawing();
+}
+
 int main(int argc, const char* argv[]) {
 
-    printf("Starting Reload ...\n");
+    // start logging before anything else
+    r_log_create(NULL);
+    SetTraceLogCallback(trace_log);
+
+    // charge raylib's allocations to the module making them, before raylib allocates anything
+    r_tagged_hook_raylib();
+
+    r_log(R_LOG_INFO, "Starting Reload ...\n");
+
+    // --pipelined simulates the next frame while the current one is drawn
+    // --cluster shares one build between the instances started from this directory
+    // --record <log> saves every frame's delta times and input
+    // --replay <log> plays them back hidden and uncapped, --profile <csv> gets the frame times
+    bool pipelined = false;
+    bool cluster = false;
+    const char *record_path = NULL;
+    const char *replay_path = NULL;
+    const char *profile_path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--pipelined") == 0) {
+            pipelined = true;
+        } else if (strcmp(argv[i], "--cluster") == 0) {
+            cluster = true;
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profile_path = argv[++i];
+        }
+    }
+
+    // a recording holds one frame's phases in order, the pipeline overlaps two frames
+    if (pipelined && (record_path != NULL || replay_path != NULL)) {
+        r_log(R_LOG_WARNING, "Recording and replaying run without the pipeline\n");
+        pipelined = false;
+    }
+
+    if (cluster) {
+        r_cluster_join(NULL);
+    }
+
+    // describe the module images to linux perf, e.g. RELOAD_PERF=1 perf record -k mono ...
+    if (getenv("RELOAD_PERF") != NULL) {
+        r_perf_create();
+    }
 
     r_time_init(MAX_FPS);
 
@@ -41,40 +186,76 @@ int main(int argc, const char* argv[]) {
     // Create module lifecycle and filetracker
     r_module_create();
 
-    // register basic module
+    // raylib's file loading goes through the I/O service
+    r_io_hook_raylib();
+
+    // register the modules, they're loaded together once they're all declared
+    r_module_load_begin();
     r_module_add("basic");
+    r_module_snapshot_enable("basic", SNAPSHOT_FRAMES, SNAPSHOT_PAGES);
 
+    // RELOAD_TIMELINE=startup.json writes a trace of the startup for chrome://tracing
+    r_module_load_end(getenv("RELOAD_TIMELINE"));
+
+
+    if (replay_path != NULL) {
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    }
 
     InitWindow(800, 450, "Reload");
     SetTargetFPS(MAX_FPS);   
-    // loop until we're finished
-    while (!finished && !WindowShouldClose()) {
 
-        float delta_time = r_time_get_delta();
+    // a replay runs on the recorded clock, as fast as the frames go
+    if (replay_path != NULL) {
+        finished = !r_replay_play(replay_path, profile_path, r_module_build());
+        SetTargetFPS(0);
+    } else if (record_path != NULL) {
+        r_replay_record(record_path, r_module_build());
+    }
 
-        r_module_pre_frame(delta_time);
+    if (pipelined && !r_module_pipeline_create()) {
+        pipelined = false;
+    }
 
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
+    // loop until we're finished
+    while (!finished && !WindowShouldClose()) {
 
-        r_module_update(delta_time);
+        float delta_time = r_time_get_delta();
 
-        r_module_ui_update(delta_time);
+        // raylib polled the input at the end of the last frame
+        if (!r_replay_frame_begin()) {
+            break;
+        }
 
-        EndDrawing();
+        if (pipelined) {
+            frame_pipelined(delta_time);
+        } else {
+            frame(delta_time);
+        }
 
-        r_module_post_frame(delta_time);
+        r_replay_frame_end();
 
         // r_time_sleep_remaining();
     }
 
-    CloseWindow();
+    // the last simulated frame is never drawn
+    r_module_pipeline_destroy();
 
-    // Clean up modules
+    r_replay_stop();
+
+    // Clean up modules, their textures and shaders need the GL context
     r_module_destroy();
+
+    CloseWindow();
+    r_cluster_leave();
     
     // Load the library
-    printf("Reload finished.\n");
+    r_log(R_LOG_INFO, "Reload finished.\n");
+
+    r_perf_destroy();
+
+    // write out the remaining messages
+    r_log_destroy();
 
     return 0;
 }
@@ -3,7 +3,9 @@
 
 #include "raylib/raylib.h"
 
+#include "draw/commands.h"
 #include "memory/allocator.h"
+#include "module/tweak.h"
 
 
 #include "basic.h"
@@ -23,18 +25,18 @@ typedef struct entity_t {
     int     type;
 } entity_t;
 
-void _draw_entity(entity_t *entity) {
+void _draw_entity(r_draw_list *list, entity_t *entity) {
     switch(entity->type) {
         case ENTITY_TYPE_CUBE:
-            DrawCube(entity->position, entity->dim.x, entity->dim.y, entity->dim.z, entity->colour);
-            DrawCubeWires(entity->position, entity->dim.x, entity->dim.y, entity->dim.z, BLACK);
+            r_draw_cube(list, entity->position, entity->dim, entity->colour);
+            r_draw_cube_wires(list, entity->position, entity->dim, BLACK);
             break;
         case ENTITY_TYPE_SPHERE:
-            DrawSphere(entity->position, entity->dim.x, entity->colour);
-            DrawSphereWires(entity->position, entity->dim.x, 16, 16, BLACK);
+            r_draw_sphere(list, entity->position, entity->dim.x, 16, 16, entity->colour);
+            r_draw_sphere_wires(list, entity->position, entity->dim.x, 16, 16, BLACK);
             break;
         case ENTITY_TYPE_PLANE:
-            DrawPlane(entity->position, (Vector2){entity->dim.x, entity->dim.y}, entity->colour);
+            r_draw_plane(list, entity->position, (Vector2){entity->dim.x, entity->dim.y}, entity->colour);
             break;
         default:
             break;
@@ -88,8 +90,8 @@ bool init(r_module_properties *props) {
     
     _mem = _basic_int_create(props);
     props->memory.p_mem = (void *)_mem;
-    props->memory.create = _basic_int_create;
-    props->memory.destroy = _basic_int_destroy;
+    MBIND(props->memory.create, _basic_int_create);
+    MBIND(props->memory.destroy, _basic_int_destroy);
     // alloc and free - already set
 
     for (int i = 0; i < 4; i++) {
@@ -122,7 +124,9 @@ bool update(r_module_properties *props, float delta_time) {
     static float el = 0.f;
     el += delta_time;
     
-    if (_cursor_locked) {
+    // _cursor_locked belongs to ui_update, which may run alongside this on
+    // another thread, raylib's input state tells the same
+    if (IsCursorHidden()) {
         UpdateCamera(&_mem->camera, CAMERA_FREE);
     }    
 
@@ -133,19 +137,23 @@ bool update(r_module_properties *props, float delta_time) {
 
     }
 
-    BeginMode3D(_mem->camera);
-    DrawGrid(10, 1.0f);
+    // recorded here, replayed by the host on the main thread
+    r_draw_list *list = props->draw.begin(props, 0);
+
+    r_draw_begin_mode_3d(list, _mem->camera);
+    r_draw_grid(list, 10, 1.0f);
 
     // Vector3 cubePosition = { 0.0f, 0.0f, 0.0f };
 
     for (int i = 0; i < _mem->_entity_count; i++) {
-        _draw_entity(&_mem->_entities[i]);
+        _draw_entity(list, &_mem->_entities[i]);
     }
 
     // DrawCube(cubePosition, 2.0f, 2.0f, 2.0f, RED);
     // DrawCubeWires(cubePosition, 2.0f, 2.0f, 2.0f, MAROON);
 
-    EndMode3D();
+    r_draw_end_mode_3d(list);
+    props->draw.submit(list);
 
     return true;
 }
@@ -154,19 +162,22 @@ bool ui_update(r_module_properties *props, float delta_time) {
     // animate the text across the screen
     static int xPos = 0;
 
-    int speed = 200;
+    int speed = TWEAK_INT(200);
 
     xPos += (int)(speed * (delta_time/1000.0f));
 
     if (xPos > 800) {
         xPos = 10;
     }
-    char text[100];
-    sprintf(text, "From Basic! [%d] [%f]", xPos, delta_time);
+    char *text = TMALLOC(char, 100);
+    if (text) {
+        snprintf(text, 100, "From Basic! [%d] [%f]", xPos, delta_time);
+    }
 
     DrawText("Smoother", xPos, 300, 20, LIGHTGRAY);
     
-    float ballSpeed = 2.f;
+    float ballSpeed = TWEAK_FLOAT(2.f);
+    (void)ballSpeed;
 
     // if (IsKeyDown(KEY_RIGHT)) _mem->ballPosition.x += ballSpeed;
     // if (IsKeyDown(KEY_LEFT)) _mem->ballPosition.x -= ballSpeed;
@@ -195,6 +206,8 @@ bool ui_update(r_module_properties *props, float delta_time) {
 
 
     DrawFPS(10, 10);
+
+    return true;
 }
 
 bool post_frame(r_module_properties *props, float delta_time) {
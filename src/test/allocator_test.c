@@ -0,0 +1,300 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "memory/allocator.h"
+#include "memory/heap.h"
+#include "memory/tagged.h"
+#include "memory/transient.h"
+#include "module/context.h"
+#include "module/persistent.h"
+#include "test/allocator_test.h"
+
+#define BENCH_BATCH 256
+
+#define HEAP_RESERVE (16 * 1024 * 1024)
+#define HEAP_THREADS 4
+#define HEAP_ROUNDS  20000
+
+// Tests
+// -----
+
+static void _test_malloc_stats(r_test *test) {
+    r_mem_stats before = r_mem_get_stats();
+
+    void *a = r_malloc("a", 16);
+    void *b = r_malloc("b", 100);
+    TEST_CHECK(test, a != NULL && b != NULL);
+
+    r_mem_stats allocated = r_mem_get_stats();
+    TEST_CHECK(test, allocated.allocations == before.allocations + 2);
+    TEST_CHECK(test, allocated.bytes_allocated == before.bytes_allocated + 116);
+
+    r_free("a", a);
+    r_free("b", b);
+    r_free("none", NULL);
+
+    r_mem_stats freed = r_mem_get_stats();
+    TEST_CHECK(test, freed.frees == before.frees + 2);
+}
+
+static void _test_tagged_owner(r_test *test) {
+    r_module_properties owner = { .name = "allocator_test_owner" };
+    r_module_properties other = { .name = "allocator_test_other" };
+
+    // charged to whichever module is running
+    r_module_context_set(&owner);
+    void *small = r_tagged_malloc(24);
+    void *large = r_tagged_malloc(TAGGED_MAX_POOLED * 4);
+    r_module_context_set(NULL);
+
+    r_tagged_usage usage = r_tagged_get_usage(&owner);
+    TEST_CHECK(test, usage.blocks == 2);
+    TEST_CHECK(test, usage.bytes == 24 + TAGGED_MAX_POOLED * 4);
+
+    // resizing keeps the owner, even from elsewhere
+    small = r_tagged_realloc(small, 3000);
+    TEST_CHECK(test, r_tagged_get_usage(&owner).bytes == 3000 + TAGGED_MAX_POOLED * 4);
+
+    r_tagged_adopt(large, &other);
+    TEST_CHECK(test, r_tagged_get_usage(&owner).blocks == 1);
+    TEST_CHECK(test, r_tagged_get_usage(&other).bytes == TAGGED_MAX_POOLED * 4);
+
+    r_tagged_free(small);
+    r_tagged_free(large);
+    TEST_CHECK(test, r_tagged_get_usage(&owner).blocks == 0);
+    TEST_CHECK(test, r_tagged_get_usage(&other).blocks == 0);
+    TEST_CHECK(test, !r_tagged_report(&owner));
+}
+
+static void _test_tagged_blocks(r_test *test) {
+    // every size class and the large blocks come back aligned and usable
+    for (size_t size = 0; size < TAGGED_MAX_POOLED * 2; size = size * 2 + 1) {
+        uint8_t *block = r_tagged_malloc(size);
+
+        if (TEST_CHECK(test, block != NULL)) {
+            TEST_CHECK(test, ((uintptr_t)block & 15) == 0);
+            memset(block, 0xA5, size);
+            r_tagged_free(block);
+        }
+    }
+
+    uint8_t *zeroed = r_tagged_calloc(33, 7);
+    bool     clear = zeroed != NULL;
+    for (size_t i = 0; clear && i < 33 * 7; i++) {
+        clear = zeroed[i] == 0;
+    }
+    TEST_CHECK(test, clear);
+    r_tagged_free(zeroed);
+
+    // growing keeps the contents
+    uint8_t *grown = r_tagged_malloc(10);
+    memcpy(grown, "abcdefghij", 10);
+    grown = r_tagged_realloc(grown, 10000);
+    TEST_CHECK(test, grown != NULL && memcmp(grown, "abcdefghij", 10) == 0);
+    r_tagged_free(grown);
+
+    TEST_CHECK(test, r_tagged_calloc(SIZE_MAX / 2, 4) == NULL);
+}
+
+static void * _heap_churn(void *heap) {
+    for (int i = 0; i < HEAP_ROUNDS; i++) {
+        uint8_t *block = r_heap_alloc(heap, (size_t)(i % 200) + 1);
+        if (block == NULL) {
+            return NULL;
+        }
+        block[0] = (uint8_t)i;
+        r_heap_free(heap, block);
+    }
+    return heap;
+}
+
+static void _test_heap_threads(r_test *test) {
+    r_heap *  heap = r_heap_create(HEAP_RESERVE);
+    pthread_t threads[HEAP_THREADS];
+    void *    results[HEAP_THREADS];
+
+    if (!TEST_CHECK(test, heap != NULL)) {
+        return;
+    }
+
+    for (int i = 0; i < HEAP_THREADS; i++) {
+        pthread_create(&threads[i], NULL, _heap_churn, heap);
+    }
+    for (int i = 0; i < HEAP_THREADS; i++) {
+        pthread_join(threads[i], &results[i]);
+        TEST_CHECK(test, results[i] == heap);
+    }
+
+    // every block came back, so the free list merged into one
+    TEST_CHECK(test, r_heap_used(heap) == 0);
+    void *whole = r_heap_alloc(heap, HEAP_RESERVE / 2);
+    TEST_CHECK(test, whole != NULL);
+    r_heap_free(heap, whole);
+
+    r_heap_destroy(heap);
+}
+
+static void _test_heap_snapshot(r_test *test) {
+    size_t   page = (size_t)sysconf(_SC_PAGESIZE);
+    r_heap * heap = r_heap_create(HEAP_RESERVE);
+    uint8_t *data = heap ? r_heap_alloc(heap, page * 4) : NULL;
+
+    if (!TEST_CHECK(test, data != NULL)) {
+        return;
+    }
+    memset(data, 1, page * 4);
+
+    // the pool holds two pages
+    TEST_CHECK(test, r_heap_snapshot_enable(heap, 4, 2));
+    data[0] = 2;
+    TEST_CHECK(test, r_heap_snapshot_commit(heap));
+    TEST_CHECK(test, r_heap_snapshot_frames(heap) == 1);
+
+    data[0] = 3;
+    TEST_CHECK(test, r_heap_snapshot_rewind(heap, 1));
+    TEST_CHECK(test, data[0] == 1);
+
+    // a frame writing more pages than that drops the history and reports it
+    for (int i = 0; i < 4; i++) {
+        data[page * i] = 4;
+    }
+    TEST_CHECK(test, !r_heap_snapshot_commit(heap));
+    TEST_CHECK(test, r_heap_snapshot_frames(heap) == 0);
+    TEST_CHECK(test, data[0] == 4 && data[page * 3] == 4);
+
+    // and tracking picks up again
+    data[page * 3] = 5;
+    TEST_CHECK(test, r_heap_snapshot_commit(heap));
+    TEST_CHECK(test, r_heap_snapshot_rewind(heap, 1));
+    TEST_CHECK(test, data[page * 3] == 4);
+
+    r_heap_destroy(heap);
+}
+
+static void _test_persistent_free(r_test *test) {
+    r_module_properties owner = { .name = "allocator_test_owner", .memory.heap = r_heap_create(HEAP_RESERVE) };
+
+    if (!TEST_CHECK(test, owner.memory.heap != NULL)) {
+        return;
+    }
+
+    // allocated outside of a callback and freed inside one goes back to r_free
+    void *outside = r_module_persistent_allocate("outside", 32);
+    TEST_CHECK(test, r_heap_find(outside) == NULL);
+    r_mem_stats before = r_mem_get_stats();
+    r_module_context_set(&owner);
+    r_module_persistent_free("outside", outside);
+    r_module_context_set(NULL);
+    TEST_CHECK(test, r_mem_get_stats().frees == before.frees + 1);
+
+    // and the reverse goes back to the heap
+    r_module_context_set(&owner);
+    void *inside = r_module_persistent_allocate("inside", 32);
+    r_module_context_set(NULL);
+    TEST_CHECK(test, r_heap_find(inside) == owner.memory.heap);
+    r_module_persistent_free("inside", inside);
+    TEST_CHECK(test, r_heap_used(owner.memory.heap) == 0);
+
+    r_heap_destroy(owner.memory.heap);
+}
+
+static void _test_transient_frames(r_test *test) {
+    r_transient_next_frame();
+
+    char *text = r_transient_alloc(64);
+    if (!TEST_CHECK(test, text != NULL)) {
+        return;
+    }
+    memset(text, 'a', 64);
+
+    // still valid through the following frame
+    r_transient_next_frame();
+    TEST_CHECK(test, text[0] == 'a' && text[63] == 'a');
+
+#ifdef _DEBUG
+    // poisoned at the frame boundary, without this thread allocating again
+    r_transient_next_frame();
+    TEST_CHECK(test, (uint8_t)text[0] == TRANSIENT_POISON && (uint8_t)text[63] == TRANSIENT_POISON);
+#endif
+
+    r_transient_destroy();
+}
+
+// Benchmarks
+// ----------
+
+// allocate a batch then free it, throughput counts the bytes handed out
+static void _bench_batch(r_bench *bench, size_t size, void * (*allocate)(size_t), void (*release)(void *)) {
+    void *blocks[BENCH_BATCH];
+
+    bench->bytes = size;
+    for (uint64_t i = 0; i < bench->iterations; i += BENCH_BATCH) {
+        uint64_t count = bench->iterations - i < BENCH_BATCH ? bench->iterations - i : BENCH_BATCH;
+
+        for (uint64_t j = 0; j < count; j++) {
+            blocks[j] = allocate(size);
+            BENCH_KEEP(blocks[j]);
+        }
+        for (uint64_t j = 0; j < count; j++) {
+            release(blocks[j]);
+        }
+    }
+}
+
+static void * _r_malloc(size_t size) {
+    return r_malloc("bench", size);
+}
+
+static void _r_free(void *ptr) {
+    r_free("bench", ptr);
+}
+
+static void _bench_libc_64(r_bench *bench) {
+    _bench_batch(bench, 64, malloc, free);
+}
+
+static void _bench_r_malloc_64(r_bench *bench) {
+    _bench_batch(bench, 64, _r_malloc, _r_free);
+}
+
+static void _bench_tagged_64(r_bench *bench) {
+    _bench_batch(bench, 64, r_tagged_malloc, r_tagged_free);
+}
+
+static void _bench_tagged_1k(r_bench *bench) {
+    _bench_batch(bench, 1024, r_tagged_malloc, r_tagged_free);
+}
+
+static void _bench_tagged_64k(r_bench *bench) {
+    _bench_batch(bench, 64 * 1024, r_tagged_malloc, r_tagged_free);
+}
+
+static const r_test_case tests[] = {
+    { "malloc_stats", _test_malloc_stats },
+    { "tagged_owner", _test_tagged_owner },
+    { "tagged_blocks", _test_tagged_blocks },
+    { "heap_threads", _test_heap_threads },
+    { "heap_snapshot", _test_heap_snapshot },
+    { "persistent_free", _test_persistent_free },
+    { "transient_frames", _test_transient_frames },
+    { NULL },
+};
+
+static const r_bench_case benches[] = {
+    { "libc_64", _bench_libc_64 },
+    { "r_malloc_64", _bench_r_malloc_64 },
+    { "tagged_64", _bench_tagged_64 },
+    { "tagged_1k", _bench_tagged_1k },
+    { "tagged_64k", _bench_tagged_64k },
+    { NULL },
+};
+
+r_test_suite r_allocator_test_setup() {
+    return (r_test_suite){
+        .name = "allocator",
+        .tests = tests,
+        .benches = benches,
+    };
+}
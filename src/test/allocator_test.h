@@ -0,0 +1,8 @@
+#ifndef _TEST_ALLOCATOR_TEST_H_
+#define _TEST_ALLOCATOR_TEST_H_
+
+#include "test/test.h"
+
+r_test_suite r_allocator_test_setup();
+
+#endif
@@ -0,0 +1,590 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "asset/asset.h"
+#include "asset/cache.h"
+#include "job/job.h"
+#include "test/asset_test.h"
+#include "time/time.h"
+
+#define HASH_BENCH_SIZE    (1024 * 1024)
+#define ASSET_TEST_SOUNDS  3
+#define ASSET_TEST_WORKERS 2
+#define CHECK_MS           (CHECK_FREQUENCY_S * 1000.f)
+#define WAIT_ASSETS_MS     3000
+
+typedef struct r_asset_fixture {
+    char root[64];
+    char cache[96];
+    char texture[96];
+    char material[96];
+    char gltf[96];
+    char buffer[96];
+    char sounds[ASSET_TEST_SOUNDS][96];
+
+    r_filetracker *filetracker;
+} r_asset_fixture;
+
+static bool _fixture_create(r_asset_fixture *fixture) {
+    if (!r_test_dir_create(fixture->root, sizeof(fixture->root), "asset")) {
+        return false;
+    }
+
+    snprintf(fixture->cache, sizeof(fixture->cache), "%s/cache/assets", fixture->root);
+    snprintf(fixture->texture, sizeof(fixture->texture), "%s/texture.png", fixture->root);
+    snprintf(fixture->material, sizeof(fixture->material), "%s/texture.mtl", fixture->root);
+    snprintf(fixture->gltf, sizeof(fixture->gltf), "%s/triangle.gltf", fixture->root);
+    snprintf(fixture->buffer, sizeof(fixture->buffer), "%s/triangle.bin", fixture->root);
+    r_test_write(fixture->texture, "texture");
+    r_test_write(fixture->material, "material");
+
+    return r_asset_cache_create(fixture->cache);
+}
+
+static void _fixture_destroy(r_asset_fixture *fixture) {
+    r_asset_cache_destroy();
+    r_test_dir_destroy(fixture->root);
+}
+
+// sounds upload without a GL context, they stand in for every type
+static void _write_sound(const char *path, unsigned int frames) {
+    Wave wave = { .frameCount = frames, .sampleRate = 48000, .sampleSize = 16, .channels = 1 };
+
+    wave.data = MemAlloc(frames * sizeof(short));
+    ExportWave(wave, path);
+    MemFree(wave.data);
+}
+
+// the asset system with its own job workers and filetracker, and a cache in the fixture
+static bool _assets_create(r_asset_fixture *fixture) {
+    if (!_fixture_create(fixture)) {
+        return false;
+    }
+
+    for (int i = 0; i < ASSET_TEST_SOUNDS; i++) {
+        snprintf(fixture->sounds[i], sizeof(fixture->sounds[i]), "%s/sound%d.wav", fixture->root, i);
+        _write_sound(fixture->sounds[i], 1000 * (i + 1));
+    }
+
+    InitAudioDevice();
+    r_job_system_create(ASSET_TEST_WORKERS);
+    fixture->filetracker = r_filetracker_create();
+    r_asset_create(fixture->filetracker);
+
+    r_asset_cache_destroy();
+    return IsAudioDeviceReady() && r_asset_cache_create(fixture->cache);
+}
+
+static void _assets_destroy(r_asset_fixture *fixture) {
+    // the budgets outlive the asset system, the next test gets the default
+    r_asset_set_budget(R_ASSET_SOUND, ASSET_SOUND_BUDGET);
+    r_asset_destroy();
+    r_filetracker_destroy(fixture->filetracker);
+    r_job_system_destroy();
+    CloseAudioDevice();
+    _fixture_destroy(fixture);
+}
+
+// run updates until the asset is at version, reloads wait for the filetracker to see the file
+static bool _update_until(r_asset_fixture *fixture, r_asset *asset, uint32_t version, uint64_t budget_ns) {
+    uint64_t start = r_time_now_ns();
+    uint32_t current = 0;
+
+    while (r_time_now_ns() - start < WAIT_ASSETS_MS * 1000000ull) {
+        r_filetracker_check(fixture->filetracker, CHECK_MS);
+        r_asset_update(budget_ns);
+
+        r_asset_get(asset, &current);
+        if (current >= version) {
+            return current == version;
+        }
+        usleep(10 * 1000);
+    }
+    return false;
+}
+
+static unsigned int _frames(r_asset *asset) {
+    const Sound *sound = r_asset_get(asset, NULL);
+    return sound ? sound->frameCount : 0;
+}
+
+// the bytes a loaded sound counts against its budget
+static uint64_t _bytes(r_asset *asset) {
+    const Sound *sound = r_asset_get(asset, NULL);
+    return sound ? (uint64_t)sound->frameCount * sound->stream.channels * (sound->stream.sampleSize / 8) : 0;
+}
+
+// updates which use nothing, so every asset ages
+static void _idle(uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        r_asset_update(ASSET_UPLOAD_BUDGET_NS);
+    }
+}
+
+// a 4x4 image with its mip chain, every byte tells where it is
+static Image _image() {
+    Image image = {
+        .width = 4,
+        .height = 4,
+        .mipmaps = 3,
+        .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,
+    };
+    int size = (4 * 4 + 2 * 2 + 1 * 1) * 4;
+
+    image.data = MemAlloc(size);
+    for (int i = 0; i < size; i++) {
+        ((unsigned char *)image.data)[i] = (unsigned char)i;
+    }
+    return image;
+}
+
+// a glTF triangle whose vertices are in a buffer file next to it, raylib expects normals
+static void _write_gltf(r_asset_fixture *fixture) {
+    const float vertices[] = {
+        0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f,
+        0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 0.f, 0.f, 1.f,
+    };
+
+    FILE *file = fopen(fixture->buffer, "wb");
+    if (file) {
+        fwrite(vertices, sizeof(vertices), 1, file);
+        fclose(file);
+    }
+
+    r_test_write(fixture->gltf,
+        "{\"asset\":{\"version\":\"2.0\"},"
+        "\"buffers\":[{\"uri\":\"triangle.bin\",\"byteLength\":72}],"
+        "\"bufferViews\":[{\"buffer\":0,\"byteLength\":72}],"
+        "\"accessors\":[{\"bufferView\":0,\"componentType\":5126,\"count\":3,\"type\":\"VEC3\",\"min\":[0,0,0],\"max\":[1,1,0]},"
+        "{\"bufferView\":0,\"byteOffset\":36,\"componentType\":5126,\"count\":3,\"type\":\"VEC3\"}],"
+        "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1}}]}],"
+        "\"nodes\":[{\"mesh\":0}],\"scenes\":[{\"nodes\":[0]}],\"scene\":0}");
+}
+
+// bake the texture with what a decode reading the material along with it captures
+static bool _write_texture(r_asset_fixture *fixture, uint64_t key, bool with_material) {
+    r_asset_data               data = { .image = _image() };
+    r_asset_cache_dependencies dependencies;
+    unsigned int               size = 0;
+
+    r_asset_cache_capture_begin(&dependencies, fixture->texture);
+    UnloadFileData(LoadFileData(fixture->texture, &size));
+    if (with_material) {
+        UnloadFileData(LoadFileData(fixture->material, &size));
+    }
+    r_asset_cache_capture_end(&dependencies);
+
+    bool written = dependencies.count == (with_material ? 1 : 0) && r_asset_cache_write(key, R_ASSET_TEXTURE, &data, &dependencies);
+    r_asset_cache_dependencies_free(&dependencies);
+    UnloadImage(data.image);
+    return written;
+}
+
+// Tests
+// -----
+
+static void _test_cache_texture(r_test *test) {
+    r_asset_fixture fixture;
+    if (!TEST_CHECK(test, _fixture_create(&fixture))) {
+        return;
+    }
+
+    uint64_t key = r_asset_cache_key(fixture.texture, R_ASSET_TEXTURE, 0);
+    TEST_CHECK(test, key != 0);
+    TEST_CHECK(test, key != r_asset_cache_key(fixture.texture, R_ASSET_FONT, 0));
+    TEST_CHECK(test, r_asset_cache_key(fixture.material, R_ASSET_FONT, 16) != r_asset_cache_key(fixture.material, R_ASSET_FONT, 24));
+
+    r_asset_data data;
+    TEST_CHECK(test, !r_asset_cache_read(key, R_ASSET_TEXTURE, &data));
+    TEST_CHECK(test, _write_texture(&fixture, key, false));
+
+    // the mip chain comes back as it was baked
+    Image expected = _image();
+    if (TEST_CHECK(test, r_asset_cache_read(key, R_ASSET_TEXTURE, &data))) {
+        TEST_CHECK(test, data.image.width == 4 && data.image.height == 4);
+        TEST_CHECK(test, data.image.mipmaps == 3);
+        TEST_CHECK(test, data.image.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        TEST_CHECK(test, memcmp(data.image.data, expected.data, (4 * 4 + 2 * 2 + 1) * 4) == 0);
+        UnloadImage(data.image);
+    }
+    UnloadImage(expected);
+
+    // an entry of another type under the same key isn't used
+    TEST_CHECK(test, !r_asset_cache_read(key, R_ASSET_SOUND, &data));
+
+    // an edit changes the key
+    r_test_write(fixture.texture, "texture, edited");
+    TEST_CHECK(test, r_asset_cache_key(fixture.texture, R_ASSET_TEXTURE, 0) != key);
+
+    _fixture_destroy(&fixture);
+}
+
+static void _test_cache_dependencies(r_test *test) {
+    r_asset_fixture fixture;
+    if (!TEST_CHECK(test, _fixture_create(&fixture))) {
+        return;
+    }
+
+    uint64_t     key = r_asset_cache_key(fixture.texture, R_ASSET_TEXTURE, 0);
+    r_asset_data data;
+
+    TEST_CHECK(test, _write_texture(&fixture, key, true));
+    if (TEST_CHECK(test, r_asset_cache_read(key, R_ASSET_TEXTURE, &data))) {
+        UnloadImage(data.image);
+    }
+
+    // the asset's own file is the same, one it read isn't
+    r_test_write(fixture.material, "material, edited");
+    TEST_CHECK(test, r_asset_cache_key(fixture.texture, R_ASSET_TEXTURE, 0) == key);
+    TEST_CHECK(test, !r_asset_cache_read(key, R_ASSET_TEXTURE, &data));
+
+    _fixture_destroy(&fixture);
+}
+
+static void _test_cache_gltf_buffers(r_test *test) {
+    r_asset_fixture fixture;
+    if (!TEST_CHECK(test, _fixture_create(&fixture))) {
+        return;
+    }
+    _write_gltf(&fixture);
+
+    // the buffers cgltf reads are files the entry depends on
+    r_asset_cache_dependencies dependencies;
+    r_asset_cache_capture_begin(&dependencies, fixture.gltf);
+    ModelData model = LoadModelData(fixture.gltf);
+    r_asset_cache_capture_end(&dependencies);
+
+    TEST_CHECK(test, model.model.meshCount == 1);
+    if (TEST_CHECK(test, dependencies.count == 1)) {
+        TEST_CHECK(test, strcmp(dependencies.files[0].path, fixture.buffer) == 0);
+    }
+
+    uint64_t key = r_asset_cache_key(fixture.gltf, R_ASSET_MODEL, 0);
+    r_asset_data data = { .model = model };
+    TEST_CHECK(test, r_asset_cache_write(key, R_ASSET_MODEL, &data, &dependencies));
+    r_asset_cache_dependencies_free(&dependencies);
+    UnloadModelData(model);
+
+    // so an edit to the buffer alone is noticed
+    if (TEST_CHECK(test, r_asset_cache_read(key, R_ASSET_MODEL, &data))) {
+        UnloadModelData(data.model);
+    }
+    r_test_write(fixture.buffer, "not the same vertices, not at all");
+    TEST_CHECK(test, !r_asset_cache_read(key, R_ASSET_MODEL, &data));
+
+    _fixture_destroy(&fixture);
+}
+
+static void _test_cache_truncated(r_test *test) {
+    r_asset_fixture fixture;
+    if (!TEST_CHECK(test, _fixture_create(&fixture))) {
+        return;
+    }
+
+    uint64_t key = r_asset_cache_key(fixture.texture, R_ASSET_TEXTURE, 0);
+    TEST_CHECK(test, _write_texture(&fixture, key, false));
+
+    char entry[160];
+    snprintf(entry, sizeof(entry), "%s/%016llx.asset", fixture.cache, (unsigned long long)key);
+    TEST_CHECK(test, truncate(entry, 100) == 0);
+
+    r_asset_data data;
+    TEST_CHECK(test, !r_asset_cache_read(key, R_ASSET_TEXTURE, &data));
+
+    _fixture_destroy(&fixture);
+}
+
+static void _test_cache_prune(r_test *test) {
+    r_asset_fixture fixture;
+    if (!TEST_CHECK(test, _fixture_create(&fixture))) {
+        return;
+    }
+
+    // three entries baked a while apart, a read brings the oldest back into use
+    char     entries[3][160];
+    uint64_t key = r_asset_cache_key(fixture.texture, R_ASSET_TEXTURE, 0);
+    for (uint64_t i = 0; i < 3; i++) {
+        TEST_CHECK(test, _write_texture(&fixture, key + i, false));
+        snprintf(entries[i], sizeof(entries[i]), "%s/%016llx.asset", fixture.cache, (unsigned long long)(key + i));
+        r_test_touch(entries[i], 1000000 * (time_t)(i + 1));
+    }
+
+    r_asset_data data;
+    if (TEST_CHECK(test, r_asset_cache_read(key, R_ASSET_TEXTURE, &data))) {
+        UnloadImage(data.image);
+    }
+
+    struct stat statbuf;
+    TEST_CHECK(test, stat(entries[0], &statbuf) == 0);
+
+    // room for two, the one used least recently goes
+    TEST_CHECK(test, r_asset_cache_prune(2 * (uint64_t)statbuf.st_size) == 1);
+    TEST_CHECK(test, access(entries[0], F_OK) == 0);
+    TEST_CHECK(test, access(entries[1], F_OK) != 0);
+    TEST_CHECK(test, access(entries[2], F_OK) == 0);
+    TEST_CHECK(test, r_asset_cache_prune(2 * (uint64_t)statbuf.st_size) == 0);
+
+    _fixture_destroy(&fixture);
+}
+
+static void _test_asset_shared(r_test *test) {
+    r_asset_fixture fixture;
+    if (!TEST_CHECK(test, _assets_create(&fixture))) {
+        _assets_destroy(&fixture);
+        return;
+    }
+
+    // the same file shares one handle, another file gets its own
+    r_asset *sound = r_asset_load(NULL, fixture.sounds[0], R_ASSET_SOUND, NULL);
+    r_asset *again = r_asset_load(NULL, fixture.sounds[0], R_ASSET_SOUND, NULL);
+    r_asset *other = r_asset_load(NULL, fixture.sounds[1], R_ASSET_SOUND, NULL);
+    TEST_CHECK(test, sound != NULL && sound == again);
+    TEST_CHECK(test, other != NULL && other != sound);
+
+    TEST_CHECK(test, _update_until(&fixture, sound, 1, ASSET_UPLOAD_BUDGET_NS));
+    TEST_CHECK(test, _update_until(&fixture, other, 1, ASSET_UPLOAD_BUDGET_NS));
+    TEST_CHECK(test, _frames(sound) > 0 && _frames(sound) < _frames(other));
+
+    // one release leaves the other reference working
+    r_asset_release(again);
+    r_asset_update(ASSET_UPLOAD_BUDGET_NS);
+    TEST_CHECK(test, _frames(sound) > 0);
+
+    r_asset_release(sound);
+    r_asset_release(other);
+    _assets_destroy(&fixture);
+}
+
+static void _test_asset_upload_budget(r_test *test) {
+    r_asset_fixture fixture;
+    if (!TEST_CHECK(test, _assets_create(&fixture))) {
+        _assets_destroy(&fixture);
+        return;
+    }
+
+    r_asset *sounds[ASSET_TEST_SOUNDS];
+    for (int i = 0; i < ASSET_TEST_SOUNDS; i++) {
+        sounds[i] = r_asset_load(NULL, fixture.sounds[i], R_ASSET_SOUND, NULL);
+    }
+
+    // let the decodes land, then a budget which is gone at once still uploads one per update
+    usleep(250 * 1000);
+    for (int update = 1; update <= ASSET_TEST_SOUNDS; update++) {
+        r_asset_update(0);
+
+        int loaded = 0;
+        for (int i = 0; i < ASSET_TEST_SOUNDS; i++) {
+            loaded += _frames(sounds[i]) > 0;
+        }
+        TEST_CHECK(test, loaded == update);
+    }
+
+    for (int i = 0; i < ASSET_TEST_SOUNDS; i++) {
+        r_asset_release(sounds[i]);
+    }
+    _assets_destroy(&fixture);
+}
+
+static void _test_asset_failed_reload(r_test *test) {
+    r_asset_fixture fixture;
+    if (!TEST_CHECK(test, _assets_create(&fixture))) {
+        _assets_destroy(&fixture);
+        return;
+    }
+
+    r_asset *sound = r_asset_load(NULL, fixture.sounds[0], R_ASSET_SOUND, NULL);
+    TEST_CHECK(test, _update_until(&fixture, sound, 1, ASSET_UPLOAD_BUDGET_NS));
+    unsigned int frames = _frames(sound);
+
+    // a file which doesn't decode leaves the handle on the version it had
+    r_test_write(fixture.sounds[0], "not a wave");
+    TEST_CHECK(test, !_update_until(&fixture, sound, 2, ASSET_UPLOAD_BUDGET_NS));
+    uint32_t version = 0;
+    TEST_CHECK(test, r_asset_get(sound, &version) != NULL && version == 1);
+    TEST_CHECK(test, _frames(sound) == frames);
+
+    // and the next good edit is picked up
+    _write_sound(fixture.sounds[0], 3000);
+    TEST_CHECK(test, _update_until(&fixture, sound, 2, ASSET_UPLOAD_BUDGET_NS));
+    TEST_CHECK(test, _frames(sound) > frames);
+
+    r_asset_release(sound);
+    _assets_destroy(&fixture);
+}
+
+static void _test_asset_retired(r_test *test) {
+    r_asset_fixture fixture;
+    if (!TEST_CHECK(test, _assets_create(&fixture))) {
+        _assets_destroy(&fixture);
+        return;
+    }
+
+    r_asset *sound = r_asset_load(NULL, fixture.sounds[0], R_ASSET_SOUND, NULL);
+    TEST_CHECK(test, _update_until(&fixture, sound, 1, ASSET_UPLOAD_BUDGET_NS));
+    TEST_CHECK(test, r_asset_retiring() == 0);
+
+    // the replaced version outlives the update which swapped it out, draw lists may refer to it
+    _write_sound(fixture.sounds[0], 3000);
+    TEST_CHECK(test, _update_until(&fixture, sound, 2, ASSET_UPLOAD_BUDGET_NS));
+    TEST_CHECK(test, r_asset_retiring() == 1);
+
+    r_asset_update(ASSET_UPLOAD_BUDGET_NS);
+    TEST_CHECK(test, r_asset_retiring() == 0);
+    const Sound *current = r_asset_get(sound, NULL);
+    TEST_CHECK(test, current && r_asset_resident(R_ASSET_SOUND) == (uint64_t)current->frameCount * current->stream.channels * (current->stream.sampleSize / 8));
+
+    r_asset_release(sound);
+    _assets_destroy(&fixture);
+}
+
+static void _test_asset_evict_order(r_test *test) {
+    r_asset_fixture fixture;
+    if (!TEST_CHECK(test, _assets_create(&fixture))) {
+        _assets_destroy(&fixture);
+        return;
+    }
+
+    r_asset *sounds[ASSET_TEST_SOUNDS];
+    for (int i = 0; i < ASSET_TEST_SOUNDS; i++) {
+        sounds[i] = r_asset_load(NULL, fixture.sounds[i], R_ASSET_SOUND, NULL);
+        TEST_CHECK(test, _update_until(&fixture, sounds[i], 1, ASSET_UPLOAD_BUDGET_NS));
+    }
+
+    // use them newest last, the first is the least recently used even though it's the smallest
+    uint64_t bytes[ASSET_TEST_SOUNDS];
+    for (int i = 0; i < ASSET_TEST_SOUNDS; i++) {
+        bytes[i] = _bytes(sounds[i]);
+        r_asset_update(ASSET_UPLOAD_BUDGET_NS);
+    }
+    _idle(ASSET_EVICT_AFTER);
+
+    // one byte over evicts only the first
+    uint64_t total = r_asset_resident(R_ASSET_SOUND);
+    TEST_CHECK(test, total == bytes[0] + bytes[1] + bytes[2]);
+    r_asset_set_budget(R_ASSET_SOUND, total - 1);
+    r_asset_update(ASSET_UPLOAD_BUDGET_NS);
+    TEST_CHECK(test, r_asset_resident(R_ASSET_SOUND) == bytes[1] + bytes[2]);
+
+    // then the next least recently used, whatever its size
+    r_asset_set_budget(R_ASSET_SOUND, bytes[2]);
+    r_asset_update(ASSET_UPLOAD_BUDGET_NS);
+    TEST_CHECK(test, r_asset_resident(R_ASSET_SOUND) == bytes[2]);
+    TEST_CHECK(test, r_asset_get(sounds[0], NULL) == NULL);
+    TEST_CHECK(test, r_asset_get(sounds[1], NULL) == NULL);
+    TEST_CHECK(test, _frames(sounds[2]) > 0);
+
+    for (int i = 0; i < ASSET_TEST_SOUNDS; i++) {
+        r_asset_release(sounds[i]);
+    }
+    _assets_destroy(&fixture);
+}
+
+static void _test_asset_evict_grace(r_test *test) {
+    r_asset_fixture fixture;
+    if (!TEST_CHECK(test, _assets_create(&fixture))) {
+        _assets_destroy(&fixture);
+        return;
+    }
+
+    r_asset *sound = r_asset_load(NULL, fixture.sounds[0], R_ASSET_SOUND, NULL);
+    TEST_CHECK(test, _update_until(&fixture, sound, 1, ASSET_UPLOAD_BUDGET_NS));
+    uint64_t bytes = _bytes(sound);
+
+    // over budget, but used every update it stays
+    r_asset_set_budget(R_ASSET_SOUND, 1);
+    for (int i = 0; i < 2 * ASSET_EVICT_AFTER; i++) {
+        TEST_CHECK(test, _frames(sound) > 0);
+        r_asset_update(ASSET_UPLOAD_BUDGET_NS);
+    }
+
+    // the update it was last used in is the first of the ASSET_EVICT_AFTER it's spared for
+    _idle(ASSET_EVICT_AFTER - 1);
+    TEST_CHECK(test, r_asset_resident(R_ASSET_SOUND) == bytes);
+    _idle(1);
+    TEST_CHECK(test, r_asset_resident(R_ASSET_SOUND) == 0);
+
+    r_asset_release(sound);
+    _assets_destroy(&fixture);
+}
+
+static void _test_asset_evict_wanted(r_test *test) {
+    r_asset_fixture fixture;
+    if (!TEST_CHECK(test, _assets_create(&fixture))) {
+        _assets_destroy(&fixture);
+        return;
+    }
+
+    r_asset *sound = r_asset_load(NULL, fixture.sounds[0], R_ASSET_SOUND, NULL);
+    TEST_CHECK(test, _update_until(&fixture, sound, 1, ASSET_UPLOAD_BUDGET_NS));
+    unsigned int frames = _frames(sound);
+
+    r_asset_set_budget(R_ASSET_SOUND, 1);
+    _idle(ASSET_EVICT_AFTER + 1);
+    TEST_CHECK(test, r_asset_resident(R_ASSET_SOUND) == 0);
+
+    // nobody asked for it, so it stays out
+    usleep(100 * 1000);
+    _idle(2);
+    TEST_CHECK(test, r_asset_resident(R_ASSET_SOUND) == 0);
+
+    // a get misses and brings it back as a new version of the same file
+    uint32_t version = 0;
+    TEST_CHECK(test, r_asset_get(sound, &version) == NULL && version == 1);
+    TEST_CHECK(test, _update_until(&fixture, sound, 2, ASSET_UPLOAD_BUDGET_NS));
+    TEST_CHECK(test, _frames(sound) == frames);
+    TEST_CHECK(test, r_asset_resident(R_ASSET_SOUND) == _bytes(sound));
+
+    r_asset_release(sound);
+    _assets_destroy(&fixture);
+}
+
+// Benchmarks
+// ----------
+
+static void _bench_hash_1m(r_bench *bench) {
+    r_bench_pause(bench);
+    uint8_t *data = malloc(HASH_BENCH_SIZE);
+    for (int i = 0; i < HASH_BENCH_SIZE; i++) {
+        data[i] = (uint8_t)(i * 31);
+    }
+    r_bench_resume(bench);
+
+    bench->bytes = HASH_BENCH_SIZE;
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        BENCH_KEEP(r_asset_cache_hash(data, HASH_BENCH_SIZE, i));
+    }
+
+    free(data);
+}
+
+static const r_test_case tests[] = {
+    { "cache_texture", _test_cache_texture },
+    { "cache_dependencies", _test_cache_dependencies },
+    { "cache_gltf_buffers", _test_cache_gltf_buffers },
+    { "cache_truncated", _test_cache_truncated },
+    { "cache_prune", _test_cache_prune },
+    { "asset_shared", _test_asset_shared },
+    { "asset_upload_budget", _test_asset_upload_budget },
+    { "asset_failed_reload", _test_asset_failed_reload },
+    { "asset_retired", _test_asset_retired },
+    { "asset_evict_order", _test_asset_evict_order },
+    { "asset_evict_grace", _test_asset_evict_grace },
+    { "asset_evict_wanted", _test_asset_evict_wanted },
+    { NULL },
+};
+
+static const r_bench_case benches[] = {
+    { "hash_1m", _bench_hash_1m },
+    { NULL },
+};
+
+r_test_suite r_asset_test_setup() {
+    return (r_test_suite){
+        .name = "asset",
+        .tests = tests,
+        .benches = benches,
+    };
+}
@@ -0,0 +1,8 @@
+#ifndef _TEST_ASSET_TEST_H_
+#define _TEST_ASSET_TEST_H_
+
+#include "test/test.h"
+
+r_test_suite r_asset_test_setup();
+
+#endif
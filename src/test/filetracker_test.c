@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "filetracker/filetracker.h"
+#include "test/filetracker_test.h"
+#include "time/time.h"
+
+#define CHECK_MS       (CHECK_FREQUENCY_S * 1000.f)
+#define WAIT_EVENTS_MS 3000
+
+typedef struct r_filetracker_fixture {
+    char               root[64];
+    char               library[96];
+    r_module_interface interface;
+} r_filetracker_fixture;
+
+static bool _fixture_create(r_filetracker_fixture *fixture) {
+    if (!r_test_dir_create(fixture->root, sizeof(fixture->root), "test")) {
+        return false;
+    }
+
+    snprintf(fixture->library, sizeof(fixture->library), "%s/libmodule.so", fixture->root);
+    r_test_write(fixture->library, "library");
+    r_test_touch(fixture->library, 1000000);
+
+    memset(&fixture->interface, 0, sizeof(fixture->interface));
+    fixture->interface.properties.name = "tracked";
+    fixture->interface.properties.library_path = fixture->library;
+    fixture->interface.properties.library_files_root = fixture->root;
+    return true;
+}
+
+static void _fixture_destroy(r_filetracker_fixture *fixture) {
+    r_test_dir_destroy(fixture->root);
+}
+
+// check until the flag is raised, events may take a moment to arrive
+static bool _wait_for(r_filetracker *filetracker, bool *flag) {
+    uint64_t start = r_time_now_ns();
+
+    while (!*flag && r_time_now_ns() - start < WAIT_EVENTS_MS * 1000000ull) {
+        r_filetracker_check(filetracker, CHECK_MS);
+        usleep(10 * 1000);
+    }
+    return *flag;
+}
+
+// Tests
+// -----
+
+static void _test_library_changed(r_test *test) {
+    r_filetracker_fixture fixture;
+    if (!TEST_CHECK(test, _fixture_create(&fixture))) {
+        return;
+    }
+
+    r_filetracker *filetracker = r_filetracker_create();
+    r_module_properties *props = &fixture.interface.properties;
+    r_filetracker_add_module(filetracker, &fixture.interface);
+
+    // the first check only records the library's time
+    r_filetracker_check(filetracker, CHECK_MS);
+    TEST_CHECK(test, props->last_modified == 1000000);
+    TEST_CHECK(test, !props->needs_reload);
+
+    // nothing is checked until a check is due
+    r_test_touch(fixture.library, 1000010);
+    r_filetracker_check(filetracker, 1.f);
+    TEST_CHECK(test, !props->needs_reload);
+
+    r_filetracker_check(filetracker, CHECK_MS);
+    TEST_CHECK(test, props->needs_reload);
+    TEST_CHECK(test, props->last_modified == 1000010);
+
+    r_filetracker_remove_module(filetracker, fixture.library);
+    r_filetracker_destroy(filetracker);
+    _fixture_destroy(&fixture);
+}
+
+static void _test_sources_changed(r_test *test) {
+    r_filetracker_fixture fixture;
+    if (!TEST_CHECK(test, _fixture_create(&fixture))) {
+        return;
+    }
+
+    r_filetracker *filetracker = r_filetracker_create();
+    r_module_properties *props = &fixture.interface.properties;
+    r_filetracker_add_module(filetracker, &fixture.interface);
+
+    char path[128];
+    snprintf(path, sizeof(path), "%s/module.c", fixture.root);
+    r_test_write(path, "int a = 1;\n");
+    TEST_CHECK(test, _wait_for(filetracker, &props->files_changed));
+
+    // directories created later are watched as well
+    props->files_changed = false;
+    snprintf(path, sizeof(path), "%s/nested", fixture.root);
+    mkdir(path, 0700);
+    _wait_for(filetracker, &props->files_changed);
+
+    props->files_changed = false;
+    snprintf(path, sizeof(path), "%s/nested/nested.c", fixture.root);
+    r_test_write(path, "int b = 2;\n");
+    TEST_CHECK(test, _wait_for(filetracker, &props->files_changed));
+
+    r_filetracker_remove_module(filetracker, fixture.library);
+    r_filetracker_destroy(filetracker);
+    _fixture_destroy(&fixture);
+}
+
+static void _test_file_changed(r_test *test) {
+    r_filetracker_fixture fixture;
+    if (!TEST_CHECK(test, _fixture_create(&fixture))) {
+        return;
+    }
+
+    r_filetracker *filetracker = r_filetracker_create();
+
+    char path[128], other[128];
+    snprintf(path, sizeof(path), "%s/texture.png", fixture.root);
+    snprintf(other, sizeof(other), "%s/other.png", fixture.root);
+    r_test_write(path, "texture");
+    r_test_write(other, "other");
+
+    bool changed = false, other_changed = false;
+    TEST_CHECK(test, r_filetracker_add_file(filetracker, path, &changed));
+    TEST_CHECK(test, r_filetracker_add_file(filetracker, other, &other_changed));
+
+    // adding the file records it as it is
+    r_filetracker_check(filetracker, CHECK_MS);
+    TEST_CHECK(test, !changed);
+
+    r_test_write(path, "texture, edited");
+    TEST_CHECK(test, _wait_for(filetracker, &changed));
+    TEST_CHECK(test, !other_changed);
+
+    // removed files aren't looked at anymore
+    r_filetracker_remove_file(filetracker, &changed);
+    changed = false;
+    r_test_write(path, "texture, edited again");
+    r_test_write(other, "other, edited");
+    TEST_CHECK(test, _wait_for(filetracker, &other_changed));
+    TEST_CHECK(test, !changed);
+
+    r_filetracker_remove_file(filetracker, &other_changed);
+    r_filetracker_destroy(filetracker);
+    _fixture_destroy(&fixture);
+}
+
+static const r_test_case tests[] = {
+    { "library_changed", _test_library_changed },
+    { "sources_changed", _test_sources_changed },
+    { "file_changed", _test_file_changed },
+    { NULL },
+};
+
+r_test_suite r_filetracker_test_setup() {
+    return (r_test_suite){
+        .name = "filetracker",
+        .tests = tests,
+        .benches = NULL,
+    };
+}
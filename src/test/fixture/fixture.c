@@ -0,0 +1,63 @@
+#include <string.h>
+
+#include "test/fixture/fixture.h"
+
+// tests load the library under several names, so all state goes through props
+#define STATE(props) ((r_fixture_state *)(props)->memory.p_mem)
+
+void _fixture_destroy(r_module_properties *props) {
+    MFREE(r_fixture_state, props->memory.p_mem);
+}
+
+bool init(r_module_properties *props) {
+    r_fixture_state *state = MMALLOC(r_fixture_state, 1);
+    memset(state, 0, sizeof(*state));
+    state->inits++;
+
+    props->memory.p_mem = state;
+    MBIND(props->memory.destroy, _fixture_destroy);
+    return true;
+}
+
+bool destroy(r_module_properties *props) {
+    _fixture_destroy(props);
+    props->memory.p_mem = NULL;
+    return true;
+}
+
+bool pre_frame(r_module_properties *props, float delta_time) {
+    (void)delta_time;
+    STATE(props)->frames[R_MODULE_PHASE_PRE_FRAME]++;
+    return true;
+}
+
+bool update(r_module_properties *props, float delta_time) {
+    (void)delta_time;
+    STATE(props)->frames[R_MODULE_PHASE_UPDATE]++;
+    return true;
+}
+
+bool ui_update(r_module_properties *props, float delta_time) {
+    (void)delta_time;
+    STATE(props)->frames[R_MODULE_PHASE_UI_UPDATE]++;
+    return true;
+}
+
+bool post_frame(r_module_properties *props, float delta_time) {
+    (void)delta_time;
+    STATE(props)->frames[R_MODULE_PHASE_POST_FRAME]++;
+    return true;
+}
+
+bool on_unload(r_module_properties *props) {
+    STATE(props)->unloads++;
+    if (STATE(props)->change_version) {
+        props->memory.data_version++;
+    }
+    return true;
+}
+
+bool on_reload(r_module_properties *props) {
+    STATE(props)->reloads++;
+    return true;
+}
@@ -0,0 +1,28 @@
+#ifndef _TEST_FIXTURE_H_
+#define _TEST_FIXTURE_H_
+
+// A module which counts the lifecycle calls it gets into its persistent
+// memory, the module tests load it and read the counts back.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "module/interface.h"
+
+#if defined(__APPLE__)
+#define FIXTURE_LIBRARY "./build/libfixture.dylib"
+#else
+#define FIXTURE_LIBRARY "./build/libfixture.so"
+#endif
+
+typedef struct r_fixture_state {
+    uint32_t inits;
+    uint32_t reloads;
+    uint32_t unloads;
+    uint32_t frames[R_MODULE_PHASE_COUNT];
+
+    // set by a test, the next unload changes the data version
+    bool     change_version;
+} r_fixture_state;
+
+#endif
@@ -0,0 +1,147 @@
+#include <stdatomic.h>
+
+#include "job/job.h"
+#include "memory/allocator.h"
+#include "test/job_test.h"
+#include "time/time.h"
+
+#define JOB_TEST_WORKERS 4
+
+static void _count(void *data) {
+    atomic_fetch_add((_Atomic uint32_t *)data, 1);
+}
+
+static void _count_range(void *data, uint32_t begin, uint32_t end) {
+    _Atomic uint32_t *counts = data;
+    for (uint32_t i = begin; i < end; i++) {
+        atomic_fetch_add(&counts[i], 1);
+    }
+}
+
+// Tests
+// -----
+
+static void _test_parallel_for(r_test *test) {
+    r_job_system_create(JOB_TEST_WORKERS);
+
+    // more ranges than a ring has slots
+    uint32_t          count = MAX_JOBS_PER_THREAD * 3;
+    _Atomic uint32_t *counts = MALLOC(_Atomic uint32_t, count);
+    for (uint32_t i = 0; i < count; i++) {
+        atomic_init(&counts[i], 0);
+    }
+
+    r_job_parallel_for(NULL, _count_range, counts, count, 1);
+
+    bool once = true;
+    for (uint32_t i = 0; i < count; i++) {
+        once = once && atomic_load(&counts[i]) == 1;
+    }
+    TEST_CHECK(test, once);
+
+    FREE(_Atomic uint32_t, counts);
+    r_job_system_destroy();
+}
+
+static void _test_fan_in(r_test *test) {
+    r_job_system_create(JOB_TEST_WORKERS);
+
+    // more dependents than a job has continuations
+    uint32_t         count = MAX_JOB_CONTINUATIONS * 4;
+    _Atomic uint32_t ran = 0;
+    r_job *          dependents[MAX_JOB_CONTINUATIONS * 4];
+
+    r_job *gate = r_job_create(NULL, NULL, NULL, NULL);
+    for (uint32_t i = 0; i < count; i++) {
+        dependents[i] = r_job_create(NULL, _count, &ran, NULL);
+        r_job_depends_on(dependents[i], gate);
+        r_job_run(dependents[i]);
+    }
+    TEST_CHECK(test, atomic_load(&ran) == 0);
+
+    r_job_run(gate);
+    for (uint32_t i = 0; i < count; i++) {
+        r_job_wait(dependents[i]);
+    }
+    TEST_CHECK(test, atomic_load(&ran) == count);
+
+    r_job_system_destroy();
+}
+
+static void _test_exhausted(r_test *test) {
+    r_job_system_create(JOB_TEST_WORKERS);
+
+    _Atomic uint32_t ran = 0;
+    r_job **         held = MALLOC(r_job *, MAX_JOBS_PER_THREAD);
+
+    // jobs which haven't been run keep their slots
+    bool created = true;
+    for (uint32_t i = 0; i < MAX_JOBS_PER_THREAD; i++) {
+        held[i] = r_job_create(NULL, _count, &ran, NULL);
+        created = created && held[i] != NULL;
+    }
+    TEST_CHECK(test, created);
+    TEST_CHECK(test, r_job_create(NULL, _count, &ran, NULL) == NULL);
+
+    for (uint32_t i = 0; i < MAX_JOBS_PER_THREAD; i++) {
+        r_job_run(held[i]);
+    }
+    for (uint32_t i = 0; i < MAX_JOBS_PER_THREAD; i++) {
+        r_job_wait(held[i]);
+    }
+    TEST_CHECK(test, atomic_load(&ran) == MAX_JOBS_PER_THREAD);
+
+    // the slots are free again
+    r_job *job = r_job_create(NULL, _count, &ran, NULL);
+    TEST_CHECK(test, job != NULL);
+    r_job_run(job);
+    r_job_wait(job);
+
+    FREE(r_job *, held);
+    r_job_system_destroy();
+}
+
+static void _test_drain_stuck(r_test *test) {
+    r_job_system_create(JOB_TEST_WORKERS);
+
+    r_module_properties owner = { .name = "job_test_owner" };
+    _Atomic uint32_t    ran = 0;
+
+    // a job which is only created isn't waited for
+    r_job *created = r_job_create(&owner, _count, &ran, NULL);
+    TEST_CHECK(test, atomic_load(&owner.jobs.in_flight) == 0);
+
+    // one waiting on a job which never runs is cancelled once the drain gives up on it
+    r_job *blocked = r_job_create(&owner, _count, &ran, NULL);
+    r_job_depends_on(blocked, created);
+    r_job_run(blocked);
+    TEST_CHECK(test, atomic_load(&owner.jobs.in_flight) == 1);
+
+    uint64_t start = r_time_now_ns();
+    r_job_drain(&owner);
+    TEST_CHECK(test, r_time_now_ns() - start >= JOB_DRAIN_TIMEOUT_NS);
+    TEST_CHECK(test, atomic_load(&owner.jobs.in_flight) == 0);
+
+    // and never calls into the module, even once what it waited on has run
+    r_job_run(created);
+    r_job_wait(blocked);
+    TEST_CHECK(test, atomic_load(&ran) == 1);
+    TEST_CHECK(test, atomic_load(&owner.jobs.in_flight) == 0);
+
+    r_job_system_destroy();
+}
+
+static const r_test_case tests[] = {
+    { "parallel_for", _test_parallel_for },
+    { "fan_in", _test_fan_in },
+    { "exhausted", _test_exhausted },
+    { "drain_stuck", _test_drain_stuck },
+    { NULL },
+};
+
+r_test_suite r_job_test_setup() {
+    return (r_test_suite){
+        .name = "job",
+        .tests = tests,
+    };
+}
@@ -0,0 +1,8 @@
+#ifndef _TEST_JOB_TEST_H_
+#define _TEST_JOB_TEST_H_
+
+#include "test/test.h"
+
+r_test_suite r_job_test_setup();
+
+#endif
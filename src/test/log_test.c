@@ -0,0 +1,94 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log/log.h"
+#include "test/log_test.h"
+
+#define LOG_TEST_PATH    "/tmp/reload_log_test.log"
+#define LOG_TEST_THREADS (MAX_LOG_THREADS * 2)
+
+// log into a file for the test
+static void _log_begin() {
+    r_log_destroy();
+    r_log_create(LOG_TEST_PATH);
+    r_log_set_level(R_LOG_INFO);
+}
+
+// what was logged, the harness logs to stdout again afterwards
+static char * _log_end() {
+    r_log_destroy();
+    r_log_create(NULL);
+    r_log_set_level(R_LOG_WARNING);
+
+    FILE *file = fopen(LOG_TEST_PATH, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *text = malloc((size_t)size + 1);
+    text[fread(text, 1, (size_t)size, file)] = '\0';
+    fclose(file);
+    remove(LOG_TEST_PATH);
+
+    return text;
+}
+
+static void * _log_thread(void *data) {
+    r_log(R_LOG_INFO, "thread %d\n", *(int *)data);
+    return NULL;
+}
+
+// Tests
+// -----
+
+static void _test_percent_n(r_test *test) {
+    _log_begin();
+
+    // the conversions after it get their own arguments
+    int written = -1;
+    r_log(R_LOG_INFO, "count%n %d %s\n", &written, 42, "after");
+
+    char *text = _log_end();
+    TEST_CHECK(test, text != NULL && strstr(text, "count 42 after") != NULL);
+    TEST_CHECK(test, written == -1);
+    free(text);
+}
+
+static void _test_thread_rings(r_test *test) {
+    _log_begin();
+
+    // more threads than there are rings, one after the other, all get a ring
+    for (int i = 0; i < LOG_TEST_THREADS; i++) {
+        pthread_t thread;
+        pthread_create(&thread, NULL, _log_thread, &i);
+        pthread_join(thread, NULL);
+        r_log_flush();
+    }
+
+    char *text = _log_end();
+    int   lines = 0;
+    for (const char *line = text; line && (line = strstr(line, "thread ")) != NULL; line++) {
+        lines++;
+    }
+    TEST_CHECK(test, lines == LOG_TEST_THREADS);
+    free(text);
+}
+
+static const r_test_case tests[] = {
+    { "percent_n", _test_percent_n },
+    { "thread_rings", _test_thread_rings },
+    { NULL },
+};
+
+r_test_suite r_log_test_setup() {
+    return (r_test_suite){
+        .name = "log",
+        .tests = tests,
+    };
+}
@@ -0,0 +1,440 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE   // asprintf
+#endif
+
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "memory/allocator.h"
+#include "module/function.h"
+#include "module/module.h"
+#include "module/service.h"
+#include "module/tweak.h"
+#include "test/fixture/fixture.h"
+#include "test/module_test.h"
+
+#define DISPATCH_MODULES 16
+#define TWEAK_BINDS      2000
+
+static r_module_properties _properties(const char *name) {
+    r_module_properties props = {
+        .memory = (r_module_memory){
+            .allocate = r_malloc,
+            .free = r_free,
+            .p_mem = NULL,
+            .data_version = 0,
+        },
+        .functions = (r_module_functions){
+            .bind = r_module_fn_bind,
+            .unbind = r_module_fn_unbind,
+            .count = 0,
+        },
+        .previous_data_version = 0,
+        .dependency_count = 0,
+    };
+
+    asprintf(&props.name, "%s", name);
+    asprintf(&props.library_path, "%s", FIXTURE_LIBRARY);
+    asprintf(&props.library_files_root, "./src/test/fixture");
+
+    return props;
+}
+
+static r_fixture_state * _state(r_module_interface *interface) {
+    return (r_fixture_state *)interface->properties.memory.p_mem;
+}
+
+static void _frame(r_module_lifecycle *lifecycle) {
+    r_module_lifecycle_pre_frame(lifecycle, 16.f);
+    r_module_lifecycle_update(lifecycle, 16.f);
+    r_module_lifecycle_ui_update(lifecycle, 16.f);
+    r_module_lifecycle_post_frame(lifecycle, 16.f);
+}
+
+// Tests
+// -----
+
+static void _test_register(r_test *test) {
+    r_module_lifecycle *lifecycle = r_module_lifecycle_create();
+    r_module_interface *interface = r_module_lifecycle_register(lifecycle, _properties("fixture"));
+
+    if (TEST_CHECK(test, interface != NULL) && TEST_CHECK(test, interface->properties.library_handle != NULL)) {
+        TEST_CHECK(test, _state(interface) != NULL && _state(interface)->inits == 1);
+        TEST_CHECK(test, r_module_lifecycle_find(lifecycle, "fixture") == interface);
+        TEST_CHECK(test, r_module_lifecycle_count(lifecycle) == 1);
+    }
+
+    // names are unique
+    r_module_properties duplicate = _properties("fixture");
+    TEST_CHECK(test, r_module_lifecycle_register(lifecycle, duplicate) == NULL);
+    free(duplicate.name);
+    free(duplicate.library_path);
+    free(duplicate.library_files_root);
+
+    r_module_lifecycle_destroy(lifecycle);
+}
+
+static void _test_dispatch(r_test *test) {
+    r_module_lifecycle *lifecycle = r_module_lifecycle_create();
+    r_module_interface *interface = r_module_lifecycle_register(lifecycle, _properties("fixture"));
+
+    if (TEST_CHECK(test, interface != NULL && _state(interface) != NULL)) {
+        for (int i = 0; i < 3; i++) {
+            _frame(lifecycle);
+        }
+
+        for (int phase = 0; phase < R_MODULE_PHASE_COUNT; phase++) {
+            TEST_CHECK(test, _state(interface)->frames[phase] == 3);
+        }
+    }
+
+    r_module_lifecycle_destroy(lifecycle);
+}
+
+static void _test_reload(r_test *test) {
+    r_module_lifecycle *lifecycle = r_module_lifecycle_create();
+    r_module_interface *interface = r_module_lifecycle_register(lifecycle, _properties("fixture"));
+
+    if (TEST_CHECK(test, interface != NULL && _state(interface) != NULL)) {
+        r_fixture_state *before = _state(interface);
+        _frame(lifecycle);
+
+        // the reload happens at the start of the post frame
+        interface->properties.needs_reload = true;
+        r_module_lifecycle_post_frame(lifecycle, 16.f);
+
+        TEST_CHECK(test, interface->properties.library_handle != NULL);
+        TEST_CHECK(test, interface->properties.needs_reload == false);
+        TEST_CHECK(test, interface->stats.reloads == 1);
+        TEST_CHECK(test, _state(interface) == before);
+        TEST_CHECK(test, before->inits == 1);
+        TEST_CHECK(test, before->unloads == 1);
+        TEST_CHECK(test, before->reloads == 1);
+        TEST_CHECK(test, before->frames[R_MODULE_PHASE_UPDATE] == 1);
+        TEST_CHECK(test, before->frames[R_MODULE_PHASE_POST_FRAME] == 2);
+    }
+
+    r_module_lifecycle_destroy(lifecycle);
+}
+
+static void _test_reload_data_version(r_test *test) {
+    r_module_lifecycle *lifecycle = r_module_lifecycle_create();
+    r_module_interface *interface = r_module_lifecycle_register(lifecycle, _properties("fixture"));
+
+    if (TEST_CHECK(test, interface != NULL && _state(interface) != NULL)) {
+        _frame(lifecycle);
+
+        // a new data version throws the old memory away and initialises again
+        _state(interface)->change_version = true;
+        interface->properties.needs_reload = true;
+        r_module_lifecycle_post_frame(lifecycle, 16.f);
+
+        TEST_CHECK(test, interface->properties.memory.data_version == 1);
+        if (TEST_CHECK(test, _state(interface) != NULL)) {
+            TEST_CHECK(test, _state(interface)->inits == 1);
+            TEST_CHECK(test, _state(interface)->reloads == 0);
+            TEST_CHECK(test, _state(interface)->frames[R_MODULE_PHASE_UPDATE] == 0);
+        }
+    }
+
+    r_module_lifecycle_destroy(lifecycle);
+}
+
+static void _test_dependents_reload(r_test *test) {
+    r_module_lifecycle *lifecycle = r_module_lifecycle_create();
+
+    // registered before what it depends on
+    r_module_lifecycle_register(lifecycle, _properties("dependent"));
+    r_module_lifecycle_register(lifecycle, _properties("dependency"));
+
+    r_module_interface *dependent = r_module_lifecycle_find(lifecycle, "dependent");
+    r_module_interface *dependency = r_module_lifecycle_find(lifecycle, "dependency");
+
+    if (TEST_CHECK(test, dependent != NULL && dependency != NULL)) {
+        TEST_CHECK(test, r_module_lifecycle_add_dependency(lifecycle, dependent, "dependency"));
+
+        dependency->properties.needs_reload = true;
+        r_module_lifecycle_post_frame(lifecycle, 16.f);
+
+        TEST_CHECK(test, dependency->stats.reloads == 1);
+        TEST_CHECK(test, dependent->stats.reloads == 1);
+    }
+
+    r_module_lifecycle_destroy(lifecycle);
+}
+
+static void _test_unregister(r_test *test) {
+    r_module_lifecycle *lifecycle = r_module_lifecycle_create();
+    r_module_lifecycle_register(lifecycle, _properties("first"));
+    r_module_lifecycle_register(lifecycle, _properties("second"));
+
+    r_module_interface *first = r_module_lifecycle_find(lifecycle, "first");
+    if (TEST_CHECK(test, first != NULL)) {
+        r_module_lifecycle_unregister(lifecycle, first);
+
+        TEST_CHECK(test, r_module_lifecycle_count(lifecycle) == 1);
+        TEST_CHECK(test, r_module_lifecycle_find(lifecycle, "first") == NULL);
+
+        // the remaining module still runs
+        r_module_interface *second = r_module_lifecycle_find(lifecycle, "second");
+        if (TEST_CHECK(test, second != NULL && second->properties.library_handle != NULL)) {
+            uint32_t updates = _state(second)->frames[R_MODULE_PHASE_UPDATE];
+            _frame(lifecycle);
+            TEST_CHECK(test, _state(second)->frames[R_MODULE_PHASE_UPDATE] == updates + 1);
+        }
+    }
+
+    r_module_lifecycle_destroy(lifecycle);
+}
+
+static void _test_fn_bind(r_test *test) {
+    r_module_lifecycle *lifecycle = r_module_lifecycle_create();
+    r_module_interface *interface = r_module_lifecycle_register(lifecycle, _properties("fixture"));
+    if (!TEST_CHECK(test, interface != NULL)) {
+        r_module_lifecycle_destroy(lifecycle);
+        return;
+    }
+
+    r_module_properties *props = &interface->properties;
+    void *update = dlsym(props->library_handle, "update");
+    r_module_fn *handle = MALLOC(r_module_fn, 1);
+
+    // an exported function bound from host memory follows the reload
+    TEST_CHECK(test, r_module_fn_bind(props, handle, "update", update));
+    props->needs_reload = true;
+    r_module_lifecycle_post_frame(lifecycle, 16.f);
+    TEST_CHECK(test, handle->ptr == dlsym(props->library_handle, "update"));
+    r_module_fn_unbind(props, handle);
+
+    // an address which isn't what the symbol resolves to, like a static function, is refused
+    TEST_CHECK(test, !r_module_fn_bind(props, handle, "update", dlsym(props->library_handle, "pre_frame")));
+
+    // so is a handle in the module's image, any address in it stands in for a static handle
+    r_module_fn *in_image = (r_module_fn *)dlsym(props->library_handle, "init");
+    TEST_CHECK(test, !r_module_fn_bind(props, in_image, "update", NULL));
+    TEST_CHECK(test, props->functions.count == 0);
+
+    FREE(r_module_fn, handle);
+    r_module_lifecycle_destroy(lifecycle);
+}
+
+// the fixture's phases, published as a service
+typedef struct r_fixture_api {
+    bool (*pre_frame)(r_module_properties *props, float delta_time);
+    bool (*update)(r_module_properties *props, float delta_time);
+} r_fixture_api;
+
+static void _test_service_revoke(r_test *test) {
+    static const char *symbols[] = { "pre_frame", "update" };
+    static const char *missing[] = { "pre_frame", "missing" };
+
+    r_module_lifecycle *lifecycle = r_module_lifecycle_create();
+    r_module_interface *provider = r_module_lifecycle_register(lifecycle, _properties("provider"));
+    r_module_interface *other = r_module_lifecycle_register(lifecycle, _properties("other"));
+    if (!TEST_CHECK(test, provider != NULL && other != NULL)) {
+        r_module_lifecycle_destroy(lifecycle);
+        return;
+    }
+
+    r_service *service = r_service_publish(&provider->properties, "fixture_api", 1, symbols, 2);
+    TEST_CHECK(test, r_service_acquire(&other->properties, "fixture_api", 1) == service);
+    TEST_CHECK(test, MSERVICE(r_fixture_api, service) != NULL);
+
+    // a table with a function missing isn't handed out
+    r_service *partial = r_service_publish(&provider->properties, "fixture_partial", 1, missing, 2);
+    if (TEST_CHECK(test, partial != NULL)) {
+        TEST_CHECK(test, MSERVICE(r_fixture_api, partial) == NULL);
+        TEST_CHECK(test, r_service_acquire(&other->properties, "fixture_partial", 1) == NULL);
+    }
+
+    // a library which fails to load leaves the service unavailable rather than pointing at the closed image
+    char *library_path = provider->properties.library_path;
+    provider->properties.library_path = "./build/missing.so";
+    provider->properties.needs_reload = true;
+    r_module_lifecycle_post_frame(lifecycle, 16.f);
+    TEST_CHECK(test, MSERVICE(r_fixture_api, service) == NULL);
+    TEST_CHECK(test, r_service_acquire(&other->properties, "fixture_api", 1) == NULL);
+    TEST_CHECK(test, provider->stats.reloads == 0);
+
+    // the next good load resolves it again, and hands the module back its memory
+    provider->properties.library_path = library_path;
+    provider->properties.needs_reload = true;
+    r_module_lifecycle_post_frame(lifecycle, 16.f);
+    TEST_CHECK(test, MSERVICE(r_fixture_api, service) != NULL);
+    TEST_CHECK(test, provider->stats.reloads == 1);
+    TEST_CHECK(test, _state(provider) != NULL && _state(provider)->inits == 1 && _state(provider)->reloads == 1);
+
+    // and it's revoked once the provider is gone
+    r_module_lifecycle_unregister(lifecycle, provider);
+    TEST_CHECK(test, MSERVICE(r_fixture_api, service) == NULL);
+
+    // and another module can provide it
+    other = r_module_lifecycle_find(lifecycle, "other");
+    TEST_CHECK(test, r_service_publish(&other->properties, "fixture_api", 1, symbols, 2) == service);
+    TEST_CHECK(test, MSERVICE(r_fixture_api, service) != NULL);
+
+    r_module_lifecycle_destroy(lifecycle);
+}
+
+static void _test_tweak_pending(r_test *test) {
+    char root[64], source[96];
+    if (!TEST_CHECK(test, r_test_dir_create(root, sizeof(root), "tweak"))) {
+        return;
+    }
+    snprintf(source, sizeof(source), "%s/tweaked.c", root);
+    r_test_write(source, "\nint speed = TWEAK_INT(200);\nfloat scale = TWEAK_FLOAT(2.f);\n");
+
+    r_module_properties props = { .name = "tweaked", .library_files_root = root };
+    props.tweaks.bind = r_tweak_bind;
+    r_tweak_track(&props);
+
+    float *scale = r_tweak_bind(&props, source, 3, R_TWEAK_FLOAT, &(float){ 2.f });
+    TEST_CHECK(test, scale != NULL && *scale == 2.f);
+
+    // both values change, only the float has run so far
+    r_test_write(source, "\nint speed = TWEAK_INT(300);\nfloat scale = TWEAK_FLOAT(4.5f);\n");
+    TEST_CHECK(test, r_tweak_apply(&props));
+    TEST_CHECK(test, *scale == 4.5f);
+
+    // the int starts with the patched value rather than the compiled one
+    int *speed = r_tweak_bind(&props, source, 2, R_TWEAK_INT, &(int){ 200 });
+    TEST_CHECK(test, speed != NULL && *speed == 300);
+
+    // anything else needs a build
+    r_test_write(source, "\nint speed = TWEAK_INT(300) + 1;\nfloat scale = TWEAK_FLOAT(4.5f);\n");
+    TEST_CHECK(test, !r_tweak_apply(&props));
+
+    r_tweak_destroy(&props);
+    r_test_dir_destroy(root);
+}
+
+typedef struct r_tweak_binder {
+    r_module_properties *props;
+    const char *         source;
+} r_tweak_binder;
+
+// what a module's jobs do, every line binds a new tweak
+static void * _bind_tweaks(void *data) {
+    r_tweak_binder *binder = data;
+
+    for (int line = 100; line < 100 + TWEAK_BINDS; line++) {
+        int *value = r_tweak_bind(binder->props, binder->source, line, R_TWEAK_INT, &line);
+        if (value == NULL || *value != line) {
+            return NULL;
+        }
+    }
+    return binder;
+}
+
+static void _test_tweak_threads(r_test *test) {
+    char root[64], source[96];
+    if (!TEST_CHECK(test, r_test_dir_create(root, sizeof(root), "tweak"))) {
+        return;
+    }
+    snprintf(source, sizeof(source), "%s/tweaked.c", root);
+    r_test_write(source, "\nint speed = TWEAK_INT(0);\n");
+
+    r_module_properties props = { .name = "tweaked", .library_files_root = root };
+    props.tweaks.bind = r_tweak_bind;
+    r_tweak_track(&props);
+    int *speed = r_tweak_bind(&props, source, 2, R_TWEAK_INT, &(int){ 0 });
+
+    // binding on another thread while the main thread patches
+    r_tweak_binder binder = { .props = &props, .source = source };
+    pthread_t      thread;
+    void *         result = NULL;
+    pthread_create(&thread, NULL, _bind_tweaks, &binder);
+
+    char text[64];
+    for (int i = 1; i <= 20; i++) {
+        snprintf(text, sizeof(text), "\nint speed = TWEAK_INT(%d);\n", i);
+        r_test_write(source, text);
+        TEST_CHECK(test, r_tweak_apply(&props));
+    }
+    pthread_join(thread, &result);
+
+    TEST_CHECK(test, result == &binder);
+    TEST_CHECK(test, speed != NULL && *speed == 20);
+
+    r_tweak_destroy(&props);
+    r_test_dir_destroy(root);
+}
+
+// Benchmarks
+// ----------
+
+static void _bench_dispatch(r_bench *bench, uint32_t modules) {
+    r_bench_pause(bench);
+
+    r_module_lifecycle *lifecycle = r_module_lifecycle_create();
+    for (uint32_t i = 0; i < modules; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "fixture_%u", i);
+        r_module_lifecycle_register(lifecycle, _properties(name));
+    }
+
+    r_bench_resume(bench);
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        _frame(lifecycle);
+    }
+    r_bench_pause(bench);
+
+    r_module_lifecycle_destroy(lifecycle);
+}
+
+// every phase of one frame
+static void _bench_frame_dispatch_1(r_bench *bench) {
+    _bench_dispatch(bench, 1);
+}
+
+static void _bench_frame_dispatch_16(r_bench *bench) {
+    _bench_dispatch(bench, DISPATCH_MODULES);
+}
+
+// unload, load and on_reload of one module
+static void _bench_reload(r_bench *bench) {
+    r_bench_pause(bench);
+    r_module_lifecycle *lifecycle = r_module_lifecycle_create();
+    r_module_interface *interface = r_module_lifecycle_register(lifecycle, _properties("fixture"));
+    r_bench_resume(bench);
+
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        interface->properties.needs_reload = true;
+        r_module_lifecycle_post_frame(lifecycle, 16.f);
+    }
+
+    r_bench_pause(bench);
+    r_module_lifecycle_destroy(lifecycle);
+}
+
+static const r_test_case tests[] = {
+    { "register", _test_register },
+    { "dispatch", _test_dispatch },
+    { "reload", _test_reload },
+    { "reload_data_version", _test_reload_data_version },
+    { "dependents_reload", _test_dependents_reload },
+    { "unregister", _test_unregister },
+    { "fn_bind", _test_fn_bind },
+    { "service_revoke", _test_service_revoke },
+    { "tweak_pending", _test_tweak_pending },
+    { "tweak_threads", _test_tweak_threads },
+    { NULL },
+};
+
+static const r_bench_case benches[] = {
+    { "frame_dispatch_1", _bench_frame_dispatch_1 },
+    { "frame_dispatch_16", _bench_frame_dispatch_16 },
+    { "reload", _bench_reload },
+    { NULL },
+};
+
+r_test_suite r_module_test_setup() {
+    return (r_test_suite){
+        .name = "module",
+        .tests = tests,
+        .benches = benches,
+    };
+}
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <unistd.h>
+
+#include "replay/replay.h"
+#include "test/replay_test.h"
+
+#define REPLAY_TEST_PATH  "/tmp/reload_replay_test.rrp"
+#define REPLAY_TEST_BUILD 0x5245504cull
+
+// the deltas each phase is given per frame, zero for the phases a frame skips
+static const float deltas[][R_MODULE_PHASE_COUNT] = {
+    { 16.f, 16.f, 16.f, 16.f },
+    { 16.6f, 16.6f, 16.6f, 16.6f },
+    { 15.f, 17.f, 16.f, 33.f },
+    { 20.f, 0.f, 20.f, 0.f },
+};
+
+#define REPLAY_TEST_FRAMES (sizeof(deltas) / sizeof(deltas[0]))
+
+static void _record() {
+    r_replay_record(REPLAY_TEST_PATH, REPLAY_TEST_BUILD);
+
+    for (uint32_t i = 0; i < REPLAY_TEST_FRAMES; i++) {
+        r_replay_frame_begin();
+        for (int phase = 0; phase < R_MODULE_PHASE_COUNT; phase++) {
+            if (deltas[i][phase] > 0.f) {
+                r_replay_delta(phase, deltas[i][phase]);
+            }
+        }
+        r_replay_frame_end();
+    }
+
+    r_replay_stop();
+}
+
+// Tests
+// -----
+
+static void _test_roundtrip(r_test *test) {
+    _record();
+
+    if (!TEST_CHECK(test, r_replay_play(REPLAY_TEST_PATH, NULL, REPLAY_TEST_BUILD))) {
+        return;
+    }
+    TEST_CHECK(test, r_replay_get_mode() == R_REPLAY_PLAY);
+
+    // the live clock is replaced by the recorded one, phases without a delta keep theirs
+    bool same = true;
+    for (uint32_t i = 0; i < REPLAY_TEST_FRAMES; i++) {
+        same = same && r_replay_frame_begin();
+        for (int phase = 0; phase < R_MODULE_PHASE_COUNT; phase++) {
+            float expected = deltas[i][phase] > 0.f ? deltas[i][phase] : 1.f;
+            same = same && r_replay_delta(phase, 1.f) == expected;
+        }
+        r_replay_frame_end();
+    }
+    TEST_CHECK(test, same);
+
+    // and it ends with the recording
+    TEST_CHECK(test, !r_replay_frame_begin());
+
+    r_replay_stop();
+    TEST_CHECK(test, r_replay_get_mode() == R_REPLAY_NONE);
+    unlink(REPLAY_TEST_PATH);
+}
+
+static void _test_foreign(r_test *test) {
+    FILE *file = fopen(REPLAY_TEST_PATH, "wb");
+    if (!TEST_CHECK(test, file != NULL)) {
+        return;
+    }
+    fputs("not a recording", file);
+    fclose(file);
+
+    TEST_CHECK(test, !r_replay_play(REPLAY_TEST_PATH, NULL, REPLAY_TEST_BUILD));
+    TEST_CHECK(test, r_replay_get_mode() == R_REPLAY_NONE);
+    TEST_CHECK(test, !r_replay_play("/tmp/reload_replay_test_missing.rrp", NULL, REPLAY_TEST_BUILD));
+
+    // without a mode the deltas pass through
+    TEST_CHECK(test, r_replay_frame_begin());
+    TEST_CHECK(test, r_replay_delta(R_MODULE_PHASE_UPDATE, 5.f) == 5.f);
+    unlink(REPLAY_TEST_PATH);
+}
+
+static void _test_corrupt(r_test *test) {
+    // a header, then a frame with one event of a type raylib doesn't play
+    r_replay_record(REPLAY_TEST_PATH, REPLAY_TEST_BUILD);
+    r_replay_stop();
+
+    FILE *file = fopen(REPLAY_TEST_PATH, "ab");
+    if (!TEST_CHECK(test, file != NULL)) {
+        return;
+    }
+    const uint8_t record[] = { REPLAY_FRAME_EVENTS, 1, 0xa0, 0x1f };
+    fwrite(record, 1, sizeof(record), file);
+    fclose(file);
+
+    if (!TEST_CHECK(test, r_replay_play(REPLAY_TEST_PATH, NULL, REPLAY_TEST_BUILD))) {
+        return;
+    }
+    TEST_CHECK(test, !r_replay_frame_begin());
+
+    r_replay_stop();
+    unlink(REPLAY_TEST_PATH);
+}
+
+static const r_test_case tests[] = {
+    { "roundtrip", _test_roundtrip },
+    { "foreign", _test_foreign },
+    { "corrupt", _test_corrupt },
+    { NULL },
+};
+
+r_test_suite r_replay_test_setup() {
+    return (r_test_suite){
+        .name = "replay",
+        .tests = tests,
+        .benches = NULL,
+    };
+}
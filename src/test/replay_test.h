@@ -0,0 +1,8 @@
+#ifndef _TEST_REPLAY_TEST_H_
+#define _TEST_REPLAY_TEST_H_
+
+#include "test/test.h"
+
+r_test_suite r_replay_test_setup();
+
+#endif
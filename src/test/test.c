@@ -0,0 +1,207 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "test/test.h"
+#include "time/time.h"
+
+struct r_test {
+    uint32_t checks;
+    uint32_t failures;
+};
+
+typedef struct r_test_options {
+    bool         bench;
+    const char * filter;
+    FILE *       json;
+    time_t       started;
+} r_test_options;
+
+bool r_test_check(r_test *test, bool passed, const char *expression, const char *file, int line) {
+    test->checks++;
+    if (!passed) {
+        test->failures++;
+        printf("    %s:%d: check failed: %s\n", file, line, expression);
+    }
+    return passed;
+}
+
+void r_bench_pause(r_bench *bench) {
+    if (!bench->paused) {
+        bench->elapsed_ns += r_time_now_ns() - bench->started_ns;
+        bench->paused = true;
+    }
+}
+
+void r_bench_resume(r_bench *bench) {
+    if (bench->paused) {
+        bench->started_ns = r_time_now_ns();
+        bench->paused = false;
+    }
+}
+
+bool r_test_dir_create(char *root, size_t size, const char *name) {
+    snprintf(root, size, "/tmp/reload_%s_XXXXXX", name);
+    return mkdtemp(root) != NULL;
+}
+
+void r_test_dir_destroy(const char *root) {
+    char command[128];
+    snprintf(command, sizeof(command), "rm -rf %s", root);
+    system(command);
+}
+
+void r_test_write(const char *path, const char *text) {
+    FILE *file = fopen(path, "w");
+    if (file) {
+        fputs(text, file);
+        fclose(file);
+    }
+}
+
+void r_test_touch(const char *path, time_t seconds) {
+    struct timespec times[2] = {
+        { .tv_sec = seconds, .tv_nsec = 0 },
+        { .tv_sec = seconds, .tv_nsec = 0 },
+    };
+    utimensat(AT_FDCWD, path, times, 0);
+}
+
+static bool _selected(const r_test_options *options, const char *suite, const char *name) {
+    if (options->filter == NULL) {
+        return true;
+    }
+
+    char full[256];
+    snprintf(full, sizeof(full), "%s/%s", suite, name);
+    return strstr(full, options->filter) != NULL;
+}
+
+static bool _run_test(const r_test_options *options, const r_test_suite *suite, const r_test_case *test_case) {
+    r_test   test = { .checks = 0, .failures = 0 };
+    uint64_t start = r_time_now_ns();
+
+    test_case->fn(&test);
+
+    double elapsed_ms = (double)(r_time_now_ns() - start) / 1e6;
+    bool   passed = test.failures == 0;
+
+    printf("  %-40s %s  %u checks  %8.3f ms\n", test_case->name, passed ? "ok  " : "FAIL", test.checks, elapsed_ms);
+
+    if (options->json) {
+        fprintf(options->json,
+                "{\"type\":\"test\",\"timestamp\":%lld,\"suite\":\"%s\",\"name\":\"%s\",\"passed\":%s,\"checks\":%u,\"failures\":%u,\"ms\":%.3f}\n",
+                (long long)options->started, suite->name, test_case->name, passed ? "true" : "false", test.checks, test.failures, elapsed_ms);
+    }
+    return passed;
+}
+
+static uint64_t _bench_once(const r_bench_case *bench_case, uint64_t iterations, uint64_t *bytes) {
+    r_bench bench = {
+        .iterations = iterations,
+        .bytes = 0,
+        .elapsed_ns = 0,
+        .paused = false,
+    };
+
+    bench.started_ns = r_time_now_ns();
+    bench_case->fn(&bench);
+    r_bench_pause(&bench);
+
+    *bytes = bench.bytes;
+    return bench.elapsed_ns;
+}
+
+static void _run_bench(const r_test_options *options, const r_test_suite *suite, const r_bench_case *bench_case) {
+    uint64_t bytes = 0;
+    uint64_t iterations = 1;
+
+    // grow the run until it is long enough to time reliably
+    uint64_t elapsed = _bench_once(bench_case, iterations, &bytes);
+    while (elapsed < BENCH_MIN_NS && iterations < BENCH_MAX_ITERS) {
+        iterations *= elapsed < BENCH_MIN_NS / 16 ? 8 : 2;
+        elapsed = _bench_once(bench_case, iterations, &bytes);
+    }
+
+    // the fastest run is the least disturbed one
+    uint64_t best = elapsed;
+    for (uint32_t run = 1; run < BENCH_RUNS; run++) {
+        elapsed = _bench_once(bench_case, iterations, &bytes);
+        best = elapsed < best ? elapsed : best;
+    }
+
+    double ns_per_op = (double)best / (double)iterations;
+    double mb_per_s = bytes ? (double)bytes * 1e9 / ns_per_op / (1024.0 * 1024.0) : 0.0;
+
+    printf("  %-40s %12.1f ns/op  %12llu iterations", bench_case->name, ns_per_op, (unsigned long long)iterations);
+    if (bytes) {
+        printf("  %10.1f MiB/s", mb_per_s);
+    }
+    printf("\n");
+
+    if (options->json) {
+        fprintf(options->json,
+                "{\"type\":\"bench\",\"timestamp\":%lld,\"suite\":\"%s\",\"name\":\"%s\",\"iterations\":%llu,\"ns_per_op\":%.3f,\"mib_per_s\":%.3f}\n",
+                (long long)options->started, suite->name, bench_case->name, (unsigned long long)iterations, ns_per_op, mb_per_s);
+    }
+}
+
+int r_test_main(const r_test_suite *suites, int argc, const char *argv[]) {
+    r_test_options options = {
+        .bench = false,
+        .filter = NULL,
+        .json = NULL,
+        .started = time(NULL),
+    };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bench") == 0) {
+            options.bench = true;
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            options.json = fopen(argv[++i], "a");
+            if (options.json == NULL) {
+                fprintf(stderr, "Unable to open %s\n", argv[i]);
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "usage: %s [--bench] [--filter <text>] [--json <path>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    uint32_t run = 0;
+    uint32_t failed = 0;
+
+    for (const r_test_suite *suite = suites; suite->name; suite++) {
+        printf("%s\n", suite->name);
+
+        for (const r_test_case *test_case = suite->tests; test_case && test_case->name; test_case++) {
+            if (_selected(&options, suite->name, test_case->name)) {
+                run++;
+                failed += _run_test(&options, suite, test_case) ? 0 : 1;
+            }
+        }
+
+        if (!options.bench) {
+            continue;
+        }
+
+        for (const r_bench_case *bench_case = suite->benches; bench_case && bench_case->name; bench_case++) {
+            if (_selected(&options, suite->name, bench_case->name)) {
+                _run_bench(&options, suite, bench_case);
+            }
+        }
+    }
+
+    printf("\n%u tests, %u failed\n", run, failed);
+
+    if (options.json) {
+        fclose(options.json);
+    }
+    return failed == 0 ? 0 : 1;
+}
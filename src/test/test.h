@@ -0,0 +1,79 @@
+#ifndef _TEST_H_
+#define _TEST_H_
+
+// A unit test and microbenchmark harness for the host libraries.
+//
+// A test records failed checks with TEST_CHECK and carries on, it fails if
+// any check did. A benchmark runs its body bench->iterations times. The
+// harness doubles the count until a run takes at least BENCH_MIN_NS, then
+// reports the fastest of BENCH_RUNS runs per iteration.
+//
+// Results are printed as a table. `--json <path>` also writes one JSON object
+// per line, so results can be collected and compared across commits.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#define BENCH_MIN_NS     (50ull * 1000 * 1000)
+#define BENCH_RUNS       5
+#define BENCH_MAX_ITERS  (1ull << 30)
+
+typedef struct r_test r_test;
+
+typedef struct r_bench {
+    uint64_t iterations;
+    // bytes processed per iteration, reported as throughput when set
+    uint64_t bytes;
+
+    uint64_t elapsed_ns;
+    uint64_t started_ns;
+    bool     paused;
+} r_bench;
+
+typedef void (*r_test_fn)(r_test *test);
+typedef void (*r_bench_fn)(r_bench *bench);
+
+typedef struct r_test_case {
+    const char *name;
+    r_test_fn   fn;
+} r_test_case;
+
+typedef struct r_bench_case {
+    const char *name;
+    r_bench_fn  fn;
+} r_bench_case;
+
+// tests and benches are terminated by an entry without a name, either may be NULL
+typedef struct r_test_suite {
+    const char *         name;
+    const r_test_case *  tests;
+    const r_bench_case * benches;
+} r_test_suite;
+
+#define TEST_CHECK(test, condition) r_test_check(test, (condition), #condition, __FILE__, __LINE__)
+
+bool r_test_check(r_test *test, bool passed, const char *expression, const char *file, int line);
+
+// leave setup out of the measurement
+void r_bench_pause(r_bench *bench);
+void r_bench_resume(r_bench *bench);
+
+// keep the compiler from discarding a result
+#define BENCH_KEEP(value) __asm__ volatile("" : : "g"(value) : "memory")
+
+// a fresh directory /tmp/reload_<name>_XXXXXX for a test's files, written into root
+bool r_test_dir_create(char *root, size_t size, const char *name);
+// removes the directory and everything in it
+void r_test_dir_destroy(const char *root);
+void r_test_write(const char *path, const char *text);
+// move the modification time, stat only resolves whole seconds
+void r_test_touch(const char *path, time_t seconds);
+
+// run the suites, the list is terminated by an entry without a name.
+// --bench runs the benchmarks too, --filter <text> runs what has text in its
+// suite/name, --json <path> writes the results
+int r_test_main(const r_test_suite *suites, int argc, const char *argv[]);
+
+#endif
@@ -0,0 +1,67 @@
+#include <time.h>
+#include <unistd.h>
+
+#include "test/time_test.h"
+#include "time/time.h"
+
+// Tests
+// -----
+
+static void _test_monotonic(r_test *test) {
+    uint64_t previous = r_time_now_ns();
+    bool     forwards = true;
+
+    for (int i = 0; i < 10000; i++) {
+        uint64_t now = r_time_now_ns();
+        forwards = forwards && now >= previous;
+        previous = now;
+    }
+    TEST_CHECK(test, forwards);
+
+    // the same clock as the kernel's monotonic one
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t kernel = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    uint64_t ours = r_time_now_ns();
+    TEST_CHECK(test, ours >= kernel && ours - kernel < 1000000ull);
+}
+
+static void _test_delta(r_test *test) {
+    r_time_init(60.f);
+    r_time_get_delta();
+
+    usleep(20 * 1000);
+
+    // milliseconds, allowing for a busy machine
+    float delta = r_time_get_delta();
+    TEST_CHECK(test, delta >= 19.f);
+    TEST_CHECK(test, delta < 500.f);
+}
+
+// Benchmarks
+// ----------
+
+static void _bench_now(r_bench *bench) {
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        BENCH_KEEP(r_time_now_ns());
+    }
+}
+
+static const r_test_case tests[] = {
+    { "monotonic", _test_monotonic },
+    { "delta", _test_delta },
+    { NULL },
+};
+
+static const r_bench_case benches[] = {
+    { "now_ns", _bench_now },
+    { NULL },
+};
+
+r_test_suite r_time_test_setup() {
+    return (r_test_suite){
+        .name = "time",
+        .tests = tests,
+        .benches = benches,
+    };
+}
@@ -0,0 +1,236 @@
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "telemetry/segment.h"
+
+// telemetry attaches to the metrics segment of a running reload host and
+// displays them, or records them as csv.
+//
+//   telemetry [pid] [--record file.csv] [--interval ms]
+
+#define DEFAULT_INTERVAL_MS 250
+
+static const char *phase_names[R_MODULE_PHASE_COUNT] = {
+    "pre_frame",
+    "update",
+    "ui_update",
+    "post_frame",
+};
+
+static volatile sig_atomic_t finished = 0;
+
+void signal_handler(int signum) {
+    (void)signum;
+    finished = 1;
+}
+
+// the newest host if no pid was given
+static int find_host() {
+    DIR *dir = opendir("/dev/shm");
+    if (dir == NULL) {
+        return 0;
+    }
+
+    int            pid = 0;
+    time_t         newest = 0;
+    struct dirent *entry;
+
+    while ((entry = readdir(dir)) != NULL) {
+        int candidate = 0;
+        if (sscanf(entry->d_name, "reload-%d", &candidate) != 1) {
+            continue;
+        }
+
+        char        path[300];
+        struct stat statbuf;
+        snprintf(path, sizeof(path), "/dev/shm/%s", entry->d_name);
+
+        // skip segments left behind by hosts which didn't exit cleanly
+        if (stat(path, &statbuf) == 0 && kill(candidate, 0) == 0 && statbuf.st_mtime >= newest) {
+            newest = statbuf.st_mtime;
+            pid = candidate;
+        }
+    }
+
+    closedir(dir);
+    return pid;
+}
+
+static const r_telemetry_segment * attach(int pid) {
+    char name[TELEMETRY_NAME_LENGTH];
+    snprintf(name, sizeof(name), TELEMETRY_NAME_FORMAT, pid);
+
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        fprintf(stderr, "Unable to open %s\n", name);
+        return NULL;
+    }
+
+    struct stat statbuf;
+    if (fstat(fd, &statbuf) != 0 || (size_t)statbuf.st_size < sizeof(r_telemetry_segment)) {
+        fprintf(stderr, "%s is not a telemetry segment\n", name);
+        close(fd);
+        return NULL;
+    }
+
+    const r_telemetry_segment *segment = mmap(NULL, sizeof(r_telemetry_segment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (segment == MAP_FAILED) {
+        fprintf(stderr, "Unable to map %s\n", name);
+        return NULL;
+    }
+
+    if (segment->magic != TELEMETRY_MAGIC || segment->version != TELEMETRY_VERSION) {
+        fprintf(stderr, "%s has an unknown layout\n", name);
+        munmap((void *)segment, sizeof(r_telemetry_segment));
+        return NULL;
+    }
+
+    return segment;
+}
+
+static void display(const r_telemetry_frame *frame, const r_telemetry_modules *modules,
+                    const r_telemetry_memory *memory, const r_telemetry_draw *draw, int pid) {
+
+    // clear the terminal and start at the top
+    printf("\033[H\033[2J");
+    printf("reload %d  frame %llu\n\n", pid, (unsigned long long)frame->frame);
+    printf("frame     %7.2f ms  avg %7.2f ms  max %7.2f ms\n", frame->frame_ms, frame->frame_ms_average, frame->frame_ms_max);
+    printf("draw      %7u calls  %9u vertices\n", draw->draw_calls, draw->vertices);
+    printf("memory    %llu allocations  %llu frees  %llu bytes allocated\n\n",
+           (unsigned long long)memory->allocations, (unsigned long long)memory->frees, (unsigned long long)memory->bytes_allocated);
+
+    printf("%-20s %8s %12s %12s", "module", "reloads", "heap", "raylib");
+    for (uint32_t p = 0; p < R_MODULE_PHASE_COUNT; p++) {
+        printf(" %12s", phase_names[p]);
+    }
+    printf("\n");
+
+    for (uint32_t i = 0; i < modules->count && i < MAX_MODULES; i++) {
+        const r_telemetry_module *module = &modules->modules[i];
+
+        printf("%-20.20s %8u %12llu %12llu", module->name, module->reloads,
+               (unsigned long long)module->heap_used, (unsigned long long)module->raylib_used);
+        for (uint32_t p = 0; p < R_MODULE_PHASE_COUNT; p++) {
+            printf(" %9.3f ms", (double)module->callback_ns[p] / 1e6);
+        }
+        printf("\n");
+    }
+    fflush(stdout);
+}
+
+static void record(FILE *file, const r_telemetry_frame *frame, const r_telemetry_modules *modules,
+                   const r_telemetry_memory *memory, const r_telemetry_draw *draw) {
+
+    for (uint32_t i = 0; i < modules->count && i < MAX_MODULES; i++) {
+        const r_telemetry_module *module = &modules->modules[i];
+
+        fprintf(file, "%llu,%llu,%.3f,%.3f,%.3f,%u,%u,%llu,%llu,%llu,%s,%u,%llu,%llu",
+                (unsigned long long)frame->frame, (unsigned long long)frame->timestamp_ns,
+                frame->frame_ms, frame->frame_ms_average, frame->frame_ms_max,
+                draw->draw_calls, draw->vertices,
+                (unsigned long long)memory->allocations, (unsigned long long)memory->frees, (unsigned long long)memory->bytes_allocated,
+                module->name, module->reloads, (unsigned long long)module->heap_used, (unsigned long long)module->raylib_used);
+
+        for (uint32_t p = 0; p < R_MODULE_PHASE_COUNT; p++) {
+            fprintf(file, ",%llu", (unsigned long long)module->callback_ns[p]);
+        }
+        fprintf(file, "\n");
+    }
+    fflush(file);
+}
+
+int main(int argc, const char *argv[]) {
+    int         pid = 0;
+    const char *record_path = NULL;
+    int         interval_ms = DEFAULT_INTERVAL_MS;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+            interval_ms = atoi(argv[++i]);
+        } else {
+            pid = atoi(argv[i]);
+        }
+    }
+
+    if (pid == 0) {
+        pid = find_host();
+    }
+    if (pid == 0) {
+        fprintf(stderr, "No running reload host found\n");
+        return 1;
+    }
+
+    const r_telemetry_segment *segment = attach(pid);
+    if (segment == NULL) {
+        return 1;
+    }
+
+    FILE *file = NULL;
+    if (record_path != NULL) {
+        file = fopen(record_path, "w");
+        if (file == NULL) {
+            fprintf(stderr, "Unable to open %s\n", record_path);
+            return 1;
+        }
+
+        fprintf(file, "frame,timestamp_ns,frame_ms,frame_ms_average,frame_ms_max,draw_calls,vertices,allocations,frees,bytes_allocated,module,reloads,heap_used,raylib_used");
+        for (uint32_t p = 0; p < R_MODULE_PHASE_COUNT; p++) {
+            fprintf(file, ",%s_ns", phase_names[p]);
+        }
+        fprintf(file, "\n");
+    }
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    uint64_t last_frame = 0;
+
+    while (!finished) {
+        r_telemetry_frame   frame;
+        r_telemetry_modules modules;
+        r_telemetry_memory  memory;
+        r_telemetry_draw    draw;
+
+        bool read = r_telemetry_read(&segment->frame.block, &frame, TELEMETRY_FRAME_VERSION, sizeof(frame)) &&
+                    r_telemetry_read(&segment->modules.block, &modules, TELEMETRY_MODULES_VERSION, sizeof(modules)) &&
+                    r_telemetry_read(&segment->memory.block, &memory, TELEMETRY_MEMORY_VERSION, sizeof(memory)) &&
+                    r_telemetry_read(&segment->draw.block, &draw, TELEMETRY_DRAW_VERSION, sizeof(draw));
+
+        // the host exits without touching the segment again
+        if (kill(pid, 0) != 0) {
+            fprintf(stderr, "reload %d exited\n", pid);
+            break;
+        }
+
+        if (read && frame.frame != last_frame) {
+            last_frame = frame.frame;
+
+            if (file != NULL) {
+                record(file, &frame, &modules, &memory, &draw);
+            } else {
+                display(&frame, &modules, &memory, &draw, pid);
+            }
+        }
+
+        usleep(file != NULL ? 1000 : interval_ms * 1000);
+    }
+
+    if (file != NULL) {
+        fclose(file);
+    }
+    munmap((void *)segment, sizeof(r_telemetry_segment));
+
+    return 0;
+}